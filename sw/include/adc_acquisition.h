@@ -0,0 +1,300 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef ADC_ACQUISITION_H
+#define ADC_ACQUISITION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <avr/io.h>
+#include <array.h>
+#include <atomic.h>
+#include <functional.h>
+#include <register_access.h>
+#include <span.h>
+
+/**
+@brief Driver for the ADC module of AVR devices
+The registers are passed as template parameters. Since register_access.h redefines the register macros of avr/io.h as MMIORegister types,
+the module is declared as
+@code
+using ADCDevice = ADCModule<ADMUX, ADCSRA, ADCSRB, ADC>;
+@endcode
+Any other classes with static methods read() and write() can be used instead, e.g. a simulated peripheral for testing.
+@tparam MuxRegister ADC multiplexer selection register (ADMUX)
+@tparam ControlRegisterA ADC control and status register A (ADCSRA)
+@tparam ControlRegisterB ADC control and status register B (ADCSRB)
+@tparam DataRegister 16-bit ADC data register (ADC)
+*/
+template <typename MuxRegister, typename ControlRegisterA, typename ControlRegisterB, typename DataRegister>
+class ADCModule
+{
+    public:
+
+    /// @brief Voltage reference
+    enum class Reference : uint8_t
+    {
+        aref = 0,
+        avcc,
+        internal = 3
+    };
+
+    /// @brief ADC clock prescaler
+    enum class Prescaler : uint8_t
+    {
+        div2 = 1,
+        div4,
+        div8,
+        div16,
+        div32,
+        div64,
+        div128
+    };
+
+    /// @brief Auto trigger source
+    enum class Trigger : uint8_t
+    {
+        freeRunning = 0,
+        analogComparator,
+        externalInterrupt0,
+        timer0CompareMatchA,
+        timer0Overflow,
+        timer1CompareMatchB,
+        timer1Overflow,
+        timer1CaptureEvent
+    };
+
+    /**
+    @brief Initialization of the ADC module. The ADC is enabled, but no conversion is started.
+    @param reference Voltage reference
+    @param prescaler ADC clock prescaler. The ADC clock should be in range 50..200 kHz for full resolution.
+    */
+    static void init(const Reference reference, const Prescaler prescaler)
+    {
+        MuxRegister::write(static_cast<uint8_t>(reference) << REFS0);
+        ControlRegisterA::write(_BV(ADEN) | _BV(ADIF) | static_cast<uint8_t>(prescaler));
+    }
+
+    /**
+    @brief Select the input channel. Takes effect with the next conversion.
+    @param channel Input channel
+    */
+    static void selectChannel(const uint8_t channel)
+    {
+        ChannelBits::write(channel);
+    }
+
+    /**
+    @brief Start conversions on every rising edge of the given trigger source, with an interrupt after every conversion
+    @param trigger Auto trigger source
+    */
+    static void startAutoTrigger(const Trigger trigger)
+    {
+        TriggerBits::write(trigger);
+        ControlRegisterA::write(ControlRegisterA::read() | _BV(ADATE) | _BV(ADIE) | _BV(ADIF));
+    }
+
+    /**
+    @brief Stop auto triggering and disable the ADC interrupt. A conversion in progress completes without interrupt.
+    */
+    static void stopAutoTrigger()
+    {
+        ControlRegisterA::write(ControlRegisterA::read() & ~(_BV(ADATE) | _BV(ADIE) | _BV(ADIF)));
+    }
+
+    /**
+    @brief Get the result of the last conversion
+    @result Conversion result
+    */
+    static uint16_t read()
+    {
+        return DataRegister::read();
+    }
+
+    private:
+
+    using ChannelBits = BitGroupInRegister<MuxRegister, MUX0, MUX3>;
+    using TriggerBits = BitGroupInRegister<ControlRegisterB, ADTS0, ADTS2, Trigger>;
+};
+
+/**
+@brief Timer-triggered ADC acquisition into a double buffer (ping-pong buffer)
+The ADC is auto-triggered by a timer, so the sampling instants do not depend on interrupt or software latency.
+The ADC interrupt only stores the conversion result into the half of the buffer being filled. Once a half is full, it is handed over to process(),
+which calls the block callback with the completed half while the ADC interrupt fills the other half. Signal processing thus runs in blocks of
+t_blockSize samples and has t_blockSize sample periods to finish.
+@code
+using Acquisition = ADCAcquisition<ADCModule<ADMUX, ADCSRA, ADCSRB, ADC>, 32>;
+ISR(ADC_vect)
+{
+    Acquisition::onInterrupt();
+}
+
+// Timer 1 compare match B, e.g. at 8 kHz. The compare flag must be cleared for the next trigger, so an empty ISR is enabled.
+EMPTY_INTERRUPT(TIMER1_COMPB_vect)
+
+Acquisition::start(0, Acquisition::Device::Trigger::timer1CompareMatchB, &onBlock);
+while (true)
+{
+    Acquisition::process();
+}
+@endcode
+process() may also be called from the ADC interrupt itself if the block processing is short compared to the sample period.
+The block callback is kept until the acquisition is restarted, but Callback only refers to the invokable passed to start(). Pass a function pointer as above
+or an object with static storage duration; a capturing lambda written inline in the call to start() no longer exists when the first block is complete.
+If a half is completed while the previous half has not been processed yet, the previous half is dropped and counted as overrun,
+since it is about to be overwritten.
+@tparam _ADCModule ADC module driver, e.g. ADCModule
+@tparam t_blockSize Number of samples per half of the buffer
+*/
+template <typename _ADCModule, uint8_t t_blockSize>
+class ADCAcquisition
+{
+    static_assert(t_blockSize > 0 && t_blockSize < 128, "Block size must be in range 1..127");
+
+    public:
+
+    /// ADC module driver
+    typedef _ADCModule Device;
+
+    /// @brief Block callback, called with a complete half of the buffer. A function pointer or an invokable with static storage duration.
+    using Callback = function<void(ConstSpan<uint16_t>)>;
+
+    /**
+    @brief Start the acquisition
+    @param channel Input channel
+    @param trigger Auto trigger source
+    @param callback Block callback, a function pointer or an invokable with static storage duration
+    */
+    static void start(const uint8_t channel, const typename Device::Trigger trigger, const Callback& callback)
+    {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            s_callback = callback;
+            s_pos = 0;
+            s_ready = 0;
+            s_nofOverruns = 0;
+        }
+        Device::selectChannel(channel);
+        Device::startAutoTrigger(trigger);
+    }
+
+    /**
+    @brief Stop the acquisition. A partially filled half is discarded, complete halves can still be processed.
+    */
+    static void stop()
+    {
+        Device::stopAutoTrigger();
+    }
+
+    /**
+    @brief Call the block callback for the completed half of the buffer, if any
+    @result Number of blocks processed
+    */
+    static uint8_t process()
+    {
+        uint8_t nofBlocks = 0;
+        while (true)
+        {
+            uint8_t ready = 0;
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+            {
+                ready = s_ready;
+            }
+            if (0 == ready)
+            {
+                return nofBlocks;
+            }
+
+            // At most one half is ready, since the other one is being filled
+            const uint8_t half = ready >> 1;
+            s_callback(ConstSpan<uint16_t>(s_buffer.data() + half * t_blockSize, t_blockSize));
+            ++nofBlocks;
+
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+            {
+                s_ready = s_ready & ~ready;
+            }
+        }
+    }
+
+    /**
+    @brief Get the number of halves dropped because they were not processed in time
+    @result Number of overruns since start()
+    */
+    static uint8_t getNofOverruns()
+    {
+        return s_nofOverruns;
+    }
+
+    /**
+    @brief Callback for the ADC interrupt storing one conversion result
+    */
+    static void onInterrupt()
+    {
+        uint8_t pos = s_pos;
+        s_buffer[pos] = Device::read();
+        ++pos;
+
+        if (t_blockSize == pos || 2 * t_blockSize == pos)
+        {
+            // The other half is filled next, so it must not be processed any more
+            const uint8_t half = t_blockSize == pos ? 0b01 : 0b10;
+            if (s_ready & ~half)
+            {
+                ++s_nofOverruns;
+            }
+            s_ready = half;
+
+            if (2 * t_blockSize == pos)
+            {
+                pos = 0;
+            }
+        }
+        s_pos = pos;
+    }
+
+    private:
+
+    static Array<uint16_t, 2 * t_blockSize> s_buffer;
+    static Callback s_callback;
+
+    // Position of the next sample in the buffer
+    static uint8_t s_pos;
+
+    // Bit mask of the half ready for processing
+    static volatile uint8_t s_ready;
+    static uint8_t s_nofOverruns;
+};
+
+// Static initialization
+template <typename Device, uint8_t t_blockSize>
+Array<uint16_t, 2 * t_blockSize> ADCAcquisition<Device, t_blockSize>::s_buffer;
+
+template <typename Device, uint8_t t_blockSize>
+typename ADCAcquisition<Device, t_blockSize>::Callback ADCAcquisition<Device, t_blockSize>::s_callback;
+
+template <typename Device, uint8_t t_blockSize>
+uint8_t ADCAcquisition<Device, t_blockSize>::s_pos = 0;
+
+template <typename Device, uint8_t t_blockSize>
+volatile uint8_t ADCAcquisition<Device, t_blockSize>::s_ready = 0;
+
+template <typename Device, uint8_t t_blockSize>
+uint8_t ADCAcquisition<Device, t_blockSize>::s_nofOverruns = 0;
+
+#endif
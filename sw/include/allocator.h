@@ -20,6 +20,7 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <bits/c++config.h>
 #include <stddef.h> // size_t
+#include <stdint.h> // uintptr_t
 #include <type_traits.h> // DownCast
 #include <bits/move.h>
 
@@ -344,8 +345,8 @@ class FreeListAllocator
         Node* nextNode = prevNode->m_next;
         while (nextNode != nullptr)
         {
-            // Find position of new node
-            if (newNode > prevNode)
+            // Find position of new node: The new node succeeds the previous node, check if it precedes the next node
+            if (newNode < nextNode)
             {
                 // Try to join new and previous node
                 if (reinterpret_cast<char*>(prevNode) + prevNode->m_size + sizeof(Node) == reinterpret_cast<char*>(newNode))
@@ -544,4 +545,158 @@ uint8_t HeapAllocator<t_capacity>::s_memory[t_capacity];
 template <size_t t_capacity>
 FreeListAllocator HeapAllocator<t_capacity>::s_allocator(HeapAllocator<t_capacity>::s_memory, t_capacity);
 
+/**
+@brief Memory region given by a fixed address range
+Region tag type for RegionAllocator, e.g. for external SRAM attached via the external memory interface (XMEM) of the ATmega1280/2560.
+@tparam t_begin First address of the region
+@tparam t_size Size of the region in bytes
+*/
+template <uintptr_t t_begin, size_t t_size>
+struct MemoryRegion
+{
+    /**
+    @brief First address of the region
+    @result Pointer to the first byte of the region
+    */
+    static void* begin()
+    {
+        return reinterpret_cast<void*>(t_begin);
+    }
+    
+    /**
+    @brief Size of the region
+    @result Size of the region in bytes
+    */
+    static constexpr size_t size()
+    {
+        return t_size;
+    }
+};
+
+/**
+@brief Region allocator
+Stateless heap allocator managing the memory of a region given by a tag type, which provides the static methods begin() and size() like MemoryRegion.
+Each region has its own heap, so containers can be placed into a specific region via their Allocator template parameter, while operator new and
+all containers using the default HeapAllocator keep using the fast internal SRAM:
+@code
+// ATmega2560 with 56 KB external SRAM mapped above the internal SRAM
+using ExternalSRAM = MemoryRegion<0x2200, 0xDE00>;
+using XMEMAllocator = RegionAllocator<ExternalSRAM>;
+
+XMCRA = 1 << SRE; // Enable the external memory interface
+XMEMAllocator::init();
+Vector<int16_t, XMEMAllocator> samples;
+@endcode
+The region is not touched before init() is called, so the external memory interface can be enabled in main(). Until then, allocate() returns nullptr.
+Memory allocated from one region must only be deallocated by an allocator of the same region.
+@tparam Region Region tag type
+*/
+template <typename Region>
+class RegionAllocator
+{
+    public:
+    
+    using size_type = size_t;
+    
+    CXX14_CONSTEXPR RegionAllocator() = default;
+    
+    /**
+    @brief Copy constructor
+    @param other Allocator to copy from
+    */
+    CXX14_CONSTEXPR RegionAllocator(const RegionAllocator&)
+    {
+        // RegionAllocator is stateless --> nothing to do
+    }
+
+    /**
+    @brief move constructor
+    @param other Allocator to move from
+    */
+    CXX14_CONSTEXPR RegionAllocator(RegionAllocator&&)
+    {
+        // RegionAllocator is stateless --> nothing to do
+    }
+
+    /**
+    @brief Copy assignment
+    @param other Allocator to copy from
+    */
+    CXX14_CONSTEXPR RegionAllocator& operator=(const RegionAllocator&)
+    {
+        // RegionAllocator is stateless --> nothing to do
+        return *this;
+    }
+
+    /**
+    @brief Move assignment
+    @param other Allocator to move from
+    */
+    CXX14_CONSTEXPR RegionAllocator& operator=(RegionAllocator&&)
+    {
+        // RegionAllocator is stateless --> nothing to do
+        return *this;
+    }
+    
+    /**
+    @brief Initialize the heap of the region
+    Discards all previous allocations. The memory of the region must be accessible, i.e. an external memory interface must be enabled before.
+    */
+    static void init()
+    {
+        s_allocator = FreeListAllocator(Region::begin(), Region::size());
+    }
+
+    /**
+    @brief Allocation of memory
+    Allocates a block of memory from the region.
+    @param size Number of bytes to allocate
+    @result Pointer to allocated memory
+    @note If the region is out of memory or has not been initialized, a nullptr is returned
+    */
+    CXX14_CONSTEXPR static void* allocate(const size_type size)
+    {
+        return s_allocator.allocate(size);
+    }
+
+    /**
+    @brief Deallocation of memory
+    Returns a block of memory to the region.
+    @param Pointer to memory to be deallocated
+    */
+    CXX14_CONSTEXPR static void deallocate(void* ptr)
+    {
+        s_allocator.deallocate(ptr);
+    }
+    
+    /**
+    @brief Equality operator
+    Check if allocator is equal to other
+    @param other Allocator to compare with
+    @result true if allocators are equal, false otherwise
+    */
+    constexpr bool operator==(const RegionAllocator&) const
+    {
+        // All allocators of the same region share the same heap
+        return true;
+    }
+    
+    /**
+    @brief Swap allocators
+    @param other Allocator to swap with
+    */
+    constexpr void swap(RegionAllocator&)
+    {
+        // RegionAllocator is stateless --> nothing to do
+    }
+    
+    private:
+
+    static FreeListAllocator s_allocator;
+};
+
+// Static initialization
+template <typename Region>
+FreeListAllocator RegionAllocator<Region>::s_allocator;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,218 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATOMIC_POOL_ALLOCATOR_H
+#define ATOMIC_POOL_ALLOCATOR_H
+
+#include <bits/c++config.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic.h>
+
+/**
+@brief Interrupt-safe pool allocator
+Stateless allocator handing out fixed-size blocks from a static pool. allocate() and deallocate() only disable interrupts
+while the head of the free list is exchanged (a handful of cycles, independent of the pool size), so the same pool can be
+used from application code and from ISRs at the same time. All allocators with the same template arguments share the same pool.
+
+Since every block has the same size, the pool is only suitable for containers allocating one node per element, e.g.
+List, ForwardList, Queue and PriorityQueue over List, or Scheduler with t_capacity == 0:
+@code
+using TaskPool = AtomicPoolAllocator<List<Event>::nodeSize(), 16>;
+List<Event, TaskPool> events;
+@endcode
+Containers reallocating contiguous storage (Vector, Deque, String) request blocks larger than the node size and get a nullptr.
+
+Interrupt safety in this library:
+- AtomicPoolAllocator: allocate() and deallocate() may be called from anywhere
+- HeapAllocator, RegionAllocator, FreeListAllocator, PoolAllocator and operator new: not interrupt-safe. An allocation in an ISR
+  can corrupt the free list if it interrupts an allocation in application code
+- Containers: the allocator only makes allocation safe, a container object itself is never synchronized. A container may be
+  shared between an ISR and application code only if all accesses of the application code are wrapped in ATOMIC_BLOCK.
+  Containers which are only accessed from a single context (e.g. one list per ISR) need no synchronization with this allocator.
+- StaticList, StaticDeque, StaticVector, RingBuffer: no dynamic allocation, the same rule as for containers applies
+- Scheduler: schedule() and execute() in application code, clock() in ISR. With t_capacity == 0, pass this allocator
+  (sized with Scheduler::nodeSize()) if the heap is also used by application code or other ISRs.
+@tparam t_nodeSize Size of one block in bytes. Blocks are at least as large as a pointer
+@tparam t_nofNodes Number of blocks in the pool
+@tparam Tag Tag type to create distinct pools of equal geometry
+*/
+template <size_t t_nodeSize, size_t t_nofNodes, typename Tag = void>
+class AtomicPoolAllocator
+{
+    public:
+
+    using size_type = size_t;
+
+    CXX14_CONSTEXPR AtomicPoolAllocator() = default;
+
+    /**
+    @brief Copy constructor
+    @param other Allocator to copy from
+    */
+    CXX14_CONSTEXPR AtomicPoolAllocator(const AtomicPoolAllocator&)
+    {
+        // AtomicPoolAllocator is stateless --> nothing to do
+    }
+
+    /**
+    @brief move constructor
+    @param other Allocator to move from
+    */
+    CXX14_CONSTEXPR AtomicPoolAllocator(AtomicPoolAllocator&&)
+    {
+        // AtomicPoolAllocator is stateless --> nothing to do
+    }
+
+    /**
+    @brief Copy assignment
+    @param other Allocator to copy from
+    */
+    CXX14_CONSTEXPR AtomicPoolAllocator& operator=(const AtomicPoolAllocator&)
+    {
+        // AtomicPoolAllocator is stateless --> nothing to do
+        return *this;
+    }
+
+    /**
+    @brief Move assignment
+    @param other Allocator to move from
+    */
+    CXX14_CONSTEXPR AtomicPoolAllocator& operator=(AtomicPoolAllocator&&)
+    {
+        // AtomicPoolAllocator is stateless --> nothing to do
+        return *this;
+    }
+
+    /**
+    @brief Allocation of memory
+    Detaches one block from the pool. Can be called from ISRs.
+    @param size Number of bytes to allocate
+    @result Pointer to the allocated block
+    @note If size exceeds the block size or the pool is exhausted, a nullptr is returned
+    */
+    static void* allocate(const size_type size)
+    {
+        if (0 == size || s_nodeSize < size)
+        {
+            return nullptr;
+        }
+
+        Node* node;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            node = s_head;
+            if (nullptr != node)
+            {
+                // Reuse a returned block
+                s_head = node->m_next;
+            }
+            else if (s_nofFresh < t_nofNodes)
+            {
+                // Hand out a block which was never used before
+                node = reinterpret_cast<Node*>(s_memory[s_nofFresh++]);
+            }
+        }
+        return node;
+    }
+
+    /**
+    @brief Deallocation of memory
+    Returns a block to the pool. Can be called from ISRs.
+    @param Pointer to memory to be deallocated
+    */
+    static void deallocate(void* ptr)
+    {
+        if (nullptr != ptr)
+        {
+            Node* node = static_cast<Node*>(ptr);
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+            {
+                node->m_next = s_head;
+                s_head = node;
+            }
+        }
+    }
+
+    /**
+    @brief Size of one block
+    @result Size of one block in bytes
+    */
+    static constexpr size_type nodeSize()
+    {
+        return s_nodeSize;
+    }
+
+    /**
+    @brief Number of blocks in the pool
+    @result Number of blocks, including allocated ones
+    */
+    static constexpr size_type capacity()
+    {
+        return t_nofNodes;
+    }
+
+    /**
+    @brief Equality operator
+    Check if allocator is equal to other
+    @param other Allocator to compare with
+    @result true if allocators are equal, false otherwise
+    */
+    constexpr bool operator==(const AtomicPoolAllocator&) const
+    {
+        // All allocators of the same type share the same pool
+        return true;
+    }
+
+    /**
+    @brief Swap allocators
+    @param other Allocator to swap with
+    */
+    constexpr void swap(AtomicPoolAllocator&)
+    {
+        // AtomicPoolAllocator is stateless --> nothing to do
+    }
+
+    private:
+
+    // Memory node
+    struct Node
+    {
+        Node* m_next;
+    };
+
+    // Block size rounded up to the alignment of a node, so that every block of the pool is aligned
+    static constexpr size_type s_nodeSize = ((t_nodeSize > sizeof(Node) ? t_nodeSize : sizeof(Node)) + alignof(Node) - 1) / alignof(Node) * alignof(Node);
+
+    // The pool needs no initialization at startup, so it can be used by constructors of other static objects:
+    // Blocks are handed out from s_memory in order, returned blocks are kept in the free list starting at s_head.
+    alignas(Node) static uint8_t s_memory[t_nofNodes][s_nodeSize];
+    static Node* s_head;
+    static size_type s_nofFresh;
+};
+
+// Static initialization
+template <size_t t_nodeSize, size_t t_nofNodes, typename Tag>
+alignas(typename AtomicPoolAllocator<t_nodeSize, t_nofNodes, Tag>::Node) uint8_t AtomicPoolAllocator<t_nodeSize, t_nofNodes, Tag>::s_memory[t_nofNodes][s_nodeSize];
+
+template <size_t t_nodeSize, size_t t_nofNodes, typename Tag>
+typename AtomicPoolAllocator<t_nodeSize, t_nofNodes, Tag>::Node* AtomicPoolAllocator<t_nodeSize, t_nofNodes, Tag>::s_head = nullptr;
+
+template <size_t t_nodeSize, size_t t_nofNodes, typename Tag>
+typename AtomicPoolAllocator<t_nodeSize, t_nofNodes, Tag>::size_type AtomicPoolAllocator<t_nodeSize, t_nofNodes, Tag>::s_nofFresh = 0;
+
+#endif
@@ -0,0 +1,177 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef BIT_ANGLE_MODULATION_H
+#define BIT_ANGLE_MODULATION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <array.h>
+
+/**
+@brief Bit angle modulation (binary code modulation) engine for dimming LEDs on shift registers or multiplexed outputs
+Instead of comparing the brightness of every LED to a PWM counter on every timer tick, the brightness values are split into bit planes
+whenever a brightness changes. Each timer interrupt outputs one bit plane, and plane n is displayed for 2^n base periods. The average on-time
+of each LED then equals its brightness, while the interrupt cost is independent of the brightness values and of the PWM resolution:
+one write of the output image per plane, i.e. t_bits interrupts per PWM period.
+The outputs are driven through the same device policies as OutputShadowRegister, e.g. ShiftRegister74HC595, MCP23S17Outputs or PinOutputs.
+The timer interrupt must call onInterrupt() and reload the timer with the returned number of base periods:
+@code
+using LEDs = BitAngleModulation<ShiftRegister74HC595<SPIMaster, LatchPin>, 64>;
+ISR(TIMER1_COMPA_vect)
+{
+    OCR1A = LEDs::onInterrupt() * s_baseTicks - 1;
+}
+@endcode
+The base period must be longer than the execution time of the interrupt, e.g. 8 SPI bytes for 64 LEDs on 74HC595 shift registers.
+@note Brightness changes take effect with the next bit plane, so a PWM period may show a mix of old and new brightness for the LED being changed.
+@tparam Device Output device policy
+@tparam t_nofLEDs Number of LEDs
+@tparam t_bits Brightness resolution in bits (1..8), default is 8. The bit planes are the only copy of the brightness values,
+i.e. t_bits * (t_nofLEDs + 7) / 8 bytes of RAM, so lower resolutions save RAM.
+*/
+template <typename Device, uint8_t t_nofLEDs, uint8_t t_bits = 8>
+class BitAngleModulation
+{
+    static_assert(t_bits > 0 && t_bits <= 8, "Brightness resolution must be in range 1..8 bits");
+    
+    public:
+    
+    /// @brief Maximum brightness
+    static constexpr uint8_t s_maxBrightness = static_cast<uint8_t>((1u << t_bits) - 1);
+    
+    /**
+    @brief Initialization of the output device. All LEDs are off.
+    */
+    static void init()
+    {
+        Device::init();
+        setAll(0);
+    }
+    
+    /**
+    @brief Set the brightness of a single LED. The bit planes are updated accordingly.
+    @param idx LED index
+    @param brightness Brightness in range 0..s_maxBrightness
+    */
+    static void setBrightness(const uint8_t idx, const uint8_t brightness)
+    {
+        const uint8_t byteIdx = idx >> 3;
+        const uint8_t mask = 1 << (idx & 0b111);
+        for (uint8_t plane = 0; plane < t_bits; ++plane)
+        {
+            if (brightness & (1 << plane))
+            {
+                s_planes[plane][byteIdx] |= mask;
+            }
+            else
+            {
+                s_planes[plane][byteIdx] &= ~mask;
+            }
+        }
+    }
+    
+    /**
+    @brief Get the brightness of a single LED. The brightness is assembled from the bit planes.
+    @param idx LED index
+    @result Brightness
+    */
+    static uint8_t getBrightness(const uint8_t idx)
+    {
+        const uint8_t byteIdx = idx >> 3;
+        const uint8_t mask = 1 << (idx & 0b111);
+        uint8_t brightness = 0;
+        for (uint8_t plane = 0; plane < t_bits; ++plane)
+        {
+            if (s_planes[plane][byteIdx] & mask)
+            {
+                brightness |= 1 << plane;
+            }
+        }
+        return brightness;
+    }
+    
+    /**
+    @brief Set all LEDs to the same brightness
+    @param brightness Brightness in range 0..s_maxBrightness
+    */
+    static void setAll(const uint8_t brightness)
+    {
+        for (uint8_t plane = 0; plane < t_bits; ++plane)
+        {
+            s_planes[plane].fill((brightness & (1 << plane)) ? 0xFF : 0x00);
+        }
+    }
+    
+    /**
+    @brief Output the next bit plane. Call from the timer interrupt.
+    @result Duration of the bit plane in base periods, i.e. the time until the next call
+    */
+    static uint8_t onInterrupt()
+    {
+        const uint8_t plane = s_plane;
+        Device::write(s_planes[plane].data(), s_nofBytes, AllDirty());
+        s_plane = plane + 1 < t_bits ? plane + 1 : 0;
+        return getDuration(plane);
+    }
+    
+    /**
+    @brief Get the duration of a bit plane
+    @param plane Bit plane
+    @result Duration in base periods
+    */
+    static constexpr uint8_t getDuration(const uint8_t plane)
+    {
+        return static_cast<uint8_t>(1 << plane);
+    }
+    
+    /**
+    @brief Get the duration of a complete PWM period
+    @result Duration in base periods
+    */
+    static constexpr uint16_t getPeriod()
+    {
+        return s_maxBrightness;
+    }
+    
+    private:
+    
+    static constexpr uint8_t s_nofBytes = (t_nofLEDs + 7) >> 3;
+    
+    // Dirty mask for device policies requesting all bytes, since every bit plane differs from the previous one
+    struct AllDirty
+    {
+        constexpr bool operator[](const uint8_t) const
+        {
+            return true;
+        }
+    };
+    
+    using Planes = Array<Array<uint8_t, s_nofBytes>, t_bits>;
+    
+    static Planes s_planes;
+    static uint8_t s_plane;
+};
+
+// Static initialization
+template <typename Device, uint8_t t_nofLEDs, uint8_t t_bits>
+typename BitAngleModulation<Device, t_nofLEDs, t_bits>::Planes BitAngleModulation<Device, t_nofLEDs, t_bits>::s_planes = {};
+
+template <typename Device, uint8_t t_nofLEDs, uint8_t t_bits>
+uint8_t BitAngleModulation<Device, t_nofLEDs, t_bits>::s_plane = 0;
+
+#endif
@@ -0,0 +1,128 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef BYTE_STREAM_H
+#define BYTE_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <span.h>
+
+/**
+@brief Batch processing of byte streams shared by the streaming parsers and encoders
+The parsers (MidiParser, COBSDecoder, SLIPDecoder) and the encoders (COBSEncoder, SLIPEncoder) work one byte at a time. The loops feeding them
+from a span or a receive buffer, or draining them into a transmitter, are implemented once in the CRTP base classes below.
+*/
+namespace byteStreamHelper
+{
+    /**
+    @brief Base class of parsers consuming one byte at a time
+    Derived classes have to bring parse(const ConstSpan<uint8_t>) into scope with a using declaration, since their parse(const uint8_t) hides it.
+    @tparam Derived Parser class providing the method void parse(const uint8_t)
+    */
+    template <typename Derived>
+    class ByteParser
+    {
+        public:
+        
+        /**
+        @brief Parse a sequence of bytes
+        @param data Received bytes
+        */
+        void parse(const ConstSpan<uint8_t> data)
+        {
+            for (const uint8_t byte : data)
+            {
+                derived().parse(byte);
+            }
+        }
+        
+        /**
+        @brief Parse bytes from a source, e.g. a RingBuffer filled by the USART receive interrupt
+        @tparam Source Source class providing the method bool read(uint8_t&)
+        @param source Source
+        @param maxNofBytes Maximum number of bytes parsed, e.g. to limit the time spent in one call
+        @result Number of bytes parsed
+        */
+        template <typename Source>
+        uint8_t parseFrom(Source& source, const uint8_t maxNofBytes = 0xFF)
+        {
+            uint8_t nofBytes = 0;
+            uint8_t data;
+            while (nofBytes < maxNofBytes && source.read(data))
+            {
+                derived().parse(data);
+                ++nofBytes;
+            }
+            return nofBytes;
+        }
+        
+        protected:
+        
+        constexpr ByteParser() = default;
+        
+        private:
+        
+        Derived& derived()
+        {
+            return static_cast<Derived&>(*this);
+        }
+    };
+    
+    /**
+    @brief Base class of encoders producing one byte at a time
+    @tparam Derived Encoder class providing the methods bool read(uint8_t&) and bool done() const
+    */
+    template <typename Derived>
+    class ByteEncoder
+    {
+        public:
+        
+        /**
+        @brief Enqueue encoded bytes in a transmitter until the frame is complete or the transmitter is full
+        @tparam TX Transmitter class providing the static methods
+        bool put(const uint8_t data)
+        size_t getNofFreeBytes()
+        @result true if the frame has been enqueued completely
+        */
+        template <typename TX>
+        bool encodeTo()
+        {
+            uint8_t data;
+            size_t nofFreeBytes = TX::getNofFreeBytes();
+            while (nofFreeBytes-- > 0 && derived().read(data))
+            {
+                TX::put(data);
+            }
+            return derived().done();
+        }
+        
+        protected:
+        
+        constexpr ByteEncoder() = default;
+        
+        private:
+        
+        Derived& derived()
+        {
+            return static_cast<Derived&>(*this);
+        }
+    };
+}
+
+#endif
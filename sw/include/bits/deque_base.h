@@ -0,0 +1,127 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DEQUE_BASE_H
+#define DEQUE_BASE_H
+
+#include <bits/c++config.h>
+#include <bits/move.h>
+#include <memcopy.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+@brief Type-independent core of the Deque container
+*/
+namespace dequeHelper
+{
+    /**
+    @brief Ring index math of a deque storing its elements in a circular buffer
+    This class only depends on the size type, i.e. the code is shared by all deques using the same allocator size type regardless of the element type.
+    Elements are addressed by byte offsets where element storage has to be accessed.
+    @tparam SizeType Integral type used for sizes and indices
+    */
+    template <typename SizeType>
+    class DequeBase
+    {
+        public:
+
+        using size_type = SizeType;
+
+        protected:
+
+        constexpr DequeBase() = default;
+        DequeBase(const DequeBase&) = delete;
+        DequeBase& operator=(const DequeBase&) = delete;
+
+        // Storage index of the element at logical position pos, pos <= m_capacity
+        // pos + m_front is not evaluated as it can exceed the range of size_type for large capacities
+        CXX14_CONSTEXPR size_type toIndex(const size_type pos) const
+        {
+            const size_type nofElemsFront = m_capacity - m_front;
+            return pos < nofElemsFront ? m_front + pos : pos - nofElemsFront;
+        }
+
+        CXX14_CONSTEXPR void incIndex(size_type& idx) const
+        {
+            if (++idx == m_capacity)
+            {
+                idx = 0;
+            }
+        }
+
+        CXX14_CONSTEXPR void decIndex(size_type& idx) const
+        {
+            if (idx == 0)
+            {
+                idx = m_capacity;
+            }
+            --idx;
+        }
+
+        constexpr bool full() const
+        {
+            return m_size == m_capacity;
+        }
+
+        // Capacity after growing a full container. An empty container without storage grows to one element.
+        constexpr size_type grownCapacity() const
+        {
+            return 0 == m_capacity ? 1 : m_capacity << 1;
+        }
+
+        // Reset the indices to hold size elements starting at the begin of a storage of given capacity
+        CXX14_CONSTEXPR void resetIndices(const size_type capacity, const size_type size)
+        {
+            m_capacity = capacity;
+            m_size = size;
+            m_front = 0;
+            m_end = size;
+        }
+
+        CXX14_CONSTEXPR void swapIndices(DequeBase& other)
+        {
+            swap(m_capacity, other.m_capacity);
+            swap(m_size, other.m_size);
+            swap(m_front, other.m_front);
+            swap(m_end, other.m_end);
+        }
+
+        // Copy the first count elements of elemSize bytes each from the circular storage src into the linear storage dst.
+        // Only valid for trivially copyable elements.
+        CXX14_CONSTEXPR void copyLinear(uint8_t* dst, const uint8_t* src, const size_t elemSize, const size_type count) const
+        {
+            // Number of elements up to the end of the storage, the remaining elements wrap around to the begin of the storage
+            size_type nofElemsFront = m_capacity - m_front;
+            if (nofElemsFront > count)
+            {
+                nofElemsFront = count;
+            }
+
+            const size_t nofBytesFront = nofElemsFront * elemSize;
+            memcopy(dst, src + m_front * elemSize, nofBytesFront);
+            memcopy(dst + nofBytesFront, src, (count - nofElemsFront) * elemSize);
+        }
+
+        size_type m_capacity = 0;
+        size_type m_size = 0;
+        size_type m_front = 0;
+        size_type m_end = 0;
+    };
+}
+
+#endif
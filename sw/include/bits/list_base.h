@@ -0,0 +1,300 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIST_BASE_H
+#define LIST_BASE_H
+
+#include <bits/c++config.h>
+#include <bits/move.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+@brief Type-independent core of the linked list containers
+List, StaticList and ForwardList only differ in the type of the element stored in a node. Everything that merely relinks nodes is implemented
+once in the non-template classes below, operating on node base pointers. The containers derive from these classes and only add the code which
+actually touches elements, i.e. construction, destruction and comparison. This keeps the flash footprint of each additional element type small.
+*/
+namespace listHelper
+{
+    /**
+    @brief Node base of doubly linked lists
+    Constructing a node links it between prev and next, destructing a node unlinks it again.
+    */
+    struct ListNodeBase
+    {
+        CXX14_CONSTEXPR ListNodeBase(ListNodeBase* prev = nullptr, ListNodeBase* next = nullptr) : m_prev(prev), m_next(next)
+        {
+            if (nullptr != prev)
+            {
+                prev->m_next = this;
+            }
+
+            if (nullptr != next)
+            {
+                next->m_prev = this;
+            }
+        }
+
+        CXX20_CONSTEXPR ~ListNodeBase()
+        {
+            if (nullptr != m_prev)
+            {
+                m_prev->m_next = m_next;
+            }
+
+            if (nullptr != m_next)
+            {
+                m_next->m_prev = m_prev;
+            }
+        }
+
+        ListNodeBase* m_prev = nullptr;
+        ListNodeBase* m_next = nullptr;
+    };
+
+    /**
+    @brief Doubly linked list of node bases between a sentinel front and back node
+    */
+    class ListBase
+    {
+        public:
+
+        using NodeBase = ListNodeBase;
+
+        /**
+        @brief Checks if the list has no nodes
+        @result true if the list is empty, false otherwise
+        */
+        [[nodiscard]] constexpr bool empty() const
+        {
+            return (m_front.m_next == &m_back);
+        }
+
+        protected:
+
+        /// Constructor. Constructs an empty list
+        CXX14_CONSTEXPR ListBase()
+        {
+            init();
+        }
+
+        ListBase(const ListBase&) = delete;
+        ListBase& operator=(const ListBase&) = delete;
+
+        CXX14_CONSTEXPR void init()
+        {
+            // Link front and back node
+            link(m_front, m_back);
+        }
+
+        // Count the nodes between front and back node
+        CXX14_CONSTEXPR size_t countNodes() const
+        {
+            size_t nofNodes = 0;
+            for (const NodeBase* node = m_front.m_next; &m_back != node; node = node->m_next)
+            {
+                ++nofNodes;
+            }
+            return nofNodes;
+        }
+
+        // Take over all nodes of other. *this must be empty, other is empty afterwards.
+        CXX14_CONSTEXPR void takeOver(ListBase& other)
+        {
+            if (!other.empty())
+            {
+                link(m_front, *other.m_front.m_next);
+                link(*other.m_back.m_prev, m_back);
+                other.init();
+            }
+        }
+
+        // Reverse the order of all nodes
+        CXX14_CONSTEXPR void reverseNodes()
+        {
+            // An empty list would link the front and back node to themselves
+            if (empty())
+            {
+                return;
+            }
+
+            NodeBase* node = m_front.m_next;
+            while (node != &m_back)
+            {
+                swap(node->m_prev, node->m_next);
+                node = node->m_prev;
+            }
+
+            swap(m_front.m_next, m_back.m_prev);
+            link(m_front, *m_front.m_next);
+            link(*m_back.m_prev, m_back);
+        }
+
+        // Move the nodes in range [first, last) before pos. The range may belong to another list.
+        static CXX14_CONSTEXPR void transfer(NodeBase* pos, NodeBase* first, NodeBase* last)
+        {
+            if (first != last)
+            {
+                NodeBase* lastNode = last->m_prev;
+
+                // Unlink range from its list
+                link(*first->m_prev, *last);
+
+                // Link range before pos
+                link(*pos->m_prev, *first);
+                link(*lastNode, *pos);
+            }
+        }
+
+        // Detach all nodes as a chain terminated by nullptr for use with listHelper algorithms.
+        // The list is in an inconsistent state until the chain is attached again by relink().
+        CXX14_CONSTEXPR NodeBase* detach()
+        {
+            if (empty())
+            {
+                return nullptr;
+            }
+
+            m_back.m_prev->m_next = nullptr;
+            return m_front.m_next;
+        }
+
+        // Attach a chain terminated by nullptr between front and back node and restore the backward links
+        CXX14_CONSTEXPR void relink(NodeBase* node)
+        {
+            NodeBase* prev = &m_front;
+            while (nullptr != node)
+            {
+                link(*prev, *node);
+                prev = node;
+                node = node->m_next;
+            }
+            link(*prev, m_back);
+        }
+
+        CXX14_CONSTEXPR static void link(NodeBase& prev, NodeBase& next)
+        {
+            // Link two nodes of the list
+            prev.m_next = &next;
+            next.m_prev = &prev;
+        }
+
+        NodeBase m_front;
+        NodeBase m_back;
+    };
+
+    /**
+    @brief Doubly linked list of node bases with nodes taken from a fixed buffer
+    Unused nodes are kept in a singly linked available-list. Nodes are addressed by byte offsets into the buffer, so the buffer can be owned
+    by the derived class with the actual node size.
+    */
+    class StaticListBase : public ListBase
+    {
+        protected:
+
+        // Put nofNodes nodes of nodeSize bytes each stored in buffer into the available-list
+        CXX14_CONSTEXPR void initPool(uint8_t* buffer, const size_t nodeSize, size_t nofNodes)
+        {
+            while (nofNodes--)
+            {
+                NodeBase* node = reinterpret_cast<NodeBase*>(buffer);
+                node->m_next = m_available;
+                m_available = node;
+                buffer += nodeSize;
+            }
+        }
+
+        // Detach a node from the available-list, or return nullptr if all nodes are in use
+        CXX14_CONSTEXPR NodeBase* popAvailable()
+        {
+            NodeBase* available = m_available;
+            if (nullptr != available)
+            {
+                m_available = available->m_next;
+            }
+            return available;
+        }
+
+        // Attach a destructed node to the available-list
+        CXX14_CONSTEXPR void pushAvailable(NodeBase* node)
+        {
+            node->m_next = m_available;
+            m_available = node;
+        }
+
+        NodeBase* m_available = nullptr;
+    };
+
+    /**
+    @brief Node base of singly linked lists
+    */
+    struct ForwardListNodeBase
+    {
+        constexpr ForwardListNodeBase(ForwardListNodeBase* next = nullptr) : m_next(next)
+        {}
+
+        ForwardListNodeBase* m_next = nullptr;
+    };
+
+    /**
+    @brief Singly linked list of node bases following a sentinel head node
+    */
+    class ForwardListBase
+    {
+        public:
+
+        using NodeBase = ForwardListNodeBase;
+
+        /**
+        @brief Checks if the list has no nodes
+        @result true if the list is empty, false otherwise
+        */
+        [[nodiscard]] constexpr bool empty() const
+        {
+            return (nullptr == m_head.m_next);
+        }
+
+        protected:
+
+        constexpr ForwardListBase() = default;
+        ForwardListBase(const ForwardListBase&) = delete;
+        ForwardListBase& operator=(const ForwardListBase&) = delete;
+
+        // Move all nodes of other after pos
+        static CXX14_CONSTEXPR void transferAfter(NodeBase* pos, ForwardListBase& other)
+        {
+            // Append other to pos node and store the original successor of pos
+            NodeBase* next = pos->m_next;
+            pos->m_next = other.m_head.m_next;
+
+            // Uncouple moved list nodes from other
+            other.m_head.m_next = nullptr;
+
+            // Append remaining nodes of this to other
+            while (nullptr != pos->m_next)
+            {
+                pos = pos->m_next;
+            }
+            pos->m_next = next;
+        }
+
+        NodeBase m_head;
+    };
+}
+
+#endif
@@ -0,0 +1,134 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIST_SORT_H
+#define LIST_SORT_H
+
+#include <bits/c++config.h>
+#include <stddef.h>
+
+/**
+@brief Sorting and merging of singly linked chains of list nodes
+The algorithms only relink nodes via their m_next pointer. Elements are neither copied nor moved and no memory is allocated.
+Chains are terminated by nullptr. Doubly linked lists have to restore the m_prev pointers afterwards.
+*/
+namespace listHelper
+{
+    // Access the element stored in a node
+    template <typename Node, typename NodeBase>
+    constexpr auto data(const NodeBase* node) -> const decltype(Node::m_data)&
+    {
+        return static_cast<const Node*>(node)->m_data;
+    }
+
+    /**
+    @brief Merge two sorted chains into one sorted chain
+    The merge is stable, i.e. for equivalent elements, the elements of lhs precede the elements of rhs.
+    @tparam Node Node type containing the element as m_data
+    @param lhs, rhs Sorted chains to merge, may be nullptr
+    @param comp Comparison function object returning true if the first argument is less than the second one
+    @result First node of the merged chain
+    */
+    template <typename Node, typename NodeBase, typename Compare>
+    CXX14_CONSTEXPR NodeBase* merge(NodeBase* lhs, NodeBase* rhs, Compare& comp)
+    {
+        NodeBase* head = nullptr;
+        NodeBase** tail = &head;
+        while (nullptr != lhs && nullptr != rhs)
+        {
+            if (comp(data<Node>(rhs), data<Node>(lhs)))
+            {
+                *tail = rhs;
+                rhs = rhs->m_next;
+            }
+            else
+            {
+                *tail = lhs;
+                lhs = lhs->m_next;
+            }
+            tail = &(*tail)->m_next;
+        }
+        *tail = (nullptr != lhs) ? lhs : rhs;
+        return head;
+    }
+
+    /**
+    @brief Sort a chain using bottom-up merge sort
+    The chain is sorted in passes merging pairs of adjacent sorted runs of length 1, 2, 4, ... until a single run is left.
+    This takes O(n log n) comparisons and O(1) memory, i.e. no recursion and no auxiliary array of run heads. The sort is stable.
+    @tparam Node Node type containing the element as m_data
+    @param head First node of the chain, may be nullptr
+    @param comp Comparison function object returning true if the first argument is less than the second one
+    @result First node of the sorted chain
+    */
+    template <typename Node, typename NodeBase, typename Compare>
+    CXX14_CONSTEXPR NodeBase* sort(NodeBase* head, Compare& comp)
+    {
+        for (size_t runLength = 1; nullptr != head; runLength <<= 1)
+        {
+            NodeBase* lhs = head;
+            NodeBase** tail = &head;
+            size_t nofMerges = 0;
+
+            while (nullptr != lhs)
+            {
+                ++nofMerges;
+
+                // Find start of the right run
+                NodeBase* rhs = lhs;
+                size_t lhsLength = 0;
+                while (lhsLength < runLength && nullptr != rhs)
+                {
+                    rhs = rhs->m_next;
+                    ++lhsLength;
+                }
+                size_t rhsLength = runLength;
+
+                // Merge both runs and append them to the output chain
+                while (lhsLength > 0 || (rhsLength > 0 && nullptr != rhs))
+                {
+                    if (0 == lhsLength || (rhsLength > 0 && nullptr != rhs && comp(data<Node>(rhs), data<Node>(lhs))))
+                    {
+                        *tail = rhs;
+                        rhs = rhs->m_next;
+                        --rhsLength;
+                    }
+                    else
+                    {
+                        *tail = lhs;
+                        lhs = lhs->m_next;
+                        --lhsLength;
+                    }
+                    tail = &(*tail)->m_next;
+                }
+
+                // Continue with the next pair of runs
+                lhs = rhs;
+            }
+            *tail = nullptr;
+
+            if (nofMerges <= 1)
+            {
+                break;
+            }
+        }
+        return head;
+    }
+}
+
+#endif
@@ -0,0 +1,504 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef BUFFERED_GLCD_H
+#define BUFFERED_GLCD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <avr/pgmspace.h>
+#include <array.h>
+#include <bool_array.h>
+#include <span.h>
+
+/// @brief Pixel color of monochrome graphic LCDs
+enum class GLCDColor : uint8_t
+{
+    black,
+    white,
+    invert
+};
+
+/**
+@brief Fixed-width font stored in program memory
+Each glyph is width bytes, one byte per column with the top pixel in the least significant bit, i.e. glyphs are up to 8 pixels high.
+Glyphs are stored consecutively starting with character first.
+*/
+struct GLCDFont
+{
+    PgmSpan<uint8_t> glyphs;
+    uint8_t width;
+    char first;
+    
+    /**
+    @brief Get the number of glyphs
+    @result Number of glyphs
+    */
+    constexpr size_t size() const
+    {
+        return glyphs.size() / width;
+    }
+};
+
+/**
+@brief Frame buffer for monochrome graphic LCDs with page addressing (e.g. SSD1306, SH1106, ST7565, KS0108)
+The frame buffer uses the memory layout of the display: Each page of 8 pixel rows is stored as one byte per column with the top row in the least significant bit.
+The display is divided into tiles of 8x8 pixels, i.e. 8 columns of one page. Drawing marks the tiles whose content actually changed as dirty,
+and refresh() transfers only dirty tiles to the display. Adjacent dirty tiles of a page are sent as a single bulk transfer.
+A 128x64 display uses 1024 bytes of frame buffer plus 16 bytes of dirty flags.
+@tparam GLCD Underlying graphic LCD device driver.
+This driver class needs to implement the following static methods:
+void init()
+uint8_t getWidth()
+uint8_t getHeight()
+void setWindow(const uint8_t pageIdx, const uint8_t columnIdx)
+void putData(const uint8_t * data, const uint8_t nofBytes)
+putData() writes to consecutive columns of the current page, typically as a single SPIMasterSync::put(data, nofBytes) call.
+*/
+template <typename GLCD>
+class GLCDBuffered
+{
+    public:
+    
+    /**
+    @brief Get width of graphic LCD from underlying graphic LCD device
+    @result Width in pixels
+    */
+    static constexpr uint8_t getWidth()
+    {
+        return GLCD::getWidth();
+    }
+    
+    /**
+    @brief Get height of graphic LCD from underlying graphic LCD device
+    @result Height in pixels
+    */
+    static constexpr uint8_t getHeight()
+    {
+        return GLCD::getHeight();
+    }
+    
+    /**
+    @brief Initialization. Clears the frame buffer and the LCD
+    */
+    static void init()
+    {
+        GLCD::init();
+        clear();
+        invalidate();
+        refresh();
+    }
+    
+    /**
+    @brief Clear the frame buffer
+    */
+    static void clear()
+    {
+        fillRect(0, 0, getWidth(), getHeight(), GLCDColor::black);
+    }
+    
+    /**
+    @brief Mark the whole frame buffer as dirty, e.g. if the display content was lost
+    */
+    static void invalidate()
+    {
+        s_dirty.setAll();
+    }
+    
+    /**
+    @brief Refresh the LCD, i.e. transfer all dirty tiles of the frame buffer to the LCD
+    */
+    static void refresh()
+    {
+        for (uint8_t pageIdx = 0; pageIdx < s_nofPages; ++pageIdx)
+        {
+            const uint8_t firstTile = pageIdx * s_nofTileColumns;
+            uint8_t tileIdx = 0;
+            while (tileIdx < s_nofTileColumns)
+            {
+                if (!s_dirty[firstTile + tileIdx])
+                {
+                    ++tileIdx;
+                    continue;
+                }
+                
+                // Collect adjacent dirty tiles
+                const uint8_t runStart = tileIdx;
+                do
+                {
+                    s_dirty.clear(firstTile + tileIdx);
+                    ++tileIdx;
+                }
+                while (tileIdx < s_nofTileColumns && s_dirty[firstTile + tileIdx]);
+                
+                const uint8_t columnIdx = runStart * s_tileWidth;
+                GLCD::setWindow(pageIdx, columnIdx);
+                GLCD::putData(&s_buffer[pageIdx * getWidth() + columnIdx], (tileIdx - runStart) * s_tileWidth);
+            }
+        }
+    }
+    
+    /**
+    @brief Check if the frame buffer has changed since the last refresh
+    @result true if at least one tile is dirty
+    */
+    static bool isDirty()
+    {
+        for (const uint8_t flags : s_dirty.data())
+        {
+            if (0 != flags)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    /**
+    @brief Set a single pixel. Pixels outside the display are ignored.
+    @param x Column
+    @param y Row
+    @param color Pixel color
+    */
+    static void setPixel(const uint8_t x, const uint8_t y, const GLCDColor color = GLCDColor::white)
+    {
+        if (x < getWidth() && y < getHeight())
+        {
+            write(y >> 3, x, 1 << (y & 0b111), color);
+        }
+    }
+    
+    /**
+    @brief Read a single pixel
+    @param x Column
+    @param y Row
+    @result true if the pixel is white, false if it is black or outside the display
+    */
+    static bool getPixel(const uint8_t x, const uint8_t y)
+    {
+        if (x < getWidth() && y < getHeight())
+        {
+            return s_buffer[(y >> 3) * getWidth() + x] & (1 << (y & 0b111));
+        }
+        return false;
+    }
+    
+    /**
+    @brief Draw a line using Bresenham's algorithm. Pixels outside the display are clipped.
+    @param x0, y0 Start point
+    @param x1, y1 End point
+    @param color Pixel color
+    */
+    static void drawLine(const uint8_t x0, const uint8_t y0, const uint8_t x1, const uint8_t y1, const GLCDColor color = GLCDColor::white)
+    {
+        // Horizontal and vertical lines are drawn bytewise
+        if (y0 == y1)
+        {
+            const uint8_t x = x0 < x1 ? x0 : x1;
+            fillRect(x, y0, (x0 < x1 ? x1 - x0 : x0 - x1) + 1, 1, color);
+            return;
+        }
+        if (x0 == x1)
+        {
+            const uint8_t y = y0 < y1 ? y0 : y1;
+            fillRect(x0, y, 1, (y0 < y1 ? y1 - y0 : y0 - y1) + 1, color);
+            return;
+        }
+        
+        const int16_t dx = x0 < x1 ? x1 - x0 : x0 - x1;
+        const int16_t dy = y0 < y1 ? y0 - y1 : y1 - y0;
+        const int8_t stepX = x0 < x1 ? 1 : -1;
+        const int8_t stepY = y0 < y1 ? 1 : -1;
+        int16_t error = dx + dy;
+        uint8_t x = x0;
+        uint8_t y = y0;
+        while (true)
+        {
+            setPixel(x, y, color);
+            if (x == x1 && y == y1)
+            {
+                break;
+            }
+            const int16_t error2 = 2 * error;
+            if (error2 >= dy)
+            {
+                error += dy;
+                x += stepX;
+            }
+            if (error2 <= dx)
+            {
+                error += dx;
+                y += stepY;
+            }
+        }
+    }
+    
+    /**
+    @brief Draw the outline of a rectangle. Pixels outside the display are clipped.
+    @param x, y Top left corner
+    @param width, height Size of the rectangle
+    @param color Pixel color
+    */
+    static void drawRect(const uint8_t x, const uint8_t y, const uint8_t width, const uint8_t height, const GLCDColor color = GLCDColor::white)
+    {
+        if (0 == width || 0 == height)
+        {
+            return;
+        }
+        
+        fillRect(x, y, width, 1, color);
+        if (height > 1)
+        {
+            fillRect(x, y + height - 1, width, 1, color);
+        }
+        if (height > 2)
+        {
+            fillRect(x, y + 1, 1, height - 2, color);
+            if (width > 1)
+            {
+                fillRect(x + width - 1, y + 1, 1, height - 2, color);
+            }
+        }
+    }
+    
+    /**
+    @brief Fill a rectangle. Pixels outside the display are clipped.
+    The rectangle is filled bytewise, i.e. with one read-modify-write per column and page.
+    @param x, y Top left corner
+    @param width, height Size of the rectangle
+    @param color Pixel color
+    */
+    static void fillRect(const uint8_t x, const uint8_t y, uint8_t width, uint8_t height, const GLCDColor color = GLCDColor::white)
+    {
+        if (x >= getWidth() || y >= getHeight())
+        {
+            return;
+        }
+        width = clip(x, width, getWidth());
+        height = clip(y, height, getHeight());
+        if (0 == width || 0 == height)
+        {
+            return;
+        }
+        
+        const uint8_t yEnd = y + height;
+        const uint8_t lastPage = (yEnd - 1) >> 3;
+        for (uint8_t pageIdx = y >> 3; pageIdx <= lastPage; ++pageIdx)
+        {
+            // Mask of the rows covered in this page
+            uint8_t mask = 0xFF;
+            if (pageIdx == (y >> 3))
+            {
+                mask &= 0xFF << (y & 0b111);
+            }
+            if (pageIdx == lastPage)
+            {
+                mask &= 0xFF >> (7 - ((yEnd - 1) & 0b111));
+            }
+            
+            for (uint8_t column = x; column < x + width; ++column)
+            {
+                write(pageIdx, column, mask, color);
+            }
+        }
+    }
+    
+    /**
+    @brief Draw a bitmap stored in program memory. Pixels outside the display are clipped.
+    The bitmap uses the memory layout of the frame buffer: ceil(height / 8) pages of width bytes each, one byte per column with the top pixel in the least significant bit.
+    The height of the bitmap is derived from its size. The bitmap is opaque, i.e. black pixels are drawn as well.
+    @param x, y Top left corner
+    @param width Width of the bitmap
+    @param bitmap Bitmap data, e.g. a PgmArray<uint8_t>
+    */
+    static void drawBitmapP(const uint8_t x, const uint8_t y, const uint8_t width, const PgmSpan<uint8_t> bitmap)
+    {
+        drawColumnsP(x, y, width, bitmap.size() / width, bitmap.data());
+    }
+    
+    /**
+    @brief Draw a character using the given font. Characters not contained in the font are skipped.
+    @param x, y Top left corner
+    @param c Character
+    @param font Font
+    @result Column following the character including one column of spacing, at most getWidth()
+    */
+    static uint8_t drawChar(const uint8_t x, const uint8_t y, const char c, const GLCDFont& font)
+    {
+        if (x >= getWidth())
+        {
+            return getWidth();
+        }
+        const uint16_t spacing = x + font.width;
+        const uint8_t glyphIdx = static_cast<uint8_t>(c) - static_cast<uint8_t>(font.first);
+        if (glyphIdx < font.size())
+        {
+            drawColumnsP(x, y, font.width, 1, font.glyphs.data() + glyphIdx * font.width);
+            
+            // Character spacing
+            if (spacing < getWidth())
+            {
+                fillRect(spacing, y, 1, 8, GLCDColor::black);
+            }
+        }
+        return spacing < getWidth() ? spacing + 1 : getWidth();
+    }
+    
+    /**
+    @brief Draw a string using the given font
+    @param x, y Top left corner
+    @param str String, e.g. a String or a Span of characters
+    @param font Font
+    @result Column following the last character, at most getWidth()
+    */
+    template <typename StringType>
+    static uint8_t drawString(uint8_t x, const uint8_t y, const StringType& str, const GLCDFont& font)
+    {
+        for (const char c : str)
+        {
+            if (x >= getWidth())
+            {
+                break;
+            }
+            x = drawChar(x, y, c, font);
+        }
+        return x;
+    }
+    
+    /**
+    @brief Draw a null-terminated string using the given font
+    @param x, y Top left corner
+    @param str Null-terminated string
+    @param font Font
+    @result Column following the last character, at most getWidth()
+    */
+    static uint8_t drawString(uint8_t x, const uint8_t y, const char * str, const GLCDFont& font)
+    {
+        while (*str && x < getWidth())
+        {
+            x = drawChar(x, y, *str++, font);
+        }
+        return x;
+    }
+    
+    /**
+    @brief Direct read-only access to the frame buffer
+    @result Frame buffer in the memory layout of the display
+    */
+    static constexpr const auto& data()
+    {
+        return s_buffer;
+    }
+    
+    private:
+    
+    static constexpr uint8_t s_tileWidth = 8;
+    static constexpr uint8_t s_nofPages = GLCD::getHeight() / 8;
+    static constexpr uint8_t s_nofTileColumns = GLCD::getWidth() / s_tileWidth;
+    static constexpr uint16_t s_nofTiles = s_nofPages * s_nofTileColumns;
+    
+    static_assert(0 == GLCD::getHeight() % 8 && 0 == GLCD::getWidth() % s_tileWidth, "Display size must be a multiple of the tile size");
+    static_assert(s_nofTiles < 256, "Number of tiles must not exceed 255");
+    
+    // Remaining size of a range starting at pos, clipped to limit
+    static constexpr uint8_t clip(const uint8_t pos, const uint8_t size, const uint8_t limit)
+    {
+        return size < limit - pos ? size : limit - pos;
+    }
+    
+    // Modify the masked pixels of a single byte and mark its tile as dirty if the content changed
+    static void write(const uint8_t pageIdx, const uint8_t column, const uint8_t mask, const GLCDColor color)
+    {
+        uint8_t& data = s_buffer[pageIdx * getWidth() + column];
+        uint8_t newData;
+        switch (color)
+        {
+            case GLCDColor::black:
+            newData = data & ~mask;
+            break;
+            
+            case GLCDColor::white:
+            newData = data | mask;
+            break;
+            
+            default:
+            newData = data ^ mask;
+            break;
+        }
+        
+        if (newData != data)
+        {
+            data = newData;
+            s_dirty.set(pageIdx * s_nofTileColumns + column / s_tileWidth);
+        }
+    }
+    
+    // Replace the masked pixels of a single byte
+    static void replace(const uint8_t pageIdx, const uint8_t column, const uint8_t mask, const uint8_t bits)
+    {
+        write(pageIdx, column, mask & ~bits, GLCDColor::black);
+        write(pageIdx, column, mask & bits, GLCDColor::white);
+    }
+    
+    // Draw columns of page-organized data from program memory at an arbitrary row
+    static void drawColumnsP(const uint8_t x, const uint8_t y, const uint8_t width, const uint8_t nofPages, const uint8_t * data)
+    {
+        if (x >= getWidth() || y >= getHeight())
+        {
+            return;
+        }
+        
+        const uint8_t nofColumns = clip(x, width, getWidth());
+        const uint8_t shift = y & 0b111;
+        for (uint8_t srcPage = 0; srcPage < nofPages; ++srcPage)
+        {
+            const uint8_t dstPage = (y >> 3) + srcPage;
+            if (dstPage >= s_nofPages)
+            {
+                break;
+            }
+            
+            const uint8_t * src = data + srcPage * width;
+            for (uint8_t column = 0; column < nofColumns; ++column)
+            {
+                const uint8_t bits = pgm_read_byte(src + column);
+                
+                // Unaligned rows straddle two pages
+                replace(dstPage, x + column, 0xFF << shift, bits << shift);
+                if (0 != shift && dstPage + 1 < s_nofPages)
+                {
+                    replace(dstPage + 1, x + column, 0xFF >> (8 - shift), bits >> (8 - shift));
+                }
+            }
+        }
+    }
+    
+    static Array<uint8_t, s_nofPages * GLCD::getWidth()> s_buffer;
+    
+    static BoolArray<s_nofTiles> s_dirty;
+};
+
+// Static initialization
+template <typename GLCD>
+Array<uint8_t, GLCDBuffered<GLCD>::s_nofPages * GLCD::getWidth()> GLCDBuffered<GLCD>::s_buffer = {};
+
+template <typename GLCD>
+BoolArray<GLCDBuffered<GLCD>::s_nofTiles> GLCDBuffered<GLCD>::s_dirty(true);
+
+#endif
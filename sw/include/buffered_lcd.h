@@ -19,11 +19,15 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #define LCD_BUFFERED_H
 
 #include <stdint.h>
-#include <static_deque.h>
-#include <static_string.h>
+#include <stdbool.h>
+#include <array.h>
+#include <lcd_glyph_cache.h>
 
 /**
 @brief Driver for buffered operation of an alphanumeric LCD.
+The frame buffer is divided into regions of consecutive rows, e.g. a static header and a scrolling log. Each region has its own cursor and scrolls independently.
+Rows are stored in a fixed row memory, and a row table maps display rows to memory rows. Scrolling a region rotates its part of the row table and blanks a single row,
+i.e. no row content is moved. Each display row tracks the range of columns changed since the last refresh, and refresh() transfers only these columns.
 @tparam LCDAlphanumeric Underlying alphanumeric LCD device driver.
 This driver class needs to implement the following static methods:
 void init()
@@ -31,12 +35,20 @@ uint8_t getNofColumns()
 uint8_t getNofRows()
 void setCursor(const uint8_t rowIdx, const uint8_t columnIdx)
 void putc(const char character)
+Custom characters via GlyphCache additionally require:
+void setCustomCharacter(const uint8_t slot, const LCDGlyph& glyph)
 */
 template <typename LCDAlphanumeric>
 class LCDAlphanumericBuffered
 {
     public:
     
+    /// @brief Cache of custom characters shown on this LCD, see LCDGlyphCache
+    using GlyphCache = LCDGlyphCache<LCDAlphanumeric>;
+    
+    /// @brief Bar graph renderer, see LCDBarGraph
+    using BarGraph = LCDBarGraph<GlyphCache>;
+    
     /**
     @brief Get number of columns of alphanumeric LCD from underlying alphanumeric LCD device
     @result Number of columns of alphanumeric LCD
@@ -61,6 +73,7 @@ class LCDAlphanumericBuffered
     static void init()
     {
         LCDAlphanumeric::init();
+        invalidate();
         clear();
     }
 
@@ -72,71 +85,91 @@ class LCDAlphanumericBuffered
         s_frameBuffer.clear();
         refresh();       
     }
+    
+    /**
+    @brief Mark the whole LCD as changed, e.g. if the display content was lost
+    */
+    static void invalidate()
+    {
+        for (uint8_t rowIdx = 0; rowIdx < getNofRows(); ++rowIdx)
+        {
+            markChanged(rowIdx, 0, getNofColumns());
+        }
+    }
 
     /**
-    @brief Refresh the LCD, i.e. transfer the frame buffer to the LCD
+    @brief Refresh the LCD, i.e. transfer the changed columns of the frame buffer to the LCD
     */
     static void refresh()
     {
-        if (s_refresh)
+        for (uint8_t rowIdx = 0; rowIdx < getNofRows(); ++rowIdx)
         {
-            // Iterate through all rows of the frame buffer
-            uint8_t rowCnt = 0;
-            for (auto & row : s_frameBuffer.m_buffer)
-            {
-                // Set Cursor to first column
-                LCDAlphanumeric::setCursor(rowCnt++, 0);
-                for (auto & c : row)
-                {
-                    LCDAlphanumeric::putc(c);
-                }
-            }
-            
-            // Add blank lines
-            while (rowCnt < getNofRows())
+            const uint8_t begin = s_changedBegin[rowIdx];
+            const uint8_t end = s_changedEnd[rowIdx];
+            if (begin < end)
             {
-                LCDAlphanumeric::setCursor(rowCnt++, 0);
-                for (uint8_t colCnt = 0; colCnt < getNofColumns(); ++colCnt)
+                const auto& row = s_rows[s_rowTable[rowIdx]];
+                LCDAlphanumeric::setCursor(rowIdx, begin);
+                for (uint8_t columnIdx = begin; columnIdx < end; ++columnIdx)
                 {
-                    LCDAlphanumeric::putc(' ');
+                    LCDAlphanumeric::putc(row[columnIdx]);
                 }
+                s_changedBegin[rowIdx] = getNofColumns();
+                s_changedEnd[rowIdx] = 0;
             }
         }
     }
     
     /**
-    @brief LCD frame buffer
+    @brief Region of consecutive rows of the LCD with its own cursor
+    Writing a new line at the bottom of the region scrolls the region up by one row.
+    Regions must not overlap. The row memory is shared, so regions are light-weight objects (4 bytes) that can be created where needed.
     This class meets the requirements of a string implementation to be used with StringStream
     */
-    class FrameBuffer
+    class Region
     {
         public:
         
         /**
         @brief Constructor
+        @param firstRow First display row of the region
+        @param nofRows Number of rows of the region
         */
-        constexpr FrameBuffer()
-        {
-            clear();
-        }
+        constexpr Region(const uint8_t firstRow = 0, const uint8_t nofRows = getNofRows()) : m_firstRow(firstRow), m_nofRows(nofRows)
+        {}
         
         /**
-        @brief Clear the frame buffer
+        @brief Clear the region
+        Like after a line feed, the next character is written to a new line, i.e. the first row of the region.
         */
-        constexpr void clear()
+        void clear()
         {
-            // Clear underlying memory
-            m_buffer.clear();
+            for (uint8_t rowIdx = m_firstRow; rowIdx < m_firstRow + m_nofRows; ++rowIdx)
+            {
+                clearRow(rowIdx);
+            }
             
             // Set the cursor to end of the line to make sure a new line is inserted before the next character
+            m_rowIdx = s_beforeFirstRow;
             m_cursor = getNofColumns();
         }
-
+        
+        /**
+        @brief Set the cursor, e.g. to update part of a row
+        @param rowIdx Row within the region, a row beyond the region selects the last row of the region
+        @param columnIdx Column
+        */
+        void setCursor(const uint8_t rowIdx, const uint8_t columnIdx)
+        {
+            m_rowIdx = rowIdx < m_nofRows ? rowIdx : m_nofRows - 1;
+            m_cursor = columnIdx;
+        }
+        
         /**
         @brief Put character to LCD
         @param character Character to displayed on LCD
         */
-        constexpr void pushBack(const char c)
+        void pushBack(const char c)
         {
             if (c == '\n')
             {
@@ -148,30 +181,65 @@ class LCDAlphanumericBuffered
                 {
                     newLine();
                 }
-                m_buffer.back()[m_cursor++] = c;
+                if (m_rowIdx < m_nofRows)
+                {
+                    putc(m_firstRow + m_rowIdx, m_cursor, c);
+                }
+                ++m_cursor;
             }
-            s_refresh = true;
         }
-
-        private:
         
-        friend class LCDAlphanumericBuffered<LCDAlphanumeric>;
+        private:
         
-        uint8_t m_cursor = 0;
+        static constexpr uint8_t s_beforeFirstRow = 0xFF;
         
-        constexpr void newLine()
+        void newLine()
         {
-            if (m_buffer.size() >= getNofRows())
+            if (s_beforeFirstRow == m_rowIdx || m_rowIdx + 1 < m_nofRows)
+            {
+                ++m_rowIdx;
+            }
+            else
             {
-                m_buffer.popFront();
+                scroll();
+                m_rowIdx = m_nofRows - 1;
             }
-            m_buffer.emplaceBack(getNofColumns(), ' ');
+            clearRow(m_firstRow + m_rowIdx);
             m_cursor = 0;
         }
         
-        StaticDeque<StaticString<getNofColumns()>, getNofRows()> m_buffer;
+        // Scroll the region up by one row by rotating the row table
+        void scroll()
+        {
+            const uint8_t lastRow = m_firstRow + m_nofRows - 1;
+            const uint8_t firstRowMemory = s_rowTable[m_firstRow];
+            for (uint8_t rowIdx = m_firstRow; rowIdx < lastRow; ++rowIdx)
+            {
+                s_rowTable[rowIdx] = s_rowTable[rowIdx + 1];
+            }
+            s_rowTable[lastRow] = firstRowMemory;
+            
+            // All rows of the region show different content now
+            for (uint8_t rowIdx = m_firstRow; rowIdx < lastRow; ++rowIdx)
+            {
+                markChanged(rowIdx, 0, getNofColumns());
+            }
+            
+            // The row which moved from the top to the bottom is blanked by the caller
+            markChanged(lastRow, 0, getNofColumns());
+        }
+        
+        uint8_t m_firstRow;
+        uint8_t m_nofRows;
+        uint8_t m_rowIdx = s_beforeFirstRow;
+        uint8_t m_cursor = getNofColumns();
     };
     
+    /**
+    @brief LCD frame buffer, i.e. a region covering the whole LCD
+    */
+    using FrameBuffer = Region;
+    
     static constexpr FrameBuffer& getBuffer()
     {
         return s_frameBuffer;
@@ -179,9 +247,84 @@ class LCDAlphanumericBuffered
     
     private:
     
+    using Row        = Array<char, getNofColumns()>;
+    using Rows       = Array<Row, getNofRows()>;
+    using RowIndices = Array<uint8_t, getNofRows()>;
+    
+    // Write character to display row and track the changed columns
+    static void putc(const uint8_t rowIdx, const uint8_t columnIdx, const char c)
+    {
+        if (rowIdx >= getNofRows() || columnIdx >= getNofColumns())
+        {
+            return;
+        }
+        
+        char& data = s_rows[s_rowTable[rowIdx]][columnIdx];
+        if (data != c)
+        {
+            data = c;
+            markChanged(rowIdx, columnIdx, columnIdx + 1);
+        }
+    }
+    
+    static void clearRow(const uint8_t rowIdx)
+    {
+        for (uint8_t columnIdx = 0; columnIdx < getNofColumns(); ++columnIdx)
+        {
+            putc(rowIdx, columnIdx, ' ');
+        }
+    }
+    
+    static void markChanged(const uint8_t rowIdx, const uint8_t begin, const uint8_t end)
+    {
+        if (begin < s_changedBegin[rowIdx])
+        {
+            s_changedBegin[rowIdx] = begin;
+        }
+        if (end > s_changedEnd[rowIdx])
+        {
+            s_changedEnd[rowIdx] = end;
+        }
+    }
+    
+    static constexpr Rows makeRows()
+    {
+        Rows rows = {};
+        for (Row& row : rows)
+        {
+            row.fill(' ');
+        }
+        return rows;
+    }
+    
+    static constexpr RowIndices makeFilled(const uint8_t value)
+    {
+        RowIndices array = {};
+        array.fill(value);
+        return array;
+    }
+    
+    static constexpr RowIndices makeRowTable()
+    {
+        RowIndices rowTable = {};
+        for (uint8_t rowIdx = 0; rowIdx < getNofRows(); ++rowIdx)
+        {
+            rowTable[rowIdx] = rowIdx;
+        }
+        return rowTable;
+    }
+    
     static FrameBuffer s_frameBuffer;
     
-    static bool s_refresh;
+    // Row memory
+    static Rows s_rows;
+    
+    // Display row to memory row mapping
+    static RowIndices s_rowTable;
+    
+    // Range of changed columns per display row
+    static RowIndices s_changedBegin;
+    static RowIndices s_changedEnd;
 };
 
 // Static initialization
@@ -189,6 +332,15 @@ template <typename LCDAlphanumeric>
 typename LCDAlphanumericBuffered<LCDAlphanumeric>::FrameBuffer LCDAlphanumericBuffered<LCDAlphanumeric>::s_frameBuffer;
 
 template <typename LCDAlphanumeric>
-bool LCDAlphanumericBuffered<LCDAlphanumeric>::s_refresh = true;
+typename LCDAlphanumericBuffered<LCDAlphanumeric>::Rows LCDAlphanumericBuffered<LCDAlphanumeric>::s_rows = LCDAlphanumericBuffered<LCDAlphanumeric>::makeRows();
+
+template <typename LCDAlphanumeric>
+typename LCDAlphanumericBuffered<LCDAlphanumeric>::RowIndices LCDAlphanumericBuffered<LCDAlphanumeric>::s_rowTable = LCDAlphanumericBuffered<LCDAlphanumeric>::makeRowTable();
+
+template <typename LCDAlphanumeric>
+typename LCDAlphanumericBuffered<LCDAlphanumeric>::RowIndices LCDAlphanumericBuffered<LCDAlphanumeric>::s_changedBegin = LCDAlphanumericBuffered<LCDAlphanumeric>::makeFilled(LCDAlphanumeric::getNofColumns());
+
+template <typename LCDAlphanumeric>
+typename LCDAlphanumericBuffered<LCDAlphanumeric>::RowIndices LCDAlphanumericBuffered<LCDAlphanumeric>::s_changedEnd = {};
 
 #endif
@@ -22,6 +22,7 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include <stdbool.h>
 #include <static_deque.h>
 #include <queue.h>
+#include <span.h>
 
 /**
 @brief Driver class for tx-buffered USART using a static Decorator approach
@@ -74,11 +75,60 @@ class BufferedUSART : _USART
         return txOK;
     }
 
+    /**
+    @brief Transmit multiple Bytes (non-blocking, Tx errors must be handled in the caller's scope)
+    Bytes are enqueued until the Tx buffer is full.
+    @param data Span of data bytes to be transmitted
+    @result Number of data bytes enqueued for transmission
+    */
+    static size_t put(const ConstSpan<uint8_t> data)
+    {
+        return enqueue(data.begin(), data.end());
+    }
+
+    /**
+    @brief Transmit multiple Bytes stored in program memory (non-blocking, Tx errors must be handled in the caller's scope)
+    Bytes are enqueued until the Tx buffer is full.
+    @param data Span of data bytes in program memory to be transmitted
+    @result Number of data bytes enqueued for transmission
+    */
+    static size_t put(const PgmSpan<uint8_t> data)
+    {
+        return enqueue(data.begin(), data.end());
+    }
+
+    /**
+    @brief Get the number of bytes which can be enqueued without blocking, e.g. to enqueue a message as a whole
+    @result Number of free bytes in the Tx buffer
+    */
+    static size_t getNofFreeBytes()
+    {
+        return t_txBufferSize - s_txBuffer.size();
+    }
+
     // Expose base class methods
     using USART::get;
 
     private:
     
+    // Enqueue bytes in range [first, last) until the Tx buffer is full
+    template <typename Iter>
+    static size_t enqueue(Iter first, const Iter last)
+    {
+        size_t nofBytes = 0;
+        while (first != last && s_txBuffer.size() < t_txBufferSize)
+        {
+            s_txBuffer.push(*first);
+            ++first;
+            ++nofBytes;
+        }
+
+        // Start USART transmission
+        USART::startTransmission();
+
+        return nofBytes;
+    }
+
     // Tx buffer
     static Queue<uint8_t, StaticDeque<uint8_t, t_txBufferSize>> s_txBuffer;
 };
@@ -0,0 +1,324 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef COMMAND_TABLE_H
+#define COMMAND_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <avr/pgmspace.h>
+#include <exception.h>
+#include <memcopy.h>
+#include <pgm_string.h>
+#include <span.h>
+
+/**
+@brief Command table entry as passed to makeCommandTable()
+@tparam Handler Handler type, e.g. a function pointer
+*/
+template <typename Handler>
+struct Command
+{
+    PgmString name;
+    Handler handler;
+};
+
+/**
+@brief Compile-time table mapping command names to handlers
+The table is sorted by command name at compile time, so instances declared constexpr and PROGMEM do not use any RAM:
+@code
+constexpr auto commands PROGMEM = makeCommandTable(
+    Command{"start"_pgm, &onStart},
+    Command{"stop"_pgm, &onStop});
+@endcode
+Incoming tokens are matched character by character. Each character narrows down the range of candidate commands by binary search,
+so matching costs O(length * log(number of commands)) reads from program memory and no RAM copies of either the token or the command names.
+Characters can be fed one at a time using a Matcher, e.g. directly from a receive interrupt, or a complete token can be matched using matchP().
+@note All methods with suffix P read from program memory and must only be called for instances stored in PROGMEM.
+@note Handlers are stored in the table, so Handler must be a literal type like a function pointer. Since function<> objects cannot be
+constructed at compile time, use the command index returned by matchP() to look up a function<> in RAM instead.
+@tparam Handler Handler type
+@tparam t_size Number of commands
+*/
+template <typename Handler, size_t t_size>
+class CommandTable
+{
+    static_assert(t_size > 0 && t_size < 0xFF, "Number of commands must be in range 1..254");
+
+    public:
+
+    /// @brief Index returned if a token does not match any command
+    static constexpr uint8_t s_noMatch = 0xFF;
+
+    /// @brief Table entry stored in program memory
+    struct Entry
+    {
+        const char* name;
+        uint8_t size;
+        uint8_t index;
+        Handler handler;
+    };
+
+    /**
+    @brief Incremental matcher consuming a token character by character
+    A matcher uses 5 bytes of RAM (on AVR) and does not need to buffer the token.
+    */
+    class Matcher
+    {
+        public:
+
+        /**
+        @brief Constructor
+        @param table Command table stored in PROGMEM
+        */
+        constexpr explicit Matcher(const CommandTable& table) : m_table(&table)
+        {}
+
+        /**
+        @brief Restart matching for a new token
+        */
+        constexpr void reset()
+        {
+            m_first = 0;
+            m_last = t_size;
+            m_pos = 0;
+        }
+
+        /**
+        @brief Consume the next character of the token
+        @param c Next character
+        @result true if there is at least one command starting with the characters consumed so far
+        */
+        bool feed(const char c)
+        {
+            if (m_first == m_last || 0xFF == m_pos)
+            {
+                return false;
+            }
+
+            // All candidates share the prefix consumed so far, so the candidates with character c at m_pos form a contiguous range
+            m_first = m_table->lowerBoundP(m_first, m_last, m_pos, static_cast<uint8_t>(c));
+            m_last = m_table->lowerBoundP(m_first, m_last, m_pos, static_cast<uint8_t>(c) + 1);
+            ++m_pos;
+
+            return m_first != m_last;
+        }
+
+        /**
+        @brief Check if the characters consumed so far match a command exactly
+        @result true if a command matches
+        */
+        bool matched() const
+        {
+            // Among all candidates, an exact match is the shortest command and is sorted first
+            return m_first != m_last && m_table->sizeP(m_first) == m_pos;
+        }
+
+        /**
+        @brief Get the index of the matched command
+        @result Index of the matched command in the argument list of makeCommandTable(), or s_noMatch
+        */
+        uint8_t index() const
+        {
+            return matched() ? m_table->indexP(m_first) : s_noMatch;
+        }
+
+        /**
+        @brief Get the handler of the matched command. Calling this method if no command matches is undefined.
+        @result Handler of the matched command
+        */
+        Handler handler() const
+        {
+            return m_table->handlerP(m_first);
+        }
+
+        private:
+
+        const CommandTable* m_table;
+        uint8_t m_first = 0;
+        uint8_t m_last = t_size;
+        uint8_t m_pos = 0;
+    };
+
+    /**
+    @brief Constructor. Sorts the given commands by name.
+    Duplicate command names result in a compile error
+    @param commands Commands
+    */
+    consteval CommandTable(const Command<Handler> (&commands)[t_size])
+    {
+        for (size_t idx = 0; idx < t_size; ++idx)
+        {
+            const Entry entry = {commands[idx].name.data(), commands[idx].name.size(), static_cast<uint8_t>(idx), commands[idx].handler};
+
+            // Insertion sort
+            size_t pos = idx;
+            while (pos > 0 && compare(entry, m_entries[pos - 1]) <= 0)
+            {
+                if (0 == compare(entry, m_entries[pos - 1]))
+                {
+                    // Duplicate command name: Calling a non-constexpr function makes the constant evaluation fail
+                    throw_length_error();
+                }
+                m_entries[pos] = m_entries[pos - 1];
+                --pos;
+            }
+            m_entries[pos] = entry;
+        }
+    }
+
+    /**
+    @brief Returns the number of commands
+    @result Number of commands
+    */
+    static constexpr size_t size()
+    {
+        return t_size;
+    }
+
+    /**
+    @brief Match a token
+    @param token Token to match
+    @result Index of the matched command in the argument list of makeCommandTable(), or s_noMatch
+    */
+    uint8_t matchP(const ConstSpan<char> token) const
+    {
+        Matcher matcher(*this);
+        for (const char c : token)
+        {
+            if (!matcher.feed(c))
+            {
+                return s_noMatch;
+            }
+        }
+        return matcher.index();
+    }
+
+    /**
+    @brief Parse a command line and call the handler of the matched command
+    The command line consists of the command name followed by optional arguments, separated by spaces.
+    The handler is called with the argument string (excluding the separating spaces) as the only argument.
+    @param line Command line
+    @result true if a command matched, false otherwise
+    */
+    bool dispatchP(const ConstSpan<char> line) const
+    {
+        Matcher matcher(*this);
+        auto it = line.begin();
+
+        // Match command name
+        for (; it != line.end() && ' ' != *it; ++it)
+        {
+            if (!matcher.feed(*it))
+            {
+                return false;
+            }
+        }
+
+        if (!matcher.matched())
+        {
+            return false;
+        }
+
+        // Skip separators
+        while (it != line.end() && ' ' == *it)
+        {
+            ++it;
+        }
+
+        matcher.handler()(ConstSpan<char>(it, line.end()));
+        return true;
+    }
+
+    private:
+
+    // Constant-evaluated three-way comparison of command names
+    static consteval int compare(const Entry& lhs, const Entry& rhs)
+    {
+        for (uint8_t pos = 0; pos < lhs.size && pos < rhs.size; ++pos)
+        {
+            if (lhs.name[pos] != rhs.name[pos])
+            {
+                return static_cast<uint8_t>(lhs.name[pos]) < static_cast<uint8_t>(rhs.name[pos]) ? -1 : 1;
+            }
+        }
+        return static_cast<int>(lhs.size) - static_cast<int>(rhs.size);
+    }
+
+    // Sort key of entry idx at position pos. Names ending before pos sort first.
+    uint16_t keyP(const uint8_t idx, const uint8_t pos) const
+    {
+        if (sizeP(idx) <= pos)
+        {
+            return 0;
+        }
+        return static_cast<uint16_t>(pgm_read_byte(memread_P(&m_entries[idx].name) + pos)) + 1;
+    }
+
+    // Find the first entry in range [first, last) whose character at pos is not less than c
+    uint8_t lowerBoundP(uint8_t first, uint8_t last, const uint8_t pos, const uint16_t c) const
+    {
+        while (first < last)
+        {
+            const uint8_t mid = first + ((last - first) >> 1);
+            if (keyP(mid, pos) < c + 1)
+            {
+                first = mid + 1;
+            }
+            else
+            {
+                last = mid;
+            }
+        }
+        return first;
+    }
+
+    uint8_t sizeP(const uint8_t idx) const
+    {
+        return memread_P(&m_entries[idx].size);
+    }
+
+    uint8_t indexP(const uint8_t idx) const
+    {
+        return memread_P(&m_entries[idx].index);
+    }
+
+    Handler handlerP(const uint8_t idx) const
+    {
+        return memread_P(&m_entries[idx].handler);
+    }
+
+    // Entries sorted by name
+    Entry m_entries[t_size] = {};
+};
+
+/**
+@brief Create a command table sorted by command name at compile time
+@tparam Handler Handler type, deduced from the first command
+@param first First command
+@param commands Further commands
+@result Command table
+*/
+template <typename Handler, typename ... Commands>
+consteval CommandTable<Handler, 1 + sizeof...(Commands)> makeCommandTable(const Command<Handler>& first, const Commands& ... commands)
+{
+    const Command<Handler> list[] = {first, commands...};
+    return CommandTable<Handler, 1 + sizeof...(Commands)>(list);
+}
+
+#endif
@@ -0,0 +1,318 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CRC_H
+#define CRC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#include <array.h>
+#include <memcopy.h>
+#include <span.h>
+
+/**
+@brief Implementations of the CRC update, trading flash size for speed
+*/
+enum class CRCImplementation : uint8_t
+{
+    /// Shift register, one iteration per bit. No table, smallest code.
+    bitwise,
+    
+    /// Lookup table of 16 entries in program memory, two lookups per byte
+    nibble,
+    
+    /// Lookup table of 256 entries in program memory, one lookup per byte
+    table
+};
+
+/**
+@brief Cyclic redundancy check with selectable implementation
+Lookup tables are computed at compile time and stored in program memory, so no implementation uses any RAM besides the CRC register.
+All implementations of the same CRC yield the same results, so sender and receiver can use different implementations.
+A CRC is computed incrementally by passing the value returned by init() through any number of calls to update(), followed by finalize():
+@code
+uint16_t crc = CRC16::init();
+crc = CRC16::update(crc, header);
+crc = CRC16::update(crc, payload);
+crc = CRC16::finalize(crc);
+@endcode
+@tparam T Unsigned integral type of the CRC register, determines the width of the CRC
+@tparam t_poly Generator polynomial in normal (MSB first) representation
+@tparam t_init Initial register value
+@tparam t_xorOut Value XORed to the register to obtain the final CRC
+@tparam t_reflected Process data least significant bit first, e.g. for CRC-32
+@tparam t_impl Implementation, default is a lookup table of 256 entries
+*/
+template <typename T, T t_poly, T t_init, T t_xorOut = 0, bool t_reflected = false, CRCImplementation t_impl = CRCImplementation::table>
+class CRC
+{
+    public:
+    
+    using value_type = T;
+    
+    /// @brief Width of the CRC in bytes
+    static constexpr uint8_t s_size = sizeof(T);
+    
+    /**
+    @brief Get the initial register value
+    @result Initial register value
+    */
+    static constexpr T init()
+    {
+        return t_init;
+    }
+    
+    /**
+    @brief Update the CRC register with one byte
+    @param crc Current register value
+    @param data Data byte
+    @result New register value
+    */
+    static T update(const T crc, const uint8_t data)
+    {
+        if CXX17_CONSTEXPR(CRCImplementation::table == t_impl)
+        {
+            return updateTable(crc, data);
+        }
+        else if CXX17_CONSTEXPR(CRCImplementation::nibble == t_impl)
+        {
+            return updateNibble(updateNibble(crc, t_reflected ? data : data >> 4), t_reflected ? data >> 4 : data);
+        }
+        else
+        {
+            return updateBitwise(crc, data);
+        }
+    }
+    
+    /**
+    @brief Update the CRC register with a sequence of bytes
+    @param crc Current register value
+    @param data Data bytes
+    @result New register value
+    */
+    static T update(T crc, const ConstSpan<uint8_t> data)
+    {
+        for (const uint8_t byte : data)
+        {
+            crc = update(crc, byte);
+        }
+        return crc;
+    }
+    
+    /**
+    @brief Update the CRC register with a sequence of bytes stored in program memory
+    @param crc Current register value
+    @param data Data bytes in program memory
+    @result New register value
+    */
+    static T update(T crc, const PgmSpan<uint8_t> data)
+    {
+        for (const uint8_t byte : data)
+        {
+            crc = update(crc, byte);
+        }
+        return crc;
+    }
+    
+    /**
+    @brief Get the CRC from the register value after the last update
+    @param crc Register value
+    @result CRC
+    */
+    static constexpr T finalize(const T crc)
+    {
+        return crc ^ t_xorOut;
+    }
+    
+    /**
+    @brief Compute the CRC of a sequence of bytes in one go
+    @param data Data bytes
+    @result CRC
+    */
+    static T compute(const ConstSpan<uint8_t> data)
+    {
+        return finalize(update(init(), data));
+    }
+    
+    /**
+    @brief Compute the CRC of a sequence of bytes stored in program memory in one go
+    @param data Data bytes in program memory
+    @result CRC
+    */
+    static T compute(const PgmSpan<uint8_t> data)
+    {
+        return finalize(update(init(), data));
+    }
+    
+    /**
+    @brief Get a byte of the CRC in the order it is appended to a message, i.e. most significant byte first, or least significant byte first
+    if t_reflected is set
+    @param crc CRC as returned by finalize()
+    @param idx Index of the byte in range 0..s_size-1
+    @result CRC byte
+    */
+    static constexpr uint8_t getByte(const T crc, const uint8_t idx)
+    {
+        return static_cast<uint8_t>(crc >> (t_reflected ? 8 * idx : s_shift - 8 * idx));
+    }
+    
+    /**
+    @brief Get the register value after updating with a message followed by its CRC as returned by getByte()
+    The residue does not depend on the message, so a receiver can check a message including its CRC without knowing where the message ends.
+    @result Residue
+    */
+    static constexpr T getResidue()
+    {
+        return s_residue;
+    }
+    
+    private:
+    
+    static constexpr uint8_t s_shift = 8 * (s_size - 1);
+    
+    static constexpr T s_msb = static_cast<T>(static_cast<T>(1) << (8 * s_size - 1));
+    
+    // Polynomial in the bit order of the register
+    static constexpr T reflect(const T value)
+    {
+        T result = 0;
+        for (uint8_t bit = 0; bit < 8 * s_size; ++bit)
+        {
+            if (value & (static_cast<T>(1) << bit))
+            {
+                result |= static_cast<T>(static_cast<T>(1) << (8 * s_size - 1 - bit));
+            }
+        }
+        return result;
+    }
+    
+    static constexpr T s_poly = t_reflected ? reflect(t_poly) : t_poly;
+    
+    // Shift the register by the given number of bits with zero input
+    static constexpr T shift(T crc, const uint8_t nofBits)
+    {
+        for (uint8_t bit = 0; bit < nofBits; ++bit)
+        {
+            if CXX17_CONSTEXPR(t_reflected)
+            {
+                crc = (crc & 1) ? static_cast<T>((crc >> 1) ^ s_poly) : static_cast<T>(crc >> 1);
+            }
+            else
+            {
+                crc = (crc & s_msb) ? static_cast<T>((crc << 1) ^ s_poly) : static_cast<T>(crc << 1);
+            }
+        }
+        return crc;
+    }
+    
+    // Add the given bits to the end of the register which is shifted out first
+    static constexpr T feed(const T crc, const uint8_t data, const uint8_t nofBits)
+    {
+        if CXX17_CONSTEXPR(t_reflected)
+        {
+            return crc ^ data;
+        }
+        else
+        {
+            return crc ^ static_cast<T>(static_cast<T>(data) << (8 * s_size - nofBits));
+        }
+    }
+    
+    static constexpr T updateBitwise(const T crc, const uint8_t data)
+    {
+        return shift(feed(crc, data, 8), 8);
+    }
+    
+    // Update with the lower 4 bits of data
+    static T updateNibble(const T crc, const uint8_t data)
+    {
+        if CXX17_CONSTEXPR(t_reflected)
+        {
+            return static_cast<T>(crc >> 4) ^ memread_P(&s_nibbleTable[(crc ^ data) & 0x0F]);
+        }
+        else
+        {
+            return static_cast<T>(crc << 4) ^ memread_P(&s_nibbleTable[((crc >> (8 * s_size - 4)) ^ data) & 0x0F]);
+        }
+    }
+    
+    static T updateTable(const T crc, const uint8_t data)
+    {
+        if CXX17_CONSTEXPR(t_reflected)
+        {
+            return static_cast<T>(crc >> 8) ^ memread_P(&s_table[static_cast<uint8_t>(crc) ^ data]);
+        }
+        else
+        {
+            return static_cast<T>(crc << 8) ^ memread_P(&s_table[static_cast<uint8_t>(crc >> s_shift) ^ data]);
+        }
+    }
+    
+    template <size_t t_nofBits>
+    static constexpr Array<T, 1 << t_nofBits> makeTable()
+    {
+        Array<T, 1 << t_nofBits> table = {};
+        for (size_t idx = 0; idx < table.size(); ++idx)
+        {
+            table[idx] = shift(feed(0, static_cast<uint8_t>(idx), t_nofBits), t_nofBits);
+        }
+        return table;
+    }
+    
+    // Register value after a message of zero length followed by its CRC
+    static constexpr T makeResidue()
+    {
+        T crc = init();
+        const T value = finalize(crc);
+        for (uint8_t idx = 0; idx < s_size; ++idx)
+        {
+            crc = updateBitwise(crc, getByte(value, idx));
+        }
+        return crc;
+    }
+    
+    static constexpr T s_residue = makeResidue();
+    
+    // Only the table of the selected implementation is referenced, so the other one is not linked
+    static constexpr Array<T, 16> s_nibbleTable PROGMEM = makeTable<4>();
+    static constexpr Array<T, 256> s_table PROGMEM = makeTable<8>();
+};
+
+/// @brief CRC-8 (polynomial x^8 + x^2 + x + 1, also known as CRC-8/SMBUS)
+template <CRCImplementation t_impl>
+using CRC8Type = CRC<uint8_t, 0x07, 0x00, 0x00, false, t_impl>;
+
+/// @brief CRC-16-CCITT (polynomial x^16 + x^12 + x^5 + 1, initial value 0xFFFF, also known as CRC-16/CCITT-FALSE)
+template <CRCImplementation t_impl>
+using CRC16Type = CRC<uint16_t, 0x1021, 0xFFFF, 0x0000, false, t_impl>;
+
+/// @brief CRC-32 as used by Ethernet, zlib and PNG (polynomial 0x04C11DB7, reflected)
+template <CRCImplementation t_impl>
+using CRC32Type = CRC<uint32_t, 0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, true, t_impl>;
+
+using CRC8         = CRC8Type<CRCImplementation::table>;
+using CRC8Nibble   = CRC8Type<CRCImplementation::nibble>;
+using CRC8Bitwise  = CRC8Type<CRCImplementation::bitwise>;
+using CRC16        = CRC16Type<CRCImplementation::table>;
+using CRC16Nibble  = CRC16Type<CRCImplementation::nibble>;
+using CRC16Bitwise = CRC16Type<CRCImplementation::bitwise>;
+using CRC32        = CRC32Type<CRCImplementation::table>;
+using CRC32Nibble  = CRC32Type<CRCImplementation::nibble>;
+using CRC32Bitwise = CRC32Type<CRCImplementation::bitwise>;
+
+#endif
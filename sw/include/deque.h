@@ -19,9 +19,10 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #define DEQUE_H
 
 #include <bits/c++config.h>
+#include <bits/deque_base.h>
 #include <bits/move.h>
 #include <bits/new.h>
-#include <type_traits>
+#include <type_traits.h>
 #include <exception.h>
 
 #include <initializer_list>
@@ -34,8 +35,19 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 @tparam Allocator allocator class to use for all memory allocations of this container
 */
 template <typename T, typename Allocator = HeapAllocator<>>
-class Deque
+class Deque : private dequeHelper::DequeBase<typename Allocator::size_type>
 {
+    using Base = dequeHelper::DequeBase<typename Allocator::size_type>;
+    using Base::m_capacity;
+    using Base::m_size;
+    using Base::m_front;
+    using Base::m_end;
+    using Base::toIndex;
+    using Base::incIndex;
+    using Base::decIndex;
+    using Base::full;
+    using Base::grownCapacity;
+    
     public:
     
     template <bool t_const, bool t_reverse>
@@ -206,18 +218,8 @@ class Deque
         if (m_allocator == other.m_allocator)
         {
             // Copy all members from other to this
-            m_capacity = other.m_capacity;
-            m_size = other.m_size;
-            m_end = other.m_end;
-            m_front = other.m_front;
-            m_data = other.m_data;
-            
-            // Invalidate other object
-            other.m_capacity = 0;
-            other.m_size = 0;
-            other.m_end = 0;
-            other.m_front = 0;
-            other.m_data = nullptr;
+            Base::swapIndices(other);
+            swap(m_data, other.m_data);
         }
         else
         {
@@ -295,10 +297,7 @@ class Deque
             if (m_allocator == other.m_allocator)
             {
                 // Swap all members from other to this
-                swap(m_capacity, other.m_capacity);
-                swap(m_size, other.m_size);
-                swap(m_end, other.m_end);
-                swap(m_front, other.m_front);
+                Base::swapIndices(other);
                 swap(m_data, other.m_data);
             }
             else
@@ -533,12 +532,7 @@ class Deque
     */
     CXX14_CONSTEXPR reference operator[](const size_type pos)
     {
-        size_type idx = pos + m_front; // TODO check for integer overflow
-        if (idx >= m_capacity)
-        {
-            idx -= m_capacity;
-        }
-        return m_data[idx];
+        return m_data[toIndex(pos)];
     }
     
     /**
@@ -549,12 +543,7 @@ class Deque
     */
     CXX14_CONSTEXPR const_reference operator[](const size_type pos) const
     {
-        size_type idx = pos + m_front; // TODO check for integer overflow
-        if (idx >= m_capacity)
-        {
-            idx -= m_capacity;
-        }
-        return m_data[idx];
+        return m_data[toIndex(pos)];
     }
     
     /**
@@ -731,7 +720,7 @@ class Deque
     {
         if (full())
         {
-            reallocate(m_capacity << 1);
+            reallocate(grownCapacity());
         }
         
         ++m_size;
@@ -748,7 +737,7 @@ class Deque
     {
         if (full())
         {
-            reallocate(m_capacity << 1);
+            reallocate(grownCapacity());
         }
         
         ++m_size;
@@ -768,7 +757,7 @@ class Deque
     {
         if (full())
         {
-            reallocate(m_capacity << 1);
+            reallocate(grownCapacity());
         }
 
         ++m_size;
@@ -797,7 +786,7 @@ class Deque
     {
         if (full())
         {
-            reallocate(m_capacity << 1);
+            reallocate(grownCapacity());
         }
         
         ++m_size;
@@ -815,7 +804,7 @@ class Deque
     {
         if (full())
         {
-            reallocate(m_capacity << 1);
+            reallocate(grownCapacity());
         }
         
         ++m_size;
@@ -835,7 +824,7 @@ class Deque
     {
         if (full())
         {
-            reallocate(m_capacity << 1);
+            reallocate(grownCapacity());
         }
 
         ++m_size;
@@ -874,11 +863,18 @@ class Deque
             }
             
             // Copy-construct existing elements
-            auto it = cbegin();
-            for (size_type idx = 0; idx < newSize; ++idx)
+            if CXX17_CONSTEXPR(is_trivially_copyable<value_type>::value)
+            {
+                Base::copyLinear(reinterpret_cast<uint8_t*>(data), reinterpret_cast<const uint8_t*>(m_data), sizeof(value_type), newSize);
+            }
+            else
             {
-                new (data + idx) value_type(*it);
-                ++it;
+                auto it = cbegin();
+                for (size_type idx = 0; idx < newSize; ++idx)
+                {
+                    new (data + idx) value_type(*it);
+                    ++it;
+                }
             }
                     
             // Deallocate old memory
@@ -887,35 +883,10 @@ class Deque
                     
             // Assign members to new memory
             m_data = data;
-            m_capacity = count;
-            m_size = newSize;
-            m_front = 0;
-            m_end = newSize;
+            Base::resetIndices(count, newSize);
         }
     }
     
-    constexpr void incIndex(size_type& idx) const
-    {
-        if (++idx == m_capacity)
-        {
-            idx = 0;
-        }
-    }
-
-    constexpr void decIndex(size_type& idx) const
-    {
-        if (idx == 0)
-        {
-            idx = m_capacity;
-        }
-        --idx;
-    }
-
-    constexpr bool full() const
-    {
-        return m_size == m_capacity;
-    }
-    
     constexpr value_type* allocate(const size_type capacity)
     {
         value_type* ptr = static_cast<value_type*>(m_allocator.allocate(capacity * sizeof(value_type)));
@@ -932,10 +903,6 @@ class Deque
     }
 
     value_type* m_data = nullptr;
-    size_type m_capacity = 0;
-    size_type m_size = 0;
-    size_type m_front = 0;
-    size_type m_end = 0;
     allocator_type m_allocator;
 };
 
@@ -19,6 +19,8 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #define FORWARD_LIST_H
 
 #include <bits/c++config.h>
+#include <bits/list_base.h>
+#include <bits/list_sort.h>
 #include <bits/move.h>
 #include <bits/new.h>
 #include <exception.h>
@@ -32,10 +34,10 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 @tparam An allocator that is used to acquire/release memory and to construct/destroy the elements in that
 */
 template <typename T, typename Allocator = HeapAllocator<>>
-class ForwardList
+class ForwardList : private listHelper::ForwardListBase
 {    
-    class NodeBase;
-    class Node;
+    using listHelper::ForwardListBase::NodeBase;
+    struct Node;
     
     public:
      
@@ -321,6 +323,17 @@ class ForwardList
     {
         return m_allocator;
     }
+    
+    /**
+    @brief returns the size of one list node
+    Each element is stored in a separate node, i.e. the allocator is called with this size once per element.
+    Use this to size fixed-size block allocators like AtomicPoolAllocator.
+    @result Size of one node in bytes
+    */
+    static constexpr size_t nodeSize()
+    {
+        return sizeof(Node);
+    }
 
     /**
     @brief Returns an iterator to the element before beginning
@@ -706,32 +719,103 @@ class ForwardList
             throw_nullptr_error();
         }
 
-        // Append other to pos node and store the original successor of pos        
-        NodeBase* next = node->m_next;
-        node->m_next = other.m_head.m_next;        
-
-        // Uncouple moved list nodes from other
-        other.m_head.m_next = nullptr;
-         
-        // Append remaining nodes of this to other
-        while (nullptr != node->m_next)
+        transferAfter(node, other);
+    }
+    
+    /**
+    @brief sorts the elements
+    Sorts the elements in ascending order using operator<. The order of equal elements is preserved.
+    The nodes are relinked using bottom-up merge sort, i.e. no elements are copied and no memory is allocated.
+    No references or iterators become invalidated.
+    */
+    CXX14_CONSTEXPR void sort()
+    {
+        sort([](const value_type& lhs, const value_type& rhs) { return lhs < rhs; });
+    }
+    
+    /**
+    @brief sorts the elements
+    Sorts the elements in ascending order using the given comparison function. The order of equal elements is preserved.
+    The nodes are relinked using bottom-up merge sort, i.e. no elements are copied and no memory is allocated.
+    No references or iterators become invalidated.
+    @param comp comparison function object which returns true if the first argument is less than the second one
+    */
+    template <typename Compare>
+    CXX14_CONSTEXPR void sort(Compare comp)
+    {
+        m_head.m_next = listHelper::sort<Node>(m_head.m_next, comp);
+    }
+    
+    /**
+    @brief merges two sorted lists
+    Merges the sorted list other into *this using operator<. The lists should be sorted into ascending order.
+    No elements are copied, the nodes of other are relinked into *this. The container other becomes empty after the operation.
+    The behavior is undefined if getAllocator() != other.getAllocator(). For equivalent elements, the elements of *this precede the elements of other.
+    @param other another container to merge
+    */
+    CXX14_CONSTEXPR void merge(ForwardList& other)
+    {
+        merge(other, [](const value_type& lhs, const value_type& rhs) { return lhs < rhs; });
+    }
+    
+    /**
+    @brief merges two sorted lists
+    Merges the sorted list other into *this using the given comparison function. The lists should be sorted into ascending order.
+    No elements are copied, the nodes of other are relinked into *this. The container other becomes empty after the operation.
+    The behavior is undefined if getAllocator() != other.getAllocator(). For equivalent elements, the elements of *this precede the elements of other.
+    @param other another container to merge
+    @param comp comparison function object which returns true if the first argument is less than the second one
+    */
+    template <typename Compare>
+    CXX14_CONSTEXPR void merge(ForwardList& other, Compare comp)
+    {
+        if (this != &other)
         {
-            node = node->m_next;
+            m_head.m_next = listHelper::merge<Node>(m_head.m_next, other.m_head.m_next, comp);
+            other.m_head.m_next = nullptr;
         }
-        node->m_next = next;
     }
-        
-    private:
     
-    // Forward list node base class
-    struct NodeBase
+    /**
+    @brief removes consecutive duplicate elements
+    Removes all but the first element from every consecutive group of equal elements.
+    @result The number of elements removed
+    */
+    constexpr size_type unique()
+    {
+        return unique([](const value_type& lhs, const value_type& rhs) { return lhs == rhs; });
+    }
+    
+    /**
+    @brief removes consecutive duplicate elements
+    Removes all but the first element from every consecutive group of equivalent elements.
+    @param pred binary predicate which returns true if the elements should be treated as equal
+    @result The number of elements removed
+    */
+    template <typename BinaryPredicate>
+    constexpr size_type unique(BinaryPredicate pred)
     {
-        constexpr NodeBase(NodeBase * next = nullptr) : m_next(next)
-        {}
+        size_type nofRemovedElems = 0;
+        NodeBase* node = m_head.m_next;
+        while (nullptr != node && nullptr != node->m_next)
+        {
+            Node* next = static_cast<Node*>(node->m_next);
+            if (pred(static_cast<Node*>(node)->m_data, next->m_data))
+            {
+                node->m_next = deleteNode(next);
+                ++nofRemovedElems;
+            }
+            else
+            {
+                node = next;
+            }
+        }
         
-        NodeBase* m_next = nullptr;
-    };
-
+        return nofRemovedElems;
+    }
+        
+    private:
+    
     // Forward list node class
     struct Node : public NodeBase
     {
@@ -775,7 +859,6 @@ class ForwardList
         return ptr;
     }
 
-    NodeBase m_head;
     Allocator m_allocator;
 };
 
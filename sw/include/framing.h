@@ -0,0 +1,629 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef FRAMING_H
+#define FRAMING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <crc.h>
+#include <span.h>
+#include <bits/byte_stream.h>
+
+/**
+@brief Errors reported by frame decoders
+*/
+enum class FrameError : uint8_t
+{
+    /// Frame does not fit into the receive buffer
+    overflow,
+    
+    /// Frame is too short to contain a CRC or the CRC does not match
+    crc,
+    
+    /// Byte sequence violating the encoding, e.g. a truncated COBS block or an invalid SLIP escape sequence
+    encoding
+};
+
+/**
+@brief Default frame handlers. Derive from this class and hide the methods of interest:
+@code
+struct Handlers : FrameHandlers
+{
+    static void frame(const ConstSpan<uint8_t> payload) {...}
+};
+COBSDecoder<Handlers> decoder(buffer);
+@endcode
+Since handlers are static methods called directly by the decoder, empty handlers do not generate any code.
+*/
+struct FrameHandlers
+{
+    /**
+    @brief Called for each frame received with a valid CRC
+    @param payload Payload of the frame, excluding the CRC. Only valid during the call.
+    */
+    static void frame(const ConstSpan<uint8_t> payload)
+    {
+        (void)payload;
+    }
+    
+    /**
+    @brief Called for each frame which has been discarded
+    @param error Reason for discarding the frame
+    */
+    static void error(const FrameError error)
+    {
+        (void)error;
+    }
+};
+
+/**
+@brief Payload of a frame followed by its CRC, as seen by frame encoders
+@tparam CRCType CRC class, e.g. CRC8 or CRC16
+*/
+template <typename CRCType>
+class FrameSource
+{
+    public:
+    
+    /**
+    @brief Start a new frame. The payload is not copied and must remain valid until the frame has been encoded.
+    @param payload Payload
+    */
+    void begin(const ConstSpan<uint8_t> payload)
+    {
+        m_payload = payload;
+        m_crc = CRCType::compute(payload);
+    }
+    
+    /**
+    @brief Returns the number of bytes of payload and CRC
+    @result Number of bytes
+    */
+    size_t size() const
+    {
+        return m_payload.size() + CRCType::s_size;
+    }
+    
+    /**
+    @brief Access the byte at the given position. No bounds checking is performed.
+    @param pos Position of the byte
+    @result Payload byte or CRC byte
+    */
+    uint8_t operator[](const size_t pos) const
+    {
+        if (pos < m_payload.size())
+        {
+            return m_payload[pos];
+        }
+        return CRCType::getByte(m_crc, static_cast<uint8_t>(pos - m_payload.size()));
+    }
+    
+    private:
+    
+    ConstSpan<uint8_t> m_payload;
+    typename CRCType::value_type m_crc = 0;
+};
+
+/**
+@brief Receive buffer of frame decoders. Decoded bytes are appended and checked against the CRC on the fly.
+@tparam Handlers Frame handler class derived from FrameHandlers
+@tparam CRCType CRC class, e.g. CRC8 or CRC16
+*/
+template <typename Handlers, typename CRCType>
+class FrameSink
+{
+    public:
+    
+    /**
+    @brief Constructor
+    @param buffer Receive buffer. Must hold the largest payload plus the CRC.
+    */
+    constexpr explicit FrameSink(const Span<uint8_t> buffer) : m_buffer(buffer)
+    {}
+    
+    /**
+    @brief Append a decoded byte. If the buffer is full, the frame is marked as overflown.
+    @param data Decoded byte
+    */
+    void push(const uint8_t data)
+    {
+        if (m_size == m_buffer.size())
+        {
+            m_overflow = true;
+            return;
+        }
+        m_buffer[m_size++] = data;
+        m_crc = CRCType::update(m_crc, data);
+    }
+    
+    /**
+    @brief Complete the current frame and call the frame or error handler
+    */
+    void complete()
+    {
+        if (m_overflow)
+        {
+            Handlers::error(FrameError::overflow);
+        }
+        else if (m_size < CRCType::s_size || m_crc != CRCType::getResidue())
+        {
+            Handlers::error(FrameError::crc);
+        }
+        else
+        {
+            Handlers::frame(ConstSpan<uint8_t>(m_buffer.data(), m_size - CRCType::s_size));
+        }
+        clear();
+    }
+    
+    /**
+    @brief Discard the current frame
+    */
+    void clear()
+    {
+        m_size = 0;
+        m_overflow = false;
+        m_crc = CRCType::init();
+    }
+    
+    /**
+    @brief Check if no byte has been appended since the last frame
+    @result true if the current frame is empty
+    */
+    bool empty() const
+    {
+        return 0 == m_size && !m_overflow;
+    }
+    
+    private:
+    
+    Span<uint8_t> m_buffer;
+    size_t m_size = 0;
+    bool m_overflow = false;
+    typename CRCType::value_type m_crc = CRCType::init();
+};
+
+/**
+@brief Streaming encoder for Consistent Overhead Byte Stuffing (COBS) with CRC
+A frame consists of the COBS-encoded payload and CRC, followed by a delimiter byte 0x00. Encoded frames never contain 0x00, and the overhead is
+one byte per 254 bytes of payload, plus the delimiter and the CRC.
+Encoded bytes are produced one at a time directly from the payload, i.e. without an intermediate copy. Each byte takes a bounded amount of time,
+so the encoder can be driven by the SPI interrupt, or it can fill the Tx ring buffer of BufferedUSART as far as there is room:
+@code
+encoder.begin(payload);
+while (!encoder.encodeTo<USART>())
+{
+    // Do something else while the Tx buffer drains
+}
+@endcode
+@tparam CRCType CRC class, default is CRC16
+*/
+template <typename CRCType = CRC16>
+class COBSEncoder : public byteStreamHelper::ByteEncoder<COBSEncoder<CRCType>>
+{
+    public:
+    
+    /// @brief Frame delimiter. Receivers ignore repeated delimiters, so it can also be used as idle byte, e.g. by an SPI slave.
+    static constexpr uint8_t s_delimiter = 0x00;
+    
+    /**
+    @brief Start encoding a new frame. The payload is not copied and must remain valid until the frame has been encoded.
+    A frame in progress is discarded.
+    @param payload Payload
+    */
+    void begin(const ConstSpan<uint8_t> payload)
+    {
+        m_source.begin(payload);
+        m_pos = 0;
+        m_blockEnd = 0;
+        m_state = State::code;
+    }
+    
+    /**
+    @brief Check if the current frame has been encoded completely
+    @result true if there are no more bytes to encode
+    */
+    bool done() const
+    {
+        return State::done == m_state;
+    }
+    
+    /**
+    @brief Get the next encoded byte
+    @param data Next encoded byte. Left untouched if the frame has been encoded completely.
+    @result true if a byte has been returned
+    */
+    bool read(uint8_t& data)
+    {
+        switch (m_state)
+        {
+            case State::code:
+            data = beginBlock();
+            return true;
+            
+            case State::data:
+            data = m_source[m_pos++];
+            if (m_pos == m_blockEnd)
+            {
+                endBlock();
+            }
+            return true;
+            
+            case State::delimiter:
+            data = s_delimiter;
+            m_state = State::done;
+            return true;
+            
+            default:
+            return false;
+        }
+    }
+    
+    private:
+    
+    enum class State : uint8_t
+    {
+        code,
+        data,
+        delimiter,
+        done
+    };
+    
+    // Maximum number of data bytes per block
+    static constexpr uint8_t s_maxBlockSize = 0xFE;
+    
+    // Scan the source for the end of the next block and return its code byte
+    uint8_t beginBlock()
+    {
+        const size_t size = m_source.size();
+        m_blockEnd = m_pos;
+        while (m_blockEnd < size && m_blockEnd - m_pos < s_maxBlockSize && 0 != m_source[m_blockEnd])
+        {
+            ++m_blockEnd;
+        }
+        
+        // Blocks of maximum length are not followed by an implicit zero
+        m_zeroFollows = m_blockEnd < size && m_blockEnd - m_pos < s_maxBlockSize;
+        
+        const uint8_t code = static_cast<uint8_t>(m_blockEnd - m_pos + 1);
+        if (m_pos == m_blockEnd)
+        {
+            endBlock();
+        }
+        else
+        {
+            m_state = State::data;
+        }
+        return code;
+    }
+    
+    void endBlock()
+    {
+        if (m_zeroFollows)
+        {
+            // The zero byte is implied by the code of this block, skip it. A zero at the end still requires another block.
+            ++m_pos;
+            m_state = State::code;
+        }
+        else
+        {
+            // Block of maximum length or end of frame
+            m_state = m_blockEnd < m_source.size() ? State::code : State::delimiter;
+        }
+    }
+    
+    FrameSource<CRCType> m_source;
+    size_t m_pos = 0;
+    size_t m_blockEnd = 0;
+    bool m_zeroFollows = false;
+    State m_state = State::done;
+};
+
+/**
+@brief Streaming decoder for COBS frames with CRC as produced by COBSEncoder
+Bytes are decoded as they are received, e.g. in the receive interrupt or in batches from the Rx ring buffer.
+Frames with a valid CRC are passed to Handlers::frame(), all other frames to Handlers::error(). The decoder resynchronizes at the next delimiter.
+@tparam Handlers Frame handler class derived from FrameHandlers
+@tparam CRCType CRC class, default is CRC16
+*/
+template <typename Handlers, typename CRCType = CRC16>
+class COBSDecoder : public byteStreamHelper::ByteParser<COBSDecoder<Handlers, CRCType>>
+{
+    public:
+    
+    /**
+    @brief Constructor
+    @param buffer Receive buffer. Must hold the largest payload plus CRCType::s_size bytes.
+    */
+    constexpr explicit COBSDecoder(const Span<uint8_t> buffer) : m_sink(buffer)
+    {}
+    
+    /// @brief Decode a sequence of bytes, see byteStreamHelper::ByteParser
+    using byteStreamHelper::ByteParser<COBSDecoder>::parse;
+    
+    /**
+    @brief Decode a single byte
+    @param data Received byte
+    */
+    void parse(const uint8_t data)
+    {
+        if (0 == data)
+        {
+            endFrame();
+        }
+        else if (0 == m_remaining)
+        {
+            // Code byte. The previous block is followed by an implicit zero unless it has maximum length.
+            if (m_zeroPending)
+            {
+                m_sink.push(0);
+            }
+            m_remaining = data - 1;
+            m_zeroPending = 0xFF != data;
+            m_started = true;
+        }
+        else
+        {
+            m_sink.push(data);
+            --m_remaining;
+        }
+    }
+    
+    /**
+    @brief Reset the decoder, e.g. after a receive error. The current frame is discarded without calling a handler.
+    */
+    void reset()
+    {
+        m_sink.clear();
+        m_remaining = 0;
+        m_zeroPending = false;
+        m_started = false;
+    }
+    
+    private:
+    
+    void endFrame()
+    {
+        // Repeated delimiters are ignored
+        if (m_started)
+        {
+            if (0 != m_remaining)
+            {
+                Handlers::error(FrameError::encoding);
+                m_sink.clear();
+            }
+            else
+            {
+                m_sink.complete();
+            }
+        }
+        reset();
+    }
+    
+    FrameSink<Handlers, CRCType> m_sink;
+    
+    // Number of data bytes remaining in the current block
+    uint8_t m_remaining = 0;
+    bool m_zeroPending = false;
+    bool m_started = false;
+};
+
+/**
+@brief Streaming encoder for Serial Line Internet Protocol (SLIP, RFC 1055) framing with CRC
+A frame consists of a leading END byte, the escaped payload and CRC, and a trailing END byte. The leading END flushes any line noise received before the frame.
+Bytes END and ESC are replaced by two-byte escape sequences, so the overhead depends on the payload, but no lookahead is needed.
+Encoded bytes are produced one at a time directly from the payload, like with COBSEncoder.
+@tparam CRCType CRC class, default is CRC16
+*/
+template <typename CRCType = CRC16>
+class SLIPEncoder : public byteStreamHelper::ByteEncoder<SLIPEncoder<CRCType>>
+{
+    public:
+    
+    /// @brief Frame delimiter
+    static constexpr uint8_t s_end = 0xC0;
+    
+    /// @brief Escape byte
+    static constexpr uint8_t s_esc = 0xDB;
+    
+    /// @brief Escaped END byte
+    static constexpr uint8_t s_escEnd = 0xDC;
+    
+    /// @brief Escaped ESC byte
+    static constexpr uint8_t s_escEsc = 0xDD;
+    
+    /**
+    @brief Start encoding a new frame. The payload is not copied and must remain valid until the frame has been encoded.
+    A frame in progress is discarded.
+    @param payload Payload
+    */
+    void begin(const ConstSpan<uint8_t> payload)
+    {
+        m_source.begin(payload);
+        m_pos = 0;
+        m_state = State::start;
+    }
+    
+    /**
+    @brief Check if the current frame has been encoded completely
+    @result true if there are no more bytes to encode
+    */
+    bool done() const
+    {
+        return State::done == m_state;
+    }
+    
+    /**
+    @brief Get the next encoded byte
+    @param data Next encoded byte. Left untouched if the frame has been encoded completely.
+    @result true if a byte has been returned
+    */
+    bool read(uint8_t& data)
+    {
+        switch (m_state)
+        {
+            case State::start:
+            data = s_end;
+            m_state = State::data;
+            return true;
+            
+            case State::data:
+            if (m_pos == m_source.size())
+            {
+                data = s_end;
+                m_state = State::done;
+            }
+            else
+            {
+                data = m_source[m_pos];
+                if (s_end == data || s_esc == data)
+                {
+                    m_state = State::escaped;
+                    data = s_esc;
+                }
+                else
+                {
+                    ++m_pos;
+                }
+            }
+            return true;
+            
+            case State::escaped:
+            data = s_end == m_source[m_pos++] ? s_escEnd : s_escEsc;
+            m_state = State::data;
+            return true;
+            
+            default:
+            return false;
+        }
+    }
+    
+    private:
+    
+    enum class State : uint8_t
+    {
+        start,
+        data,
+        escaped,
+        done
+    };
+    
+    FrameSource<CRCType> m_source;
+    size_t m_pos = 0;
+    State m_state = State::done;
+};
+
+/**
+@brief Streaming decoder for SLIP frames with CRC as produced by SLIPEncoder
+Frames with a valid CRC are passed to Handlers::frame(), all other frames to Handlers::error(). The decoder resynchronizes at the next END byte.
+@tparam Handlers Frame handler class derived from FrameHandlers
+@tparam CRCType CRC class, default is CRC16
+*/
+template <typename Handlers, typename CRCType = CRC16>
+class SLIPDecoder : public byteStreamHelper::ByteParser<SLIPDecoder<Handlers, CRCType>>
+{
+    using Encoder = SLIPEncoder<CRCType>;
+    
+    public:
+    
+    /**
+    @brief Constructor
+    @param buffer Receive buffer. Must hold the largest payload plus CRCType::s_size bytes.
+    */
+    constexpr explicit SLIPDecoder(const Span<uint8_t> buffer) : m_sink(buffer)
+    {}
+    
+    /// @brief Decode a sequence of bytes, see byteStreamHelper::ByteParser
+    using byteStreamHelper::ByteParser<SLIPDecoder>::parse;
+    
+    /**
+    @brief Decode a single byte
+    @param data Received byte
+    */
+    void parse(const uint8_t data)
+    {
+        if (Encoder::s_end == data)
+        {
+            endFrame();
+        }
+        else if (m_escaped)
+        {
+            m_escaped = false;
+            if (Encoder::s_escEnd == data)
+            {
+                m_sink.push(Encoder::s_end);
+            }
+            else if (Encoder::s_escEsc == data)
+            {
+                m_sink.push(Encoder::s_esc);
+            }
+            else
+            {
+                m_invalid = true;
+            }
+        }
+        else if (Encoder::s_esc == data)
+        {
+            m_escaped = true;
+            m_started = true;
+        }
+        else
+        {
+            m_sink.push(data);
+            m_started = true;
+        }
+    }
+    
+    /**
+    @brief Reset the decoder, e.g. after a receive error. The current frame is discarded without calling a handler.
+    */
+    void reset()
+    {
+        m_sink.clear();
+        m_escaped = false;
+        m_invalid = false;
+        m_started = false;
+    }
+    
+    private:
+    
+    void endFrame()
+    {
+        // Empty frames, e.g. between back-to-back frames, are ignored
+        if (m_started)
+        {
+            if (m_escaped || m_invalid)
+            {
+                Handlers::error(FrameError::encoding);
+                m_sink.clear();
+            }
+            else
+            {
+                m_sink.complete();
+            }
+        }
+        reset();
+    }
+    
+    FrameSink<Handlers, CRCType> m_sink;
+    bool m_escaped = false;
+    bool m_invalid = false;
+    bool m_started = false;
+};
+
+#endif
@@ -0,0 +1,239 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef HASH_H
+#define HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits.h>
+#include <pgm_string.h>
+#include <span.h>
+
+namespace hash_helper
+{
+    // Fold higher bits into the lower bits, since hash tables use the lower bits of a hash value only
+    constexpr size_t fold(const uint32_t value)
+    {
+        return static_cast<size_t>(value ^ (value >> 16));
+    }
+
+    // Hash a sequence of characters [first, last) using the xor variant of djb2.
+    // All character sequences (RAM or PROGMEM) must be hashed by this function so they can be compared with each other.
+    template <typename Iter>
+    constexpr size_t hashString(Iter first, const Iter last)
+    {
+        uint16_t hash = 5381;
+        for (; first != last; ++first)
+        {
+            // hash * 33 compiles into shift and add
+            hash = ((hash << 5) + hash) ^ static_cast<uint8_t>(*first);
+        }
+
+        // Fold high byte into low byte
+        return hash ^ (hash >> 8);
+    }
+
+    // Compare two sequences of characters [first1, last1) and [first2, first2 + (last1 - first1))
+    template <typename Iter1, typename Iter2>
+    constexpr bool equalString(Iter1 first1, const Iter1 last1, Iter2 first2)
+    {
+        for (; first1 != last1; ++first1, ++first2)
+        {
+            if (*first1 != *first2)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+/**
+@brief Function object computing the hash value of a key
+The hash function is selected at compile-time by the key type. Integral types of up to 16 bits are hashed by identity, i.e. sequential keys never collide.
+Enumeration types are hashed by their underlying type. Specialize this template to add hash functions for user-defined key types.
+@tparam Key Key type
+*/
+template <typename Key>
+struct Hash
+{
+    static_assert(is_enum<Key>::value, "No hash function available for this key type");
+
+    constexpr size_t operator()(const Key key) const
+    {
+        return Hash<underlying_type_t<Key>>()(static_cast<underlying_type_t<Key>>(key));
+    }
+};
+
+template <>
+struct Hash<uint8_t>
+{
+    constexpr size_t operator()(const uint8_t key) const
+    {
+        return key;
+    }
+};
+
+template <>
+struct Hash<char>
+{
+    constexpr size_t operator()(const char key) const
+    {
+        return static_cast<uint8_t>(key);
+    }
+};
+
+template <>
+struct Hash<int8_t>
+{
+    constexpr size_t operator()(const int8_t key) const
+    {
+        return static_cast<uint8_t>(key);
+    }
+};
+
+template <>
+struct Hash<uint16_t>
+{
+    constexpr size_t operator()(const uint16_t key) const
+    {
+        return key;
+    }
+};
+
+template <>
+struct Hash<int16_t>
+{
+    constexpr size_t operator()(const int16_t key) const
+    {
+        return static_cast<uint16_t>(key);
+    }
+};
+
+template <>
+struct Hash<uint32_t>
+{
+    constexpr size_t operator()(const uint32_t key) const
+    {
+        return hash_helper::fold(key);
+    }
+};
+
+template <>
+struct Hash<int32_t>
+{
+    constexpr size_t operator()(const int32_t key) const
+    {
+        return hash_helper::fold(static_cast<uint32_t>(key));
+    }
+};
+
+template <typename T>
+struct Hash<T*>
+{
+    size_t operator()(const T* key) const
+    {
+        // Consecutive objects are sizeof(T) bytes apart, so the lower bits alone are not well distributed
+        const uintptr_t address = reinterpret_cast<uintptr_t>(key);
+        return static_cast<size_t>(address ^ (address >> 5));
+    }
+};
+
+/**
+@brief Hash function for strings stored in program memory
+The characters are read directly from program memory. Character spans in RAM (ConstSpan<char>) yield the same hash value as an equal PgmString,
+so a container with PgmString keys can be searched using a RAM buffer without copying.
+*/
+template <>
+struct Hash<PgmString>
+{
+    size_t operator()(const PgmString& key) const
+    {
+        return hash_helper::hashString(key.begin(), key.end());
+    }
+
+    size_t operator()(const PgmSpan<char>& key) const
+    {
+        return hash_helper::hashString(key.begin(), key.end());
+    }
+
+    constexpr size_t operator()(const ConstSpan<char>& key) const
+    {
+        return hash_helper::hashString(key.begin(), key.end());
+    }
+};
+
+/**
+@brief Function object for performing comparisons for equality
+Unless specialized, invokes operator== on type Key.
+@tparam Key Key type
+*/
+template <typename Key>
+struct EqualTo
+{
+    constexpr bool operator()(const Key& lhs, const Key& rhs) const
+    {
+        return lhs == rhs;
+    }
+};
+
+/**
+@brief Function object comparing strings stored in program memory
+Strings may be compared with other strings in program memory or character spans in RAM.
+*/
+template <>
+struct EqualTo<PgmString>
+{
+    bool operator()(const PgmString& lhs, const PgmString& rhs) const
+    {
+        if (lhs.size() != rhs.size())
+        {
+            return false;
+        }
+
+        // Equal _pgm literals share the same storage, so most matches are found without reading program memory
+        if (lhs.data() == rhs.data())
+        {
+            return true;
+        }
+
+        return hash_helper::equalString(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    bool operator()(const PgmString& lhs, const ConstSpan<char>& rhs) const
+    {
+        if (lhs.size() != rhs.size())
+        {
+            return false;
+        }
+
+        return hash_helper::equalString(rhs.begin(), rhs.end(), lhs.begin());
+    }
+
+    bool operator()(const PgmString& lhs, const PgmSpan<char>& rhs) const
+    {
+        if (lhs.size() != rhs.size())
+        {
+            return false;
+        }
+
+        return hash_helper::equalString(rhs.begin(), rhs.end(), lhs.begin());
+    }
+};
+
+#endif
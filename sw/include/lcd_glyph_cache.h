@@ -0,0 +1,300 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LCD_GLYPH_CACHE_H
+#define LCD_GLYPH_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <array.h>
+
+/**
+@brief Custom character of an alphanumeric LCD (HD44780 5x8 format)
+Each element is one pixel row from top to bottom. The 5 least significant bits are the pixels from left (bit 4) to right (bit 0).
+*/
+using LCDGlyph = Array<uint8_t, 8>;
+
+/**
+@brief Cache of custom characters for an alphanumeric LCD
+HD44780-compatible LCDs provide 8 slots of character generator RAM (CGRAM) for custom characters.
+The cache assigns glyphs to these slots on demand and uploads a glyph only if it is not already resident.
+If all slots are taken, the least recently used glyph is replaced.
+Glyphs are identified by a user-defined ID, so a glyph pattern needs to be generated only if it has to be uploaded.
+
+Replacing a glyph changes all characters on the display showing the replaced slot. Therefore, all glyphs requested since the last call
+of beginFrame() are pinned and will not be replaced. If all slots are pinned, get() returns the given fallback character.
+Call beginFrame() whenever the whole display content is rebuilt.
+
+@tparam LCDAlphanumeric Underlying alphanumeric LCD device driver.
+This driver class needs to implement the following static method:
+void setCustomCharacter(const uint8_t slot, const LCDGlyph& glyph)
+*/
+template <typename LCDAlphanumeric>
+class LCDGlyphCache
+{
+    public:
+    
+    /// @brief Number of custom character slots
+    static constexpr uint8_t s_nofSlots = 8;
+    
+    /// @brief Reserved glyph ID of an unused slot
+    static constexpr uint8_t s_invalidId = 0xFF;
+    
+    /**
+    @brief Initialization. Marks all slots as unused. Call after (re-)initialization of the LCD, since CGRAM content is lost.
+    */
+    static void init()
+    {
+        for (uint8_t slot = 0; slot < s_nofSlots; ++slot)
+        {
+            s_ids[slot] = s_invalidId;
+            
+            // Unused slots are assigned in ascending order
+            s_order[slot] = s_nofSlots - 1 - slot;
+        }
+        s_pinned = 0;
+    }
+    
+    /**
+    @brief Start a new frame. Glyphs used in the previous frame may be replaced from now on.
+    */
+    static void beginFrame()
+    {
+        s_pinned = 0;
+    }
+    
+    /**
+    @brief Get the character code of a glyph, uploading the glyph to the LCD if it is not resident
+    The glyph is pinned until the next call of beginFrame().
+    @param id Glyph ID (0..254)
+    @param generate Callable with signature void(LCDGlyph&) generating the glyph pattern. Only called if the glyph needs to be uploaded.
+    @param fallback Character returned if the glyph is not resident and all slots are pinned
+    @result Character code to be put to the LCD
+    */
+    template <typename Generator>
+    static char get(const uint8_t id, Generator generate, const char fallback = ' ')
+    {
+        // Lookup resident glyphs, most recently used first
+        for (uint8_t pos = 0; pos < s_nofSlots; ++pos)
+        {
+            const uint8_t slot = s_order[pos];
+            if (id == s_ids[slot])
+            {
+                return use(pos);
+            }
+        }
+        
+        // Replace the least recently used glyph which is not pinned
+        for (uint8_t pos = s_nofSlots; pos > 0; --pos)
+        {
+            const uint8_t slot = s_order[pos - 1];
+            if (0 == (s_pinned & (1 << slot)))
+            {
+                LCDGlyph glyph = {};
+                generate(glyph);
+                LCDAlphanumeric::setCustomCharacter(slot, glyph);
+                s_ids[slot] = id;
+                return use(pos - 1);
+            }
+        }
+        
+        return fallback;
+    }
+    
+    /**
+    @brief Get the character code of a glyph, uploading the glyph to the LCD if it is not resident
+    @param id Glyph ID (0..254)
+    @param glyph Glyph pattern
+    @param fallback Character returned if the glyph is not resident and all slots are pinned
+    @result Character code to be put to the LCD
+    */
+    static char get(const uint8_t id, const LCDGlyph& glyph, const char fallback = ' ')
+    {
+        return get(id, [&glyph](LCDGlyph& dst) { dst = glyph; }, fallback);
+    }
+    
+    private:
+    
+    // Mark the slot at the given position of the LRU order as most recently used and pin it
+    static char use(const uint8_t pos)
+    {
+        const uint8_t slot = s_order[pos];
+        for (uint8_t idx = pos; idx > 0; --idx)
+        {
+            s_order[idx] = s_order[idx - 1];
+        }
+        s_order[0] = slot;
+        s_pinned |= 1 << slot;
+        
+        // HD44780 maps character codes 0..7 to CGRAM slots 0..7. The mirrored codes 8..15 are not used since code 10 would be taken for '\n' by the frame buffer.
+        return static_cast<char>(slot);
+    }
+    
+    // Glyph ID per slot
+    static uint8_t s_ids[s_nofSlots];
+    
+    // Slots ordered from most to least recently used
+    static uint8_t s_order[s_nofSlots];
+    
+    // Bit mask of slots used in the current frame
+    static uint8_t s_pinned;
+};
+
+// Static initialization
+template <typename LCDAlphanumeric>
+uint8_t LCDGlyphCache<LCDAlphanumeric>::s_ids[s_nofSlots] = {s_invalidId, s_invalidId, s_invalidId, s_invalidId, s_invalidId, s_invalidId, s_invalidId, s_invalidId};
+
+template <typename LCDAlphanumeric>
+uint8_t LCDGlyphCache<LCDAlphanumeric>::s_order[s_nofSlots] = {7, 6, 5, 4, 3, 2, 1, 0};
+
+template <typename LCDAlphanumeric>
+uint8_t LCDGlyphCache<LCDAlphanumeric>::s_pinned = 0;
+
+/**
+@brief Bar graph renderer for alphanumeric LCDs using custom characters
+Horizontal bars have a resolution of 5 steps per character cell (one per pixel column), vertical bars have a resolution of 8 steps per cell.
+Full cells use the solid block character 0xFF of the HD44780 character ROM, so only partially filled cells occupy custom character slots:
+Up to 4 slots for horizontal bars and up to 7 slots for vertical bars.
+@tparam GlyphCache Glyph cache, see LCDGlyphCache
+*/
+template <typename GlyphCache>
+class LCDBarGraph
+{
+    public:
+    
+    /// @brief Number of steps per character cell of horizontal bars
+    static constexpr uint8_t s_horizontalResolution = 5;
+    
+    /// @brief Number of steps per character cell of vertical bars
+    static constexpr uint8_t s_verticalResolution = 8;
+    
+    /// @brief Glyph IDs used for partially filled cells of horizontal bars (s_horizontalId + 1..4)
+    static constexpr uint8_t s_horizontalId = 0xF0;
+
+    /// @brief Glyph IDs used for partially filled cells of vertical bars (s_verticalId + 1..7)
+    static constexpr uint8_t s_verticalId = 0xF4;
+    
+    /**
+    @brief Render a horizontal bar
+    @param str String implementation the characters are appended to, e.g. the frame buffer of LCDAlphanumericBuffered
+    @param width Width of the bar in character cells
+    @param value Value to display, clipped to maxValue
+    @param maxValue Value corresponding to a full bar
+    */
+    template <typename StringImpl>
+    static void putHorizontal(StringImpl& str, const uint8_t width, const uint16_t value, const uint16_t maxValue)
+    {
+        uint16_t steps = scale(value, maxValue, width * s_horizontalResolution);
+        for (uint8_t cell = 0; cell < width; ++cell)
+        {
+            const uint8_t fill = steps < s_horizontalResolution ? steps : s_horizontalResolution;
+            str.pushBack(getHorizontal(fill));
+            steps -= fill;
+        }
+    }
+    
+    /**
+    @brief Render one row of vertical bars
+    Multi-row bars are rendered row by row from top to bottom.
+    @param str String implementation the characters are appended to, e.g. the frame buffer of LCDAlphanumericBuffered
+    @param rowIdx Index of the row to render, 0 is the top row
+    @param height Height of the bars in character cells
+    @param first, last Range of values to display, one bar per value. Values are clipped to maxValue.
+    @param maxValue Value corresponding to a full bar
+    */
+    template <typename StringImpl, typename InputIt>
+    static void putVertical(StringImpl& str, const uint8_t rowIdx, const uint8_t height, InputIt first, const InputIt last, const uint16_t maxValue)
+    {
+        // Steps below the given row
+        const uint8_t offset = (height - 1 - rowIdx) * s_verticalResolution;
+        for (; first != last; ++first)
+        {
+            const uint8_t steps = scale(*first, maxValue, height * s_verticalResolution);
+            uint8_t fill = 0;
+            if (steps > offset)
+            {
+                fill = steps - offset;
+                if (fill > s_verticalResolution)
+                {
+                    fill = s_verticalResolution;
+                }
+            }
+            str.pushBack(getVertical(fill));
+        }
+    }
+    
+    private:
+    
+    static constexpr char s_empty = ' ';
+    static constexpr char s_full = static_cast<char>(0xFF);
+    
+    // Scale value to the given number of steps, rounding down
+    static uint16_t scale(const uint16_t value, const uint16_t maxValue, const uint16_t nofSteps)
+    {
+        if (value >= maxValue)
+        {
+            return nofSteps;
+        }
+        return static_cast<uint32_t>(value) * nofSteps / maxValue;
+    }
+    
+    // Character of a horizontal bar cell filled with the given number of pixel columns
+    static char getHorizontal(const uint8_t fill)
+    {
+        if (0 == fill)
+        {
+            return s_empty;
+        }
+        if (s_horizontalResolution == fill)
+        {
+            return s_full;
+        }
+        return GlyphCache::get(s_horizontalId + fill, [fill](LCDGlyph& glyph)
+        {
+            // Columns are filled from the left
+            const uint8_t row = static_cast<uint8_t>(0x1F << (s_horizontalResolution - fill)) & 0x1F;
+            for (uint8_t& r : glyph)
+            {
+                r = row;
+            }
+        });
+    }
+
+    // Character of a vertical bar cell filled with the given number of pixel rows
+    static char getVertical(const uint8_t fill)
+    {
+        if (0 == fill)
+        {
+            return s_empty;
+        }
+        if (s_verticalResolution == fill)
+        {
+            return s_full;
+        }
+        return GlyphCache::get(s_verticalId + fill, [fill](LCDGlyph& glyph)
+        {
+            // Rows are filled from the bottom
+            for (uint8_t idx = 0; idx < s_verticalResolution; ++idx)
+            {
+                glyph[idx] = (idx >= s_verticalResolution - fill) ? 0x1F : 0;
+            }
+        });
+    }
+};
+
+#endif
@@ -80,4 +80,29 @@ struct numeric_limits <uint16_t>
     }
 };
 
+/**
+@brief Numeric limits of uint32_t
+*/
+template <>
+struct numeric_limits <uint32_t>
+{
+    /**
+    @brief Maximum value
+    @result Maximum value of uint32_t
+    */
+    static constexpr uint32_t max()
+    {
+        return 4294967295UL;
+    }
+
+    /**
+    @brief Minimum value
+    @result Minimum value of uint32_t
+    */
+    static constexpr uint32_t min()
+    {
+        return 0;
+    }
+};
+
 #endif
\ No newline at end of file
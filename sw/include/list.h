@@ -19,6 +19,8 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #define LIST_H
 
 #include <bits/c++config.h>
+#include <bits/list_base.h>
+#include <bits/list_sort.h>
 #include <bits/move.h>
 #include <bits/new.h>
 #include <exception.h>
@@ -32,10 +34,10 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 @tparam An allocator that is used to acquire/release memory and to construct/destroy the elements in that
 */
 template <typename T, typename Allocator = HeapAllocator<>>
-class List
+class List : private listHelper::ListBase
 {
-    class NodeBase;
-    class Node;
+    using listHelper::ListBase::NodeBase;
+    struct Node;
     
     public:
     
@@ -119,7 +121,6 @@ class List
     */
     CXX14_CONSTEXPR explicit List(const Allocator& allocator = Allocator()) : m_allocator(allocator)
     {
-        init();
     }
     
     /**
@@ -130,7 +131,6 @@ class List
     */
     CXX14_CONSTEXPR explicit List(size_type count, const Allocator& allocator = Allocator()) : m_allocator(allocator)
     {
-        init();
         NodeBase* prev = &m_front;
         while (count--)
         {
@@ -147,7 +147,6 @@ class List
     */
     CXX14_CONSTEXPR List(size_type count, const value_type& value, const Allocator& allocator = Allocator()) : m_allocator(allocator)
     {
-        init();
         NodeBase* prev = &m_front;
         while (count--)
         {
@@ -164,7 +163,6 @@ class List
     template< class InputIt >
     CXX14_CONSTEXPR List(InputIt first, InputIt last, const Allocator& allocator = Allocator()) : m_allocator(allocator)
     {
-        init();
         assign(first, last);
     }
     
@@ -195,16 +193,11 @@ class List
     {
         if (m_allocator == other.m_allocator)
         {
-            // Link front and back to other list nodes
-            link(m_front, *other.m_front.m_next);
-            link(*other.m_back.m_prev, m_back);
-            
-            // Clear other list
-            link(other.m_front, other.m_back);
+            // Take over the nodes of other
+            takeOver(other);
         }
         else
         {
-            init();
             assign(other.begin(), other.end());
         }
     }
@@ -246,12 +239,9 @@ class List
             // Check if other uses the same allocator object
             if (m_allocator == other.m_allocator)
             {
-                // Link front and back to other list nodes
-                link(m_front, *other.m_front.m_next);
-                link(*other.m_back.m_prev, m_back);
-                
-                // Clear other list
-                link(other.m_front, other.m_back);
+                // Take over the nodes of other
+                clear();
+                takeOver(other);
             }
             else
             {
@@ -344,6 +334,17 @@ class List
         return m_allocator;
     }
     
+    /**
+    @brief returns the size of one list node
+    Each element is stored in a separate node, i.e. the allocator is called with this size once per element.
+    Use this to size fixed-size block allocators like AtomicPoolAllocator.
+    @result Size of one node in bytes
+    */
+    static constexpr size_t nodeSize()
+    {
+        return sizeof(Node);
+    }
+    
     /**
     @brief access the first element
     Returns a reference to the first element in the container.
@@ -542,16 +543,7 @@ class List
     */
     [[nodiscard]] constexpr size_type size() const
     {
-        size_type nofElems = 0;
-        const_iterator itCurrent = cbegin();
-        const_iterator itEnd = cend();
-        
-        while (itCurrent != itEnd)
-        {
-            ++nofElems;
-            ++itCurrent;
-        }
-        return nofElems;
+        return static_cast<size_type>(countNodes());
     }
     
     /**
@@ -861,52 +853,153 @@ class List
     */
     CXX14_CONSTEXPR void reverse()
     {
-        NodeBase* node = m_front.m_next;
-        while (node != &m_back)
-        {
-            swap(node->m_prev, node->m_next);
-            node = node->m_prev;
-        }
-        swap(m_front.m_next, m_back.m_prev);
-        link(m_front, *m_front.m_next);
-        link(*m_back.m_prev, m_back);
+        reverseNodes();
     }
     
-    private:
+    /**
+    @brief sorts the elements
+    Sorts the elements in ascending order using operator<. The order of equal elements is preserved.
+    The nodes are relinked using bottom-up merge sort, i.e. no elements are copied and no memory is allocated.
+    No references or iterators become invalidated.
+    */
+    CXX14_CONSTEXPR void sort()
+    {
+        sort([](const value_type& lhs, const value_type& rhs) { return lhs < rhs; });
+    }
     
-    // List node base class
-    struct NodeBase
+    /**
+    @brief sorts the elements
+    Sorts the elements in ascending order using the given comparison function. The order of equal elements is preserved.
+    The nodes are relinked using bottom-up merge sort, i.e. no elements are copied and no memory is allocated.
+    No references or iterators become invalidated.
+    @param comp comparison function object which returns true if the first argument is less than the second one
+    */
+    template <typename Compare>
+    CXX14_CONSTEXPR void sort(Compare comp)
     {
-        CXX14_CONSTEXPR NodeBase(NodeBase* prev = nullptr, NodeBase * next = nullptr) : m_prev(prev), m_next(next)
+        relink(listHelper::sort<Node>(detach(), comp));
+    }
+    
+    /**
+    @brief removes consecutive duplicate elements
+    Removes all but the first element from every consecutive group of equal elements.
+    @result The number of elements removed
+    */
+    constexpr size_type unique()
+    {
+        return unique([](const value_type& lhs, const value_type& rhs) { return lhs == rhs; });
+    }
+    
+    /**
+    @brief removes consecutive duplicate elements
+    Removes all but the first element from every consecutive group of equivalent elements.
+    @param pred binary predicate which returns true if the elements should be treated as equal
+    @result The number of elements removed
+    */
+    template <typename BinaryPredicate>
+    constexpr size_type unique(BinaryPredicate pred)
+    {
+        size_type nofRemovedElems = 0;
+        if (empty())
         {
-            if (nullptr != prev)
-            {
-                prev->m_next = this;
-            }
-            
-            if (nullptr != next)
-            {
-                next->m_prev = this;
-            }
+            return nofRemovedElems;
         }
         
-        CXX20_CONSTEXPR ~NodeBase()
+        NodeBase* node = m_front.m_next;
+        while (&m_back != node->m_next)
         {
-            if (nullptr != m_prev)
+            Node* next = static_cast<Node*>(node->m_next);
+            if (pred(static_cast<Node*>(node)->m_data, next->m_data))
             {
-                m_prev->m_next = m_next;
+                deleteNode(next);
+                ++nofRemovedElems;
             }
-            
-            if (nullptr != m_next)
+            else
             {
-                m_next->m_prev = m_prev;
+                node = next;
             }
         }
         
-        NodeBase* m_prev = nullptr;
-        NodeBase* m_next = nullptr;
-    };
-
+        return nofRemovedElems;
+    }
+    
+    /**
+    @brief merges two sorted lists
+    Merges the sorted list other into *this using operator<. The lists should be sorted into ascending order.
+    No elements are copied, the nodes of other are relinked into *this. The container other becomes empty after the operation.
+    The behavior is undefined if getAllocator() != other.getAllocator(). For equivalent elements, the elements of *this precede the elements of other.
+    @param other another container to merge
+    */
+    CXX14_CONSTEXPR void merge(List& other)
+    {
+        merge(other, [](const value_type& lhs, const value_type& rhs) { return lhs < rhs; });
+    }
+    
+    /**
+    @brief merges two sorted lists
+    Merges the sorted list other into *this using the given comparison function. The lists should be sorted into ascending order.
+    No elements are copied, the nodes of other are relinked into *this. The container other becomes empty after the operation.
+    The behavior is undefined if getAllocator() != other.getAllocator(). For equivalent elements, the elements of *this precede the elements of other.
+    @param other another container to merge
+    @param comp comparison function object which returns true if the first argument is less than the second one
+    */
+    template <typename Compare>
+    CXX14_CONSTEXPR void merge(List& other, Compare comp)
+    {
+        if (this != &other)
+        {
+            NodeBase* otherHead = other.detach();
+            other.init();
+            relink(listHelper::merge<Node>(detach(), otherHead, comp));
+        }
+    }
+    
+    /**
+    @brief moves elements from another list
+    Moves all elements from other into *this. The elements are inserted before the element pointed to by pos. The container other becomes empty after the operation.
+    No elements are copied and the operation takes constant time. The behavior is undefined if getAllocator() != other.getAllocator() or if other refers to the same object as *this.
+    No iterators or references become invalidated, the iterators to the moved elements now refer into *this, not into other.
+    @param pos element before which the content will be inserted
+    @param other another container to move the content from
+    */
+    CXX14_CONSTEXPR void splice(const_iterator pos, List& other)
+    {
+        splice(pos, other, other.cbegin(), other.cend());
+    }
+    
+    /**
+    @brief moves elements from another list
+    Moves the element pointed to by it from other into *this. The element is inserted before the element pointed to by pos.
+    No elements are copied and the operation takes constant time. The behavior is undefined if getAllocator() != other.getAllocator().
+    other may refer to the same object as *this.
+    @param pos element before which the content will be inserted
+    @param other another container to move the content from
+    @param it the element to move from other to *this
+    */
+    CXX14_CONSTEXPR void splice(const_iterator pos, List& other, const_iterator it)
+    {
+        const_iterator next = it;
+        ++next;
+        splice(pos, other, it, next);
+    }
+    
+    /**
+    @brief moves elements from another list
+    Moves the elements in the range [first, last) from other into *this. The elements are inserted before the element pointed to by pos.
+    No elements are copied and the operation takes constant time. The behavior is undefined if getAllocator() != other.getAllocator() or if pos is an iterator in the range [first,last).
+    other may refer to the same object as *this.
+    @param pos element before which the content will be inserted
+    @param other another container to move the content from
+    @param first, last the range of elements to move from other to *this
+    */
+    CXX14_CONSTEXPR void splice(const_iterator pos, List& other, const_iterator first, const_iterator last)
+    {
+        (void)other;
+        transfer(pos.m_node, first.m_node, last.m_node);
+    }
+    
+    private:
+    
     // List node class
     struct Node : public NodeBase
     {
@@ -926,19 +1019,6 @@ class List
         value_type m_data;
     };
     
-    CXX14_CONSTEXPR void init()
-    {
-        // Link front and back node
-        link(m_front, m_back);
-    }
-    
-    constexpr static void link(NodeBase& prev, NodeBase& next)
-    {
-        // Link two nodes of the list
-        prev.m_next = &next;
-        next.m_prev = &prev;
-    }
-
     constexpr void deleteNode(Node* node)
     {
         node->~Node();
@@ -951,8 +1031,6 @@ class List
     }
 
     Allocator m_allocator;
-    NodeBase m_front;
-    NodeBase m_back;
 };
 
 #endif
\ No newline at end of file
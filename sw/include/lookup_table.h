@@ -124,4 +124,94 @@ class SparseLUT
     Elem m_data[static_cast<IntIdx>(t_length)];   
 };
 
+template <typename Generator>
+class PgmSparseLUTStorage;
+
+/**
+@brief Read-only view of a SparseLUT stored in PROGMEM
+Objects of this class are created by makePgmLUT() only, so the referenced table is guaranteed to be stored in PROGMEM.
+@tparam Elem Type of elements stored in the table
+@tparam Idx Index type used when accessing the table
+@tparam t_length number of elements stored in the table
+*/
+template <typename Elem, typename Idx, Idx t_length>
+class PgmSparseLUT
+{
+    public:
+    
+    /**
+    @brief Read table entry from PROGMEM
+    @param idx Index of element to read
+    @result Copy of the element
+    */
+    Elem operator() (const Idx idx) const
+    {
+        return m_lut->getP(idx);
+    }
+    
+    /**
+    @brief Returns the number of elements
+    @result Number of elements stored in the table
+    */
+    static constexpr Idx size()
+    {
+        return t_length;
+    }
+    
+    private:
+    
+    template <typename Generator>
+    friend class PgmSparseLUTStorage;
+    
+    constexpr explicit PgmSparseLUT(const SparseLUT<Elem, Idx, t_length>* lut) : m_lut(lut)
+    {}
+    
+    const SparseLUT<Elem, Idx, t_length>* m_lut;
+};
+
+/**
+@brief Storage of a SparseLUT generated at compile time in PROGMEM
+@tparam Generator Type of the generator
+*/
+template <typename Generator>
+class PgmSparseLUTStorage
+{
+    public:
+    
+    PgmSparseLUTStorage() = delete;
+    
+    static constexpr auto view()
+    {
+        return makeView(&s_lut);
+    }
+    
+    private:
+    
+    template <typename Elem, typename Idx, Idx t_length>
+    static constexpr PgmSparseLUT<Elem, Idx, t_length> makeView(const SparseLUT<Elem, Idx, t_length>* lut)
+    {
+        return PgmSparseLUT<Elem, Idx, t_length>(lut);
+    }
+    
+    // Compile-time constant table stored in PROGMEM
+    static constexpr decltype(Generator()()) s_lut PROGMEM = Generator()();
+};
+
+/**
+@brief Create a SparseLUT at compile time and place it in PROGMEM
+The generator is a captureless lambda returning a SparseLUT. It is only evaluated at compile time, so the table neither uses RAM nor static initialization code,
+and the returned view always reads from PROGMEM:
+@code
+constexpr auto lut = makePgmLUT([]{ return SparseLUT<uint8_t, uint8_t, 128>(0xFF, Pair<uint8_t, uint8_t>(1, 1), Pair<uint8_t, uint8_t>(64, 2)); });
+const uint8_t value = lut(64);
+@endcode
+@tparam Generator Type of the generator
+@result PgmSparseLUT referring to the generated table in PROGMEM
+*/
+template <typename Generator>
+constexpr auto makePgmLUT(Generator)
+{
+    return PgmSparseLUTStorage<Generator>::view();
+}
+
 #endif
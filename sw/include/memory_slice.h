@@ -19,6 +19,7 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #define MEMORY_SLICE_H
 
 #include <stdint.h>
+#include <span.h>
 
 /**
 @brief Driver for SPI EEPROM 25AA512/25LC512
@@ -67,6 +68,17 @@ class MemorySlice
         Memory::write(address + t_offsetBytes, data, nofBytes);
     }
 
+    /**
+    @brief Write multiple Bytes to EEPROM starting at given position
+    @param pos Position of first byte in EEPROM (0..65535)
+    @param data Span of Bytes to be written to EEPROM
+    */
+    static void write(const Address address, const ConstSpan<uint8_t> data)
+    {
+        check();
+        Memory::write(address + t_offsetBytes, data.data(), data.size());
+    }
+
     /**
     @brief Write multiple Bytes to EEPROM starting at given position
     @param pos Position of first byte in EEPROM (0..65535)
@@ -116,6 +128,17 @@ class MemorySlice
         check();
         Memory::read(address + t_offsetBytes, data, nofBytes);
     }
+
+    /**
+    @brief Read multiple Bytes from EEPROM starting at given position
+    @param pos Position of first byte in EEPROM (0..65535)
+    @param data Span of receive buffer. The number of Bytes read equals the size of the span
+    */
+    static void read(const Address address, const Span<uint8_t> data)
+    {
+        check();
+        Memory::read(address + t_offsetBytes, data.data(), data.size());
+    }
     
     private:
     
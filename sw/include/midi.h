@@ -0,0 +1,554 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef MIDI_H
+#define MIDI_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <span.h>
+#include <bits/byte_stream.h>
+
+/**
+@brief MIDI status bytes. For channel messages, the lower nibble holds the channel.
+*/
+enum class MidiStatus : uint8_t
+{
+    noteOff         = 0x80,
+    noteOn          = 0x90,
+    polyPressure    = 0xA0,
+    controlChange   = 0xB0,
+    programChange   = 0xC0,
+    channelPressure = 0xD0,
+    pitchBend       = 0xE0,
+    sysExStart      = 0xF0,
+    timeCode        = 0xF1,
+    songPosition    = 0xF2,
+    songSelect      = 0xF3,
+    tuneRequest     = 0xF6,
+    sysExEnd        = 0xF7,
+    clock           = 0xF8,
+    start           = 0xFA,
+    resume          = 0xFB,
+    stop            = 0xFC,
+    activeSensing   = 0xFE,
+    reset           = 0xFF
+};
+
+/**
+@brief Decoded MIDI channel or system common message
+*/
+struct MidiMessage
+{
+    uint8_t status;
+    uint8_t data1;
+    uint8_t data2;
+    
+    /**
+    @brief Get the message type, i.e. the status without the channel for channel messages
+    @result Message type
+    */
+    constexpr MidiStatus getType() const
+    {
+        return static_cast<MidiStatus>(status < 0xF0 ? status & 0xF0 : status);
+    }
+    
+    /**
+    @brief Get the channel of a channel message
+    @result Channel (0..15)
+    */
+    constexpr uint8_t getChannel() const
+    {
+        return status & 0x0F;
+    }
+    
+    /**
+    @brief Get the number of data bytes of a message with the given status
+    @param status Status byte
+    @result Number of data bytes
+    */
+    static constexpr uint8_t getNofDataBytes(const uint8_t status)
+    {
+        switch (status & 0xF0)
+        {
+            case 0xC0:
+            case 0xD0:
+            return 1;
+            
+            case 0xF0:
+            switch (status)
+            {
+                case 0xF1:
+                case 0xF3:
+                return 1;
+                
+                case 0xF2:
+                return 2;
+                
+                default:
+                return 0;
+            }
+            
+            default:
+            return 2;
+        }
+    }
+};
+
+/**
+@brief Default handlers of a MIDI parser, ignoring all messages
+Handlers are static methods resolved at compile time: Derive a handler class from MidiHandlers and hide the methods for the messages to be handled.
+Calls are direct (and can be inlined), and the default handlers compile into nothing.
+@code
+struct Handlers : MidiHandlers
+{
+    static void noteOn(uint8_t channel, uint8_t note, uint8_t velocity);
+    static void realtime(MidiStatus status);
+};
+MidiParser<Handlers> parser(sysExBuffer);
+@endcode
+*/
+struct MidiHandlers
+{
+    /// @brief Called for every channel and system common message in addition to the specific handler, e.g. for MIDI thru
+    static void message(const MidiMessage&)
+    {}
+    
+    /// @brief Note on with velocity > 0
+    static void noteOn(uint8_t, uint8_t, uint8_t)
+    {}
+    
+    /// @brief Note off, including note on with velocity 0
+    static void noteOff(uint8_t, uint8_t, uint8_t)
+    {}
+    
+    static void polyPressure(uint8_t, uint8_t, uint8_t)
+    {}
+    
+    static void controlChange(uint8_t, uint8_t, uint8_t)
+    {}
+    
+    static void programChange(uint8_t, uint8_t)
+    {}
+    
+    static void channelPressure(uint8_t, uint8_t)
+    {}
+    
+    /// @brief Pitch bend, value in range -8192..8191
+    static void pitchBend(uint8_t, int16_t)
+    {}
+    
+    /// @brief System common messages (MTC quarter frame, song position, song select, tune request)
+    static void systemCommon(const MidiMessage&)
+    {}
+    
+    /// @brief System realtime messages. Called immediately, also if received in the middle of another message.
+    static void realtime(MidiStatus)
+    {}
+    
+    /**
+    @brief System exclusive data, excluding 0xF0 and 0xF7
+    Called whenever the SysEx buffer is full (complete == false) and at the end of the message (complete == true).
+    */
+    static void sysEx(ConstSpan<uint8_t>, bool)
+    {}
+};
+
+/**
+@brief MIDI stream parser
+Bytes are parsed one at a time, from a span, or in batches from a receive ring buffer filled by the USART receive interrupt.
+The parser supports running status and realtime messages interleaved anywhere in the stream.
+Channel messages are decoded in place without buffering. SysEx data is streamed into a caller-provided buffer and passed on in chunks,
+so SysEx messages of arbitrary length can be received with a small buffer.
+@tparam Handlers Handler class derived from MidiHandlers
+*/
+template <typename Handlers>
+class MidiParser : public byteStreamHelper::ByteParser<MidiParser<Handlers>>
+{
+    public:
+    
+    /**
+    @brief Constructor
+    @param sysExBuffer Buffer for SysEx data. May be empty if SysEx messages are not handled.
+    */
+    constexpr explicit MidiParser(const Span<uint8_t> sysExBuffer = Span<uint8_t>()) : m_sysExBuffer(sysExBuffer)
+    {}
+    
+    /// @brief Parse a sequence of bytes, see byteStreamHelper::ByteParser
+    using byteStreamHelper::ByteParser<MidiParser>::parse;
+    
+    /**
+    @brief Parse a single byte
+    @param data Received byte
+    */
+    void parse(const uint8_t data)
+    {
+        // Realtime messages do not affect the parser state
+        if (data >= 0xF8)
+        {
+            Handlers::realtime(static_cast<MidiStatus>(data));
+            return;
+        }
+        
+        if (data & 0x80)
+        {
+            parseStatus(data);
+            return;
+        }
+        
+        // Data byte
+        if (s_sysExStatus == m_status)
+        {
+            putSysEx(data);
+        }
+        else if (0 != m_status)
+        {
+            m_data[m_count++] = data;
+            if (m_count == m_nofDataBytes)
+            {
+                dispatch();
+                m_count = 0;
+                
+                // Running status only applies to channel messages
+                if (m_status >= 0xF0)
+                {
+                    m_status = 0;
+                }
+            }
+        }
+        
+        // Data bytes without status are ignored
+    }
+    
+    /**
+    @brief Reset the parser, e.g. after a receive error. Pending SysEx data is discarded.
+    */
+    void reset()
+    {
+        m_status = 0;
+        m_count = 0;
+        m_sysExSize = 0;
+    }
+    
+    private:
+    
+    static constexpr uint8_t s_sysExStatus = static_cast<uint8_t>(MidiStatus::sysExStart);
+    
+    void parseStatus(const uint8_t status)
+    {
+        // Any status byte terminates SysEx
+        if (s_sysExStatus == m_status)
+        {
+            flushSysEx(true);
+        }
+        
+        m_count = 0;
+        if (status == static_cast<uint8_t>(MidiStatus::sysExEnd) || 0xF4 == status || 0xF5 == status)
+        {
+            m_status = 0;
+            return;
+        }
+        
+        m_status = status;
+        m_nofDataBytes = MidiMessage::getNofDataBytes(status);
+        m_data[0] = 0;
+        m_data[1] = 0;
+        if (0 == m_nofDataBytes && s_sysExStatus != status)
+        {
+            // Tune request
+            dispatch();
+            m_status = 0;
+        }
+    }
+    
+    void putSysEx(const uint8_t data)
+    {
+        if (m_sysExBuffer.empty())
+        {
+            return;
+        }
+        if (m_sysExSize == m_sysExBuffer.size())
+        {
+            flushSysEx(false);
+        }
+        m_sysExBuffer[m_sysExSize++] = data;
+    }
+    
+    void flushSysEx(const bool complete)
+    {
+        Handlers::sysEx(ConstSpan<uint8_t>(m_sysExBuffer.data(), m_sysExSize), complete);
+        m_sysExSize = 0;
+    }
+    
+    void dispatch() const
+    {
+        const MidiMessage message = {m_status, m_data[0], m_data[1]};
+        Handlers::message(message);
+        
+        const uint8_t channel = message.getChannel();
+        switch (message.getType())
+        {
+            case MidiStatus::noteOn:
+            if (0 != message.data2)
+            {
+                Handlers::noteOn(channel, message.data1, message.data2);
+                break;
+            }
+            
+            // Note on with velocity 0 is note off
+            [[fallthrough]];
+            
+            case MidiStatus::noteOff:
+            Handlers::noteOff(channel, message.data1, message.data2);
+            break;
+            
+            case MidiStatus::polyPressure:
+            Handlers::polyPressure(channel, message.data1, message.data2);
+            break;
+            
+            case MidiStatus::controlChange:
+            Handlers::controlChange(channel, message.data1, message.data2);
+            break;
+            
+            case MidiStatus::programChange:
+            Handlers::programChange(channel, message.data1);
+            break;
+            
+            case MidiStatus::channelPressure:
+            Handlers::channelPressure(channel, message.data1);
+            break;
+            
+            case MidiStatus::pitchBend:
+            Handlers::pitchBend(channel, static_cast<int16_t>((message.data2 << 7) | message.data1) - 8192);
+            break;
+            
+            default:
+            Handlers::systemCommon(message);
+            break;
+        }
+    }
+    
+    Span<uint8_t> m_sysExBuffer;
+    size_t m_sysExSize = 0;
+    
+    // Current (running) status, 0 if none
+    uint8_t m_status = 0;
+    uint8_t m_nofDataBytes = 0;
+    uint8_t m_count = 0;
+    uint8_t m_data[2] = {};
+};
+
+/**
+@brief MIDI encoder writing messages to a transmit buffer, e.g. BufferedUSART
+Consecutive channel messages with the same status are sent using running status, i.e. the status byte is omitted.
+Messages are enqueued completely or not at all, so a full transmit buffer never corrupts the stream.
+@tparam TX Transmitter class providing the static methods
+bool put(const uint8_t data)
+size_t put(const ConstSpan<uint8_t> data)
+size_t getNofFreeBytes()
+@tparam t_noteOffAsNoteOn Send note off as note on with velocity 0, which allows for running status over sequences of note on and note off messages
+*/
+template <typename TX, bool t_noteOffAsNoteOn = false>
+class MidiEncoder
+{
+    public:
+    
+    /**
+    @brief Send note on message
+    @param channel Channel
+    @param note Note number
+    @param velocity Velocity
+    @result true if the message has been enqueued
+    */
+    static bool noteOn(const uint8_t channel, const uint8_t note, const uint8_t velocity)
+    {
+        return put(MidiStatus::noteOn, channel, note, velocity);
+    }
+    
+    /**
+    @brief Send note off message
+    @param channel Channel
+    @param note Note number
+    @param velocity Release velocity, ignored if t_noteOffAsNoteOn is set
+    @result true if the message has been enqueued
+    */
+    static bool noteOff(const uint8_t channel, const uint8_t note, const uint8_t velocity = 0)
+    {
+        if CXX17_CONSTEXPR(t_noteOffAsNoteOn)
+        {
+            return put(MidiStatus::noteOn, channel, note, 0);
+        }
+        else
+        {
+            return put(MidiStatus::noteOff, channel, note, velocity);
+        }
+    }
+    
+    /**
+    @brief Send polyphonic key pressure message
+    @param channel Channel
+    @param note Note number
+    @param pressure Pressure
+    @result true if the message has been enqueued
+    */
+    static bool polyPressure(const uint8_t channel, const uint8_t note, const uint8_t pressure)
+    {
+        return put(MidiStatus::polyPressure, channel, note, pressure);
+    }
+    
+    /**
+    @brief Send control change message
+    @param channel Channel
+    @param controller Controller number
+    @param value Controller value
+    @result true if the message has been enqueued
+    */
+    static bool controlChange(const uint8_t channel, const uint8_t controller, const uint8_t value)
+    {
+        return put(MidiStatus::controlChange, channel, controller, value);
+    }
+    
+    /**
+    @brief Send program change message
+    @param channel Channel
+    @param program Program number
+    @result true if the message has been enqueued
+    */
+    static bool programChange(const uint8_t channel, const uint8_t program)
+    {
+        return put(MidiStatus::programChange, channel, program, 0);
+    }
+    
+    /**
+    @brief Send channel pressure message
+    @param channel Channel
+    @param pressure Pressure
+    @result true if the message has been enqueued
+    */
+    static bool channelPressure(const uint8_t channel, const uint8_t pressure)
+    {
+        return put(MidiStatus::channelPressure, channel, pressure, 0);
+    }
+    
+    /**
+    @brief Send pitch bend message
+    @param channel Channel
+    @param value Pitch bend value in range -8192..8191
+    @result true if the message has been enqueued
+    */
+    static bool pitchBend(const uint8_t channel, const int16_t value)
+    {
+        const uint16_t raw = static_cast<uint16_t>(value + 8192);
+        return put(MidiStatus::pitchBend, channel, raw & 0x7F, raw >> 7);
+    }
+    
+    /**
+    @brief Send a channel or system common message
+    @param message Message
+    @result true if the message has been enqueued
+    */
+    static bool put(const MidiMessage& message)
+    {
+        const uint8_t nofDataBytes = MidiMessage::getNofDataBytes(message.status);
+        uint8_t buffer[3];
+        uint8_t size = 0;
+        if (message.status != s_runningStatus)
+        {
+            buffer[size++] = message.status;
+        }
+        if (nofDataBytes > 0)
+        {
+            buffer[size++] = message.data1 & 0x7F;
+        }
+        if (nofDataBytes > 1)
+        {
+            buffer[size++] = message.data2 & 0x7F;
+        }
+        
+        if (TX::getNofFreeBytes() < size)
+        {
+            return false;
+        }
+        TX::put(ConstSpan<uint8_t>(buffer, size));
+        
+        // System common messages cancel running status
+        s_runningStatus = message.status < 0xF0 ? message.status : 0;
+        return true;
+    }
+    
+    /**
+    @brief Send a realtime message. Running status is not affected.
+    @param status Realtime status
+    @result true if the message has been enqueued
+    */
+    static bool realtime(const MidiStatus status)
+    {
+        return TX::put(static_cast<uint8_t>(status));
+    }
+    
+    /**
+    @brief Send a SysEx message
+    @param data SysEx data, excluding 0xF0 and 0xF7
+    @result true if the message has been enqueued, false if the buffer is full or a data byte has bit 7 set
+    */
+    static bool sysEx(const ConstSpan<uint8_t> data)
+    {
+        if (TX::getNofFreeBytes() < data.size() + 2)
+        {
+            return false;
+        }
+        
+        // A data byte with bit 7 set would be received as status byte and terminate the message
+        for (const uint8_t byte : data)
+        {
+            if (byte & 0x80)
+            {
+                return false;
+            }
+        }
+        TX::put(static_cast<uint8_t>(MidiStatus::sysExStart));
+        TX::put(data);
+        TX::put(static_cast<uint8_t>(MidiStatus::sysExEnd));
+        s_runningStatus = 0;
+        return true;
+    }
+    
+    /**
+    @brief Send the status byte with the next channel message, e.g. periodically to allow receivers to synchronize
+    */
+    static void resetRunningStatus()
+    {
+        s_runningStatus = 0;
+    }
+    
+    private:
+    
+    static bool put(const MidiStatus type, const uint8_t channel, const uint8_t data1, const uint8_t data2)
+    {
+        return put(MidiMessage{static_cast<uint8_t>(static_cast<uint8_t>(type) | (channel & 0x0F)), data1, data2});
+    }
+    
+    static uint8_t s_runningStatus;
+};
+
+// Static initialization
+template <typename TX, bool t_noteOffAsNoteOn>
+uint8_t MidiEncoder<TX, t_noteOffAsNoteOn>::s_runningStatus = 0;
+
+#endif
@@ -0,0 +1,361 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef MODULATION_BANK_H
+#define MODULATION_BANK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <array.h>
+#include <bool_array.h>
+#include <param.h>
+
+/**
+@brief Waveform of a modulator
+*/
+enum class ModulatorMode : uint8_t
+{
+    envelope,
+    triangle,
+    saw,
+    square
+};
+
+/**
+@brief Bank of ADSR envelopes and LFOs, updated in a single pass per control tick and published into Param values
+Every modulator is a sequence of linear segments of a 16-bit level. The state of all modulators is stored as a structure of arrays:
+the loop in tick() only reads the level, step, rate and remaining distance of each modulator and compares two values. Stage transitions
+(e.g. attack to decay, or the turning point of a triangle LFO) are the only branch taken out of the loop and read the configuration
+of the modulator, which is stored per modulator since it is not touched on every tick.
+Modulators whose level changed are marked in a dirty mask, and publish() writes only those into their target Param:
+@code
+ModulationBank<16> modulation;
+modulation.setTarget(0, &s_cutoff);
+modulation.setEnvelope(0, 2000, 300, 0x8000, 100);
+modulation.gate(0, true);
+...
+// Control rate timer, e.g. 1 kHz
+modulation.tick();
+modulation.publish();
+@endcode
+Rates are given as level change per tick with full scale 0xFFFF, e.g. an attack rate of 0xFFFF / 1000 reaches the peak in 1000 ticks.
+An envelope rate of 0 jumps to the end of the segment on the next tick.
+An LFO with rate r has a period of about 2 * 0xFFFF / r ticks for all waveforms.
+@tparam t_nofModulators Number of modulators
+@tparam Value Value type of the target parameters, default is uint8_t. The upper bits of the 16-bit level are published.
+*/
+template <uint8_t t_nofModulators, typename Value = uint8_t>
+class ModulationBank
+{
+    static_assert(t_nofModulators > 0, "Number of modulators must not be zero");
+    static_assert(sizeof(Value) <= 2, "Value type must not exceed 16 bits");
+
+    public:
+
+    /// @brief Maximum level
+    static constexpr uint16_t s_maxLevel = 0xFFFF;
+
+    /**
+    @brief Set the parameter a modulator publishes into
+    @param idx Modulator index
+    @param target Target parameter, or nullptr to disable publishing
+    */
+    void setTarget(const uint8_t idx, Param<Value>* const target)
+    {
+        m_target[idx] = target;
+        m_dirty.set(idx);
+    }
+
+    /**
+    @brief Configure a modulator as ADSR envelope. The envelope stays idle at level 0 until gate() is called.
+    @param idx Modulator index
+    @param attack Attack rate
+    @param decay Decay rate
+    @param sustain Sustain level
+    @param release Release rate
+    */
+    void setEnvelope(const uint8_t idx, const uint16_t attack, const uint16_t decay, const uint16_t sustain, const uint16_t release)
+    {
+        m_config[idx] = Config{ModulatorMode::envelope, Stage::idle, attack, decay, sustain, release};
+        m_level[idx] = 0;
+        m_dirty.set(idx);
+        hold(idx);
+    }
+
+    /**
+    @brief Configure a modulator as free-running LFO starting at level 0
+    @param idx Modulator index
+    @param mode LFO waveform, i.e. ModulatorMode::triangle, ModulatorMode::saw or ModulatorMode::square
+    @param rate Rate, see class description. Rate 0 stops the LFO.
+    */
+    void setLFO(const uint8_t idx, const ModulatorMode mode, const uint16_t rate)
+    {
+        m_config[idx] = Config{mode, Stage::rise, rate, rate, 0, 0};
+        m_level[idx] = 0;
+        m_dirty.set(idx);
+        startStage(idx);
+    }
+
+    /**
+    @brief Change the rate of an LFO. The current segment keeps its rate, unless the LFO is stopped or started.
+    @param idx Modulator index
+    @param rate New rate, 0 stops the LFO at its current level
+    */
+    void setRate(const uint8_t idx, const uint16_t rate)
+    {
+        Config& config = m_config[idx];
+        const bool stopped = 0 == config.rise;
+        config.rise = rate;
+        config.fall = rate;
+        if (stopped || 0 == rate)
+        {
+            startStage(idx);
+        }
+    }
+
+    /**
+    @brief Open or close the gate of an envelope. The attack or release starts from the current level.
+    @param idx Modulator index
+    @param on true for note on, false for note off
+    */
+    void gate(const uint8_t idx, const bool on)
+    {
+        Config& config = m_config[idx];
+        if (on)
+        {
+            config.stage = Stage::rise;
+            startSegment(idx, s_maxLevel, config.rise);
+        }
+        else
+        {
+            config.stage = Stage::release;
+            startSegment(idx, 0, config.release);
+        }
+    }
+
+    /**
+    @brief Get the current level of a modulator
+    @param idx Modulator index
+    @result Level in range 0..s_maxLevel
+    */
+    uint16_t getLevel(const uint8_t idx) const
+    {
+        return m_level[idx];
+    }
+
+    /**
+    @brief Check if the level of a modulator changed since the last publish()
+    @param idx Modulator index
+    @result true if the modulator is dirty
+    */
+    bool isDirty(const uint8_t idx) const
+    {
+        return m_dirty[idx];
+    }
+
+    /**
+    @brief Advance all modulators by one control tick
+    */
+    void tick()
+    {
+        // Walk the dirty mask along with the modulators, avoiding variable shifts
+        uint8_t idx = 0;
+        for (uint8_t& dirty : m_dirty.data())
+        {
+            for (uint8_t mask = 1; 0 != mask && idx < t_nofModulators; mask <<= 1, ++idx)
+            {
+                const uint16_t rate = m_rate[idx];
+                const uint16_t remaining = m_remaining[idx];
+                if (remaining > rate)
+                {
+                    const uint16_t step = m_step[idx];
+                    m_remaining[idx] = remaining - rate;
+                    m_level[idx] += step;
+                    if (0 != step)
+                    {
+                        dirty |= mask;
+                    }
+                }
+                else
+                {
+                    m_level[idx] = m_end[idx];
+                    dirty |= mask;
+                    nextSegment(idx);
+                }
+            }
+        }
+    }
+
+    /**
+    @brief Write the levels of all dirty modulators into their target parameters and clear the dirty mask
+    */
+    void publish()
+    {
+        uint8_t idx = 0;
+        for (uint8_t& dirty : m_dirty.data())
+        {
+            if (0 == dirty)
+            {
+                // Skip groups of 8 clean modulators at once
+                idx += 8;
+                continue;
+            }
+
+            for (uint8_t mask = 1; 0 != mask && idx < t_nofModulators; mask <<= 1, ++idx)
+            {
+                if ((dirty & mask) && nullptr != m_target[idx])
+                {
+                    *m_target[idx] = static_cast<Value>(m_level[idx] >> (16 - 8 * sizeof(Value)));
+                }
+            }
+            dirty = 0;
+        }
+    }
+
+    private:
+
+    enum class Stage : uint8_t
+    {
+        idle,
+        rise,
+        fall,
+        sustain,
+        release
+    };
+
+    // Configuration, only accessed on stage transitions. LFOs use rise and fall as rate.
+    struct Config
+    {
+        ModulatorMode mode = ModulatorMode::envelope;
+        Stage stage = Stage::idle;
+        uint16_t rise = 0;
+        uint16_t fall = 0;
+        uint16_t sustain = 0;
+        uint16_t release = 0;
+    };
+
+    // Move linearly from the current level to the given end level
+    void startSegment(const uint8_t idx, const uint16_t end, const uint16_t rate)
+    {
+        // Rate 0 means jump to the end level on the next tick
+        const uint16_t level = m_level[idx];
+        m_end[idx] = end;
+        m_rate[idx] = rate;
+        m_remaining[idx] = 0 == rate ? 0 : (end > level ? end - level : level - end);
+        m_step[idx] = end > level ? rate : static_cast<uint16_t>(-rate);
+    }
+
+    // Keep the current level until the next stage is started from outside
+    void hold(const uint8_t idx)
+    {
+        m_end[idx] = m_level[idx];
+        m_rate[idx] = 0;
+        m_remaining[idx] = s_maxLevel;
+        m_step[idx] = 0;
+    }
+
+    // Keep the current level for 0xFFFF / rate ticks, then jump to the end level
+    void holdFor(const uint8_t idx, const uint16_t end, const uint16_t rate)
+    {
+        m_end[idx] = end;
+        m_rate[idx] = rate;
+        m_remaining[idx] = s_maxLevel;
+        m_step[idx] = 0;
+    }
+
+    // Start the segment of the current stage of an LFO
+    void startStage(const uint8_t idx)
+    {
+        const Config& config = m_config[idx];
+        if (0 == config.rise)
+        {
+            // Stopped LFO
+            hold(idx);
+            return;
+        }
+
+        const bool rising = Stage::rise == config.stage;
+        switch (config.mode)
+        {
+            case ModulatorMode::triangle:
+            startSegment(idx, rising ? s_maxLevel : 0, rising ? config.rise : config.fall);
+            break;
+
+            case ModulatorMode::saw:
+            // Ramp up at half the rate, then jump back to 0
+            startSegment(idx, s_maxLevel, config.rise > 1 ? config.rise >> 1 : 1);
+            m_end[idx] = 0;
+            break;
+
+            case ModulatorMode::square:
+            holdFor(idx, rising ? s_maxLevel : 0, config.rise);
+            break;
+
+            default:
+            break;
+        }
+    }
+
+    // Stage transition at the end of a segment
+    void nextSegment(const uint8_t idx)
+    {
+        Config& config = m_config[idx];
+        switch (config.mode)
+        {
+            case ModulatorMode::envelope:
+            if (Stage::rise == config.stage)
+            {
+                config.stage = Stage::fall;
+                startSegment(idx, config.sustain, config.fall);
+            }
+            else if (Stage::fall == config.stage)
+            {
+                config.stage = Stage::sustain;
+                hold(idx);
+            }
+            else
+            {
+                config.stage = Stage::idle;
+                hold(idx);
+            }
+            break;
+
+            case ModulatorMode::saw:
+            startStage(idx);
+            break;
+
+            default:
+            config.stage = Stage::rise == config.stage ? Stage::fall : Stage::rise;
+            startStage(idx);
+            break;
+        }
+    }
+
+    // Hot state, read on every tick
+    Array<uint16_t, t_nofModulators> m_level = {};
+    Array<uint16_t, t_nofModulators> m_step = {};
+    Array<uint16_t, t_nofModulators> m_rate = {};
+    Array<uint16_t, t_nofModulators> m_remaining = {};
+    Array<uint16_t, t_nofModulators> m_end = {};
+    BoolArray<t_nofModulators> m_dirty;
+
+    // Cold state, read on stage transitions and publish()
+    Array<Config, t_nofModulators> m_config = {};
+    Array<Param<Value>*, t_nofModulators> m_target = {};
+};
+
+#endif
@@ -25,9 +25,18 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <allocator.h>
 
+/**
+@brief Allocator used by operator new and operator delete
+Defaults to the internal SRAM heap. Define NEW_ALLOCATOR before including this file (or on the command line) to use another allocator,
+e.g. a RegionAllocator for external SRAM. Containers can still be placed into a specific region via their Allocator template parameter.
+*/
+#ifndef NEW_ALLOCATOR
+#define NEW_ALLOCATOR HeapAllocator<>
+#endif
+
 [[nodiscard]] inline void* operator new(const size_t size)
 {
-    void* ptr = HeapAllocator<>::allocate(size);
+    void* ptr = NEW_ALLOCATOR::allocate(size);
     if (!ptr)
     {
         // Handle out-of-memory condition
@@ -37,7 +46,7 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 [[nodiscard]] inline void* operator new[](const size_t size)
 {
-    void* ptr = HeapAllocator<>::allocate(size);
+    void* ptr = NEW_ALLOCATOR::allocate(size);
     if (!ptr)
     {
         // Handle out-of-memory condition
@@ -47,22 +56,22 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 inline void operator delete(void* ptr)
 {
-    HeapAllocator<>::deallocate(ptr);
+    NEW_ALLOCATOR::deallocate(ptr);
 }
 
 inline void operator delete[](void* ptr)
 {
-    HeapAllocator<>::deallocate(ptr);
+    NEW_ALLOCATOR::deallocate(ptr);
 }
 
 inline void operator delete(void* ptr, size_t)
 {
-    HeapAllocator<>::deallocate(ptr);
+    NEW_ALLOCATOR::deallocate(ptr);
 }
 
 inline void operator delete[](void* ptr, size_t)
 {
-    HeapAllocator<>::deallocate(ptr);
+    NEW_ALLOCATOR::deallocate(ptr);
 }
 
 #endif
\ No newline at end of file
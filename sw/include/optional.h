@@ -20,17 +20,175 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <bits/move.h>
+#include <bits/new.h>
+#include <type_traits.h>
 
 struct nullopt_t
 {};
     
 inline constexpr nullopt_t nullopt;
 
+/**
+@brief Niche policy encoding the empty state of an Optional as a sentinel value of the contained type
+The sentinel value itself can no longer be stored: An Optional holding the sentinel value is empty.
+A niche policy provides two static methods:
+- T empty() returns the value representing the empty state
+- bool isEmpty(const T&) checks if a value represents the empty state
+@tparam T Value type
+@tparam t_empty Sentinel value representing the empty state
+*/
+template <typename T, T t_empty>
+struct Sentinel
+{
+    static constexpr T empty()
+    {
+        return t_empty;
+    }
+    
+    static constexpr bool isEmpty(const T& value)
+    {
+        return t_empty == value;
+    }
+};
+
+/**
+@brief Niche policy for types without a niche. Optional stores a separate flag.
+*/
+struct NoNiche
+{};
+
+/**
+@brief Customization point selecting the default niche policy of Optional<T>
+Specialize this template to make Optional<T> use a sentinel value of T instead of a separate flag, e.g.
+@code
+template <>
+struct OptionalNiche<Note>
+{
+    using Type = Sentinel<Note, Note::none>;
+};
+@endcode
+@tparam T Value type
+*/
 template <typename T>
+struct OptionalNiche
+{
+    using Type = NoNiche;
+};
+
+/**
+@brief Default niche policy for pointers: nullptr represents the empty state
+*/
+template <typename T>
+struct OptionalNiche<T*>
+{
+    using Type = Sentinel<T*, nullptr>;
+};
+
+/**
+@brief Optional value using a niche of the value type to represent the empty state
+sizeof(Optional<T, Niche>) == sizeof(T), e.g. Optional<uint8_t, Sentinel<uint8_t, 0xFF>> uses a single byte.
+Assigning the sentinel value to the contained value makes the Optional empty.
+@tparam T Value type
+@tparam Niche Niche policy, see Sentinel
+*/
+template <typename T, typename Niche = typename OptionalNiche<T>::Type>
 class Optional
 {
     public:
     
+    constexpr Optional()
+    :
+    m_value(Niche::empty())
+    {}
+    
+    constexpr Optional(nullopt_t)
+    :
+    m_value(Niche::empty())
+    {}
+    
+    constexpr Optional(const T & value)
+    :
+    m_value(value)
+    {}
+    
+    constexpr Optional(T && value)
+    :
+    m_value(move(value))
+    {}
+    
+    constexpr Optional& operator=(nullopt_t)
+    {
+        reset();
+        return *this;
+    }
+    
+    constexpr Optional& operator=(const T & value)
+    {
+        m_value = value;
+        return *this;
+    }
+    
+    constexpr T & operator*()
+    {
+        return m_value;
+    }
+    
+    constexpr const T & operator*() const
+    {
+        return m_value;
+    }
+    
+    constexpr T * operator->()
+    {
+        return &m_value;
+    }
+    
+    constexpr const T * operator->() const
+    {
+        return &m_value;
+    }
+    
+    constexpr bool hasValue() const
+    {
+        return !Niche::isEmpty(m_value);
+    }
+    
+    constexpr explicit operator bool() const
+    {
+        return hasValue();
+    }
+    
+    constexpr T valueOr(const T & defaultValue) const
+    {
+        return hasValue() ? m_value : defaultValue;
+    }
+    
+    constexpr void reset()
+    {
+        m_value = Niche::empty();
+    }
+    
+    constexpr bool operator==(const Optional& other) const
+    {
+        // The empty state is a regular value of T
+        return m_value == other.m_value;
+    }
+    
+    private:
+    
+    T m_value;
+};
+
+/**
+@brief Optional value using a separate flag to represent the empty state
+@tparam T Value type
+*/
+template <typename T>
+class Optional<T, NoNiche>
+{
+    public:
+    
     constexpr Optional()
     :
     m_dummy(0),
@@ -43,8 +201,6 @@ class Optional
     m_hasValue(false)
     {}
     
-    
-    
     Optional(const T & value)
     :
     m_value(value),
@@ -53,28 +209,69 @@ class Optional
     
     Optional(T && value)
     :
-    m_value(forward<T>(value)),
+    m_value(move(value)),
     m_hasValue(true)
     {}
         
     Optional(const Optional& arg)
     :
-    m_value(arg.m_value),
-    m_hasValue(true)
-    {}
+    m_dummy(0),
+    m_hasValue(arg.m_hasValue)
+    {
+        if (m_hasValue)
+        {
+            new (&m_value) T(arg.m_value);
+        }
+    }
     
     Optional(Optional && arg)
     :
-    m_value(move(arg.m_value)),
-    m_hasValue(true)
-    {}
+    m_dummy(0),
+    m_hasValue(arg.m_hasValue)
+    {
+        if (m_hasValue)
+        {
+            new (&m_value) T(move(arg.m_value));
+        }
+    }
     
     ~Optional()
     {
-        if (m_hasValue)
+        reset();
+    }
+    
+    Optional& operator=(const Optional& arg)
+    {
+        if (this != &arg)
         {
-            m_value.~T();
+            reset();
+            if (arg.m_hasValue)
+            {
+                new (&m_value) T(arg.m_value);
+                m_hasValue = true;
+            }
         }
+        return *this;
+    }
+    
+    Optional& operator=(Optional && arg)
+    {
+        if (this != &arg)
+        {
+            reset();
+            if (arg.m_hasValue)
+            {
+                new (&m_value) T(move(arg.m_value));
+                m_hasValue = true;
+            }
+        }
+        return *this;
+    }
+    
+    Optional& operator=(nullopt_t)
+    {
+        reset();
+        return *this;
     }
     
     constexpr T & operator*()
@@ -87,11 +284,49 @@ class Optional
         return m_value;
     }
     
+    constexpr T * operator->()
+    {
+        return &m_value;
+    }
+    
+    constexpr const T * operator->() const
+    {
+        return &m_value;
+    }
+    
+    constexpr bool hasValue() const
+    {
+        return m_hasValue;
+    }
+    
     constexpr explicit operator bool() const
     {
         return m_hasValue;
     }
     
+    constexpr T valueOr(const T & defaultValue) const
+    {
+        return m_hasValue ? m_value : defaultValue;
+    }
+    
+    void reset()
+    {
+        if (m_hasValue)
+        {
+            m_value.~T();
+            m_hasValue = false;
+        }
+    }
+    
+    constexpr bool operator==(const Optional& other) const
+    {
+        if (m_hasValue != other.m_hasValue)
+        {
+            return false;
+        }
+        return !m_hasValue || m_value == other.m_value;
+    }
+    
     private:
     
      // char is the data type with the smallest possible memory consumption
@@ -103,11 +338,12 @@ class Optional
     };
     
     bool m_hasValue;
-};
+};
+
 template <typename T>
-inline constexpr Optional<T> makeOptional(T&& value)
+inline constexpr Optional<remove_cvref_t<T>> makeOptional(T&& value)
 {
-    return Optional<T>(forward<T>(value));
+    return Optional<remove_cvref_t<T>>(forward<T>(value));
 }
 
 template <typename T>
@@ -116,4 +352,4 @@ inline constexpr Optional<T> makeOptional(const T& value)
     return Optional<T>(value);
 }
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -0,0 +1,402 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OUTPUT_SHADOW_REGISTER_H
+#define OUTPUT_SHADOW_REGISTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <bool_array.h>
+
+/**
+@brief Output device policy for a chain of daisy-chained 74HC595 shift registers
+The whole chain is shifted in one SPI burst and latched by the rising edge of the latch pin (RCLK), so a shift register chain cannot be updated partially.
+Byte 0 of the output image is shifted out first, i.e. it ends up in the last register of the chain. With MSB first data order, bit n of each byte drives output Qn.
+@tparam SPIMaster Driver class for SPI master implementing static put() methods, e.g. SPIMasterSync
+@tparam LatchPin Driver class for the latch pin (RCLK) implementing static methods high() and low()
+*/
+template <typename SPIMaster, typename LatchPin>
+struct ShiftRegister74HC595
+{
+    /**
+    @brief Initialization. The latch pin must have been configured as output.
+    */
+    static void init()
+    {
+        LatchPin::low();
+    }
+    
+    /**
+    @brief Write the output image to the chain
+    @tparam DirtyMask Class implementing operator[] returning true for bytes which have changed since the last write
+    @param image Output image
+    @param nofBytes Number of bytes of the image, i.e. number of registers in the chain
+    @param dirty Changed bytes. Ignored since the whole chain is shifted.
+    */
+    template <typename DirtyMask>
+    static void write(const uint8_t * image, const uint8_t nofBytes, const DirtyMask& dirty)
+    {
+        (void)dirty;
+        SPIMaster::put(image, nofBytes);
+        LatchPin::high();
+        LatchPin::low();
+    }
+};
+
+/**
+@brief Output device policy for MCP23S17 port expanders sharing one slave select line
+Devices are selected by their hardware address (pins A2:A0), which is enabled by init(). Bytes 2n and 2n+1 of the output image are written
+to ports A and B of the device with hardware address n.
+Only ports which have changed are written. If both ports of a device have changed, they are written in one sequential transfer.
+@tparam SPIMaster Driver class for SPI master implementing static put() methods, e.g. SPIMasterSync
+@tparam SSPin Driver class for slave select pin implementing static methods high() and low()
+@tparam t_nofDevices Number of devices with hardware addresses 0..t_nofDevices-1
+*/
+template <typename SPIMaster, typename SSPin, uint8_t t_nofDevices = 1>
+struct MCP23S17Outputs
+{
+    static_assert(t_nofDevices > 0 && t_nofDevices <= 8, "Number of devices must be in range 1..8");
+    
+    /// @brief Register addresses in default bank mode (IOCON.BANK = 0)
+    enum class Register : uint8_t
+    {
+        IODIRA = 0x00,
+        IODIRB = 0x01,
+        IOCON = 0x0A,
+        OLATA = 0x14,
+        OLATB = 0x15
+    };
+    
+    /**
+    @brief Initialization. Enables hardware addressing and configures all pins as outputs.
+    */
+    static void init()
+    {
+        // Before hardware addressing is enabled, all devices respond to any address
+        writeRegisters(0, Register::IOCON, s_haen, s_haen);
+        for (uint8_t device = 0; device < t_nofDevices; ++device)
+        {
+            writeRegisters(device, Register::IODIRA, 0x00, 0x00);
+        }
+    }
+    
+    /**
+    @brief Write the changed bytes of the output image to the devices
+    @tparam DirtyMask Class implementing operator[] returning true for bytes which have changed since the last write
+    @param image Output image
+    @param nofBytes Number of bytes of the image, i.e. 2 * t_nofDevices
+    @param dirty Changed bytes
+    */
+    template <typename DirtyMask>
+    static void write(const uint8_t * image, const uint8_t nofBytes, const DirtyMask& dirty)
+    {
+        for (uint8_t idx = 0; idx < nofBytes; idx += 2)
+        {
+            const uint8_t device = idx >> 1;
+            const bool dirtyB = idx + 1 < nofBytes && dirty[idx + 1];
+            if (dirty[idx] && dirtyB)
+            {
+                writeRegisters(device, Register::OLATA, image[idx], image[idx + 1]);
+            }
+            else if (dirty[idx])
+            {
+                writeRegister(device, Register::OLATA, image[idx]);
+            }
+            else if (dirtyB)
+            {
+                writeRegister(device, Register::OLATB, image[idx + 1]);
+            }
+        }
+    }
+    
+    private:
+    
+    // IOCON.HAEN, hardware address enable
+    static constexpr uint8_t s_haen = 0x08;
+    
+    static constexpr uint8_t getOpcode(const uint8_t device)
+    {
+        return 0x40 | (device << 1);
+    }
+    
+    static void writeRegister(const uint8_t device, const Register reg, const uint8_t value)
+    {
+        const uint8_t data[] = {getOpcode(device), static_cast<uint8_t>(reg), value};
+        SSPin::low();
+        SPIMaster::put(data, static_cast<uint8_t>(sizeof(data)));
+        SSPin::high();
+    }
+    
+    // Write two consecutive registers using sequential operation (IOCON.SEQOP = 0)
+    static void writeRegisters(const uint8_t device, const Register reg, const uint8_t value0, const uint8_t value1)
+    {
+        const uint8_t data[] = {getOpcode(device), static_cast<uint8_t>(reg), value0, value1};
+        SSPin::low();
+        SPIMaster::put(data, static_cast<uint8_t>(sizeof(data)));
+        SSPin::high();
+    }
+};
+
+/**
+@brief Output device policy for individual pins, e.g. MuxPin or GPIO pin drivers
+Bit n of the output image drives the n-th pin. Only pins in changed bytes are written.
+@tparam Pins Driver classes for the output pins implementing static methods high() and low()
+*/
+template <typename ... Pins>
+struct PinOutputs
+{
+    /**
+    @brief Initialization. The pins must have been configured as outputs.
+    */
+    static void init()
+    {}
+    
+    /**
+    @brief Write the changed bytes of the output image to the pins
+    @tparam DirtyMask Class implementing operator[] returning true for bytes which have changed since the last write
+    @param image Output image
+    @param nofBytes Number of bytes of the image
+    @param dirty Changed bytes
+    */
+    template <typename DirtyMask>
+    static void write(const uint8_t * image, const uint8_t nofBytes, const DirtyMask& dirty)
+    {
+        (void)nofBytes;
+        uint8_t idx = 0;
+        (writePin<Pins>(image, dirty, idx++), ...);
+    }
+    
+    private:
+    
+    template <typename Pin, typename DirtyMask>
+    static void writePin(const uint8_t * image, const DirtyMask& dirty, const uint8_t idx)
+    {
+        if (dirty[idx >> 3])
+        {
+            if (image[idx >> 3] & (1 << (idx & 0b111)))
+            {
+                Pin::high();
+            }
+            else
+            {
+                Pin::low();
+            }
+        }
+    }
+};
+
+/**
+@brief Output shadow register for outputs of shift registers or port expanders
+Pin writes only change a bit image in RAM and mark the containing byte as changed. flush() then writes the changed bytes to the device in one burst,
+so updating many outputs costs a single bus transfer instead of one transfer per pin. Pins which are written without changing their level do not cause any bus traffic.
+Pins provide the static methods high() and low() like other pin drivers, so they can be used wherever a pin driver is expected:
+@code
+using LEDs = OutputShadowRegister<ShiftRegister74HC595<SPIMaster, LatchPin>, 32>;
+using LED0 = LEDs::Pin<0>;
+LED0::high();
+LEDs::flush();
+@endcode
+@note Pin writes and flush() are not atomic. If outputs are written from an interrupt, flush() must be called from the same interrupt or in an atomic block.
+@tparam Device Output device policy, e.g. ShiftRegister74HC595, MCP23S17Outputs or PinOutputs
+@tparam t_nofOutputs Number of outputs
+*/
+template <typename Device, uint8_t t_nofOutputs>
+class OutputShadowRegister
+{
+    public:
+    
+    /**
+    @brief Single output pin of the shadow register
+    @tparam t_idx Output index
+    */
+    template <uint8_t t_idx>
+    struct Pin
+    {
+        static_assert(t_idx < t_nofOutputs, "Output index out of range");
+        
+        /**
+        @brief Drive pin high with the next flush
+        */
+        static void high()
+        {
+            OutputShadowRegister::write(t_idx, true);
+        }
+        
+        /**
+        @brief Drive pin low with the next flush
+        */
+        static void low()
+        {
+            OutputShadowRegister::write(t_idx, false);
+        }
+        
+        /**
+        @brief Toggle pin with the next flush
+        */
+        static void toggle()
+        {
+            OutputShadowRegister::toggle(t_idx);
+        }
+        
+        /**
+        @brief Read the level the pin is driven to after the next flush
+        @result Pin level
+        */
+        static bool read()
+        {
+            return OutputShadowRegister::read(t_idx);
+        }
+    };
+    
+    /**
+    @brief Initialization of the device. All outputs are driven low.
+    */
+    static void init()
+    {
+        Device::init();
+        s_image.clearAll();
+        invalidate();
+        flush();
+    }
+    
+    /**
+    @brief Set the level of an output
+    @param idx Output index
+    @param value Output level
+    */
+    static void write(const uint8_t idx, const bool value)
+    {
+        if (s_image[idx] != value)
+        {
+            s_image.set(idx, value);
+            s_dirty.set(idx >> 3);
+        }
+    }
+    
+    /**
+    @brief Set the levels of 8 outputs at once
+    @param byteIdx Index of the byte containing outputs 8 * byteIdx .. 8 * byteIdx + 7
+    @param value Output levels
+    */
+    static void writeByte(const uint8_t byteIdx, const uint8_t value)
+    {
+        if (s_image.data()[byteIdx] != value)
+        {
+            s_image.data()[byteIdx] = value;
+            s_dirty.set(byteIdx);
+        }
+    }
+    
+    /**
+    @brief Toggle an output
+    @param idx Output index
+    */
+    static void toggle(const uint8_t idx)
+    {
+        s_image.toggle(idx);
+        s_dirty.set(idx >> 3);
+    }
+    
+    /**
+    @brief Read the level an output is driven to after the next flush
+    @param idx Output index
+    @result Output level
+    */
+    static bool read(const uint8_t idx)
+    {
+        return s_image[idx];
+    }
+    
+    /**
+    @brief Check if any output has changed since the last flush
+    @result true if a flush is pending
+    */
+    static bool isDirty()
+    {
+        for (const uint8_t dirty : s_dirty.data())
+        {
+            if (0 != dirty)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    /**
+    @brief Mark all outputs as changed, e.g. to restore the outputs after a reset of the device
+    */
+    static void invalidate()
+    {
+        s_dirty.setAll();
+    }
+    
+    /**
+    @brief Write all changed outputs to the device. Does nothing if no output has changed.
+    */
+    static void flush()
+    {
+        if (isDirty())
+        {
+            Device::write(s_image.data().data(), s_nofBytes, s_dirty);
+            s_dirty.clearAll();
+        }
+    }
+    
+    /**
+    @brief Schedule a flush unless one is already scheduled. Outputs changed until the flush is executed are written in the same burst.
+    @tparam SchedulerType Scheduler class, e.g. Scheduler. The task type must be constructible from a function pointer, e.g. function<void()>.
+    @tparam Delay Delay type of the scheduler
+    @param scheduler Scheduler
+    @param delay Delay of the flush in clock ticks of the scheduler
+    */
+    template <typename SchedulerType, typename Delay>
+    static void scheduleFlush(SchedulerType& scheduler, const Delay delay)
+    {
+        if (!s_flushScheduled)
+        {
+            s_flushScheduled = true;
+            scheduler.schedule(&scheduledFlush, delay);
+        }
+    }
+    
+    private:
+    
+    static constexpr uint8_t s_nofBytes = (t_nofOutputs + 7) >> 3;
+    
+    static void scheduledFlush()
+    {
+        s_flushScheduled = false;
+        flush();
+    }
+    
+    static BoolArray<t_nofOutputs> s_image;
+    static BoolArray<s_nofBytes> s_dirty;
+    static bool s_flushScheduled;
+};
+
+// Static initialization
+template <typename Device, uint8_t t_nofOutputs>
+BoolArray<t_nofOutputs> OutputShadowRegister<Device, t_nofOutputs>::s_image;
+
+template <typename Device, uint8_t t_nofOutputs>
+BoolArray<OutputShadowRegister<Device, t_nofOutputs>::s_nofBytes> OutputShadowRegister<Device, t_nofOutputs>::s_dirty(true);
+
+template <typename Device, uint8_t t_nofOutputs>
+bool OutputShadowRegister<Device, t_nofOutputs>::s_flushScheduled = false;
+
+#endif
@@ -0,0 +1,369 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef PACKED_ARRAY_H
+#define PACKED_ARRAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits.h>
+#include <array.h>
+
+/**
+@brief Fixed-size array of values with a width of less than 8 bits, stored densely
+Like BoolArray, but for values of 1..8 bits. Element 0 is stored in the least significant bits of the first byte.
+If t_bits divides 8 (1, 2, 4, 8 bits), no element straddles a byte boundary and access compiles into a shift and a mask.
+Otherwise, elements may span two bytes.
+Elements are accessed by value or by proxy references, since a reference to a sub-byte element cannot exist.
+@tparam t_bits Number of bits per element (1..8)
+@tparam t_length Number of elements
+@tparam T Element type, default is uint8_t. Enumeration types are supported as long as all values fit into t_bits
+*/
+template <uint8_t t_bits, size_t t_length, typename T = uint8_t>
+class PackedArray
+{
+    static_assert(t_bits > 0 && t_bits <= 8, "Number of bits per element must be in range 1..8");
+    static_assert(static_cast<uint32_t>(t_bits) * t_length <= 0xFFFF, "Bit offsets must fit into uint16_t");
+
+    public:
+
+    class Reference;
+    class ConstIterator;
+
+    using value_type     = T;
+    using size_type      = typename DownCast<t_length>::type;
+    using reference      = Reference;
+    using const_iterator = ConstIterator;
+
+    /**
+    @brief Proxy reference to a single element
+    */
+    class Reference
+    {
+        friend class PackedArray;
+
+        constexpr Reference(PackedArray& array, const size_type idx) : m_array(array), m_idx(idx)
+        {}
+
+        public:
+
+        constexpr Reference(const Reference&) = default;
+
+        constexpr operator value_type() const
+        {
+            return m_array.get(m_idx);
+        }
+
+        constexpr Reference& operator=(const value_type value)
+        {
+            m_array.set(m_idx, value);
+            return *this;
+        }
+
+        constexpr Reference& operator=(const Reference& other)
+        {
+            m_array.set(m_idx, static_cast<value_type>(other));
+            return *this;
+        }
+
+        private:
+
+        PackedArray& m_array;
+        const size_type m_idx;
+    };
+
+    /**
+    @brief Read-only iterator returning elements by value
+    */
+    class ConstIterator
+    {
+        friend class PackedArray;
+
+        constexpr ConstIterator(const PackedArray& array, const size_type idx) : m_array(array), m_idx(idx)
+        {}
+
+        public:
+
+        constexpr ConstIterator& operator++()
+        {
+            ++m_idx;
+            return *this;
+        }
+
+        constexpr value_type operator*() const
+        {
+            return m_array.get(m_idx);
+        }
+
+        constexpr bool operator!=(const ConstIterator& other) const
+        {
+            return m_idx != other.m_idx;
+        }
+
+        private:
+
+        const PackedArray& m_array;
+        size_type m_idx;
+    };
+
+    /**
+    @brief Constructor. All elements are initialized with the given value
+    @param value Initial value of all elements
+    */
+    constexpr explicit PackedArray(const value_type value = value_type())
+    {
+        fill(value);
+    }
+
+    /**
+    @brief Read element at given position. No bounds checking is performed.
+    @param idx Position of the element
+    @result Value of the element
+    */
+    constexpr value_type get(const size_type idx) const
+    {
+        const uint16_t bitOffset = static_cast<uint16_t>(idx) * t_bits;
+        const size_type byteIdx = bitOffset >> 3;
+        const uint8_t shift = bitOffset & 0b111;
+
+        if CXX17_CONSTEXPR(isAligned())
+        {
+            return static_cast<value_type>((m_data[byteIdx] >> shift) & s_mask);
+        }
+        else
+        {
+            uint16_t window = m_data[byteIdx];
+            if (shift + t_bits > 8)
+            {
+                window |= static_cast<uint16_t>(m_data[byteIdx + 1]) << 8;
+            }
+            return static_cast<value_type>((window >> shift) & s_mask);
+        }
+    }
+
+    /**
+    @brief Write element at given position. No bounds checking is performed.
+    Bits of the value exceeding the element width are ignored.
+    @param idx Position of the element
+    @param value New value of the element
+    */
+    constexpr void set(const size_type idx, const value_type value)
+    {
+        const uint16_t bitOffset = static_cast<uint16_t>(idx) * t_bits;
+        const size_type byteIdx = bitOffset >> 3;
+        const uint8_t shift = bitOffset & 0b111;
+        const uint8_t bits = static_cast<uint8_t>(value) & s_mask;
+
+        if CXX17_CONSTEXPR(isAligned())
+        {
+            m_data[byteIdx] = (m_data[byteIdx] & ~(s_mask << shift)) | (bits << shift);
+        }
+        else
+        {
+            const uint16_t mask = static_cast<uint16_t>(s_mask) << shift;
+            const uint16_t data = static_cast<uint16_t>(bits) << shift;
+            m_data[byteIdx] = (m_data[byteIdx] & ~static_cast<uint8_t>(mask)) | static_cast<uint8_t>(data);
+            if (shift + t_bits > 8)
+            {
+                m_data[byteIdx + 1] = (m_data[byteIdx + 1] & ~static_cast<uint8_t>(mask >> 8)) | static_cast<uint8_t>(data >> 8);
+            }
+        }
+    }
+
+    /**
+    @brief Access element at given position. No bounds checking is performed.
+    @param idx Position of the element
+    @result Value of the element
+    */
+    constexpr value_type operator[](const size_type idx) const
+    {
+        return get(idx);
+    }
+
+    /**
+    @brief Access element at given position. No bounds checking is performed.
+    @param idx Position of the element
+    @result Proxy reference to the element
+    */
+    constexpr Reference operator[](const size_type idx)
+    {
+        return Reference(*this, idx);
+    }
+
+    /**
+    @brief Assign the given value to all elements
+    Only the first elements up to the period of the bit pattern are set individually, the remaining bytes are copied.
+    @param value Value to be assigned
+    */
+    constexpr void fill(const value_type value)
+    {
+        // The bit pattern repeats every s_periodBytes bytes, i.e. every s_periodElems elements
+        for (size_type idx = 0; idx < s_periodElems && idx < t_length; ++idx)
+        {
+            set(idx, value);
+        }
+        for (size_type byteIdx = s_periodBytes; byteIdx < getNofBytes(); ++byteIdx)
+        {
+            m_data[byteIdx] = m_data[byteIdx - s_periodBytes];
+        }
+    }
+
+    /**
+    @brief Copy a range of elements from another packed array of the same element width
+    If source and destination ranges are byte-aligned, whole bytes are copied. Overlapping ranges within the same array are supported.
+    No bounds checking is performed.
+    @param dstIdx Position of the first destination element in this array
+    @param src Source array
+    @param srcIdx Position of the first source element
+    @param count Number of elements to copy
+    */
+    template <size_t t_srcLength>
+    constexpr void copy(size_type dstIdx, const PackedArray<t_bits, t_srcLength, T>& src, size_t srcIdx, size_t count)
+    {
+        const uint16_t dstBit = static_cast<uint16_t>(dstIdx) * t_bits;
+        const uint16_t srcBit = static_cast<uint16_t>(srcIdx) * t_bits;
+        const bool backwards = static_cast<const void*>(&src) == static_cast<const void*>(this) && dstIdx > srcIdx;
+
+        // Fast path: both ranges start at a byte boundary, so whole periods of s_periodBytes bytes can be copied bytewise
+        if (0 == (dstBit & 0b111) && 0 == (srcBit & 0b111))
+        {
+            const size_t nofPeriods = count / s_periodElems;
+            const size_t nofBytes = nofPeriods * s_periodBytes;
+            const size_t nofBulkElems = nofPeriods * s_periodElems;
+            uint8_t* dst = m_data.data() + (dstBit >> 3);
+            const uint8_t* srcData = src.data().data() + (srcBit >> 3);
+
+            if (backwards)
+            {
+                // Copy tail elements first
+                copyElements(dstIdx + nofBulkElems, src, srcIdx + nofBulkElems, count - nofBulkElems, true);
+                for (size_t byteIdx = nofBytes; byteIdx > 0; --byteIdx)
+                {
+                    dst[byteIdx - 1] = srcData[byteIdx - 1];
+                }
+                return;
+            }
+
+            for (size_t byteIdx = 0; byteIdx < nofBytes; ++byteIdx)
+            {
+                dst[byteIdx] = srcData[byteIdx];
+            }
+            dstIdx += nofBulkElems;
+            srcIdx += nofBulkElems;
+            count -= nofBulkElems;
+        }
+
+        copyElements(dstIdx, src, srcIdx, count, backwards);
+    }
+
+    /**
+    @brief Get const iterator to the first element
+    @result Const iterator to the first element
+    */
+    constexpr ConstIterator begin() const
+    {
+        return ConstIterator(*this, 0);
+    }
+
+    /**
+    @brief Get const iterator to the last plus one element
+    @result Const iterator to the last plus one element
+    */
+    constexpr ConstIterator end() const
+    {
+        return ConstIterator(*this, t_length);
+    }
+
+    /**
+    @brief Returns the number of elements
+    @result Number of elements
+    */
+    static constexpr size_type size()
+    {
+        return t_length;
+    }
+
+    /**
+    @brief Returns the size of the underlying storage in bytes
+    @result Number of bytes
+    */
+    static constexpr size_t sizeBytes()
+    {
+        return getNofBytes();
+    }
+
+    /**
+    @brief Direct access to the underlying storage
+    @result Reference to the underlying byte array
+    */
+    constexpr auto& data()
+    {
+        return m_data;
+    }
+
+    /**
+    @brief Direct read-only access to the underlying storage
+    @result Const reference to the underlying byte array
+    */
+    constexpr const auto& data() const
+    {
+        return m_data;
+    }
+
+    private:
+
+    static constexpr uint8_t s_mask = static_cast<uint8_t>((1u << t_bits) - 1);
+
+    // Number of bytes after which the bit pattern of equal elements repeats, i.e. lcm(t_bits, 8) / 8
+    static constexpr uint8_t s_periodBytes = t_bits / (t_bits & -t_bits);
+
+    // Number of elements per period of s_periodBytes bytes
+    static constexpr uint8_t s_periodElems = (s_periodBytes * 8) / t_bits;
+
+    static constexpr bool isAligned()
+    {
+        return 0 == (8 % t_bits);
+    }
+
+    static constexpr size_t getNofBytes()
+    {
+        return (static_cast<size_t>(t_bits) * t_length + 7) >> 3;
+    }
+
+    template <size_t t_srcLength>
+    constexpr void copyElements(const size_t dstIdx, const PackedArray<t_bits, t_srcLength, T>& src, const size_t srcIdx, const size_t count, const bool backwards)
+    {
+        if (backwards)
+        {
+            for (size_t idx = count; idx > 0; --idx)
+            {
+                set(dstIdx + idx - 1, src.get(srcIdx + idx - 1));
+            }
+        }
+        else
+        {
+            for (size_t idx = 0; idx < count; ++idx)
+            {
+                set(dstIdx + idx, src.get(srcIdx + idx));
+            }
+        }
+    }
+
+    Array<uint8_t, getNofBytes()> m_data = {};
+};
+
+#endif
@@ -24,6 +24,7 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <stddef.h> // ptrdiff_t
 #include <avr/pgmspace.h>
+#include <type_traits.h>
 #include "exception.h"
 #include "algorithm.h" // swap()
 
@@ -160,6 +161,16 @@ class PgmArray
         return read(m_data + size()-1);
     }
     
+    /**
+    @brief Direct access to the underlying array
+    Returns pointer to the underlying array in program memory. The pointer must not be dereferenced directly, but only via pgm_read_*() functions.
+    @result Pointer to the first element in program memory
+    */
+    constexpr const_pointer data() const
+    {
+        return m_data;
+    }
+
     /**
     @brief Get const iterator pointing to first character of string
     @result begin const iterator
@@ -246,6 +257,9 @@ class PgmArray
     template <typename U, U ... t_data>
     friend constexpr PgmArray<U> makePgmArray();
     
+    template <typename Generator>
+    friend constexpr auto makePgmArray(Generator);
+    
     constexpr PgmArray(const T* data, const size_t size) : m_data(data), m_size(size)
     {}
 
@@ -291,6 +305,49 @@ class PgmArray
         // Compile-time constant string stored in PROGMEM
         static constexpr const T s_data[] PROGMEM = {t_data...};
     };
+    
+    // Nested container to store the result of a constexpr generator in PROGMEM
+    template <typename Generator>
+    class PgmArrayGenerated
+    {
+        public:
+        
+        PgmArrayGenerated() = delete;
+        
+        static constexpr const T * data()
+        {
+            return s_data.elems;
+        }
+        
+        static constexpr size_t size()
+        {
+            return s_size;
+        }
+        
+        private:
+        
+        static constexpr size_t s_size = Generator()().size();
+        
+        struct Data
+        {
+            T elems[s_size > 0 ? s_size : 1];
+        };
+        
+        // Copy the generated elements. This is only evaluated at compile time, the generated container itself is not emitted.
+        static constexpr Data generate()
+        {
+            const auto source = Generator()();
+            Data data = {};
+            for (size_t idx = 0; idx < s_size; ++idx)
+            {
+                data.elems[idx] = source[idx];
+            }
+            return data;
+        }
+        
+        // Compile-time constant array stored in PROGMEM
+        static constexpr Data s_data PROGMEM = generate();
+    };
 };
 
 // Static initialization
@@ -311,6 +368,35 @@ constexpr PgmArray<T> makePgmArray()
     PgmArray<T>::template PgmArrayStorage<t_data ...>::size());
 }
 
+/**
+@brief Create a PgmArray from a container built at compile time
+The generator is a captureless lambda (or any default-constructible function object) returning a container like Array<T, N>,
+i.e. any literal type providing a constexpr size() and operator[]. The generator is only evaluated at compile time and the elements
+are emitted directly into PROGMEM, so neither RAM nor static initialization code is used:
+@code
+constexpr auto squares = makePgmArray([]
+{
+    Array<uint16_t, 16> table = {};
+    for (uint8_t idx = 0; idx < table.size(); ++idx)
+    {
+        table[idx] = idx * idx;
+    }
+    return table;
+});
+@endcode
+Every lambda expression has its own type, so each call site of makePgmArray() emits its own array.
+@tparam Generator Type of the generator
+@result PgmArray referring to the generated elements in PROGMEM
+*/
+template <typename Generator>
+constexpr auto makePgmArray(Generator)
+{
+    using T = typename remove_const<typename remove_reference<decltype(Generator()()[0])>::type>::type;
+    return PgmArray<T>(
+    PgmArray<T>::template PgmArrayGenerated<Generator>::data(),
+    PgmArray<T>::template PgmArrayGenerated<Generator>::size());
+}
+
 /**
 @brief Exchanges the given values.
 Specializes the swap algorithm for Array. Swaps the contents of lhs and rhs. Calls lhs.swap(rhs).
@@ -0,0 +1,250 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef PGM_SORTED_MAP_H
+#define PGM_SORTED_MAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#include <exception.h>
+#include <memcopy.h>
+#include <type_traits.h>
+#include <utility.h>
+
+template <typename Generator>
+class PgmSortedMapStorage;
+
+/**
+@brief Read-only view of a map stored in PROGMEM, sorted by key at compile time
+Objects of this class are created by makePgmSortedMap() only. Keys are looked up by binary search, reading only the keys of
+O(log(size)) entries from PROGMEM.
+@tparam Key Key type. Keys are compared using operator<
+@tparam Value Value type
+*/
+template <typename Key, typename Value>
+class PgmSortedMap
+{
+    public:
+    
+    using key_type   = Key;
+    using value_type = Pair<Key, Value>;
+    using size_type  = size_t;
+    
+    /**
+    @brief Returns the number of entries
+    @result Number of entries
+    */
+    constexpr size_type size() const
+    {
+        return m_size;
+    }
+    
+    /**
+    @brief Checks whether the map is empty
+    @result true if the map is empty, false otherwise
+    */
+    constexpr bool empty() const
+    {
+        return 0 == m_size;
+    }
+    
+    /**
+    @brief Read entry at given position in ascending key order. No bounds checking is performed.
+    @param pos Position of the entry
+    @result Copy of the entry
+    */
+    value_type operator[](const size_type pos) const
+    {
+        return memread_P(m_data + pos);
+    }
+    
+    /**
+    @brief Find the first entry whose key is not less than the given key
+    @param key Key to search for
+    @result Position of the entry, or size() if there is no such entry
+    */
+    size_type lowerBound(const Key& key) const
+    {
+        size_type first = 0;
+        size_type last = m_size;
+        while (first < last)
+        {
+            const size_type mid = first + ((last - first) >> 1);
+            if (readKey(mid) < key)
+            {
+                first = mid + 1;
+            }
+            else
+            {
+                last = mid;
+            }
+        }
+        return first;
+    }
+    
+    /**
+    @brief Find entry with given key
+    @param key Key to search for
+    @result Position of the entry, or size() if the key is not found
+    */
+    size_type find(const Key& key) const
+    {
+        const size_type pos = lowerBound(key);
+        if (pos < m_size && !(key < readKey(pos)))
+        {
+            return pos;
+        }
+        return m_size;
+    }
+    
+    /**
+    @brief Checks if the map contains an entry with given key
+    @param key Key to search for
+    @result true if the key is found, false otherwise
+    */
+    bool contains(const Key& key) const
+    {
+        return find(key) != m_size;
+    }
+    
+    /**
+    @brief Read value with bounds checking
+    If the key is not found, an exception of type out_of_range is thrown.
+    @param key Key to search for
+    @result Copy of the value mapped to key
+    */
+    Value at(const Key& key) const
+    {
+        const size_type pos = find(key);
+        if (pos == m_size)
+        {
+            throw_out_of_range();
+        }
+        return memread_P(&m_data[pos].second);
+    }
+    
+    /**
+    @brief Read value or return a default if the key is not found
+    @param key Key to search for
+    @param defaultValue Value returned if the key is not found
+    @result Copy of the value mapped to key, or defaultValue
+    */
+    Value get(const Key& key, const Value& defaultValue) const
+    {
+        const size_type pos = find(key);
+        return (pos == m_size) ? defaultValue : memread_P(&m_data[pos].second);
+    }
+    
+    private:
+    
+    template <typename Generator>
+    friend class PgmSortedMapStorage;
+    
+    constexpr PgmSortedMap(const value_type* data, const size_type size) : m_data(data), m_size(size)
+    {}
+    
+    Key readKey(const size_type pos) const
+    {
+        return memread_P(&m_data[pos].first);
+    }
+    
+    const value_type* m_data = nullptr;
+    size_type m_size = 0;
+};
+
+/**
+@brief Storage of a sorted map generated at compile time in PROGMEM
+@tparam Generator Type of the generator
+*/
+template <typename Generator>
+class PgmSortedMapStorage
+{
+    using Entry = typename remove_const<typename remove_reference<decltype(Generator()()[0])>::type>::type;
+    using Key = typename Entry::first_type;
+    using Value = typename Entry::second_type;
+    
+    public:
+    
+    PgmSortedMapStorage() = delete;
+    
+    static constexpr PgmSortedMap<Key, Value> view()
+    {
+        return PgmSortedMap<Key, Value>(s_data.entries, s_size);
+    }
+    
+    private:
+    
+    static constexpr size_t s_size = Generator()().size();
+    
+    struct Data
+    {
+        Entry entries[s_size > 0 ? s_size : 1];
+    };
+    
+    // Copy and sort the generated entries. This is only evaluated at compile time, the generated container itself is not emitted.
+    static constexpr Data generate()
+    {
+        const auto source = Generator()();
+        Data data = {};
+        for (size_t idx = 0; idx < s_size; ++idx)
+        {
+            const Entry entry = source[idx];
+            
+            // Insertion sort
+            size_t pos = idx;
+            while (pos > 0 && !(data.entries[pos - 1].first < entry.first))
+            {
+                if (!(entry.first < data.entries[pos - 1].first))
+                {
+                    // Duplicate key: Calling a non-constexpr function makes the constant evaluation fail
+                    throw_length_error();
+                }
+                data.entries[pos] = data.entries[pos - 1];
+                --pos;
+            }
+            data.entries[pos] = entry;
+        }
+        return data;
+    }
+    
+    // Compile-time constant entries stored in PROGMEM
+    static constexpr Data s_data PROGMEM = generate();
+};
+
+/**
+@brief Create a map sorted by key at compile time and place it in PROGMEM
+The generator is a captureless lambda returning a container of Pair<Key, Value> like Array<Pair<Key, Value>, N>, i.e. any literal type providing a constexpr size()
+and operator[]. The entries may be given in any order. Duplicate keys result in a compile error. The generator is only evaluated at compile time,
+so the map neither uses RAM nor static initialization code:
+@code
+constexpr auto baudRates = makePgmSortedMap([]
+{
+    return Array<Pair<uint32_t, uint16_t>, 3>{{{115200, 8}, {9600, 103}, {31250, 31}}};
+});
+const uint16_t ubrr = baudRates.get(31250, 0);
+@endcode
+@tparam Generator Type of the generator
+@result PgmSortedMap referring to the generated entries in PROGMEM
+*/
+template <typename Generator>
+constexpr auto makePgmSortedMap(Generator)
+{
+    return PgmSortedMapStorage<Generator>::view();
+}
+
+#endif
@@ -87,6 +87,16 @@ class PgmString
         return m_size;
     }
     
+    /**
+    @brief Direct access to the underlying characters
+    Returns pointer to the first character in program memory. The pointer must not be dereferenced directly, but only via pgm_read_*() functions.
+    @result Pointer to the first character in program memory
+    */
+    constexpr const char* data() const
+    {
+        return m_string;
+    }
+    
     char operator[](const size_t pos)
     {
         const char * ptr = m_string + pos;
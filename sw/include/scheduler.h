@@ -30,15 +30,34 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 /**
 @brief Implementation of a simple queue-based task scheduler.
 This implementation is interrupt-safe (i.e. call schedule() and execute() in application code and clock() in ISR)
+If t_capacity is 0, clock() allocates memory in the ISR when moving a task to the queue of due tasks. The default HeapAllocator is not
+interrupt-safe, so if the heap is also used outside of the scheduler, pass an AtomicPoolAllocator with a block size of nodeSize():
+@code
+using Pool = AtomicPoolAllocator<Scheduler<Task, uint8_t>::nodeSize(), 16>;
+Scheduler<Task, uint8_t, 0, Pool> scheduler;
+@endcode
 @tparam Task task type to be scheduled. Task must specify operator()(void) or equivalent
 @tparam Delay delay clock tick type
 @tparam t_capacity Maximum number of tasks scheduled at the same time. If t_capacity is 0, the actual maximum number of tasks is limited by available heap memory
+@tparam Allocator Allocator used for the task queues if t_capacity is 0
 */
-template <typename Task, typename Delay, size_t t_capacity = 0>
+template <typename Task, typename Delay, size_t t_capacity = 0, typename Allocator = HeapAllocator<>>
 class Scheduler
 {
+    using ScheduledTask = Pair<Delay,Task>;
+    
     public:
     
+    /**
+    @brief Size of the blocks allocated for one task
+    Largest block size requested from Allocator if t_capacity is 0
+    @result Block size in bytes
+    */
+    static constexpr size_t nodeSize()
+    {
+        return List<ScheduledTask>::nodeSize() > List<Task>::nodeSize() ? List<ScheduledTask>::nodeSize() : List<Task>::nodeSize();
+    }
+    
     /**
     @brief Schedule a task
     If two tasks have the same delay, the task scheduled first will be executed first
@@ -143,8 +162,6 @@ class Scheduler
     
     private:
     
-    using ScheduledTask = Pair<Delay,Task>;
-    
     // Compare functor used to schedule tasks
     struct Compare
     {
@@ -165,10 +182,10 @@ class Scheduler
     };
     
     // Queue of scheduled (i.e. delayed) tasks
-    PriorityQueue<ScheduledTask, typename conditional<t_capacity == 0, List<ScheduledTask>, StaticList<ScheduledTask, t_capacity>>::type, Compare> m_scheduledTasks;
+    PriorityQueue<ScheduledTask, typename conditional<t_capacity == 0, List<ScheduledTask, Allocator>, StaticList<ScheduledTask, t_capacity>>::type, Compare> m_scheduledTasks;
     
     // Queue of due tasks
-    Queue<Task, typename conditional<t_capacity == 0, List<Task>, StaticList<Task, t_capacity>>::type> m_dueTasks;
+    Queue<Task, typename conditional<t_capacity == 0, List<Task, Allocator>, StaticList<Task, t_capacity>>::type> m_dueTasks;
 };
 
 #endif
\ No newline at end of file
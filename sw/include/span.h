@@ -0,0 +1,483 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SPAN_H
+#define SPAN_H
+
+#include <bits/c++config.h>
+
+#if SINCE_CXX11
+
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits.h>
+#include <memcopy.h>
+#include <pgm_array.h>
+#include <pgm_string.h>
+
+template <bool t_progmem>
+class BasicStringView;
+
+/**
+@brief Non-owning view of a contiguous sequence of objects in RAM
+A Span refers to a contiguous sequence of objects with the first element at position zero. Span does not own the referenced objects,
+i.e. the referenced container must outlive the Span. Spans are cheap to copy and should be passed by value.
+Any container providing data() and size() (e.g. Array, Vector, StaticVector, String) can be viewed as a Span without copying the elements.
+@tparam T Element type. Use const T for a read-only view (see ConstSpan)
+*/
+template <typename T>
+class Span
+{
+    public:
+
+    using element_type    = T;
+    using value_type      = remove_cv_t<T>;
+    using size_type       = size_t;
+    using difference_type = ptrdiff_t;
+    using pointer         = T*;
+    using reference       = T&;
+    using iterator        = T*;
+
+    /**
+    @brief Constructs an empty span
+    */
+    constexpr Span() = default;
+
+    /**
+    @brief Constructs a span that is a view over the range [data, data + size)
+    @param data Pointer to the first element of the sequence
+    @param size Number of elements in the sequence
+    */
+    constexpr Span(const pointer data, const size_type size)
+    :
+    m_data(data),
+    m_size(size)
+    {}
+
+    /**
+    @brief Constructs a span that is a view over the range [first, last)
+    @param first Pointer to the first element of the sequence
+    @param last Pointer to the last plus one element of the sequence
+    */
+    constexpr Span(const pointer first, const pointer last)
+    :
+    m_data(first),
+    m_size(last - first)
+    {}
+
+    /**
+    @brief Constructs a span that is a view over a built-in array
+    @param array Built-in array
+    */
+    template <size_t t_size>
+    constexpr Span(T (&array)[t_size])
+    :
+    m_data(array),
+    m_size(t_size)
+    {}
+
+    /**
+    @brief Constructs a span that is a view over a container
+    The container has to provide the methods data() and size(). This includes Array, Vector, StaticVector and String.
+    Spans of T implicitly convert to spans of const T by means of this constructor.
+    @param container Container to view
+    */
+    template <typename Container, typename = enable_if_t<is_convertible<decltype(declval<Container&>().data()), pointer>::value>>
+    constexpr Span(Container& container)
+    :
+    m_data(container.data()),
+    m_size(container.size())
+    {}
+
+    /**
+    @brief PgmArray data resides in program memory and cannot be viewed as a RAM span. Use PgmSpan instead.
+    */
+    template <typename U>
+    Span(const PgmArray<U>&) = delete;
+
+    /**
+    @brief PgmString data resides in program memory and cannot be viewed as a RAM span. Use PgmSpan instead.
+    */
+    Span(const PgmString&) = delete;
+
+    /**
+    @brief PgmStringView data resides in program memory and cannot be viewed as a RAM span. Use PgmSpan instead.
+    */
+    Span(const BasicStringView<true>&) = delete;
+
+    /**
+    @brief Copy constructor
+    */
+    constexpr Span(const Span&) = default;
+
+    /**
+    @brief Copy assignment
+    */
+    constexpr Span& operator=(const Span&) = default;
+
+    /**
+    @brief Access specified element. No bounds checking is performed.
+    @param pos Position of the element to return
+    @result Reference to the requested element
+    */
+    constexpr reference operator[](const size_type pos) const
+    {
+        return m_data[pos];
+    }
+
+    /**
+    @brief Access the first element. Calling front on an empty span is undefined.
+    @result Reference to the first element
+    */
+    constexpr reference front() const
+    {
+        return m_data[0];
+    }
+
+    /**
+    @brief Access the last element. Calling back on an empty span is undefined.
+    @result Reference to the last element
+    */
+    constexpr reference back() const
+    {
+        return m_data[m_size - 1];
+    }
+
+    /**
+    @brief Direct access to the underlying sequence
+    @result Pointer to the first element
+    */
+    constexpr pointer data() const
+    {
+        return m_data;
+    }
+
+    /**
+    @brief Returns an iterator to the first element
+    @result Iterator to the first element
+    */
+    constexpr iterator begin() const
+    {
+        return m_data;
+    }
+
+    /**
+    @brief Returns an iterator to the element following the last element
+    @result Iterator to the last plus one element
+    */
+    constexpr iterator end() const
+    {
+        return m_data + m_size;
+    }
+
+    /**
+    @brief Returns the number of elements in the sequence
+    @result Number of elements
+    */
+    constexpr size_type size() const
+    {
+        return m_size;
+    }
+
+    /**
+    @brief Returns the size of the sequence in bytes
+    @result Size in bytes
+    */
+    constexpr size_type sizeBytes() const
+    {
+        return m_size * sizeof(T);
+    }
+
+    /**
+    @brief Checks if the sequence is empty
+    @result true if the span is empty, false otherwise
+    */
+    constexpr bool empty() const
+    {
+        return 0 == m_size;
+    }
+
+    /**
+    @brief Obtains a subspan consisting of the first count elements of the sequence.
+    The behavior is undefined if count > size()
+    @param count Number of elements
+    @result Subspan
+    */
+    constexpr Span first(const size_type count) const
+    {
+        return Span(m_data, count);
+    }
+
+    /**
+    @brief Obtains a subspan consisting of the last count elements of the sequence.
+    The behavior is undefined if count > size()
+    @param count Number of elements
+    @result Subspan
+    */
+    constexpr Span last(const size_type count) const
+    {
+        return Span(m_data + (m_size - count), count);
+    }
+
+    /**
+    @brief Obtains a subspan consisting of count elements starting at offset.
+    The number of elements is clipped to the end of the sequence. The behavior is undefined if offset > size()
+    @param offset Position of the first element of the subspan
+    @param count Number of elements
+    @result Subspan
+    */
+    constexpr Span subspan(const size_type offset, size_type count = static_cast<size_type>(-1)) const
+    {
+        const size_type remaining = m_size - offset;
+        if (count > remaining)
+        {
+            count = remaining;
+        }
+
+        return Span(m_data + offset, count);
+    }
+
+    private:
+
+    pointer m_data = nullptr;
+    size_type m_size = 0;
+};
+
+/**
+@brief Read-only view of a contiguous sequence of objects in RAM
+*/
+template <typename T>
+using ConstSpan = Span<const T>;
+
+/**
+@brief Non-owning read-only view of a contiguous sequence of objects in program memory
+Elements are read via pgm_read_byte() and returned by value. Any PgmArray or PgmString can be viewed as a PgmSpan without copying the elements to RAM.
+@tparam T Element type
+*/
+template <typename T>
+class PgmSpan
+{
+    public:
+
+    using value_type     = T;
+    using size_type      = size_t;
+    using const_pointer  = const T*;
+    using const_iterator = typename PgmArray<T>::ConstIterator;
+
+    /**
+    @brief Constructs an empty span
+    */
+    constexpr PgmSpan() = default;
+
+    /**
+    @brief Constructs a span that is a view over the range [data, data + size) in program memory
+    @param data Pointer to the first element of the sequence in program memory
+    @param size Number of elements in the sequence
+    */
+    constexpr PgmSpan(const const_pointer data, const size_type size)
+    :
+    m_data(data),
+    m_size(size)
+    {}
+
+    /**
+    @brief Constructs a span that is a view over a PgmArray
+    @param array PgmArray to view
+    */
+    constexpr PgmSpan(const PgmArray<T>& array)
+    :
+    m_data(array.data()),
+    m_size(array.size())
+    {}
+
+    /**
+    @brief Constructs a span that is a view over a PgmString (excluding the null terminator)
+    @param string PgmString to view
+    */
+    template <typename U = T, typename = enable_if_t<is_same<U, char>::value>>
+    constexpr PgmSpan(const PgmString& string)
+    :
+    m_data(string.data()),
+    m_size(string.size())
+    {}
+
+    /**
+    @brief Access specified element (read-only). No bounds checking is performed.
+    @param pos Position of the element to return
+    @result Copy of the requested element
+    */
+    value_type operator[](const size_type pos) const
+    {
+        return memread_P(m_data + pos);
+    }
+
+    /**
+    @brief Access the first element (read-only). Calling front on an empty span is undefined.
+    @result Copy of the first element
+    */
+    value_type front() const
+    {
+        return memread_P(m_data);
+    }
+
+    /**
+    @brief Access the last element (read-only). Calling back on an empty span is undefined.
+    @result Copy of the last element
+    */
+    value_type back() const
+    {
+        return memread_P(m_data + m_size - 1);
+    }
+
+    /**
+    @brief Direct access to the underlying sequence
+    The pointer must not be dereferenced directly, but only via pgm_read_*() functions.
+    @result Pointer to the first element in program memory
+    */
+    constexpr const_pointer data() const
+    {
+        return m_data;
+    }
+
+    /**
+    @brief Returns a const iterator to the first element
+    @result Const iterator to the first element
+    */
+    constexpr const_iterator begin() const
+    {
+        return m_data; // implicit conversion to const_iterator
+    }
+
+    /**
+    @brief Returns a const iterator to the element following the last element
+    @result Const iterator to the last plus one element
+    */
+    constexpr const_iterator end() const
+    {
+        return m_data + m_size; // implicit conversion to const_iterator
+    }
+
+    /**
+    @brief Returns the number of elements in the sequence
+    @result Number of elements
+    */
+    constexpr size_type size() const
+    {
+        return m_size;
+    }
+
+    /**
+    @brief Returns the size of the sequence in bytes
+    @result Size in bytes
+    */
+    constexpr size_type sizeBytes() const
+    {
+        return m_size * sizeof(T);
+    }
+
+    /**
+    @brief Checks if the sequence is empty
+    @result true if the span is empty, false otherwise
+    */
+    constexpr bool empty() const
+    {
+        return 0 == m_size;
+    }
+
+    /**
+    @brief Obtains a subspan consisting of the first count elements of the sequence.
+    The behavior is undefined if count > size()
+    @param count Number of elements
+    @result Subspan
+    */
+    constexpr PgmSpan first(const size_type count) const
+    {
+        return PgmSpan(m_data, count);
+    }
+
+    /**
+    @brief Obtains a subspan consisting of the last count elements of the sequence.
+    The behavior is undefined if count > size()
+    @param count Number of elements
+    @result Subspan
+    */
+    constexpr PgmSpan last(const size_type count) const
+    {
+        return PgmSpan(m_data + (m_size - count), count);
+    }
+
+    /**
+    @brief Obtains a subspan consisting of count elements starting at offset.
+    The number of elements is clipped to the end of the sequence. The behavior is undefined if offset > size()
+    @param offset Position of the first element of the subspan
+    @param count Number of elements
+    @result Subspan
+    */
+    constexpr PgmSpan subspan(const size_type offset, size_type count = static_cast<size_type>(-1)) const
+    {
+        const size_type remaining = m_size - offset;
+        if (count > remaining)
+        {
+            count = remaining;
+        }
+
+        return PgmSpan(m_data + offset, count);
+    }
+
+    /**
+    @brief Copy the elements of the sequence to RAM
+    @param dst Destination span. The number of copied elements is the minimum of both sizes
+    @result Number of copied elements
+    */
+    size_type copy(const Span<T> dst) const
+    {
+        const size_type count = dst.size() < m_size ? dst.size() : m_size;
+        memcopy_P(dst.data(), m_data, count);
+        return count;
+    }
+
+    private:
+
+    const_pointer m_data = nullptr;
+    size_type m_size = 0;
+};
+
+/**
+@brief Create a span of bytes viewing the object representation of a given object
+@param object Object to view
+@result Span of bytes
+*/
+template <typename T>
+constexpr Span<uint8_t> asBytes(T& object)
+{
+    return Span<uint8_t>(reinterpret_cast<uint8_t*>(&object), sizeof(T));
+}
+
+/**
+@brief Create a read-only span of bytes viewing the object representation of a given object
+@param object Object to view
+@result Read-only span of bytes
+*/
+template <typename T>
+constexpr ConstSpan<uint8_t> asBytes(const T& object)
+{
+    return ConstSpan<uint8_t>(reinterpret_cast<const uint8_t*>(&object), sizeof(T));
+}
+
+#endif
+
+#endif
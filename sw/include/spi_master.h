@@ -19,6 +19,7 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #define SPI_MASTER_H
 
 #include <stdint.h>
+#include <span.h>
 
 /**
 @brief Implementation of driver for SPI master using a given SPI module driver
@@ -85,10 +86,12 @@ class SPIMasterSync
 
     /**
     @brief Transmit multiple bytes
+    @tparam Length Integral length type. Use uint16_t or size_t for transfers of more than 255 bytes
     @param data Pointer to Bytes to be transmitted
     @param nofBytes Number of Bytes to be transmitted
     */
-    static void put(const uint8_t * data, uint8_t nofBytes)
+    template <typename Length>
+    static void put(const uint8_t * data, Length nofBytes)
     {
         if (0 == nofBytes)
         {
@@ -113,6 +116,48 @@ class SPIMasterSync
         SPIModule::wait();
     }
 
+    /**
+    @brief Transmit multiple bytes
+    @param data Span of Bytes to be transmitted
+    */
+    static void put(const ConstSpan<uint8_t> data)
+    {
+        put(data.data(), data.size());
+    }
+
+    /**
+    @brief Transmit multiple bytes stored in program memory
+    Bytes are read from program memory on the fly, i.e. no copy in RAM is required.
+    @param data Span of Bytes in program memory to be transmitted
+    */
+    static void put(const PgmSpan<uint8_t> data)
+    {
+        size_t nofBytes = data.size();
+        if (0 == nofBytes)
+        {
+            return;
+        }
+
+        const uint8_t * ptr = data.data();
+        
+        // Transmission pipeline
+        do
+        {
+            // Cache data into register so it can be sent immediately after the bus is ready
+            const uint8_t cachedData = pgm_read_byte(ptr++);
+            
+            // Wait while SPI is busy
+            SPIModule::wait();
+            
+            // Transmit data
+            SPIModule::transmit(cachedData);
+        }
+        while (--nofBytes);
+
+        // Wait while SPI is busy
+        SPIModule::wait();
+    }
+
     /**
     @brief Receive single byte
     @param dummy Dummy Byte to be transmitted, default is 0x00
@@ -133,8 +178,13 @@ class SPIMasterSync
 
     /**
     @brief Receive multiple bytes
+    @tparam Length Integral length type. Use uint16_t or size_t for transfers of more than 255 bytes
+    @param data Pointer to receive buffer
+    @param nofBytes Number of Bytes to be received
+    @param dummy Dummy Byte to be transmitted, default is 0x00
     */
-    static void get(uint8_t * data, uint8_t nofBytes, const uint8_t dummy = 0)
+    template <typename Length>
+    static void get(uint8_t * data, Length nofBytes, const uint8_t dummy = 0)
     {
         if (0 == nofBytes)
         {
@@ -166,6 +216,16 @@ class SPIMasterSync
         // Receive and store last byte
         *data = SPIModule::receive();
     }
+
+    /**
+    @brief Receive multiple bytes
+    @param data Span of receive buffer. The number of received Bytes equals the size of the span
+    @param dummy Dummy Byte to be transmitted, default is 0x00
+    */
+    static void get(const Span<uint8_t> data, const uint8_t dummy = 0)
+    {
+        get(data.data(), data.size(), dummy);
+    }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,530 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef STATIC_HASH_MAP_H
+#define STATIC_HASH_MAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <bits/c++config.h>
+#include <bits/move.h>
+#include <bits/pair.h>
+#include <type_traits.h>
+#include <exception.h>
+#include <bits/new.h>
+#include <hash.h>
+
+/**
+@brief Associative container with static capacity mapping unique keys to values
+StaticHashMap is an open addressing hash table using Robin Hood linear probing and backward shift deletion. It does not use dynamic memory allocation.
+Each slot stores its probe distance in one byte, so unsuccessful lookups terminate early and keys are only compared if they share the home slot of the searched key.
+Lookup, insertion and removal have average constant time complexity. Load factors of up to ~80% perform well.
+Lookup with heterogeneous keys (e.g. a ConstSpan<char> for PgmString keys) is supported if Hash and KeyEqual accept the heterogeneous key type.
+@tparam Key Key type
+@tparam T Mapped type
+@tparam t_capacity Maximum number of elements. Must be a power of two and must not exceed 128
+@tparam HashFn Function object computing the hash value of a key, default is Hash<Key>
+@tparam KeyEqual Function object comparing keys for equality, default is EqualTo<Key>
+*/
+template <typename Key, typename T, size_t t_capacity, typename HashFn = Hash<Key>, typename KeyEqual = EqualTo<Key>>
+class StaticHashMap
+{
+    static_assert(t_capacity > 0 && 0 == (t_capacity & (t_capacity - 1)), "Capacity must be a power of two");
+    static_assert(t_capacity <= 128, "Probe distances are stored as uint8_t, so capacity must not exceed 128");
+
+    public:
+
+    template <bool t_const>
+    class Iterator;
+
+    using key_type        = Key;
+    using mapped_type     = T;
+    using value_type      = Pair<Key, T>;
+    using size_type       = size_t;
+    using difference_type = ptrdiff_t;
+    using hasher          = HashFn;
+    using key_equal       = KeyEqual;
+    using reference       = value_type&;
+    using const_reference = const value_type&;
+    using iterator        = Iterator<false>;
+    using const_iterator  = Iterator<true>;
+
+    template <bool t_const>
+    class Iterator
+    {
+        friend class StaticHashMap;
+
+        using map_type = typename conditional<t_const, const StaticHashMap, StaticHashMap>::type;
+        using elem_type = typename conditional<t_const, const value_type, value_type>::type;
+
+        CXX14_CONSTEXPR Iterator(map_type* map, const size_type idx) : m_map(map), m_idx(idx)
+        {}
+
+        public:
+
+        CXX14_CONSTEXPR Iterator(const Iterator& rhs) = default;
+
+        // Conversion from iterator to const_iterator
+        template <bool t_otherConst, typename = enable_if_t<t_const && !t_otherConst>>
+        CXX14_CONSTEXPR Iterator(const Iterator<t_otherConst>& rhs) : m_map(rhs.m_map), m_idx(rhs.m_idx)
+        {}
+
+        CXX14_CONSTEXPR Iterator& operator=(const Iterator& rhs) = default;
+
+        CXX14_CONSTEXPR Iterator& operator++()
+        {
+            m_idx = m_map->nextOccupied(m_idx + 1);
+            return *this;
+        }
+
+        CXX14_CONSTEXPR elem_type& operator*() const
+        {
+            return m_map->slot(m_idx);
+        }
+
+        CXX14_CONSTEXPR elem_type* operator->() const
+        {
+            return &m_map->slot(m_idx);
+        }
+
+        constexpr bool operator==(const Iterator& other) const
+        {
+            return m_idx == other.m_idx;
+        }
+
+        constexpr bool operator!=(const Iterator& other) const
+        {
+            return m_idx != other.m_idx;
+        }
+
+        private:
+
+        template <bool>
+        friend class Iterator;
+
+        map_type* m_map;
+        size_type m_idx;
+    };
+
+    /**
+    @brief Constructs an empty container
+    */
+    StaticHashMap()
+    {
+        for (uint8_t& distance : m_distance)
+        {
+            distance = s_empty;
+        }
+    }
+
+    /**
+    @brief Copy constructor. Constructs the container with the copy of the contents of other.
+    */
+    StaticHashMap(const StaticHashMap& other)
+    {
+        for (size_type idx = 0; idx < t_capacity; ++idx)
+        {
+            m_distance[idx] = other.m_distance[idx];
+            if (s_empty != m_distance[idx])
+            {
+                new (&slot(idx)) value_type(other.slot(idx));
+            }
+        }
+        m_size = other.m_size;
+    }
+
+    /**
+    @brief Destructs the container. The destructors of the elements are called.
+    */
+    ~StaticHashMap()
+    {
+        clear();
+    }
+
+    /**
+    @brief Copy assignment operator. Replaces the contents with a copy of the contents of other.
+    */
+    StaticHashMap& operator=(const StaticHashMap& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            for (size_type idx = 0; idx < t_capacity; ++idx)
+            {
+                m_distance[idx] = other.m_distance[idx];
+                if (s_empty != m_distance[idx])
+                {
+                    new (&slot(idx)) value_type(other.slot(idx));
+                }
+            }
+            m_size = other.m_size;
+        }
+        return *this;
+    }
+
+    /**
+    @brief Returns an iterator to the first element
+    The order of elements is unspecified.
+    @result Iterator to the first element
+    */
+    iterator begin()
+    {
+        return iterator(this, nextOccupied(0));
+    }
+
+    /**
+    @brief Returns a const iterator to the first element
+    The order of elements is unspecified.
+    @result Const iterator to the first element
+    */
+    const_iterator begin() const
+    {
+        return const_iterator(this, nextOccupied(0));
+    }
+
+    /**
+    @brief Returns an iterator to the element following the last element
+    @result Iterator to the last plus one element
+    */
+    iterator end()
+    {
+        return iterator(this, t_capacity);
+    }
+
+    /**
+    @brief Returns a const iterator to the element following the last element
+    @result Const iterator to the last plus one element
+    */
+    const_iterator end() const
+    {
+        return const_iterator(this, t_capacity);
+    }
+
+    /**
+    @brief Checks whether the container is empty
+    @result true if the container is empty, false otherwise
+    */
+    constexpr bool empty() const
+    {
+        return 0 == m_size;
+    }
+
+    /**
+    @brief Returns the number of elements
+    @result The number of elements in the container
+    */
+    constexpr size_type size() const
+    {
+        return m_size;
+    }
+
+    /**
+    @brief Returns the maximum possible number of elements
+    @result Maximum number of elements
+    */
+    static constexpr size_type capacity()
+    {
+        return t_capacity;
+    }
+
+    /**
+    @brief Erases all elements from the container
+    */
+    void clear()
+    {
+        for (size_type idx = 0; idx < t_capacity; ++idx)
+        {
+            if (s_empty != m_distance[idx])
+            {
+                slot(idx).~value_type();
+                m_distance[idx] = s_empty;
+            }
+        }
+        m_size = 0;
+    }
+
+    /**
+    @brief Inserts a new element into the container, if the container doesn't already contain an element with an equivalent key
+    If the capacity is exceeded, an exception of type bad_alloc is thrown.
+    @param value Element to insert
+    @result Pair of an iterator to the inserted element (or to the element that prevented the insertion) and a bool denoting whether the insertion took place
+    */
+    Pair<iterator, bool> insert(const value_type& value)
+    {
+        return emplace(value.first, value.second);
+    }
+
+    /**
+    @brief Inserts a new element constructed in-place with the given args into the container, if there is no element with the key in the container
+    If the capacity is exceeded, an exception of type bad_alloc is thrown.
+    @param key Key of the element to insert
+    @param args Arguments to forward to the constructor of the mapped value
+    @result Pair of an iterator to the inserted element (or to the element that prevented the insertion) and a bool denoting whether the insertion took place
+    */
+    template <typename ... Args>
+    Pair<iterator, bool> emplace(const key_type& key, Args&& ... args)
+    {
+        const size_type idx = findIndex(key);
+        if (t_capacity != idx)
+        {
+            return Pair<iterator, bool>(iterator(this, idx), false);
+        }
+
+        return Pair<iterator, bool>(iterator(this, insertUnique(value_type(key, T(forward<Args>(args)...)))), true);
+    }
+
+    /**
+    @brief Access or insert specified element
+    Returns a reference to the value that is mapped to a key equivalent to key, performing an insertion of a default-constructed value if such key does not already exist.
+    If the capacity is exceeded, an exception of type bad_alloc is thrown.
+    @param key The key of the element to find
+    @result Reference to the mapped value
+    */
+    T& operator[](const key_type& key)
+    {
+        return emplace(key).first->second;
+    }
+
+    /**
+    @brief Access specified element with bounds checking
+    If no such element exists, an exception of type out_of_range is thrown.
+    @param key The key of the element to find
+    @result Reference to the mapped value
+    */
+    template <typename K>
+    T& at(const K& key)
+    {
+        const size_type idx = findIndex(key);
+        if (t_capacity == idx)
+        {
+            throw_out_of_range();
+        }
+        return slot(idx).second;
+    }
+
+    /**
+    @brief Access specified element with bounds checking (read-only)
+    If no such element exists, an exception of type out_of_range is thrown.
+    @param key The key of the element to find
+    @result Const reference to the mapped value
+    */
+    template <typename K>
+    const T& at(const K& key) const
+    {
+        const size_type idx = findIndex(key);
+        if (t_capacity == idx)
+        {
+            throw_out_of_range();
+        }
+        return slot(idx).second;
+    }
+
+    /**
+    @brief Finds element with specific key
+    @param key The key of the element to find
+    @result Iterator to the requested element. If no such element is found, past-the-end iterator is returned.
+    */
+    template <typename K>
+    iterator find(const K& key)
+    {
+        return iterator(this, findIndex(key));
+    }
+
+    /**
+    @brief Finds element with specific key (read-only)
+    @param key The key of the element to find
+    @result Const iterator to the requested element. If no such element is found, past-the-end iterator is returned.
+    */
+    template <typename K>
+    const_iterator find(const K& key) const
+    {
+        return const_iterator(this, findIndex(key));
+    }
+
+    /**
+    @brief Checks if the container contains an element with specific key
+    @param key The key of the element to search for
+    @result true if there is such an element, otherwise false
+    */
+    template <typename K>
+    bool contains(const K& key) const
+    {
+        return t_capacity != findIndex(key);
+    }
+
+    /**
+    @brief Removes the element with specific key (if one exists)
+    @param key The key of the element to remove
+    @result Number of elements removed (0 or 1)
+    */
+    template <typename K>
+    size_type erase(const K& key)
+    {
+        const size_type idx = findIndex(key);
+        if (t_capacity == idx)
+        {
+            return 0;
+        }
+
+        eraseIndex(idx);
+        return 1;
+    }
+
+    /**
+    @brief Removes the element at pos
+    Since elements are shifted backwards on removal, iterators to other elements may be invalidated.
+    @param pos Iterator to the element to remove
+    */
+    void erase(const iterator pos)
+    {
+        eraseIndex(pos.m_idx);
+    }
+
+    /**
+    @brief Removes the element at pos
+    Since elements are shifted backwards on removal, iterators to other elements may be invalidated.
+    @param pos Const iterator to the element to remove
+    */
+    void erase(const const_iterator pos)
+    {
+        eraseIndex(pos.m_idx);
+    }
+
+    private:
+
+    // Probe distance of an empty slot. The probe distance of an occupied slot is 1 for elements in their home slot
+    static constexpr uint8_t s_empty = 0;
+
+    static constexpr size_type s_mask = t_capacity - 1;
+
+    // Get home slot index of a key
+    template <typename K>
+    static size_type homeIndex(const K& key)
+    {
+        return static_cast<size_type>(HashFn()(key)) & s_mask;
+    }
+
+    value_type& slot(const size_type idx)
+    {
+        return *reinterpret_cast<value_type*>(m_buffer[idx]);
+    }
+
+    const value_type& slot(const size_type idx) const
+    {
+        return *reinterpret_cast<const value_type*>(m_buffer[idx]);
+    }
+
+    // Get index of next occupied slot starting at idx, or t_capacity if there is none
+    size_type nextOccupied(size_type idx) const
+    {
+        while (idx < t_capacity && s_empty == m_distance[idx])
+        {
+            ++idx;
+        }
+        return idx;
+    }
+
+    // Get index of the element with given key, or t_capacity if there is none
+    template <typename K>
+    size_type findIndex(const K& key) const
+    {
+        size_type idx = homeIndex(key);
+        uint8_t distance = 1;
+
+        // All elements sharing the home slot of key are stored in a contiguous run with probe distance == distance.
+        // The search ends as soon as a slot is empty or contains an element which is closer to its home slot than key would be.
+        while (m_distance[idx] >= distance)
+        {
+            if (m_distance[idx] == distance && KeyEqual()(slot(idx).first, key))
+            {
+                return idx;
+            }
+
+            idx = (idx + 1) & s_mask;
+            ++distance;
+        }
+
+        return t_capacity;
+    }
+
+    // Insert a value whose key is not contained in the map yet
+    size_type insertUnique(value_type&& value)
+    {
+        if (m_size == t_capacity)
+        {
+            throw_bad_alloc();
+        }
+        ++m_size;
+
+        size_type idx = homeIndex(value.first);
+        uint8_t distance = 1;
+        size_type inserted = t_capacity;
+
+        while (s_empty != m_distance[idx])
+        {
+            // Robin Hood: take the slot from an element which is closer to its home slot and continue inserting that element
+            if (m_distance[idx] < distance)
+            {
+                if (t_capacity == inserted)
+                {
+                    inserted = idx;
+                }
+                ::swap(slot(idx), value);
+                ::swap(m_distance[idx], distance);
+            }
+
+            idx = (idx + 1) & s_mask;
+            ++distance;
+        }
+
+        new (&slot(idx)) value_type(move(value));
+        m_distance[idx] = distance;
+
+        return t_capacity == inserted ? idx : inserted;
+    }
+
+    // Remove the element at given slot by shifting the following elements of the probe sequence backwards
+    void eraseIndex(size_type idx)
+    {
+        slot(idx).~value_type();
+        --m_size;
+
+        size_type next = (idx + 1) & s_mask;
+        while (m_distance[next] > 1)
+        {
+            new (&slot(idx)) value_type(move(slot(next)));
+            slot(next).~value_type();
+            m_distance[idx] = m_distance[next] - 1;
+
+            idx = next;
+            next = (next + 1) & s_mask;
+        }
+
+        m_distance[idx] = s_empty;
+    }
+
+    // Probe distance + 1 for occupied slots, s_empty for empty slots
+    uint8_t m_distance[t_capacity];
+
+    // Memory for elements
+    alignas(value_type) uint8_t m_buffer[t_capacity][sizeof(value_type)];
+
+    // Number of elements
+    size_type m_size = 0;
+};
+
+#endif
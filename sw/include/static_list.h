@@ -19,6 +19,8 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #define STATIC_LIST_H
 
 #include <bits/c++config.h>
+#include <bits/list_base.h>
+#include <bits/list_sort.h>
 #include <bits/move.h>
 #include <bits/new.h>
 #include <exception.h>
@@ -31,10 +33,10 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 @tparam t_capacity Compile time constant capacity of the container in elements of type T
 */
 template <typename T, size_t t_capacity>
-class StaticList
+class StaticList : private listHelper::StaticListBase
 {
-    class NodeBase;
-    class Node;
+    using listHelper::StaticListBase::NodeBase;
+    struct Node;
     
     public:
     
@@ -535,16 +537,7 @@ class StaticList
     */
     [[nodiscard]] constexpr size_type size() const
     {
-        size_type nofElems = 0;
-        const_iterator itCurrent = cbegin();
-        const_iterator itEnd = cend();
-        
-        while (itCurrent != itEnd)
-        {
-            ++nofElems;
-            ++itCurrent;
-        }
-        return nofElems;
+        return countNodes();
     }
     
     /**
@@ -854,52 +847,122 @@ class StaticList
     */
     CXX14_CONSTEXPR void reverse()
     {
-        NodeBase* node = m_front.m_next;
-        while (node != &m_back)
-        {
-            swap(node->m_prev, node->m_next);
-            node = node->m_prev;
-        }
-        swap(m_front.m_next, m_back.m_prev);
-        link(m_front, *m_front.m_next);
-        link(*m_back.m_prev, m_back);
+        reverseNodes();
     }
     
-    private:
+    /**
+    @brief sorts the elements
+    Sorts the elements in ascending order using operator<. The order of equal elements is preserved.
+    The nodes are relinked using bottom-up merge sort, i.e. no elements are copied and no memory is allocated.
+    No references or iterators become invalidated.
+    */
+    CXX14_CONSTEXPR void sort()
+    {
+        sort([](const value_type& lhs, const value_type& rhs) { return lhs < rhs; });
+    }
     
-    // StaticList node base class
-    struct NodeBase
+    /**
+    @brief sorts the elements
+    Sorts the elements in ascending order using the given comparison function. The order of equal elements is preserved.
+    The nodes are relinked using bottom-up merge sort, i.e. no elements are copied and no memory is allocated.
+    No references or iterators become invalidated.
+    @param comp comparison function object which returns true if the first argument is less than the second one
+    */
+    template <typename Compare>
+    CXX14_CONSTEXPR void sort(Compare comp)
     {
-        CXX14_CONSTEXPR NodeBase(NodeBase* prev = nullptr, NodeBase * next = nullptr) : m_prev(prev), m_next(next)
+        relink(listHelper::sort<Node>(detach(), comp));
+    }
+    
+    /**
+    @brief removes consecutive duplicate elements
+    Removes all but the first element from every consecutive group of equal elements.
+    @result The number of elements removed
+    */
+    constexpr size_type unique()
+    {
+        return unique([](const value_type& lhs, const value_type& rhs) { return lhs == rhs; });
+    }
+    
+    /**
+    @brief removes consecutive duplicate elements
+    Removes all but the first element from every consecutive group of equivalent elements.
+    @param pred binary predicate which returns true if the elements should be treated as equal
+    @result The number of elements removed
+    */
+    template <typename BinaryPredicate>
+    constexpr size_type unique(BinaryPredicate pred)
+    {
+        size_type nofRemovedElems = 0;
+        if (empty())
+        {
+            return nofRemovedElems;
+        }
+        
+        NodeBase* node = m_front.m_next;
+        while (&m_back != node->m_next)
         {
-            if (nullptr != prev)
+            Node* next = static_cast<Node*>(node->m_next);
+            if (pred(static_cast<Node*>(node)->m_data, next->m_data))
             {
-                prev->m_next = this;
+                deleteNode(next);
+                ++nofRemovedElems;
             }
-            
-            if (nullptr != next)
+            else
             {
-                next->m_prev = this;
+                node = next;
             }
         }
         
-        CXX20_CONSTEXPR ~NodeBase()
+        return nofRemovedElems;
+    }
+    
+    /**
+    @brief merges two sorted lists
+    Merges the sorted list other into *this using operator<. The lists should be sorted into ascending order.
+    Since each StaticList owns the storage of its nodes, the elements of other are moved into nodes of *this. The container other becomes empty after the operation.
+    Throws bad_alloc if the capacity of *this is exceeded. For equivalent elements, the elements of *this precede the elements of other.
+    @param other another container to merge
+    */
+    CXX14_CONSTEXPR void merge(StaticList& other)
+    {
+        merge(other, [](const value_type& lhs, const value_type& rhs) { return lhs < rhs; });
+    }
+    
+    /**
+    @brief merges two sorted lists
+    Merges the sorted list other into *this using the given comparison function. The lists should be sorted into ascending order.
+    Since each StaticList owns the storage of its nodes, the elements of other are moved into nodes of *this. The container other becomes empty after the operation.
+    Throws bad_alloc if the capacity of *this is exceeded. For equivalent elements, the elements of *this precede the elements of other.
+    @param other another container to merge
+    @param comp comparison function object which returns true if the first argument is less than the second one
+    */
+    template <typename Compare>
+    CXX14_CONSTEXPR void merge(StaticList& other, Compare comp)
+    {
+        if (this == &other)
         {
-            if (nullptr != m_prev)
-            {
-                m_prev->m_next = m_next;
-            }
+            return;
+        }
+        
+        NodeBase* pos = m_front.m_next;
+        while (!other.empty())
+        {
+            Node* node = static_cast<Node*>(other.m_front.m_next);
             
-            if (nullptr != m_next)
+            // Find first element of *this which is greater than the first element of other
+            while (&m_back != pos && !comp(node->m_data, static_cast<Node*>(pos)->m_data))
             {
-                m_next->m_prev = m_prev;
+                pos = pos->m_next;
             }
+            
+            new (allocateNode()) Node(pos->m_prev, pos, move(node->m_data));
+            other.deleteNode(node);
         }
-        
-        NodeBase* m_prev = nullptr;
-        NodeBase* m_next = nullptr;
-    };
-
+    }
+    
+    private:
+    
     // StaticList node class
     struct Node : public NodeBase
     {
@@ -921,54 +984,31 @@ class StaticList
     
     CXX14_CONSTEXPR void init()
     {
-        // Link front and back node
-        link(m_front, m_back);
-        
         // set up an internal available-list allocator
-        for (size_t cnt = 0; cnt < t_capacity; ++cnt)
-        {
-            NodeBase* node = reinterpret_cast<NodeBase*>(&m_buffer[cnt][0]);
-            node->m_next = m_available;
-            m_available = node;
-        }        
+        initPool(&m_buffer[0][0], sizeof(Node), t_capacity);
     }
     
-    constexpr static void link(NodeBase& prev, NodeBase& next)
-    {
-        // Link two nodes of the list
-        prev.m_next = &next;
-        next.m_prev = &prev;
-    }
-
     constexpr void deleteNode(Node* node)
     {
         // Destruct the node and its content
         node->~Node();
         
         // Attach node to available-list
-        node->m_next = m_available;
-        m_available = node;
+        pushAvailable(node);
     }
     
     constexpr void* allocateNode()
     {
-        // Check available-list
-        NodeBase * available = m_available;
-        if (nullptr == available)
+        // Detach node from available-list
+        NodeBase* node = popAvailable();
+        if (nullptr == node)
         {
             throw_bad_alloc();
         }
-        
-        // Detach node from available-list
-        m_available = available->m_next;
-        return available;
+        return node;
     }
 
-    NodeBase m_front;
-    NodeBase m_back;
-    
-    uint8_t m_buffer[t_capacity][sizeof(Node)];
-    NodeBase* m_available = nullptr;
+    alignas(Node) uint8_t m_buffer[t_capacity][sizeof(Node)];
 };
 
 #endif
\ No newline at end of file
@@ -284,6 +284,26 @@ class String
         return m_capacity;
     }
 
+    /**
+    @brief Direct access to the underlying character storage
+    The range [data(), data() + size()) is valid. The characters are not null-terminated.
+    @return Pointer to the first character of this string.
+    */
+    CXX14_CONSTEXPR char* data()
+    {
+        return m_data;
+    }
+
+    /**
+    @brief Direct read-only access to the underlying character storage
+    The range [data(), data() + size()) is valid. The characters are not null-terminated.
+    @return Pointer to the first character of this string.
+    */
+    constexpr const char* data() const
+    {
+        return m_data;
+    }
+
     /**
     @brief Returns the content of this string as a C-style string.
     @return The content of this string as a C-style string.
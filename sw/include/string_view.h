@@ -0,0 +1,637 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef STRING_VIEW_H
+#define STRING_VIEW_H
+
+#include <bits/c++config.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <avr/pgmspace.h>
+#include <type_traits.h>
+#include <string.h>
+#include <pgm_string.h>
+#include <span.h>
+
+template <bool t_progmem>
+class BasicStringView;
+
+namespace stringViewHelper
+{
+    // Containers whose data() points to program memory. These must not be viewed as a StringView.
+    template <typename Container>
+    struct isProgmemContainer : false_type {};
+
+    template <typename T>
+    struct isProgmemContainer<PgmArray<T>> : true_type {};
+
+    template <typename T>
+    struct isProgmemContainer<PgmSpan<T>> : true_type {};
+
+    template <>
+    struct isProgmemContainer<PgmString> : true_type {};
+
+    template <>
+    struct isProgmemContainer<BasicStringView<true>> : true_type {};
+}
+
+/**
+@brief Non-owning read-only view of a sequence of characters in RAM or program memory
+A string view refers to a sequence of characters it does not own, i.e. the viewed string must outlive the view. Views are cheap to copy
+and should be passed by value. All operations work on the viewed characters in place and never allocate memory, e.g. substr() and split()
+return views of the same characters. Views of RAM and program memory can be compared and searched in each other without copying.
+Use the aliases StringView and PgmStringView:
+@code
+void onLine(const StringView line)
+{
+    for (const StringView token : line.trim().split(' '))
+    {
+        if (token.startsWith("set"_pgm))
+        ...
+    }
+}
+@endcode
+@note The characters are not null-terminated.
+@tparam t_progmem true if the characters reside in program memory, false if the characters reside in RAM
+*/
+template <bool t_progmem>
+class BasicStringView
+{
+    public:
+
+    using value_type = char;
+    using size_type  = size_t;
+
+    class ConstIterator;
+    class Splitter;
+
+    using const_iterator = ConstIterator;
+
+    /// @brief Position returned by find() if nothing has been found
+    static constexpr size_type s_npos = static_cast<size_type>(-1);
+
+    /**
+    @brief Read-only iterator returning characters by value
+    */
+    class ConstIterator
+    {
+        public:
+
+        constexpr explicit ConstIterator(const char* ptr) : m_ptr(ptr)
+        {}
+
+        constexpr ConstIterator& operator++()
+        {
+            ++m_ptr;
+            return *this;
+        }
+
+        constexpr char operator*() const
+        {
+            return BasicStringView::readChar(m_ptr);
+        }
+
+        constexpr bool operator==(const ConstIterator& other) const
+        {
+            return m_ptr == other.m_ptr;
+        }
+
+        constexpr bool operator!=(const ConstIterator& other) const
+        {
+            return m_ptr != other.m_ptr;
+        }
+
+        private:
+
+        const char* m_ptr;
+    };
+
+    /**
+    @brief Range of the tokens of a view separated by a separator character, see split()
+    */
+    class Splitter
+    {
+        public:
+
+        /**
+        @brief Iterator returning one token after the other
+        */
+        class Iterator
+        {
+            friend class Splitter;
+
+            constexpr Iterator(const BasicStringView rest, const char separator, const bool end)
+            :
+            m_rest(rest),
+            m_separator(separator),
+            m_end(end)
+            {
+                if (!m_end)
+                {
+                    next();
+                }
+            }
+
+            public:
+
+            constexpr Iterator& operator++()
+            {
+                if (m_last)
+                {
+                    m_end = true;
+                }
+                else
+                {
+                    next();
+                }
+                return *this;
+            }
+
+            constexpr BasicStringView operator*() const
+            {
+                return m_token;
+            }
+
+            constexpr bool operator!=(const Iterator& other) const
+            {
+                // Only iterators of the same splitter are compared
+                return m_end != other.m_end;
+            }
+
+            private:
+
+            // Extract the next token from the remaining characters
+            constexpr void next()
+            {
+                const size_type pos = m_rest.find(m_separator);
+                if (s_npos == pos)
+                {
+                    m_token = m_rest;
+                    m_last = true;
+                }
+                else
+                {
+                    m_token = m_rest.substr(0, pos);
+                    m_rest = m_rest.substr(pos + 1);
+                }
+            }
+
+            BasicStringView m_rest;
+            BasicStringView m_token;
+            char m_separator;
+            bool m_last = false;
+            bool m_end;
+        };
+
+        constexpr Splitter(const BasicStringView view, const char separator) : m_view(view), m_separator(separator)
+        {}
+
+        constexpr Iterator begin() const
+        {
+            return Iterator(m_view, m_separator, false);
+        }
+
+        constexpr Iterator end() const
+        {
+            return Iterator(m_view, m_separator, true);
+        }
+
+        private:
+
+        BasicStringView m_view;
+        char m_separator;
+    };
+
+    /**
+    @brief Constructs an empty view
+    */
+    constexpr BasicStringView() = default;
+
+    /**
+    @brief Constructs a view over the range [str, str + size)
+    @param str Pointer to the first character, in program memory if t_progmem is true
+    @param size Number of characters
+    */
+    constexpr BasicStringView(const char* str, const size_type size)
+    :
+    m_data(str),
+    m_size(size)
+    {}
+
+    /**
+    @brief Constructs a view over a null-terminated string in RAM (excluding the null terminator)
+    @param str Null-terminated string
+    */
+    template <bool t_ram = !t_progmem, typename = enable_if_t<t_ram>>
+    constexpr BasicStringView(const char* str)
+    :
+    m_data(str),
+    m_size(strLen(str))
+    {}
+
+    /**
+    @brief Constructs a view over a container of characters in RAM
+    The container has to provide the methods data() and size(). This includes String, StaticString and ConstSpan<char>.
+    Containers in program memory (PgmArray, PgmSpan, PgmString, PgmStringView) are rejected, use PgmStringView instead.
+    @param container Container to view
+    */
+    template <typename Container, typename = enable_if_t<
+    !t_progmem &&
+    is_convertible<decltype(declval<const Container&>().data()), const char*>::value &&
+    !stringViewHelper::isProgmemContainer<Container>::value>>
+    constexpr BasicStringView(const Container& container)
+    :
+    m_data(container.data()),
+    m_size(container.size())
+    {}
+
+    /**
+    @brief Constructs a view over a PgmString
+    @param string PgmString to view
+    */
+    template <bool t_pgm = t_progmem, typename = enable_if_t<t_pgm>>
+    constexpr BasicStringView(const PgmString& string)
+    :
+    m_data(string.data()),
+    m_size(string.size())
+    {}
+
+    /**
+    @brief Constructs a view over a span of characters in program memory
+    @param span PgmSpan to view
+    */
+    template <bool t_pgm = t_progmem, typename = enable_if_t<t_pgm>>
+    constexpr BasicStringView(const PgmSpan<char>& span)
+    :
+    m_data(span.data()),
+    m_size(span.size())
+    {}
+
+    /**
+    @brief Access specified character. No bounds checking is performed.
+    @param pos Position of the character
+    @result Copy of the character
+    */
+    constexpr char operator[](const size_type pos) const
+    {
+        return readChar(m_data + pos);
+    }
+
+    /**
+    @brief Access the first character. Calling front on an empty view is undefined.
+    @result Copy of the first character
+    */
+    constexpr char front() const
+    {
+        return readChar(m_data);
+    }
+
+    /**
+    @brief Access the last character. Calling back on an empty view is undefined.
+    @result Copy of the last character
+    */
+    constexpr char back() const
+    {
+        return readChar(m_data + m_size - 1);
+    }
+
+    /**
+    @brief Direct access to the viewed characters
+    If t_progmem is true, the pointer must not be dereferenced directly, but only via pgm_read_*() functions.
+    @result Pointer to the first character
+    */
+    constexpr const char* data() const
+    {
+        return m_data;
+    }
+
+    /**
+    @brief Get const iterator to the first character
+    @result Const iterator to the first character
+    */
+    constexpr ConstIterator begin() const
+    {
+        return ConstIterator(m_data);
+    }
+
+    /**
+    @brief Get const iterator to the last plus one character
+    @result Const iterator to the last plus one character
+    */
+    constexpr ConstIterator end() const
+    {
+        return ConstIterator(m_data + m_size);
+    }
+
+    /**
+    @brief Returns the number of characters
+    @result Number of characters
+    */
+    constexpr size_type size() const
+    {
+        return m_size;
+    }
+
+    /**
+    @brief Checks if the view is empty
+    @result true if the view is empty, false otherwise
+    */
+    constexpr bool empty() const
+    {
+        return 0 == m_size;
+    }
+
+    /**
+    @brief Obtains a view of a range of characters
+    @param pos Position of the first character. Must not exceed size()
+    @param count Number of characters. The view is truncated at the end of this view
+    @result View of the range [pos, pos + count)
+    */
+    constexpr BasicStringView substr(const size_type pos, size_type count = s_npos) const
+    {
+        const size_type remaining = m_size - pos;
+        if (count > remaining)
+        {
+            count = remaining;
+        }
+        return BasicStringView(m_data + pos, count);
+    }
+
+    /**
+    @brief Shrinks the view by moving its start forward
+    @param count Number of characters to remove from the beginning. Must not exceed size()
+    */
+    constexpr void removePrefix(const size_type count)
+    {
+        m_data += count;
+        m_size -= count;
+    }
+
+    /**
+    @brief Shrinks the view by moving its end backward
+    @param count Number of characters to remove from the end. Must not exceed size()
+    */
+    constexpr void removeSuffix(const size_type count)
+    {
+        m_size -= count;
+    }
+
+    /**
+    @brief Obtains a view without leading and trailing white space (space, tab, carriage return and line feed)
+    @result Trimmed view
+    */
+    constexpr BasicStringView trim() const
+    {
+        BasicStringView result = *this;
+        while (!result.empty() && isSpace(result.front()))
+        {
+            result.removePrefix(1);
+        }
+        while (!result.empty() && isSpace(result.back()))
+        {
+            result.removeSuffix(1);
+        }
+        return result;
+    }
+
+    /**
+    @brief Splits the view into tokens separated by a separator character
+    Consecutive separators result in empty tokens, and a view without separator results in a single token:
+    @code
+    for (const StringView token : StringView("a,b,,c").split(','))
+    {
+        // "a", "b", "", "c"
+    }
+    @endcode
+    @param separator Separator character
+    @result Range of tokens for use in a range-based for loop
+    */
+    constexpr Splitter split(const char separator) const
+    {
+        return Splitter(*this, separator);
+    }
+
+    /**
+    @brief Finds the first occurrence of a character
+    @param c Character to find
+    @param pos Position at which to start the search
+    @result Position of the character, or s_npos if not found
+    */
+    constexpr size_type find(const char c, const size_type pos = 0) const
+    {
+        for (size_type idx = pos; idx < m_size; ++idx)
+        {
+            if (c == readChar(m_data + idx))
+            {
+                return idx;
+            }
+        }
+        return s_npos;
+    }
+
+    /**
+    @brief Finds the first occurrence of a string in RAM
+    @param str String to find
+    @param pos Position at which to start the search
+    @result Position of the first character of the string, or s_npos if not found
+    */
+    constexpr size_type find(const BasicStringView<false> str, const size_type pos = 0) const
+    {
+        return findImpl(str, pos);
+    }
+
+    /**
+    @brief Finds the first occurrence of a string in program memory
+    @param str String to find
+    @param pos Position at which to start the search
+    @result Position of the first character of the string, or s_npos if not found
+    */
+    constexpr size_type find(const BasicStringView<true> str, const size_type pos = 0) const
+    {
+        return findImpl(str, pos);
+    }
+
+    /**
+    @brief Checks if the view starts with the given character
+    @param c Character to check
+    @result true if the first character is c, false otherwise
+    */
+    constexpr bool startsWith(const char c) const
+    {
+        return !empty() && c == front();
+    }
+
+    /**
+    @brief Checks if the view starts with the given string in RAM
+    @param str Prefix to check
+    @result true if the view starts with str, false otherwise
+    */
+    constexpr bool startsWith(const BasicStringView<false> str) const
+    {
+        return str.size() <= m_size && 0 == substr(0, str.size()).compareImpl(str);
+    }
+
+    /**
+    @brief Checks if the view starts with the given string in program memory
+    @param str Prefix to check
+    @result true if the view starts with str, false otherwise
+    */
+    constexpr bool startsWith(const BasicStringView<true> str) const
+    {
+        return str.size() <= m_size && 0 == substr(0, str.size()).compareImpl(str);
+    }
+
+    /**
+    @brief Checks if the view ends with the given character
+    @param c Character to check
+    @result true if the last character is c, false otherwise
+    */
+    constexpr bool endsWith(const char c) const
+    {
+        return !empty() && c == back();
+    }
+
+    /**
+    @brief Checks if the view ends with the given string in RAM
+    @param str Suffix to check
+    @result true if the view ends with str, false otherwise
+    */
+    constexpr bool endsWith(const BasicStringView<false> str) const
+    {
+        return str.size() <= m_size && 0 == substr(m_size - str.size()).compareImpl(str);
+    }
+
+    /**
+    @brief Checks if the view ends with the given string in program memory
+    @param str Suffix to check
+    @result true if the view ends with str, false otherwise
+    */
+    constexpr bool endsWith(const BasicStringView<true> str) const
+    {
+        return str.size() <= m_size && 0 == substr(m_size - str.size()).compareImpl(str);
+    }
+
+    /**
+    @brief Lexicographical comparison with a string in RAM
+    @param str String to compare with
+    @result Negative value if this view sorts before str, zero if both are equal, positive value otherwise
+    */
+    constexpr int compare(const BasicStringView<false> str) const
+    {
+        return compareImpl(str);
+    }
+
+    /**
+    @brief Lexicographical comparison with a string in program memory
+    @param str String to compare with
+    @result Negative value if this view sorts before str, zero if both are equal, positive value otherwise
+    */
+    constexpr int compare(const BasicStringView<true> str) const
+    {
+        return compareImpl(str);
+    }
+
+    /**
+    @brief Equality operator
+    @param str String in RAM to compare with
+    @result true if both strings consist of the same characters, false otherwise
+    */
+    constexpr bool operator==(const BasicStringView<false> str) const
+    {
+        return m_size == str.size() && 0 == compareImpl(str);
+    }
+
+    /**
+    @brief Equality operator
+    @param str String in program memory to compare with
+    @result true if both strings consist of the same characters, false otherwise
+    */
+    constexpr bool operator==(const BasicStringView<true> str) const
+    {
+        return m_size == str.size() && 0 == compareImpl(str);
+    }
+
+    private:
+
+    template <bool>
+    friend class BasicStringView;
+
+    // Read a character from RAM or program memory
+    static constexpr char readChar(const char* ptr)
+    {
+        if CXX17_CONSTEXPR(t_progmem)
+        {
+            return static_cast<char>(pgm_read_byte(ptr));
+        }
+        else
+        {
+            return *ptr;
+        }
+    }
+
+    static constexpr bool isSpace(const char c)
+    {
+        return ' ' == c || '\t' == c || '\r' == c || '\n' == c;
+    }
+
+    template <bool t_otherProgmem>
+    constexpr int compareImpl(const BasicStringView<t_otherProgmem> str) const
+    {
+        const size_type size = m_size < str.size() ? m_size : str.size();
+        for (size_type idx = 0; idx < size; ++idx)
+        {
+            const uint8_t lhs = static_cast<uint8_t>(operator[](idx));
+            const uint8_t rhs = static_cast<uint8_t>(str[idx]);
+            if (lhs != rhs)
+            {
+                return lhs < rhs ? -1 : 1;
+            }
+        }
+        return m_size == str.size() ? 0 : (m_size < str.size() ? -1 : 1);
+    }
+
+    template <bool t_otherProgmem>
+    constexpr size_type findImpl(const BasicStringView<t_otherProgmem> str, const size_type pos) const
+    {
+        if (str.size() > m_size)
+        {
+            return s_npos;
+        }
+
+        // Naive search, i.e. O(size() * str.size()), which is fine for the short strings on a microcontroller
+        for (size_type idx = pos; idx <= m_size - str.size(); ++idx)
+        {
+            if (0 == substr(idx, str.size()).compareImpl(str))
+            {
+                return idx;
+            }
+        }
+        return s_npos;
+    }
+
+    const char* m_data = nullptr;
+    size_type m_size = 0;
+};
+
+/// @brief View of characters in RAM, e.g. of a String, StaticString or a received token
+using StringView = BasicStringView<false>;
+
+/// @brief View of characters in program memory, e.g. of a PgmString
+using PgmStringView = BasicStringView<true>;
+
+#endif
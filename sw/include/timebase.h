@@ -0,0 +1,255 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <bits/c++config.h>
+#include <limits.h>
+#include <register_access.h>
+
+/**
+@brief Monotonic 32-bit timebase extending a free-running hardware timer by a software overflow counter
+The timer counts at a fixed tick frequency and the timer overflow interrupt increments the overflow counter. The timer must be configured and started
+by the application, e.g. timer 1 in normal mode with prescaler 8 and the overflow interrupt enabled:
+@code
+using Clock = Timebase<TCNT1, BitInRegister<TIFR1, TOV1>, F_CPU / 8>;
+ISR(TIMER1_OVF_vect)
+{
+    Clock::onOverflow();
+}
+@endcode
+Reading the time does not disable interrupts. The overflow counter is read before and after the timer, and the read is repeated
+if an overflow interrupt occurred in between. If interrupts are disabled, e.g. within another interrupt, a pending overflow is detected
+by the overflow flag, so the timebase can be read from any context.
+Time values are 32-bit and wrap around, so durations must be computed as differences, which are correct across the wrap-around:
+@code
+const uint32_t start = Clock::getMicros();
+...
+const uint32_t duration = Clock::getMicros() - start;
+@endcode
+@note Reading a 16-bit timer register on AVR uses the shared TEMP register. Interrupts writing 16-bit registers of the same timer must not interrupt a read.
+@tparam Counter Timer counter register, e.g. TCNT0 or TCNT1
+@tparam OverflowFlag Timer overflow flag, e.g. BitInRegister<TIFR1, TOV1>
+@tparam t_tickFrequency Tick frequency of the timer in Hz. The number of ticks per microsecond or the number of microseconds per tick must be a power of two.
+*/
+template <typename Counter, typename OverflowFlag, uint32_t t_tickFrequency>
+class Timebase
+{
+    using Count = typename Counter::Type;
+
+    static constexpr uint8_t s_counterBits = 8 * sizeof(Count);
+
+    static constexpr bool isPowerOfTwo(const uint32_t value)
+    {
+        return 0 != value && 0 == (value & (value - 1));
+    }
+
+    static constexpr uint8_t log2(const uint32_t value)
+    {
+        return value > 1 ? 1 + log2(value >> 1) : 0;
+    }
+
+    static constexpr bool s_fastTicks = t_tickFrequency >= 1000000;
+
+    static_assert(
+    (s_fastTicks && 0 == t_tickFrequency % 1000000 && isPowerOfTwo(t_tickFrequency / 1000000)) ||
+    (!s_fastTicks && 0 == 1000000 % t_tickFrequency && isPowerOfTwo(1000000 / t_tickFrequency)),
+    "Ticks per microsecond or microseconds per tick must be a power of two");
+
+    // log2 of ticks per microsecond (fast ticks) or microseconds per tick (slow ticks)
+    static constexpr uint8_t s_shift = s_fastTicks ? log2(t_tickFrequency / 1000000) : log2(1000000 / t_tickFrequency);
+
+    static_assert(s_shift <= s_counterBits, "Tick frequency too high for the counter width");
+
+    public:
+
+    /// @brief Tick frequency in Hz
+    static constexpr uint32_t s_tickFrequency = t_tickFrequency;
+
+    /// @brief Period of the overflow interrupt in microseconds, e.g. for clocking a Scheduler from the overflow interrupt
+    static constexpr uint32_t s_overflowMicros = s_fastTicks ? (static_cast<uint32_t>(1) << (s_counterBits - s_shift)) : (static_cast<uint32_t>(1) << (s_counterBits + s_shift));
+
+    /**
+    @brief Callback for the timer overflow interrupt
+    */
+    static void onOverflow()
+    {
+        s_overflows = s_overflows + 1;
+    }
+
+    /**
+    @brief Get the current time in timer ticks
+    @result Ticks, wrapping around after 2^32 ticks
+    */
+    static uint32_t getTicks()
+    {
+        uint32_t overflows = 0;
+        const Count count = read(overflows);
+        return (overflows << s_counterBits) | count;
+    }
+
+    /**
+    @brief Get the current time in microseconds
+    @result Microseconds, wrapping around after 2^32 microseconds
+    */
+    static uint32_t getMicros()
+    {
+        uint32_t overflows = 0;
+        const Count count = read(overflows);
+
+        // Shifting the overflow count and the timer separately keeps all 32 bits of the result
+        if CXX17_CONSTEXPR(s_fastTicks)
+        {
+            return (overflows << (s_counterBits - s_shift)) + (count >> s_shift);
+        }
+        else
+        {
+            return ((overflows << s_counterBits) | count) << s_shift;
+        }
+    }
+
+    /**
+    @brief Get the time elapsed since a given point in time
+    @param start Point in time as returned by getMicros()
+    @result Elapsed microseconds
+    */
+    static uint32_t getElapsedMicros(const uint32_t start)
+    {
+        return getMicros() - start;
+    }
+
+    /**
+    @brief Convert microseconds into timer ticks
+    @param micros Microseconds
+    @result Ticks
+    */
+    static constexpr uint32_t toTicks(const uint32_t micros)
+    {
+        return s_fastTicks ? micros << s_shift : micros >> s_shift;
+    }
+
+    /**
+    @brief Convert a duration into a delay of a Scheduler clocked with a fixed period
+    The phase of the scheduler clock is unknown, i.e. the first clock() may follow immediately. One period is added, so the task is never executed early
+    and at most two periods late. Use getDelay() for a scheduler clocked from onOverflow().
+    @tparam Delay Delay type of the Scheduler
+    @param micros Duration in microseconds
+    @param periodMicros Period of Scheduler::clock() calls in microseconds, default is the overflow period
+    @result Delay in scheduler clock ticks, saturated to the range of Delay
+    */
+    template <typename Delay>
+    static constexpr Delay toDelay(const uint32_t micros, const uint32_t periodMicros = s_overflowMicros)
+    {
+        if (0 == micros)
+        {
+            return 0;
+        }
+        return saturate<Delay>(micros / periodMicros + (0 != micros % periodMicros ? 1 : 0) + 1);
+    }
+
+    /**
+    @brief Get the delay of a Scheduler clocked from onOverflow() for a task to be executed after the given duration
+    The time to the next overflow is taken into account, so the task is never executed early and at most one overflow period late.
+    @tparam Delay Delay type of the Scheduler
+    @param micros Duration in microseconds
+    @result Delay in overflow periods, saturated to the range of Delay
+    */
+    template <typename Delay>
+    static Delay getDelay(const uint32_t micros)
+    {
+        if (0 == micros)
+        {
+            return 0;
+        }
+        if (s_fastTicks && micros > (numeric_limits<uint32_t>::max() >> s_shift))
+        {
+            return numeric_limits<Delay>::max();
+        }
+
+        // Duration in ticks rounded up, and ticks until the next overflow
+        const uint32_t ticks = s_fastTicks ? micros << s_shift : shiftCeil(micros, s_shift);
+        uint32_t overflows = 0;
+        const uint32_t remaining = (static_cast<uint32_t>(1) << s_counterBits) - read(overflows);
+        if (ticks <= remaining)
+        {
+            return 1;
+        }
+        return saturate<Delay>(1 + shiftCeil(ticks - remaining, s_counterBits));
+    }
+
+    /**
+    @brief Convert a delay of a Scheduler clocked with a fixed period into microseconds
+    @tparam Delay Delay type of the Scheduler
+    @param delay Delay in scheduler clock ticks
+    @param periodMicros Period of Scheduler::clock() calls in microseconds, default is the overflow period
+    @result Duration in microseconds
+    */
+    template <typename Delay>
+    static constexpr uint32_t fromDelay(const Delay delay, const uint32_t periodMicros = s_overflowMicros)
+    {
+        return static_cast<uint32_t>(delay) * periodMicros;
+    }
+
+    private:
+
+    // Division by 2^shift rounded up. Unlike (value + 2^shift - 1) >> shift, this does not overflow for values close to 2^32.
+    static constexpr uint32_t shiftCeil(const uint32_t value, const uint8_t shift)
+    {
+        return (value >> shift) + (0 != (value & ((static_cast<uint32_t>(1) << shift) - 1)) ? 1 : 0);
+    }
+
+    template <typename Delay>
+    static constexpr Delay saturate(const uint32_t delay)
+    {
+        return delay > numeric_limits<Delay>::max() ? numeric_limits<Delay>::max() : static_cast<Delay>(delay);
+    }
+
+    // Consistent read of overflow counter and timer without disabling interrupts
+    static Count read(uint32_t& overflows)
+    {
+        uint32_t before = 0;
+        Count count = 0;
+        do
+        {
+            before = s_overflows;
+            count = Counter::read();
+            overflows = s_overflows;
+        }
+        while (before != overflows);
+
+        // With interrupts disabled, the overflow interrupt cannot increment the counter. A timer value in the lower half
+        // together with a pending overflow means that the timer has wrapped around before it was read.
+        if (OverflowFlag::read() && count < s_halfRange)
+        {
+            ++overflows;
+        }
+        return count;
+    }
+
+    static constexpr Count s_halfRange = static_cast<Count>(1) << (s_counterBits - 1);
+
+    static volatile uint32_t s_overflows;
+};
+
+// Static initialization
+template <typename Counter, typename OverflowFlag, uint32_t t_tickFrequency>
+volatile uint32_t Timebase<Counter, OverflowFlag, t_tickFrequency>::s_overflows = 0;
+
+#endif
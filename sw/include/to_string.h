@@ -23,6 +23,8 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include <stdbool.h>
 #include <string.h>
 #include <pgm_string.h>
+#include <span.h>
+#include <string_view.h>
 #include <div.h>
 
 namespace to_string_helper
@@ -195,6 +197,32 @@ namespace to_string_helper
         // Add offset to digit to get the corresponding letter
         putChar(str, static_cast<char>(value + '0'));
     }
+    
+    // Format and put a sequence of characters [first, last) to a string
+    template <typename StringImpl, typename Iter>
+    constexpr void putChars(StringImpl& str, Iter first, const Iter last, const size_t nofChars, const FormatSpec& formatSpec)
+    {
+        // Calculate number of fill characters (the field width cannot exceed 255 characters anyway)
+        const uint8_t nofFillChars = countFillChars(formatSpec.m_width, nofChars < 0xFF ? static_cast<uint8_t>(nofChars) : 0xFF);
+        
+        // Insert fill characters for right alignment
+        if (formatSpec.m_alignment == rightAlign)
+        {
+            putFillChars(str, nofFillChars, formatSpec.m_fillChar);
+        }
+        
+        // Insert actual string
+        for (; first != last; ++first)
+        {
+            putChar(str, *first, formatSpec);
+        }
+
+        // Insert fill characters for left alignment
+        if (formatSpec.m_alignment == leftAlign)
+        {
+            putFillChars(str, nofFillChars, formatSpec.m_fillChar);
+        }
+    }
 };
 
 /**
@@ -439,29 +467,7 @@ constexpr inline void toString(StringImpl& str, uint16_t value, const FormatSpec
 template <typename StringImpl, typename Allocator>
 constexpr void toString(StringImpl& str, const String<Allocator>& arg, const FormatSpec& formatSpec)
 {
-    // Calculate number of digits
-    const size_t nofChars = arg.size() ;
-    
-    // Calculate number of fill characters
-    const uint8_t nofFillChars = to_string_helper::countFillChars(formatSpec.m_width, nofChars);
-    
-    // Insert fill characters for right alignment
-    if (formatSpec.m_alignment == rightAlign)
-    {
-        to_string_helper::putFillChars(str, nofFillChars, formatSpec.m_fillChar);
-    }
-    
-    // Insert actual string
-    for (const char c : arg)
-    {
-        to_string_helper::putChar(str, c, formatSpec);
-    }
-
-    // Insert fill characters for left alignment
-    if (formatSpec.m_alignment == leftAlign)
-    {
-        to_string_helper::putFillChars(str, nofFillChars, formatSpec.m_fillChar);
-    }
+    to_string_helper::putChars(str, arg.begin(), arg.end(), arg.size(), formatSpec);
 }
 
 /**
@@ -474,29 +480,48 @@ constexpr void toString(StringImpl& str, const String<Allocator>& arg, const For
 template <typename StringImpl>
 constexpr void toString(StringImpl& str, const PgmString& arg, const FormatSpec& formatSpec)
 {
-    // Calculate number of digits
-    const size_t nofChars = arg.size() ;
-    
-    // Calculate number of fill characters
-    const uint8_t nofFillChars = to_string_helper::countFillChars(formatSpec.m_width, nofChars);
-    
-    // Insert fill characters for right alignment
-    if (formatSpec.m_alignment == rightAlign)
-    {
-        to_string_helper::putFillChars(str, nofFillChars, formatSpec.m_fillChar);
-    }
-    
-    // Insert actual string
-    for (const char c : arg)
-    {
-        to_string_helper::putChar(str, c, formatSpec);
-    }
+    to_string_helper::putChars(str, arg.begin(), arg.end(), arg.size(), formatSpec);
+}
 
-    // Insert fill characters for left alignment
-    if (formatSpec.m_alignment == leftAlign)
-    {
-        to_string_helper::putFillChars(str, nofFillChars, formatSpec.m_fillChar);
-    }
+/**
+@brief Convert a span of characters to string
+@tparam StringImpl Used string implementation
+@tparam Char Character type (char or const char)
+@param str String implementation
+@param arg Source span of characters to convert to string
+@formatSpec Format specification to be used for conversion
+*/
+template <typename StringImpl, typename Char, typename = enable_if_t<is_same<remove_cv_t<Char>, char>::value>>
+constexpr void toString(StringImpl& str, const Span<Char>& arg, const FormatSpec& formatSpec)
+{
+    to_string_helper::putChars(str, arg.begin(), arg.end(), arg.size(), formatSpec);
+}
+
+/**
+@brief Convert a span of characters stored in program memory to string
+@tparam StringImpl Used string implementation
+@param str String implementation
+@param arg Source span of characters in program memory to convert to string
+@formatSpec Format specification to be used for conversion
+*/
+template <typename StringImpl>
+constexpr void toString(StringImpl& str, const PgmSpan<char>& arg, const FormatSpec& formatSpec)
+{
+    to_string_helper::putChars(str, arg.begin(), arg.end(), arg.size(), formatSpec);
+}
+
+/**
+@brief Convert a string view (in RAM or program memory) to string
+@tparam StringImpl Used string implementation
+@tparam t_progmem true if the viewed characters reside in program memory
+@param str String implementation
+@param arg Source StringView or PgmStringView to convert to string
+@formatSpec Format specification to be used for conversion
+*/
+template <typename StringImpl, bool t_progmem>
+constexpr void toString(StringImpl& str, const BasicStringView<t_progmem>& arg, const FormatSpec& formatSpec)
+{
+    to_string_helper::putChars(str, arg.begin(), arg.end(), arg.size(), formatSpec);
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,429 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TWI_MASTER_H
+#define TWI_MASTER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <avr/io.h>
+#include <atomic.h>
+#include <functional.h>
+#include <queue.h>
+#include <register_access.h>
+#include <span.h>
+#include <static_deque.h>
+
+/**
+@brief Driver for the TWI (I2C) module of AVR devices
+The registers are passed as template parameters. Since register_access.h redefines the register macros of avr/io.h as MMIORegister types,
+the module is declared as
+@code
+using TWI = TWIModule<TWBR, TWSR, TWDR, TWCR>;
+@endcode
+Any other classes with static methods read() and write() can be used instead, e.g. a simulated peripheral for testing.
+@tparam BitRateRegister TWI bit rate register (TWBR)
+@tparam StatusRegister TWI status register (TWSR)
+@tparam DataRegister TWI data register (TWDR)
+@tparam ControlRegister TWI control register (TWCR)
+*/
+template <typename BitRateRegister, typename StatusRegister, typename DataRegister, typename ControlRegister>
+class TWIModule
+{
+    public:
+    
+    /// @brief Status codes of the TWI module in master mode
+    enum class Status : uint8_t
+    {
+        busError = 0x00,
+        start = 0x08,
+        repeatedStart = 0x10,
+        addressWriteAck = 0x18,
+        addressWriteNack = 0x20,
+        dataWriteAck = 0x28,
+        dataWriteNack = 0x30,
+        arbitrationLost = 0x38,
+        addressReadAck = 0x40,
+        addressReadNack = 0x48,
+        dataReadAck = 0x50,
+        dataReadNack = 0x58,
+        noInfo = 0xF8
+    };
+    
+    /// @brief Bit rate prescaler
+    enum class Prescaler : uint8_t
+    {
+        div1 = 0,
+        div4,
+        div16,
+        div64
+    };
+    
+    /**
+    @brief Get the bit rate register value for a given SCL frequency, assuming the prescaler is set to 1
+    @param cpuFrequency CPU clock frequency in Hz
+    @param sclFrequency SCL frequency in Hz
+    @result Bit rate register value
+    */
+    static constexpr uint8_t getBitRate(const uint32_t cpuFrequency, const uint32_t sclFrequency)
+    {
+        return static_cast<uint8_t>((cpuFrequency / sclFrequency - 16) / 2);
+    }
+    
+    /**
+    @brief Initialization of the TWI module
+    @param bitRate Bit rate register value, see getBitRate()
+    @param prescaler Bit rate prescaler, default is 1
+    */
+    static void init(const uint8_t bitRate, const Prescaler prescaler = Prescaler::div1)
+    {
+        BitRateRegister::write(bitRate);
+        PrescalerBits::write(prescaler);
+        ControlRegister::write(_BV(TWEN));
+    }
+    
+    /**
+    @brief Get the status of the last bus operation
+    @result Status
+    */
+    static Status getStatus()
+    {
+        return static_cast<Status>(StatusRegister::read() & 0xF8);
+    }
+    
+    /**
+    @brief Transmit a start (or repeated start) condition
+    */
+    static void start()
+    {
+        ControlRegister::write(_BV(TWINT) | _BV(TWSTA) | _BV(TWEN) | _BV(TWIE));
+    }
+    
+    /**
+    @brief Transmit a stop condition, optionally followed by a start condition
+    @param startNext Flag indicating if a start condition should follow once the bus is free
+    */
+    static void stop(const bool startNext)
+    {
+        if (startNext)
+        {
+            ControlRegister::write(_BV(TWINT) | _BV(TWSTO) | _BV(TWSTA) | _BV(TWEN) | _BV(TWIE));
+        }
+        else
+        {
+            ControlRegister::write(_BV(TWINT) | _BV(TWSTO) | _BV(TWEN));
+        }
+    }
+    
+    /**
+    @brief Transmit a byte, i.e. an address or data
+    @param data Byte to transmit
+    */
+    static void transmit(const uint8_t data)
+    {
+        DataRegister::write(data);
+        ControlRegister::write(_BV(TWINT) | _BV(TWEN) | _BV(TWIE));
+    }
+    
+    /**
+    @brief Receive the next byte
+    @param ack Flag indicating if the received byte should be acknowledged, i.e. if more bytes are requested
+    */
+    static void receive(const bool ack)
+    {
+        ControlRegister::write(_BV(TWINT) | _BV(TWEN) | _BV(TWIE) | (ack ? _BV(TWEA) : 0));
+    }
+    
+    /**
+    @brief Get the last byte received
+    @result Received byte
+    */
+    static uint8_t getData()
+    {
+        return DataRegister::read();
+    }
+    
+    private:
+    
+    using PrescalerBits = BitGroupInRegister<StatusRegister, TWPS0, TWPS1, Prescaler>;
+};
+
+/**
+@brief Result of a TWI transaction
+*/
+enum class TWIResult : uint8_t
+{
+    /// All bytes have been transferred
+    success,
+    
+    /// The slave did not acknowledge its address, e.g. because it is busy or not present
+    addressNack,
+    
+    /// The slave did not acknowledge a data byte
+    dataNack,
+    
+    /// Illegal start or stop condition on the bus
+    busError
+};
+
+/**
+@brief Asynchronous interrupt-driven TWI (I2C) master with a queue of transactions
+Transactions are enqueued by write(), read() and writeRead() and executed one after another by the TWI interrupt, so the application never waits
+for the bus. Data is transferred directly from and to the buffers passed by the caller, which must remain valid until the transaction has completed.
+The completion callback is called from the TWI interrupt and should be short, e.g. set a flag or schedule a task.
+Callback only stores a pointer to the invokable, not a copy. The callback must therefore be a function pointer or an object with static storage duration,
+since e.g. a lambda passed inline to write() is a temporary destroyed when write() returns, long before the transaction completes.
+If arbitration is lost to another master, the transaction is restarted as soon as the bus is free.
+The TWI interrupt must call onInterrupt():
+@code
+using TWI = TWIMasterAsync<TWIModule<TWBR, TWSR, TWDR, TWCR>, 4>;
+ISR(TWI_vect)
+{
+    TWI::onInterrupt();
+}
+@endcode
+@tparam _TWIModule TWI module driver, e.g. TWIModule
+@tparam t_queueSize Maximum number of pending transactions, including the one in progress
+@note Each part of a transaction transfers at most 255 bytes
+*/
+template <typename _TWIModule, uint8_t t_queueSize>
+class TWIMasterAsync
+{
+    public:
+    
+    /// TWI module driver
+    typedef _TWIModule TWI;
+    
+    /// @brief Completion callback, a function pointer or an invokable with static storage duration
+    using Callback = function<void(TWIResult)>;
+    
+    /**
+    @brief Initialization of the TWI module
+    @param bitRate Bit rate register value, see TWIModule::getBitRate()
+    */
+    static void init(const uint8_t bitRate)
+    {
+        TWI::init(bitRate);
+    }
+    
+    /**
+    @brief Enqueue a write transaction
+    @param address 7-bit slave address
+    @param data Bytes to write. Must remain valid until the transaction has completed.
+    @param callback Completion callback, optional. A function pointer or an invokable with static storage duration.
+    @result true if the transaction has been enqueued, false if the queue is full
+    */
+    static bool write(const uint8_t address, const ConstSpan<uint8_t> data, const Callback& callback = Callback())
+    {
+        return enqueue(Transaction{data, Span<uint8_t>(), callback, address});
+    }
+    
+    /**
+    @brief Enqueue a read transaction
+    @param address 7-bit slave address
+    @param data Buffer for the bytes to read. Must remain valid until the transaction has completed.
+    @param callback Completion callback, optional. A function pointer or an invokable with static storage duration.
+    @result true if the transaction has been enqueued, false if the queue is full
+    */
+    static bool read(const uint8_t address, const Span<uint8_t> data, const Callback& callback = Callback())
+    {
+        return enqueue(Transaction{ConstSpan<uint8_t>(), data, callback, address});
+    }
+    
+    /**
+    @brief Enqueue a write transaction followed by a read transaction using a repeated start condition, e.g. to read from a register or EEPROM address
+    @param address 7-bit slave address
+    @param writeData Bytes to write. Must remain valid until the transaction has completed.
+    @param readData Buffer for the bytes to read. Must remain valid until the transaction has completed.
+    @param callback Completion callback, optional. A function pointer or an invokable with static storage duration.
+    @result true if the transaction has been enqueued, false if the queue is full
+    */
+    static bool writeRead(const uint8_t address, const ConstSpan<uint8_t> writeData, const Span<uint8_t> readData, const Callback& callback = Callback())
+    {
+        return enqueue(Transaction{writeData, readData, callback, address});
+    }
+    
+    /**
+    @brief Check if a transaction is in progress
+    @result true if a transaction is in progress
+    */
+    static bool isBusy()
+    {
+        bool busy = false;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            busy = !s_queue.empty();
+        }
+        return busy;
+    }
+    
+    /**
+    @brief Get the number of transactions which have not completed yet
+    @result Number of pending transactions, including the one in progress
+    */
+    static size_t getNofPendingTransactions()
+    {
+        size_t size = 0;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            size = s_queue.size();
+        }
+        return size;
+    }
+    
+    /**
+    @brief Callback for the TWI interrupt advancing the transaction in progress by one step
+    */
+    static void onInterrupt()
+    {
+        using Status = typename TWI::Status;
+        
+        Transaction& transaction = s_queue.front();
+        switch (TWI::getStatus())
+        {
+            case Status::start:
+            case Status::repeatedStart:
+            // An empty write transaction only addresses the slave, e.g. to poll an EEPROM for completion of a write cycle
+            {
+                const bool reading = s_pos == transaction.writeData.size() && !transaction.readData.empty();
+                s_pos = 0;
+                TWI::transmit(static_cast<uint8_t>(transaction.address << 1) | (reading ? 1 : 0));
+            }
+            break;
+            
+            case Status::addressWriteAck:
+            case Status::dataWriteAck:
+            if (s_pos < transaction.writeData.size())
+            {
+                TWI::transmit(transaction.writeData[s_pos++]);
+            }
+            else if (!transaction.readData.empty())
+            {
+                // Continue with the read part of the transaction. s_pos still indicates that all bytes have been written.
+                TWI::start();
+            }
+            else
+            {
+                complete(TWIResult::success);
+            }
+            break;
+            
+            case Status::addressReadAck:
+            TWI::receive(transaction.readData.size() > 1);
+            break;
+            
+            case Status::dataReadAck:
+            transaction.readData[s_pos++] = TWI::getData();
+            TWI::receive(static_cast<size_t>(s_pos) + 1 < transaction.readData.size());
+            break;
+            
+            case Status::dataReadNack:
+            transaction.readData[s_pos] = TWI::getData();
+            complete(TWIResult::success);
+            break;
+            
+            case Status::addressWriteNack:
+            case Status::addressReadNack:
+            complete(TWIResult::addressNack);
+            break;
+            
+            case Status::dataWriteNack:
+            complete(TWIResult::dataNack);
+            break;
+            
+            case Status::arbitrationLost:
+            // Restart the transaction from the beginning once the bus is free
+            s_pos = 0;
+            TWI::start();
+            break;
+            
+            case Status::busError:
+            complete(TWIResult::busError);
+            break;
+            
+            default:
+            break;
+        }
+    }
+    
+    private:
+    
+    struct Transaction
+    {
+        ConstSpan<uint8_t> writeData;
+        Span<uint8_t> readData;
+        Callback callback;
+        uint8_t address;
+    };
+    
+    static bool enqueue(const Transaction& transaction)
+    {
+        bool enqueued = false;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            if (s_queue.size() < t_queueSize)
+            {
+                s_queue.push(transaction);
+                enqueued = true;
+                
+                // Start transaction unless another one is in progress or completing, which starts the next one
+                if (1 == s_queue.size() && !s_completing)
+                {
+                    s_pos = 0;
+                    TWI::start();
+                }
+            }
+        }
+        return enqueued;
+    }
+    
+    // Complete the transaction in progress and start the next one
+    static void complete(const TWIResult result)
+    {
+        // Transactions enqueued by the callback are started below
+        s_completing = true;
+        const Callback callback = s_queue.front().callback;
+        s_queue.pop();
+        callback(result);
+        s_completing = false;
+        
+        s_pos = 0;
+        TWI::stop(!s_queue.empty());
+    }
+    
+    using TransactionQueue = Queue<Transaction, StaticDeque<Transaction, t_queueSize>>;
+    
+    // Pending transactions, the front one is in progress
+    static TransactionQueue s_queue;
+    
+    // Position of the next byte to write or read
+    static uint8_t s_pos;
+    static bool s_completing;
+};
+
+// Static initialization
+template <typename TWI, uint8_t t_queueSize>
+typename TWIMasterAsync<TWI, t_queueSize>::TransactionQueue TWIMasterAsync<TWI, t_queueSize>::s_queue;
+
+template <typename TWI, uint8_t t_queueSize>
+uint8_t TWIMasterAsync<TWI, t_queueSize>::s_pos = 0;
+
+template <typename TWI, uint8_t t_queueSize>
+bool TWIMasterAsync<TWI, t_queueSize>::s_completing = false;
+
+#endif
@@ -266,7 +266,7 @@ template<class Ret, class... Args> struct is_function<Ret(Args......) const vola
     template<class T> struct is_const;
     template<class T> struct is_volatile;
     template<class T> struct is_trivial;
-    template<class T> struct is_trivially_copyable;
+    template<class T> struct is_trivially_copyable : public bool_constant<__is_trivially_copyable(T)> {};
     template<class T> struct is_standard_layout;
     template<class T> struct is_empty;
     template<class T> struct is_polymorphic;
@@ -640,6 +640,19 @@ template<class Ret, class... Args> struct is_function<Ret(Args......) const vola
     // constant evaluation context
     constexpr bool is_constant_evaluated() noexcept;
 
+	// Make a type volatile depending on a flag
+	template <typename T, bool t_volatile>
+	struct MakeVolatile
+	{
+		typedef T type;
+	};
+
+	template <typename T>
+	struct MakeVolatile<T, true>
+	{
+		typedef T volatile type;
+	};
+
 	// Cast a size_t value to the smallest possible integer type that can represent the value
 	template <size_t t_number, bool t_isUint16 = t_number < 65536, bool t_isUint8 = t_number < 256>
 	struct DownCast;
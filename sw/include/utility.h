@@ -45,4 +45,38 @@ inline constexpr in_place_index_t<I> in_place_index{};
 
 #endif
 
+#if SINCE_CXX11
+
+/**
+@brief Compile-time sequence of integers
+Used to expand a parameter pack of indices, e.g. for unrolling a loop over a fixed number of elements
+@tparam T Integer type
+@tparam t_ints Integer values
+*/
+template <typename T, T ... t_ints>
+struct integer_sequence
+{
+    using value_type = T;
+
+    static constexpr std::size_t size()
+    {
+        return sizeof...(t_ints);
+    }
+};
+
+template <std::size_t ... t_ints>
+using index_sequence = integer_sequence<std::size_t, t_ints...>;
+
+/**
+@brief Integer sequence 0, 1, ..., N-1
+Uses the GCC built-in __integer_pack to avoid recursive template instantiation
+*/
+template <typename T, T N>
+using make_integer_sequence = integer_sequence<T, __integer_pack(N)...>;
+
+template <std::size_t N>
+using make_index_sequence = make_integer_sequence<std::size_t, N>;
+
+#endif
+
 #endif
\ No newline at end of file
@@ -23,6 +23,7 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include <bits/new.h>
 #include <bits/move.h>
 #include <exception.h>
+#include <optional.h>
 
 #include <type_traits.h>
 #include <utility.h>
@@ -247,12 +248,20 @@ class Variant
     public:
     
     using size_type = size_t;
+
+    private:
+
+    // The index is stored in the smallest possible type, using the value -1 as niche for the valueless state
+    using IndexType = typename DownCast<sizeof...(Types) + 1>::type;
+    using Index = Optional<IndexType, Sentinel<IndexType, static_cast<IndexType>(-1)>>;
+
+    public:
     
     /**
     @brief constructs the variant object
     Default constructor. Constructs a variant holding the value-initialized value of the first alternative (index() is zero).
     */
-    constexpr Variant() : m_index(0)
+    constexpr Variant() : m_index(static_cast<IndexType>(0))
     {
         new (getPtr<0>()) IndexToTypeT<0>;
     }
@@ -266,7 +275,7 @@ class Variant
     {
         static_assert(isPartOfV<Type>, "Invalid type");
         new (getPtr<Type>()) Type(forward<Args>(args)...);
-        m_index = typeToIndexV<Type>;
+        m_index = static_cast<IndexType>(typeToIndexV<Type>);
     }
     
     /**
@@ -279,7 +288,7 @@ class Variant
         using Type = IndexToTypeT<t_index>;
         static_assert(isPartOfV<Type>, "Invalid type");
         new (getPtr<Type>()) Type(forward<Args>(args)...);
-        m_index = t_index;
+        m_index = static_cast<IndexType>(t_index);
     }
 
     /**
@@ -304,7 +313,7 @@ class Variant
     */
     CXX20_CONSTEXPR ~Variant()
     {
-        if (m_index != static_cast<size_type>(-1))
+        if (m_index)
         {
             destroy();
         }
@@ -319,7 +328,7 @@ class Variant
         if (other.m_index == m_index)
         {
             // This and other are holding the same alternative --> copy-assign value if not valueless
-            if (m_index != static_cast<size_type>(-1))
+            if (m_index)
             {
                 copyAssign(other);
             }
@@ -328,7 +337,7 @@ class Variant
         {
             // This and other are not holding the same alternative
             // Destroy value if this not valueless
-            if (m_index != static_cast<size_type>(-1))
+            if (m_index)
             {
                 destroy();
             }
@@ -336,7 +345,7 @@ class Variant
             m_index = other.m_index;
             
             // Copy-construct value if other is not valueless
-            if (m_index != static_cast<size_type>(-1))
+            if (m_index)
             {
                 copyConstruct(other);
             }
@@ -353,7 +362,7 @@ class Variant
         if (other.m_index == m_index)
         {
             // This and other are holding the same alternative --> move-assign value if not valueless
-            if (m_index != static_cast<size_type>(-1))
+            if (m_index)
             {
                 moveAssign(forward<Variant>(other));
             }
@@ -362,7 +371,7 @@ class Variant
         {
             // This and other are not holding the same alternative
             // Destroy value if this not valueless
-            if (m_index != static_cast<size_type>(-1))
+            if (m_index)
             {
                 destroy();
             }
@@ -370,7 +379,7 @@ class Variant
             m_index = other.m_index;
             
             // Move-construct value if other is not valueless
-            if (m_index != static_cast<size_type>(-1))
+            if (m_index)
             {
                 moveConstruct(forward<Variant>(other));
             }
@@ -388,13 +397,13 @@ class Variant
     constexpr enable_if_t<isPartOfV<remove_cvref_t<Type>>, Variant&> operator=(const Type& value)
     {
         constexpr size_t newId = typeToIndexV<Type>;
-        if (newId != m_index)
+        if (newId != index())
         {
             emplace<remove_cvref_t<Type>>(value);
         }
         else
         {
-            get<remove_cvref_t<Type>>() = value;
+            *getPtr<remove_cvref_t<Type>>() = value;
         }
         
         return *this;
@@ -410,7 +419,7 @@ class Variant
     constexpr enable_if_t<isPartOfV<remove_cvref_t<Type>>, Variant&> operator=(Type&& value)
     {
         constexpr size_t newId = typeToIndexV<remove_cvref_t<Type>>;
-        if (newId != m_index)
+        if (newId != index())
         {
             emplace<remove_cvref_t<Type>>(forward<Type>(value));
         }
@@ -433,8 +442,11 @@ class Variant
     constexpr Type& emplace(Args&&... args)
     {
         static_assert(isPartOfV<Type>, "Invalid type");
-        destroy();
-        m_index = typeToIndexV<Type>;
+        if (m_index)
+        {
+            destroy();
+        }
+        m_index = static_cast<IndexType>(typeToIndexV<Type>);
         return *(new (getPtr<Type>()) Type(forward<Args>(args)...));
     }
     
@@ -458,7 +470,7 @@ class Variant
     */
     constexpr size_type index() const
     {
-        return m_index;
+        return m_index ? *m_index : static_cast<size_type>(-1);
     }
 
     private:
@@ -530,7 +542,7 @@ class Variant
     {
         // Use destruction functor as visitor
         visit(move(Destructor()), *this);
-        m_index = -1;
+        m_index.reset();
     }
 
     // Copy-assignment functor
@@ -610,7 +622,7 @@ class Variant
     }
     
     // Members
-    size_t m_index = -1;
+    Index m_index;
     char m_buffer[variantHelper::MaxSizeV<Types...>];
 };
 
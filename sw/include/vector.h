@@ -766,7 +766,7 @@ class Vector
     {
         if (full())
         {
-            reallocate(m_capacity << 1);
+            reallocate(grownCapacity());
         }
         
         new (m_data + m_size) value_type(value);
@@ -782,7 +782,7 @@ class Vector
     {
         if (full())
         {
-            reallocate(m_capacity << 1);
+            reallocate(grownCapacity());
         }
         
         new (m_data + m_size) value_type(forward<value_type>(value));
@@ -801,7 +801,7 @@ class Vector
     {
         if (full())
         {
-            reallocate(m_capacity << 1);
+            reallocate(grownCapacity());
         }
 
         value_type* newElem = new (m_data + m_size) value_type(forward<Args>(args)...);
@@ -858,6 +858,12 @@ class Vector
         return m_size == m_capacity;
     }
     
+    // Capacity after growing a full container. An empty container without storage grows to one element.
+    constexpr size_type grownCapacity() const
+    {
+        return 0 == m_capacity ? 1 : m_capacity << 1;
+    }
+    
     constexpr value_type* allocate(const size_type capacity)
     {
         value_type* ptr = static_cast<value_type*>(m_allocator.allocate(capacity * sizeof(value_type)));
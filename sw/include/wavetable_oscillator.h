@@ -0,0 +1,415 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef WAVETABLE_OSCILLATOR_H
+#define WAVETABLE_OSCILLATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <avr/pgmspace.h>
+#include <type_traits.h>
+#include <utility.h>
+#include <array.h>
+#include <pgm_array.h>
+#include <span.h>
+
+/**
+@brief Harmonic series of a sine wave
+Shapes define the amplitude of harmonic k (k >= 1) of the sine series of a waveform. They are only evaluated at compile time.
+*/
+struct SineShape
+{
+    static constexpr float getHarmonic(const uint8_t k)
+    {
+        return 1 == k ? 1.0f : 0.0f;
+    }
+};
+
+/**
+@brief Harmonic series of a rising sawtooth wave
+*/
+struct SawShape
+{
+    static constexpr float getHarmonic(const uint8_t k)
+    {
+        return -1.0f / k;
+    }
+};
+
+/**
+@brief Harmonic series of a square wave
+*/
+struct SquareShape
+{
+    static constexpr float getHarmonic(const uint8_t k)
+    {
+        return (k & 1) ? 1.0f / k : 0.0f;
+    }
+};
+
+/**
+@brief Harmonic series of a triangle wave
+*/
+struct TriangleShape
+{
+    static constexpr float getHarmonic(const uint8_t k)
+    {
+        return (k & 1) ? ((k & 2) ? -1.0f : 1.0f) / (static_cast<float>(k) * k) : 0.0f;
+    }
+};
+
+/**
+@brief Set of band-limited wavetables of a waveform, generated at compile time and stored in program memory
+Each table holds one period of 256 signed 8-bit samples. Band 0 contains all harmonics a 256-sample table can represent (1..128),
+and every further band halves the number of harmonics. An oscillator picks the band whose highest harmonic stays below the Nyquist frequency
+for its phase increment, so high notes do not alias. Every band uses 256 bytes of flash, and all bands are normalized to the range -127..127.
+@code
+osc.setWaveform(0, Wavetable<SawShape>::getBands());
+@endcode
+@tparam Shape Harmonic series of the waveform, e.g. SineShape, SawShape, SquareShape or TriangleShape
+@tparam t_nofBands Number of bands (1..8). Band t_nofBands-1 is used for all higher frequencies.
+*/
+template <typename Shape, uint8_t t_nofBands = 8>
+class Wavetable
+{
+    static_assert(t_nofBands > 0 && t_nofBands <= 8, "Number of bands must be in range 1..8");
+
+    public:
+
+    /// @brief Number of samples per table
+    static constexpr uint16_t s_size = 256;
+
+    /**
+    @brief Get the tables of all bands
+    @result Tables ordered by decreasing number of harmonics
+    */
+    static constexpr ConstSpan<PgmArray<int8_t>> getBands()
+    {
+        return ConstSpan<PgmArray<int8_t>>(s_bands.data(), t_nofBands);
+    }
+
+    /**
+    @brief Get the table of a single band
+    @param band Band index
+    @result Table of the given band
+    */
+    static constexpr PgmArray<int8_t> getBand(const uint8_t band)
+    {
+        return s_bands[band];
+    }
+
+    /**
+    @brief Get the number of harmonics of a band
+    @param band Band index
+    @result Number of harmonics
+    */
+    static constexpr uint8_t getNofHarmonics(const uint8_t band)
+    {
+        return static_cast<uint8_t>((s_size >> 1) >> band);
+    }
+
+    private:
+
+    // Compile-time sine of 2*pi*idx/256, Taylor series after reduction to [-pi/2, pi/2]
+    static constexpr float sine(const uint8_t idx)
+    {
+        constexpr float pi = 3.14159265358979f;
+        const uint8_t quadrant = idx >> 6;
+        const uint8_t offset = idx & 0x3F;
+        float x = 2.0f * pi * ((quadrant & 1) ? 64 - offset : offset) / s_size;
+        const float x2 = x * x;
+        float term = x;
+        float sum = x;
+        for (uint8_t n = 1; n < 10; ++n)
+        {
+            term *= -x2 / ((2 * n) * (2 * n + 1));
+            sum += term;
+        }
+        return (quadrant & 2) ? -sum : sum;
+    }
+
+    // Additive synthesis of one table with the given number of harmonics, normalized to -127..127
+    static constexpr Array<int8_t, s_size> synthesize(const uint8_t nofHarmonics)
+    {
+        Array<float, s_size> sum = {};
+        float peak = 0.0f;
+        for (uint16_t idx = 0; idx < s_size; ++idx)
+        {
+            for (uint16_t k = 1; k <= nofHarmonics; ++k)
+            {
+                sum[idx] += Shape::getHarmonic(k) * sine(static_cast<uint8_t>(k * idx));
+            }
+            peak = sum[idx] > peak ? sum[idx] : (-sum[idx] > peak ? -sum[idx] : peak);
+        }
+
+        Array<int8_t, s_size> ret = {};
+        for (uint16_t idx = 0; idx < s_size; ++idx)
+        {
+            const float value = sum[idx] * 127.0f / peak;
+            ret[idx] = static_cast<int8_t>(value < 0.0f ? value - 0.5f : value + 0.5f);
+        }
+        return ret;
+    }
+
+    template <uint8_t t_band>
+    struct Band
+    {
+        static constexpr Array<int8_t, s_size> s_samples = synthesize(getNofHarmonics(t_band));
+    };
+
+    template <uint8_t t_band, size_t ... t_idx>
+    static constexpr PgmArray<int8_t> makeBand(index_sequence<t_idx...>)
+    {
+        return makePgmArray<int8_t, Band<t_band>::s_samples[t_idx]...>();
+    }
+
+    template <size_t ... t_band>
+    static constexpr Array<PgmArray<int8_t>, t_nofBands> makeBands(index_sequence<t_band...>)
+    {
+        return {makeBand<t_band>(make_index_sequence<s_size>())...};
+    }
+
+    static constexpr Array<PgmArray<int8_t>, t_nofBands> s_bands = makeBands(make_index_sequence<t_nofBands>());
+};
+
+/**
+@brief Bank of direct digital synthesis (DDS) wavetable oscillators, e.g. for audio or LFO generation in a timer interrupt
+Every voice owns a phase accumulator which is advanced by its phase increment on every tick. The upper 8 bits of the phase index a
+256-sample wavetable in program memory. With linear interpolation enabled, the next 7 bits of the phase weight the neighbouring sample,
+which removes most of the phase truncation noise at the cost of a second table read and an 8x8 bit multiplication.
+The number of voices is a compile-time constant and tick() is unrolled over all voices, so all per-voice state is accessed at
+constant addresses and the interrupt cost is a straight sequence of loads, adds and program memory reads:
+@code
+OscillatorBank<4, __uint24> osc;
+ISR(TIMER1_COMPA_vect)
+{
+    OCR0A = 128 + (osc.tick() >> 2);
+}
+@endcode
+The output frequency is f = increment * sampleRate / 2^bits, with bits being the width of the phase accumulator.
+A 24-bit accumulator (__uint24 on AVR) resolves 0.002 Hz at a sample rate of 32 kHz, a 32-bit accumulator resolves 0.00001 Hz.
+@tparam t_nofVoices Number of voices
+@tparam Phase Unsigned type of the phase accumulators, e.g. __uint24 or uint32_t (default)
+@tparam t_interpolate Enable linear interpolation between samples, default is false
+*/
+template <uint8_t t_nofVoices, typename Phase = uint32_t, bool t_interpolate = false>
+class OscillatorBank
+{
+    static_assert(t_nofVoices > 0, "Number of voices must not be zero");
+    static_assert(static_cast<Phase>(-1) > 0 && sizeof(Phase) >= 2, "Phase accumulator must be an unsigned type of at least 16 bits");
+
+    public:
+
+    /// @brief Number of voices
+    static constexpr uint8_t s_nofVoices = t_nofVoices;
+
+    /// @brief Width of the phase accumulators in bits
+    static constexpr uint8_t s_phaseBits = 8 * sizeof(Phase);
+
+    /// @brief Type of the mixed output of all voices
+    using Sample = int16_t;
+
+    /**
+    @brief Constructor. All voices play a sine wave with increment 0, i.e. output 0.
+    */
+    OscillatorBank()
+    {
+        for (uint8_t voice = 0; voice < t_nofVoices; ++voice)
+        {
+            setWaveform(voice, Wavetable<SineShape, 1>::getBands());
+        }
+    }
+
+    /**
+    @brief Convert a frequency into a phase increment. Intended for compile-time constants, as floating point arithmetic is expensive on AVR.
+    @param frequency Output frequency in Hz
+    @param sampleRate Sample rate, i.e. frequency of tick() calls, in Hz
+    @result Phase increment
+    */
+    static constexpr Phase getIncrement(const float frequency, const float sampleRate)
+    {
+        // 2^bits in two steps, since a shift by the full width of Phase is undefined
+        return static_cast<Phase>(frequency / sampleRate * static_cast<float>(static_cast<Phase>(1) << (s_phaseBits - 1)) * 2.0f + 0.5f);
+    }
+
+    /**
+    @brief Select the waveform of a voice. The band is selected according to the current phase increment.
+    @param voice Voice index
+    @param bands Band-limited tables of the waveform as returned by Wavetable::getBands()
+    */
+    void setWaveform(const uint8_t voice, const ConstSpan<PgmArray<int8_t>> bands)
+    {
+        m_bands[voice] = bands;
+        selectTable(voice);
+    }
+
+    /**
+    @brief Set the phase increment, i.e. the frequency, of a voice. The band of the wavetable is reselected accordingly.
+    Safe to call from outside the interrupt calling tick() only if Phase is written atomically or the interrupt is disabled.
+    @param voice Voice index
+    @param increment Phase increment, see getIncrement()
+    */
+    void setIncrement(const uint8_t voice, const Phase increment)
+    {
+        m_increment[voice] = increment;
+        selectTable(voice);
+    }
+
+    /**
+    @brief Get the phase increment of a voice
+    @param voice Voice index
+    @result Phase increment
+    */
+    Phase getIncrement(const uint8_t voice) const
+    {
+        return m_increment[voice];
+    }
+
+    /**
+    @brief Set the phase of a voice, e.g. to restart an LFO on key press (hard sync)
+    @param voice Voice index
+    @param phase New phase, 0 is the start of the table
+    */
+    void setPhase(const uint8_t voice, const Phase phase)
+    {
+        m_phase[voice] = phase;
+    }
+
+    /**
+    @brief Get the phase of a voice
+    @param voice Voice index
+    @result Phase
+    */
+    Phase getPhase(const uint8_t voice) const
+    {
+        return m_phase[voice];
+    }
+
+    /**
+    @brief Get the band currently used by a voice
+    @param voice Voice index
+    @result Band index
+    */
+    uint8_t getBand(const uint8_t voice) const
+    {
+        return m_band[voice];
+    }
+
+    /**
+    @brief Compute one sample of every voice and advance all phases
+    @result Sum of all voices
+    */
+    Sample tick()
+    {
+        return tickVoices(make_index_sequence<t_nofVoices>());
+    }
+
+    /**
+    @brief Compute one sample of every voice and advance all phases, keeping the voices separate, e.g. for a bank of LFOs
+    @param samples Output sample of each voice in range -128..127
+    */
+    void tick(Array<int8_t, t_nofVoices>& samples)
+    {
+        tickVoices(samples, make_index_sequence<t_nofVoices>());
+    }
+
+    /**
+    @brief Fill a buffer with consecutive output samples
+    @param buffer Buffer to fill
+    */
+    void render(const Span<Sample> buffer)
+    {
+        for (Sample& sample : buffer)
+        {
+            sample = tick();
+        }
+    }
+
+    private:
+
+    // Highest phase increment for which the harmonics of band 0 stay below the Nyquist frequency
+    static constexpr Phase s_band0Increment = static_cast<Phase>(1) << (s_phaseBits - 8);
+
+    void selectTable(const uint8_t voice)
+    {
+        // Every band halves the number of harmonics and thus doubles the permissible phase increment
+        const uint8_t nofBands = static_cast<uint8_t>(m_bands[voice].size());
+        const Phase increment = m_increment[voice];
+        Phase limit = s_band0Increment;
+        uint8_t band = 0;
+        while (band + 1 < nofBands && increment > limit)
+        {
+            limit <<= 1;
+            ++band;
+        }
+        m_band[voice] = band;
+        m_table[voice] = m_bands[voice][band].data();
+    }
+
+    template <size_t t_voice>
+    int8_t tickVoice()
+    {
+        const Phase phase = m_phase[t_voice];
+        m_phase[t_voice] = phase + m_increment[t_voice];
+
+        const int8_t* const table = m_table[t_voice];
+        const uint8_t idx = static_cast<uint8_t>(phase >> (s_phaseBits - 8));
+        const int8_t sample = static_cast<int8_t>(pgm_read_byte(table + idx));
+
+        if CXX17_CONSTEXPR(t_interpolate)
+        {
+            // 7-bit weight keeps the product of the 9-bit difference in 16 bits
+            const uint8_t weight = static_cast<uint8_t>(phase >> (s_phaseBits - 15)) & 0x7F;
+            const int8_t next = static_cast<int8_t>(pgm_read_byte(table + static_cast<uint8_t>(idx + 1)));
+            const int16_t delta = static_cast<int16_t>(next - sample) * weight;
+            return static_cast<int8_t>(sample + (delta >> 7));
+        }
+        else
+        {
+            return sample;
+        }
+    }
+
+    template <size_t ... t_voice>
+    Sample tickVoices(index_sequence<t_voice...>)
+    {
+        return (static_cast<Sample>(tickVoice<t_voice>()) + ...);
+    }
+
+    template <size_t ... t_voice>
+    void tickVoices(Array<int8_t, t_nofVoices>& samples, index_sequence<t_voice...>)
+    {
+        ((samples[t_voice] = tickVoice<t_voice>()), ...);
+    }
+
+    Array<Phase, t_nofVoices> m_phase = {};
+    Array<Phase, t_nofVoices> m_increment = {};
+    Array<const int8_t*, t_nofVoices> m_table = {};
+    Array<ConstSpan<PgmArray<int8_t>>, t_nofVoices> m_bands = {};
+    Array<uint8_t, t_nofVoices> m_band = {};
+};
+
+// Static initialization
+template <typename Shape, uint8_t t_nofBands>
+template <uint8_t t_band>
+constexpr Array<int8_t, Wavetable<Shape, t_nofBands>::s_size> Wavetable<Shape, t_nofBands>::Band<t_band>::s_samples;
+
+template <typename Shape, uint8_t t_nofBands>
+constexpr Array<PgmArray<int8_t>, t_nofBands> Wavetable<Shape, t_nofBands>::s_bands;
+
+#endif
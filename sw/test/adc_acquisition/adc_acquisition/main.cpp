@@ -0,0 +1,283 @@
+/*
+Copyright (C) 2023 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <adc_acquisition.h>
+
+#include "../../common/debug_print.h"
+
+bool test_assert(const char * str, const bool flag)
+{
+    cout << str;
+    if (flag)
+    {
+        cout << static_cast<const char *>("PASSED");
+    }
+    else
+    {
+        cout << static_cast<const char *>("FAILED");
+    }
+    return flag;
+}
+
+// ADC interrupt handler
+void handleADCInterrupt();
+
+// Simulated ADC peripheral. Conversions are started by trigger events of the simulated timers.
+struct MockADC
+{
+    static uint8_t s_admux;
+    static uint8_t s_adcsra;
+    static uint8_t s_adcsrb;
+    static uint16_t s_adc;
+
+    // Sample counter, the simulated input signal is a ramp offset by the channel index
+    static uint16_t s_nofConversions;
+
+    static void control(const uint8_t value)
+    {
+        // Writing a logical one to ADIF clears the flag, writing a zero leaves it unchanged
+        const uint8_t flag = (value & _BV(ADIF)) ? 0 : (s_adcsra & _BV(ADIF));
+        s_adcsra = (value & ~_BV(ADIF)) | flag;
+    }
+
+    static uint16_t getSignal(const uint16_t n)
+    {
+        return static_cast<uint16_t>((s_admux & 0x0F) * 1000 + n) & 0x3FF;
+    }
+
+    static void trigger(const uint8_t source)
+    {
+        const bool enabled = (s_adcsra & _BV(ADEN)) && (s_adcsra & _BV(ADATE));
+        if (!enabled || source != (s_adcsrb & 0b111))
+        {
+            return;
+        }
+
+        s_adc = getSignal(s_nofConversions++);
+        s_adcsra |= _BV(ADIF);
+        if (s_adcsra & _BV(ADIE))
+        {
+            // Executing the interrupt vector clears the flag
+            s_adcsra &= ~_BV(ADIF);
+            handleADCInterrupt();
+        }
+    }
+};
+
+uint8_t MockADC::s_admux = 0;
+uint8_t MockADC::s_adcsra = 0;
+uint8_t MockADC::s_adcsrb = 0;
+uint16_t MockADC::s_adc = 0;
+uint16_t MockADC::s_nofConversions = 0;
+
+// Simulated registers
+struct MockADMUX
+{
+    using Type = uint8_t;
+    static uint8_t read() {return MockADC::s_admux;}
+    static void write(const uint8_t value) {MockADC::s_admux = value;}
+};
+
+struct MockADCSRA
+{
+    using Type = uint8_t;
+    static uint8_t read() {return MockADC::s_adcsra;}
+    static void write(const uint8_t value) {MockADC::control(value);}
+};
+
+struct MockADCSRB
+{
+    using Type = uint8_t;
+    static uint8_t read() {return MockADC::s_adcsrb;}
+    static void write(const uint8_t value) {MockADC::s_adcsrb = value;}
+};
+
+struct MockADCW
+{
+    using Type = uint16_t;
+    static uint16_t read() {return MockADC::s_adc;}
+};
+
+using ADCDevice = ADCModule<MockADMUX, MockADCSRA, MockADCSRB, MockADCW>;
+using Trigger = ADCDevice::Trigger;
+using Acquisition = ADCAcquisition<ADCDevice, 8>;
+
+void handleADCInterrupt()
+{
+    Acquisition::onInterrupt();
+}
+
+// Simulated timer 1 compare match B
+void timerTick(const uint16_t nofTicks = 1)
+{
+    for (uint16_t cnt = 0; cnt < nofTicks; ++cnt)
+    {
+        MockADC::trigger(static_cast<uint8_t>(Trigger::timer1CompareMatchB));
+    }
+}
+
+// Block callback checking that consecutive blocks continue the input signal without gaps
+static uint16_t s_nofBlocks = 0;
+static uint16_t s_nextSample = 0;
+static bool s_continuous = true;
+
+void onBlock(const ConstSpan<uint16_t> block)
+{
+    s_continuous &= block.size() == 8;
+    for (const uint16_t sample : block)
+    {
+        s_continuous &= sample == MockADC::getSignal(s_nextSample++);
+    }
+    ++s_nofBlocks;
+}
+
+// Block callback taking longer than a block period once
+void onSlowBlock(const ConstSpan<uint16_t> block)
+{
+    onBlock(block);
+    if (1 == s_nofBlocks)
+    {
+        timerTick(12);
+    }
+}
+
+// Benchmark: 256 ADC interrupts.
+// Put a breakpoint before and after each benchmark call and read the cycle counter of the simulator.
+uint16_t benchmarkInterrupt()
+{
+    Acquisition::start(0, Trigger::timer1CompareMatchB, Acquisition::Callback());
+    for (uint16_t cnt = 0; cnt < 256; ++cnt)
+    {
+        Acquisition::onInterrupt();
+    }
+    Acquisition::stop();
+    return Acquisition::process();
+}
+
+void resetBlocks()
+{
+    MockADC::s_nofConversions = 0;
+    s_nofBlocks = 0;
+    s_nextSample = 0;
+    s_continuous = true;
+}
+
+int main(void)
+{
+    bool allPassed = true;
+    bool testPassed = true;
+
+    {
+        testPassed = true;
+        ADCDevice::init(ADCDevice::Reference::avcc, ADCDevice::Prescaler::div128);
+        testPassed &= MockADC::s_admux == 0x40;
+        testPassed &= MockADC::s_adcsra == (_BV(ADEN) | 0b111);
+
+        Acquisition::start(3, Trigger::timer1CompareMatchB, &onBlock);
+        testPassed &= MockADC::s_admux == 0x43;
+        testPassed &= MockADC::s_adcsrb == 5;
+        testPassed &= MockADC::s_adcsra == (_BV(ADEN) | _BV(ADATE) | _BV(ADIE) | 0b111);
+
+        Acquisition::stop();
+        testPassed &= MockADC::s_adcsra == (_BV(ADEN) | 0b111);
+    }
+    allPassed &= test_assert("registers", testPassed);
+
+    {
+        testPassed = true;
+        resetBlocks();
+        Acquisition::start(0, Trigger::timer1CompareMatchB, &onBlock);
+        testPassed &= Acquisition::process() == 0;
+
+        // Other trigger sources do not start conversions
+        MockADC::trigger(static_cast<uint8_t>(Trigger::timer0CompareMatchA));
+        testPassed &= MockADC::s_nofConversions == 0;
+
+        timerTick(7);
+        testPassed &= Acquisition::process() == 0;
+        timerTick();
+        testPassed &= Acquisition::process() == 1;
+        testPassed &= Acquisition::process() == 0;
+        timerTick(8);
+        testPassed &= Acquisition::process() == 1;
+
+        // Many blocks processed in time
+        for (uint8_t cnt = 0; cnt < 50; ++cnt)
+        {
+            timerTick(5);
+            Acquisition::process();
+            timerTick(3);
+            Acquisition::process();
+        }
+        testPassed &= s_nofBlocks == 52;
+        testPassed &= s_continuous;
+        testPassed &= Acquisition::getNofOverruns() == 0;
+        Acquisition::stop();
+    }
+    allPassed &= test_assert("ping-pong", testPassed);
+
+    {
+        testPassed = true;
+        resetBlocks();
+        Acquisition::start(2, Trigger::timer1CompareMatchB, &onBlock);
+
+        // Three halves completed without processing: Only the last one is left
+        timerTick(24);
+        testPassed &= Acquisition::getNofOverruns() == 2;
+        s_nextSample = 16;
+        testPassed &= Acquisition::process() == 1;
+        testPassed &= s_continuous;
+
+        // Processing too slow: The half being processed is overwritten
+        resetBlocks();
+        Acquisition::start(2, Trigger::timer1CompareMatchB, &onSlowBlock);
+        timerTick(8);
+        testPassed &= Acquisition::process() == 2;
+        testPassed &= Acquisition::getNofOverruns() == 1;
+        testPassed &= s_nofBlocks == 2;
+
+        // Stopped acquisition does not convert
+        Acquisition::stop();
+        const uint16_t nofConversions = MockADC::s_nofConversions;
+        timerTick(8);
+        testPassed &= MockADC::s_nofConversions == nofConversions;
+        testPassed &= Acquisition::process() == 0;
+    }
+    allPassed &= test_assert("overrun", testPassed);
+
+    {
+        testPassed = true;
+        testPassed &= benchmarkInterrupt() == 1;
+    }
+    allPassed &= test_assert("benchmark", testPassed);
+
+    test_assert("OVERALL:", allPassed);
+
+    while (true)
+    {
+    }
+}
+
+template <>
+struct debugPrinter<const char*>
+{
+    static void print(const char* arg)
+    {
+        // Put a tracepoint here and display {arg, s} in output window
+        (void)arg;
+    }
+};
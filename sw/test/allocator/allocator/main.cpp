@@ -16,8 +16,32 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include "allocator.h"
+#include "list.h"
 #include "..\..\common\debug_print.h"
 
+// Region tag for a heap over a dedicated buffer. On hardware, MemoryRegion<address, size> describes e.g. external SRAM.
+struct TestRegion
+{
+    static void* begin()
+    {
+        return s_memory;
+    }
+    
+    static constexpr size_t size()
+    {
+        return sizeof(s_memory);
+    }
+    
+    static uint8_t s_memory[256];
+};
+
+uint8_t TestRegion::s_memory[256];
+
+bool isInRegion(const void* ptr)
+{
+    return ptr >= TestRegion::s_memory && ptr < TestRegion::s_memory + sizeof(TestRegion::s_memory);
+}
+
 bool test_assert(const char * str, const bool flag)
 {
     cout << str;
@@ -195,6 +219,44 @@ int main(void)
     }
     allPassed &= test_assert("FreeListAllocator", testPassed);
 
+    // RegionAllocator
+    {
+        testPassed = true;
+        using Allocator = RegionAllocator<TestRegion>;
+        
+        // The region is not used before initialization
+        testPassed &= nullptr == Allocator::allocate(1);
+        
+        Allocator::init();
+        void * ptr1 = Allocator::allocate(8);
+        testPassed &= isInRegion(ptr1);
+        
+        // Memory of the default heap is not taken from the region
+        void * ptr2 = HeapAllocator<>::allocate(8);
+        testPassed &= nullptr != ptr2 && !isInRegion(ptr2);
+        HeapAllocator<>::deallocate(ptr2);
+        
+        // Place a container into the region
+        {
+            List<uint16_t, Allocator> list = {1, 2, 3};
+            for (const uint16_t& value : list)
+            {
+                testPassed &= isInRegion(&value);
+            }
+        }
+        
+        // Region is exhausted
+        void * ptr3 = Allocator::allocate(256);
+        testPassed &= nullptr == ptr3;
+        
+        // All memory is available again after deallocation
+        Allocator::deallocate(ptr1);
+        ptr3 = Allocator::allocate(200);
+        testPassed &= isInRegion(ptr3);
+        Allocator::deallocate(ptr3);
+    }
+    allPassed &= test_assert("RegionAllocator", testPassed);
+
     test_assert("Overall", allPassed);
     
     while (true)
@@ -203,6 +265,11 @@ int main(void)
 }
 
 
+void throw_nullptr_error()
+{
+    while(true);
+}
+
 // Specialization of debugging output
 template<>
 struct debugPrinter<const char*>
@@ -0,0 +1,230 @@
+/*
+Copyright (C) 2023 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <atomic_pool_allocator.h>
+#include <list.h>
+#include <scheduler.h>
+#include <avr/interrupt.h>
+#include <register_access.h>
+
+#include "../../common/debug_print.h"
+
+// Pool shared by application code and ISR. Application code uses up to 16 nodes, the ISR up to 5.
+using Pool = AtomicPoolAllocator<List<uint16_t>::nodeSize(), 24>;
+
+// Elements pushed by the ISR are tagged with the MSB, elements pushed by application code are not
+static constexpr uint16_t s_isrTag = 0x8000;
+
+static List<uint16_t, Pool> s_isrList;
+static uint16_t s_isrSequence = 0;
+static uint16_t s_isrExpected = 0;
+static volatile bool s_isrPassed = true;
+static volatile uint16_t s_nofInterrupts = 0;
+
+// Allocates and frees one node per interrupt while application code does the same.
+// The node is allocated before the oldest one is freed, so the ISR does not get back the node it has just freed.
+ISR(TIMER0_OVF_vect)
+{
+    s_isrList.pushBack(s_isrTag | s_isrSequence);
+    s_isrSequence = (s_isrSequence + 1) & ~s_isrTag;
+    if (s_isrList.size() > 4)
+    {
+        s_isrPassed = s_isrPassed && s_isrList.front() == (s_isrTag | s_isrExpected);
+        s_isrExpected = (s_isrExpected + 1) & ~s_isrTag;
+        s_isrList.popFront();
+    }
+    s_nofInterrupts = s_nofInterrupts + 1;
+}
+
+// List filled by a static constructor. The pool must be usable before main(), independent of the order of static initialization.
+using StaticPool = AtomicPoolAllocator<List<uint16_t>::nodeSize(), 4, struct StaticPoolTag>;
+
+struct StaticUser
+{
+    StaticUser()
+    {
+        for (uint16_t idx = 0; idx < 4; ++idx)
+        {
+            m_list.pushBack(idx);
+        }
+    }
+
+    List<uint16_t, StaticPool> m_list;
+};
+
+static StaticUser s_staticUser;
+
+bool test_assert(const char * str, const bool flag)
+{
+    cout << str;
+    if (flag)
+    {
+        cout << static_cast<const char *>("PASSED");
+    }
+    else
+    {
+        cout << static_cast<const char *>("FAILED");
+    }
+    return flag;
+}
+
+// Allocate all free nodes of the pool and return them
+template <typename Allocator>
+size_t countAvailable()
+{
+    void* nodes[Allocator::capacity()];
+    size_t nofNodes = 0;
+    while (nofNodes < Allocator::capacity() && nullptr != (nodes[nofNodes] = Allocator::allocate(1)))
+    {
+        ++nofNodes;
+    }
+    for (size_t idx = 0; idx < nofNodes; ++idx)
+    {
+        Allocator::deallocate(nodes[idx]);
+    }
+    return nofNodes;
+}
+
+int main(void)
+{
+    bool allPassed = true;
+    bool testPassed = true;
+
+    {
+        testPassed = true;
+        using SmallPool = AtomicPoolAllocator<1, 4, struct SmallPoolTag>;
+        testPassed &= SmallPool::nodeSize() >= sizeof(void*);
+        testPassed &= nullptr == SmallPool::allocate(0);
+        testPassed &= nullptr == SmallPool::allocate(SmallPool::nodeSize() + 1);
+
+        void* nodes[4];
+        for (void*& node : nodes)
+        {
+            node = SmallPool::allocate(1);
+            testPassed &= nullptr != node;
+        }
+        testPassed &= nullptr == SmallPool::allocate(1);
+        for (size_t idx = 0; idx < 4; ++idx)
+        {
+            for (size_t other = 0; other < idx; ++other)
+            {
+                testPassed &= nodes[idx] != nodes[other];
+            }
+        }
+        for (void* node : nodes)
+        {
+            SmallPool::deallocate(node);
+        }
+        testPassed &= countAvailable<SmallPool>() == 4;
+    }
+    allPassed &= test_assert("allocate/deallocate", testPassed);
+
+    {
+        testPassed = true;
+        uint16_t expected = 0;
+        for (const uint16_t elem : s_staticUser.m_list)
+        {
+            testPassed &= elem == expected++;
+        }
+        testPassed &= expected == 4;
+        testPassed &= countAvailable<StaticPool>() == 0;
+        s_staticUser.m_list.clear();
+        testPassed &= countAvailable<StaticPool>() == 4;
+    }
+    allPassed &= test_assert("Static initialization", testPassed);
+
+    {
+        testPassed = true;
+        using TaskPool = AtomicPoolAllocator<Scheduler<uint8_t, uint8_t>::nodeSize(), 8, struct TaskPoolTag>;
+        List<uint8_t, TaskPool> x;
+        testPassed &= TaskPool::nodeSize() >= List<uint8_t>::nodeSize();
+        for (uint8_t idx = 0; idx < 8; ++idx)
+        {
+            x.pushBack(idx);
+        }
+        testPassed &= countAvailable<TaskPool>() == 0;
+        x.clear();
+        testPassed &= countAvailable<TaskPool>() == 8;
+    }
+    allPassed &= test_assert("List", testPassed);
+
+    {
+        // Stress test: Application code and timer 0 overflow ISR allocate and free nodes of the same pool.
+        // If a node was handed out twice, the elements or links of one of the lists would be overwritten.
+        testPassed = true;
+        List<uint16_t, Pool> x;
+        uint16_t sequence = 0;
+        uint16_t expected = 0;
+
+        // Timer 0 in normal mode, prescaler 8 --> overflow interrupt every 2048 cycles
+        TCCR0B::write(1 << CS01);
+        TIMSK0::write(1 << TOIE0);
+        sei();
+
+        for (uint16_t iteration = 0; iteration < 1000; ++iteration)
+        {
+            while (x.size() < 16)
+            {
+                x.pushBack(sequence++ & ~s_isrTag);
+            }
+            while (!x.empty())
+            {
+                testPassed &= x.front() == (expected++ & ~s_isrTag);
+                x.popFront();
+            }
+        }
+
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            TIMSK0::write(0);
+        }
+
+        testPassed &= s_isrPassed;
+        testPassed &= s_nofInterrupts > 0;
+
+        // All nodes must be returned to the pool
+        s_isrList.clear();
+        testPassed &= countAvailable<Pool>() == Pool::capacity();
+    }
+    allPassed &= test_assert("ISR stress test", testPassed);
+
+    test_assert("OVERALL:", allPassed);
+
+    while (true)
+    {
+    }
+}
+
+template <>
+struct debugPrinter<const char*>
+{
+    static void print(const char* arg)
+    {
+        // Put a tracepoint here and display {arg, s} in output window
+        (void)arg;
+    }
+};
+
+void throw_nullptr_error()
+{
+    while(true);
+}
+
+void throw_bad_alloc()
+{
+    while(true);
+}
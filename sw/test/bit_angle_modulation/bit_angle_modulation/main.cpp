@@ -0,0 +1,298 @@
+/*
+Copyright (C) 2023 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <bit_angle_modulation.h>
+#include <output_shadow_register.h>
+
+#include "../../common/debug_print.h"
+
+bool test_assert(const char * str, const bool flag)
+{
+    cout << str;
+    if (flag)
+    {
+        cout << static_cast<const char *>("PASSED");
+    }
+    else
+    {
+        cout << static_cast<const char *>("FAILED");
+    }
+    return flag;
+}
+
+// Pseudo random numbers 0..127 (full period linear congruential generator)
+uint8_t nextValue(uint8_t& state)
+{
+    state = (5 * state + 1) & 0x7F;
+    return state;
+}
+
+// Simulated output device recording the current output image
+struct MockDevice
+{
+    static void init()
+    {
+        s_initialized = true;
+    }
+    
+    template <typename DirtyMask>
+    static void write(const uint8_t * image, const uint8_t nofBytes, const DirtyMask& dirty)
+    {
+        for (uint8_t idx = 0; idx < nofBytes; ++idx)
+        {
+            if (dirty[idx])
+            {
+                s_image[idx] = image[idx];
+                ++s_nofBytes;
+            }
+        }
+    }
+    
+    static bool isOn(const uint8_t idx)
+    {
+        return s_image[idx >> 3] & (1 << (idx & 0b111));
+    }
+    
+    static bool s_initialized;
+    static uint8_t s_image[8];
+    static uint16_t s_nofBytes;
+};
+
+// Static initialization
+bool MockDevice::s_initialized = false;
+uint8_t MockDevice::s_image[8] = {};
+uint16_t MockDevice::s_nofBytes = 0;
+
+// Simulated output pins, bit n of s_pinLevels is the level of pin n
+static uint8_t s_pinLevels = 0;
+
+template <uint8_t t_idx>
+struct MockPin
+{
+    static void high()
+    {
+        s_pinLevels |= 1 << t_idx;
+    }
+    
+    static void low()
+    {
+        s_pinLevels &= ~(1 << t_idx);
+    }
+};
+
+using LEDs = BitAngleModulation<MockDevice, 64>;
+
+// Run one PWM period and accumulate the on-time of each LED in base periods
+template <typename Engine, uint8_t t_nofLEDs>
+void runPeriod(uint16_t (&onTime)[t_nofLEDs])
+{
+    for (uint16_t& time : onTime)
+    {
+        time = 0;
+    }
+    
+    uint16_t period = 0;
+    while (period < Engine::getPeriod())
+    {
+        const uint8_t duration = Engine::onInterrupt();
+        for (uint8_t idx = 0; idx < t_nofLEDs; ++idx)
+        {
+            if (MockDevice::isOn(idx))
+            {
+                onTime[idx] += duration;
+            }
+        }
+        period += duration;
+    }
+}
+
+// Benchmark: One PWM period of 64 LEDs with 8 bit resolution.
+// Put a breakpoint before and after each benchmark call and read the cycle counter of the simulator.
+uint16_t benchmarkBCM()
+{
+    uint16_t period = 0;
+    while (period < LEDs::getPeriod())
+    {
+        period += LEDs::onInterrupt();
+    }
+    return period;
+}
+
+// Software PWM: Each of 255 timer ticks compares all brightness values to the PWM counter and writes the complete image
+uint16_t benchmarkSoftwarePWM(const uint8_t (&brightness)[64])
+{
+    uint8_t image[8];
+    for (uint8_t tick = 0; tick < 255; ++tick)
+    {
+        for (uint8_t byteIdx = 0; byteIdx < 8; ++byteIdx)
+        {
+            uint8_t data = 0;
+            for (uint8_t bit = 0; bit < 8; ++bit)
+            {
+                if (brightness[8 * byteIdx + bit] > tick)
+                {
+                    data |= 1 << bit;
+                }
+            }
+            image[byteIdx] = data;
+        }
+        MockDevice::write(image, 8, BoolArray<8>(true));
+    }
+    return 255;
+}
+
+int main(void)
+{
+    bool allPassed = true;
+    bool testPassed = true;
+    
+    {
+        testPassed = true;
+        LEDs::init();
+        testPassed &= MockDevice::s_initialized;
+        testPassed &= LEDs::s_maxBrightness == 255;
+        testPassed &= LEDs::getPeriod() == 255;
+        uint16_t onTime[64];
+        runPeriod<LEDs>(onTime);
+        for (const uint16_t time : onTime)
+        {
+            testPassed &= 0 == time;
+        }
+        LEDs::setAll(255);
+        runPeriod<LEDs>(onTime);
+        for (const uint16_t time : onTime)
+        {
+            testPassed &= 255 == time;
+        }
+    }
+    allPassed &= test_assert("init/setAll", testPassed);
+    
+    {
+        testPassed = true;
+        uint8_t state = 1;
+        uint8_t brightness[64];
+        for (uint8_t idx = 0; idx < 64; ++idx)
+        {
+            brightness[idx] = 2 * nextValue(state) + (idx & 1);
+            LEDs::setBrightness(idx, brightness[idx]);
+        }
+        
+        // Average on-time equals brightness, no matter at which plane the period starts
+        uint16_t onTime[64];
+        for (uint8_t run = 0; run < 3; ++run)
+        {
+            runPeriod<LEDs>(onTime);
+            for (uint8_t idx = 0; idx < 64; ++idx)
+            {
+                testPassed &= onTime[idx] == brightness[idx];
+                testPassed &= LEDs::getBrightness(idx) == brightness[idx];
+            }
+        }
+        
+        // Constant number of bytes per interrupt
+        MockDevice::s_nofBytes = 0;
+        for (uint8_t plane = 0; plane < 8; ++plane)
+        {
+            LEDs::onInterrupt();
+        }
+        testPassed &= MockDevice::s_nofBytes == 8 * 8;
+    }
+    allPassed &= test_assert("setBrightness", testPassed);
+    
+    {
+        testPassed = true;
+        
+        // 4 bit resolution, brightness stored in 2 LEDs per byte
+        using LEDs4 = BitAngleModulation<MockDevice, 20, 4>;
+        LEDs4::init();
+        testPassed &= LEDs4::getPeriod() == 15;
+        for (uint8_t idx = 0; idx < 20; ++idx)
+        {
+            LEDs4::setBrightness(idx, idx % 16);
+        }
+        uint16_t onTime[20];
+        runPeriod<LEDs4>(onTime);
+        for (uint8_t idx = 0; idx < 20; ++idx)
+        {
+            testPassed &= onTime[idx] == idx % 16;
+        }
+    }
+    allPassed &= test_assert("4 bit", testPassed);
+    
+    {
+        testPassed = true;
+        using Pins = PinOutputs<MockPin<0>, MockPin<1>, MockPin<2>, MockPin<3>>;
+        using PinLEDs = BitAngleModulation<Pins, 4>;
+        PinLEDs::init();
+        PinLEDs::setBrightness(0, 0);
+        PinLEDs::setBrightness(1, 1);
+        PinLEDs::setBrightness(2, 128);
+        PinLEDs::setBrightness(3, 255);
+        uint16_t onTime[4] = {};
+        uint16_t period = 0;
+        while (period < PinLEDs::getPeriod())
+        {
+            const uint8_t duration = PinLEDs::onInterrupt();
+            for (uint8_t idx = 0; idx < 4; ++idx)
+            {
+                if (s_pinLevels & (1 << idx))
+                {
+                    onTime[idx] += duration;
+                }
+            }
+            period += duration;
+        }
+        testPassed &= onTime[0] == 0 && onTime[1] == 1 && onTime[2] == 128 && onTime[3] == 255;
+        
+        // Shadow register on individual pins writes changed bytes only
+        using PinRegister = OutputShadowRegister<Pins, 4>;
+        PinRegister::init();
+        PinRegister::Pin<2>::high();
+        PinRegister::flush();
+        testPassed &= s_pinLevels == 0b0100;
+    }
+    allPassed &= test_assert("PinOutputs", testPassed);
+    
+    {
+        testPassed = true;
+        uint8_t state = 1;
+        uint8_t brightness[64];
+        for (uint8_t idx = 0; idx < 64; ++idx)
+        {
+            brightness[idx] = 2 * nextValue(state);
+        }
+        testPassed &= benchmarkBCM() == 255;
+        testPassed &= benchmarkSoftwarePWM(brightness) == 255;
+    }
+    allPassed &= test_assert("benchmark", testPassed);
+    
+    test_assert("OVERALL:", allPassed);
+    
+    while (true)
+    {
+    }
+}
+
+template <>
+struct debugPrinter<const char*>
+{
+    static void print(const char* arg)
+    {
+        // Put a tracepoint here and display {arg, s} in output window
+        (void)arg;
+    }
+};
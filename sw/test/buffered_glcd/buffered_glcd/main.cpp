@@ -0,0 +1,374 @@
+/*
+Copyright (C) 2023 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <buffered_glcd.h>
+#include <pgm_array.h>
+
+#include "../../common/debug_print.h"
+
+// Emulation of a 128x64 page-addressed graphic LCD counting the transferred bytes
+class MockGLCD
+{
+    public:
+
+    static void init()
+    {}
+
+    static constexpr uint8_t getWidth()
+    {
+        return 128;
+    }
+
+    static constexpr uint8_t getHeight()
+    {
+        return 64;
+    }
+
+    static void setWindow(const uint8_t pageIdx, const uint8_t columnIdx)
+    {
+        s_page = pageIdx;
+        s_column = columnIdx;
+
+        // Page address plus lower and upper nibble of the column address
+        s_nofCommandBytes += 3;
+        ++s_nofTransfers;
+    }
+
+    static void putData(const uint8_t * data, const uint8_t nofBytes)
+    {
+        for (uint8_t cnt = 0; cnt < nofBytes; ++cnt)
+        {
+            s_gram[s_page * getWidth() + s_column++] = *data++;
+        }
+        s_nofDataBytes += nofBytes;
+    }
+
+    static void resetCounters()
+    {
+        s_nofCommandBytes = 0;
+        s_nofDataBytes = 0;
+        s_nofTransfers = 0;
+    }
+
+    static uint8_t s_gram[1024];
+    static uint8_t s_page;
+    static uint8_t s_column;
+    static uint32_t s_nofCommandBytes;
+    static uint32_t s_nofDataBytes;
+    static uint16_t s_nofTransfers;
+};
+
+uint8_t MockGLCD::s_gram[1024] = {};
+uint8_t MockGLCD::s_page = 0;
+uint8_t MockGLCD::s_column = 0;
+uint32_t MockGLCD::s_nofCommandBytes = 0;
+uint32_t MockGLCD::s_nofDataBytes = 0;
+uint16_t MockGLCD::s_nofTransfers = 0;
+
+using GLCD = GLCDBuffered<MockGLCD>;
+
+// 3x5 digits
+constexpr auto digits = makePgmArray<uint8_t,
+0x1F, 0x11, 0x1F,
+0x12, 0x1F, 0x10,
+0x1D, 0x15, 0x17,
+0x15, 0x15, 0x1F,
+0x07, 0x04, 0x1F,
+0x17, 0x15, 0x1D,
+0x1F, 0x15, 0x1D,
+0x01, 0x01, 0x1F,
+0x1F, 0x15, 0x1F,
+0x17, 0x15, 0x1F>();
+
+constexpr GLCDFont font = {digits, 3, '0'};
+
+// 8x12 arrow pointing right
+constexpr auto arrow = makePgmArray<uint8_t,
+0x60, 0x60, 0x60, 0xF8, 0xF0, 0xE0, 0xC0, 0x80,
+0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00>();
+
+bool test_assert(const char * str, const bool flag)
+{
+    cout << str;
+    if (flag)
+    {
+        cout << static_cast<const char *>("PASSED");
+    }
+    else
+    {
+        cout << static_cast<const char *>("FAILED");
+    }
+    return flag;
+}
+
+// Check if the content of the LCD matches the frame buffer
+bool checkDisplay()
+{
+    bool passed = true;
+    for (uint16_t idx = 0; idx < 1024; ++idx)
+    {
+        passed &= MockGLCD::s_gram[idx] == GLCD::data()[idx];
+    }
+    return passed;
+}
+
+uint16_t countPixels()
+{
+    uint16_t nofPixels = 0;
+    for (uint8_t y = 0; y < GLCD::getHeight(); ++y)
+    {
+        for (uint8_t x = 0; x < GLCD::getWidth(); ++x)
+        {
+            nofPixels += GLCD::getPixel(x, y);
+        }
+    }
+    return nofPixels;
+}
+
+// Print the content of the LCD as plain PBM image (lit pixels are black)
+void printPBM()
+{
+    cout << static_cast<const char *>("P1");
+    cout << static_cast<const char *>("128 64");
+    char line[129];
+    for (uint8_t y = 0; y < 64; ++y)
+    {
+        for (uint8_t x = 0; x < 128; ++x)
+        {
+            line[x] = (MockGLCD::s_gram[(y >> 3) * 128 + x] & (1 << (y & 0b111))) ? '1' : '0';
+        }
+        line[128] = '\0';
+        cout << static_cast<const char *>(line);
+    }
+}
+
+// Animation: A bouncing square and a frame counter, refreshed every frame
+// Returns the number of bytes sent, including 3 command bytes per transfer
+uint32_t animate(const uint16_t nofFrames, bool& displayOK)
+{
+    MockGLCD::resetCounters();
+    displayOK = true;
+
+    GLCD::drawRect(0, 0, 128, 64);
+    uint8_t x = 10;
+    uint8_t y = 20;
+    int8_t dx = 3;
+    int8_t dy = 2;
+    char counter[] = "0000";
+    for (uint16_t frame = 0; frame < nofFrames; ++frame)
+    {
+        GLCD::fillRect(x, y, 8, 8, GLCDColor::black);
+        if (x + dx < 2 || x + dx > 118)
+        {
+            dx = -dx;
+        }
+        if (y + dy < 2 || y + dy > 54)
+        {
+            dy = -dy;
+        }
+        x += dx;
+        y += dy;
+        GLCD::fillRect(x, y, 8, 8);
+
+        // Increment decimal counter
+        for (uint8_t pos = 4; pos > 0; --pos)
+        {
+            if (++counter[pos - 1] <= '9')
+            {
+                break;
+            }
+            counter[pos - 1] = '0';
+        }
+        GLCD::drawString(106, 2, counter, font);
+
+        GLCD::refresh();
+        displayOK &= checkDisplay();
+    }
+    return MockGLCD::s_nofDataBytes + MockGLCD::s_nofCommandBytes;
+}
+
+int main(void)
+{
+    bool allPassed = true;
+    bool testPassed = true;
+
+    {
+        testPassed = true;
+        GLCD::init();
+        testPassed &= MockGLCD::s_nofDataBytes == 1024;
+        testPassed &= MockGLCD::s_nofTransfers == 8;
+        testPassed &= !GLCD::isDirty();
+        testPassed &= checkDisplay();
+    }
+    allPassed &= test_assert("init", testPassed);
+
+    {
+        testPassed = true;
+        MockGLCD::resetCounters();
+        GLCD::setPixel(10, 20);
+        testPassed &= GLCD::getPixel(10, 20);
+        testPassed &= !GLCD::getPixel(10, 21);
+        testPassed &= GLCD::isDirty();
+        GLCD::refresh();
+        testPassed &= MockGLCD::s_nofDataBytes == 8;
+        testPassed &= MockGLCD::s_nofTransfers == 1;
+        testPassed &= checkDisplay();
+
+        // Unchanged content is not transferred again
+        GLCD::setPixel(10, 20);
+        GLCD::setPixel(200, 20);
+        testPassed &= !GLCD::isDirty();
+        GLCD::setPixel(10, 20, GLCDColor::invert);
+        testPassed &= !GLCD::getPixel(10, 20);
+        GLCD::refresh();
+        testPassed &= MockGLCD::s_nofDataBytes == 16;
+        testPassed &= countPixels() == 0;
+    }
+    allPassed &= test_assert("pixel", testPassed);
+
+    {
+        testPassed = true;
+        MockGLCD::resetCounters();
+
+        // Two adjacent tiles in two pages
+        GLCD::fillRect(5, 5, 6, 5);
+        testPassed &= countPixels() == 30;
+        testPassed &= GLCD::getPixel(5, 5) && GLCD::getPixel(10, 9);
+        testPassed &= !GLCD::getPixel(4, 5) && !GLCD::getPixel(11, 9) && !GLCD::getPixel(5, 10);
+        GLCD::refresh();
+        testPassed &= MockGLCD::s_nofTransfers == 2;
+        testPassed &= MockGLCD::s_nofDataBytes == 32;
+        GLCD::clear();
+
+        // Clipping
+        GLCD::fillRect(120, 60, 20, 20);
+        testPassed &= countPixels() == 32;
+        GLCD::clear();
+
+        GLCD::drawRect(0, 0, 128, 64);
+        testPassed &= countPixels() == 2 * 128 + 2 * 62;
+        GLCD::drawRect(0, 0, 128, 64, GLCDColor::invert);
+        testPassed &= countPixels() == 0;
+        GLCD::refresh();
+        testPassed &= checkDisplay();
+    }
+    allPassed &= test_assert("rectangle", testPassed);
+
+    {
+        testPassed = true;
+        GLCD::drawLine(0, 0, 127, 63);
+        testPassed &= countPixels() == 128;
+        testPassed &= GLCD::getPixel(0, 0) && GLCD::getPixel(127, 63);
+        GLCD::drawLine(127, 63, 0, 0, GLCDColor::black);
+        testPassed &= countPixels() == 0;
+
+        GLCD::drawLine(30, 40, 20, 5);
+        testPassed &= countPixels() == 36;
+        testPassed &= GLCD::getPixel(30, 40) && GLCD::getPixel(20, 5);
+        GLCD::clear();
+
+        GLCD::drawLine(50, 10, 40, 10);
+        testPassed &= countPixels() == 11;
+        GLCD::clear();
+        GLCD::refresh();
+    }
+    allPassed &= test_assert("line", testPassed);
+
+    {
+        testPassed = true;
+
+        // Unaligned bitmap on a filled background
+        GLCD::fillRect(0, 0, 20, 24);
+        GLCD::drawBitmapP(4, 3, 8, arrow);
+        for (uint8_t row = 0; row < 16; ++row)
+        {
+            for (uint8_t column = 0; column < 8; ++column)
+            {
+                const bool expected = arrow[(row >> 3) * 8 + column] & (1 << (row & 0b111));
+                testPassed &= GLCD::getPixel(4 + column, 3 + row) == expected;
+            }
+        }
+        testPassed &= GLCD::getPixel(3, 3) && GLCD::getPixel(4, 2) && GLCD::getPixel(12, 18) && GLCD::getPixel(4, 19);
+        GLCD::clear();
+
+        // Clipping at the bottom right corner
+        GLCD::drawBitmapP(124, 60, 8, arrow);
+        testPassed &= countPixels() == 1;
+        testPassed &= GLCD::getPixel(127, 63);
+        GLCD::clear();
+        GLCD::refresh();
+    }
+    allPassed &= test_assert("bitmap", testPassed);
+
+    {
+        testPassed = true;
+        testPassed &= GLCD::drawString(1, 1, "0123", font) == 17;
+        testPassed &= GLCD::getPixel(1, 1) && GLCD::getPixel(1, 5) && !GLCD::getPixel(2, 2);
+        testPassed &= GLCD::getPixel(5, 2) && GLCD::getPixel(6, 1) && !GLCD::getPixel(5, 1);
+
+        // Characters not contained in the font are skipped
+        testPassed &= GLCD::drawString(20, 1, "A", font) == 24;
+        testPassed &= countPixels() == 12 + 8 + 11 + 11;
+        GLCD::clear();
+
+        // Text wider than 256 pixels is clipped and does not wrap around to the first column
+        char longText[71] = {};
+        longText[0] = '1';
+        for (uint8_t idx = 1; idx < 70; ++idx)
+        {
+            longText[idx] = '0';
+        }
+        testPassed &= GLCD::drawString(0, 1, longText, font) == GLCD::getWidth();
+        testPassed &= countPixels() == 8 + 31 * 12;
+        GLCD::clear();
+        testPassed &= GLCD::drawString(0, 1, ConstSpan<char>(longText, 70), font) == GLCD::getWidth();
+        testPassed &= countPixels() == 8 + 31 * 12;
+        testPassed &= GLCD::drawChar(126, 1, '0', font) == GLCD::getWidth();
+        GLCD::clear();
+        GLCD::refresh();
+    }
+    allPassed &= test_assert("text", testPassed);
+
+    {
+        testPassed = true;
+        bool displayOK = true;
+        const uint32_t nofBytes = animate(200, displayOK);
+
+        // Full refresh of 1024 data bytes plus 8 windows per frame
+        const uint32_t nofBytesFullRefresh = 200ul * (1024 + 8 * 3);
+        testPassed &= displayOK;
+        testPassed &= 10 * nofBytes < nofBytesFullRefresh;
+        printPBM();
+    }
+    allPassed &= test_assert("animation", testPassed);
+
+    test_assert("OVERALL:", allPassed);
+
+    while (true)
+    {
+    }
+}
+
+template <>
+struct debugPrinter<const char*>
+{
+    static void print(const char* arg)
+    {
+        // Put a tracepoint here and display {arg, s} in output window
+        (void)arg;
+    }
+};
@@ -55,12 +55,12 @@ class DummyLCD
     static void putc(const char c)
     {
         s_buffer[s_cursor++] = c;
-        
-        // Only dump LCD content on a complete refresh 
-        if (s_cursor >= s_nofRows * s_nofCols)
-        {
-            print(s_buffer);
-        }            
+    }
+    
+    // Dump LCD content
+    static void dump()
+    {
+        print(s_buffer);
     }
     
     static constexpr void setCursor(const uint8_t row, const uint8_t col)
@@ -82,84 +82,91 @@ char DummyLCD::s_buffer[s_nofRows * s_nofCols+1];
 
 using LCD = LCDAlphanumericBuffered<DummyLCD>;
 
+// Refresh transfers only the changed characters, so dump the whole LCD content afterwards
+void refresh()
+{
+    LCD::refresh();
+    DummyLCD::dump();
+}
+
 int main()
 {
     
     LCD::init();
-    LCD::refresh();
+    refresh();
 
     StringStream<typename LCD::FrameBuffer> oss(LCD::getBuffer());
     
     oss << String("Hello\nWorld!");
-    LCD::refresh();
+    refresh();
     oss << upperCase << String("\nHallo");
-    LCD::refresh();
+    refresh();
     oss << String("\nWelt!");
-    LCD::refresh();
+    refresh();
     
     oss.str().clear();
     oss << "PROGRAM MEMORY"_pgm; 
-    LCD::refresh();
+    refresh();
 
     oss.str().clear();    
     oss << String("DATA MEMORY");
-    LCD::refresh();
+    refresh();
 
     oss.str().clear();
     oss << static_cast<uint8_t>(1);
-    LCD::refresh();
+    refresh();
 
     oss.str().clear();
     oss << static_cast<uint8_t>(12);
-    LCD::refresh();
+    refresh();
 
     oss.str().clear();
     oss << static_cast<uint8_t>(123);
-    LCD::refresh();
+    refresh();
 
     oss.str().clear();
     oss << static_cast<int8_t>(1);
-    LCD::refresh();
+    refresh();
 
     oss.str().clear();
     oss << static_cast<int8_t>(12);
-    LCD::refresh();
+    refresh();
 
     oss.str().clear();
     oss << static_cast<int8_t>(123);
-    LCD::refresh();
+    refresh();
 
     oss.str().clear();
     oss << static_cast<int8_t>(-1);
-    LCD::refresh();
+    refresh();
 
     oss.str().clear();
     oss << static_cast<int8_t>(-12);
-    LCD::refresh();
+    refresh();
 
     oss.str().clear();
     oss << static_cast<int8_t>(-123);
-    LCD::refresh();
+    refresh();
 
     oss.str().clear();
     oss << static_cast<uint16_t>(1);
-    LCD::refresh();
+    refresh();
 
     oss.str().clear();
     oss << static_cast<uint16_t>(12);
-    LCD::refresh();
+    refresh();
 
     oss.str().clear();
     oss << static_cast<uint16_t>(123);
-    LCD::refresh();
+    refresh();
 
     oss.str().clear();
     oss << static_cast<uint16_t>(1234);
-    LCD::refresh();
+    refresh();
 
     oss.str().clear();
     oss << static_cast<uint16_t>(12345);    
-    LCD::refresh();
+    refresh();
     
     while(true);
 }
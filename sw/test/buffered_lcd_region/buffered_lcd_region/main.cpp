@@ -0,0 +1,278 @@
+/*
+Copyright (C) 2023 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <buffered_lcd.h>
+#include <string_stream.h>
+
+#include "../../common/debug_print.h"
+
+// Emulation of a 4x20 LCD counting the transferred commands
+class MockLCD
+{
+    public:
+
+    static void init()
+    {
+        for (auto& row : s_display)
+        {
+            for (char& c : row)
+            {
+                c = ' ';
+            }
+        }
+    }
+
+    static constexpr uint8_t getNofColumns()
+    {
+        return 20;
+    }
+
+    static constexpr uint8_t getNofRows()
+    {
+        return 4;
+    }
+
+    static void setCursor(const uint8_t rowIdx, const uint8_t columnIdx)
+    {
+        s_row = rowIdx;
+        s_column = columnIdx;
+        ++s_nofCommands;
+    }
+
+    static void putc(const char c)
+    {
+        s_display[s_row][s_column++] = c;
+        ++s_nofChars;
+        s_rowWritten |= 1 << s_row;
+    }
+
+    // Compare a display row with the given string, padded with spaces
+    static bool checkRow(const uint8_t rowIdx, const char * str)
+    {
+        bool passed = true;
+        for (const char c : s_display[rowIdx])
+        {
+            passed &= c == (*str ? *str++ : ' ');
+        }
+        return passed;
+    }
+
+    static void resetCounters()
+    {
+        s_nofCommands = 0;
+        s_nofChars = 0;
+        s_rowWritten = 0;
+    }
+
+    static char s_display[4][20];
+    static uint8_t s_row;
+    static uint8_t s_column;
+    static uint16_t s_nofCommands;
+    static uint16_t s_nofChars;
+    static uint8_t s_rowWritten;
+};
+
+char MockLCD::s_display[4][20] = {};
+uint8_t MockLCD::s_row = 0;
+uint8_t MockLCD::s_column = 0;
+uint16_t MockLCD::s_nofCommands = 0;
+uint16_t MockLCD::s_nofChars = 0;
+uint8_t MockLCD::s_rowWritten = 0;
+
+using LCD = LCDAlphanumericBuffered<MockLCD>;
+
+bool test_assert(const char * str, const bool flag)
+{
+    cout << str;
+    if (flag)
+    {
+        cout << static_cast<const char *>("PASSED");
+    }
+    else
+    {
+        cout << static_cast<const char *>("FAILED");
+    }
+    return flag;
+}
+
+int main(void)
+{
+    bool allPassed = true;
+    bool testPassed = true;
+
+    {
+        testPassed = true;
+        MockLCD::resetCounters();
+        LCD::init();
+        testPassed &= MockLCD::s_nofChars == 80;
+        testPassed &= MockLCD::s_nofCommands == 4;
+
+        // Nothing changed
+        LCD::refresh();
+        testPassed &= MockLCD::s_nofChars == 80;
+    }
+    allPassed &= test_assert("init", testPassed);
+
+    {
+        testPassed = true;
+
+        // Frame buffer covering the whole LCD, scrolling when full
+        StringStream<LCD::FrameBuffer> oss(LCD::getBuffer());
+        oss << "one\ntwo\nthree\nfour"_pgm;
+        LCD::refresh();
+        testPassed &= MockLCD::checkRow(0, "one");
+        testPassed &= MockLCD::checkRow(3, "four");
+        oss << "\nfive"_pgm;
+        LCD::refresh();
+        testPassed &= MockLCD::checkRow(0, "two");
+        testPassed &= MockLCD::checkRow(2, "four");
+        testPassed &= MockLCD::checkRow(3, "five");
+
+        // Line wrap
+        LCD::clear();
+        oss << "0123456789012345678901"_pgm;
+        LCD::refresh();
+        testPassed &= MockLCD::checkRow(0, "01234567890123456789");
+        testPassed &= MockLCD::checkRow(1, "01");
+        testPassed &= MockLCD::checkRow(2, "");
+        LCD::clear();
+    }
+    allPassed &= test_assert("frame buffer", testPassed);
+
+    {
+        testPassed = true;
+        LCD::Region header(0, 1);
+        LCD::Region log(1, 3);
+        StringStream<LCD::Region> headerStream(header);
+        StringStream<LCD::Region> logStream(log);
+
+        headerStream << "CPU 12%  MEM 80%"_pgm;
+        for (uint8_t line = 0; line < 10; ++line)
+        {
+            logStream << "\nevent "_pgm << line;
+        }
+        LCD::refresh();
+        testPassed &= MockLCD::checkRow(0, "CPU 12%  MEM 80%");
+        testPassed &= MockLCD::checkRow(1, "event 7");
+        testPassed &= MockLCD::checkRow(2, "event 8");
+        testPassed &= MockLCD::checkRow(3, "event 9");
+
+        // Scrolling the log does not touch the header
+        MockLCD::resetCounters();
+        logStream << "\nevent 10"_pgm;
+        LCD::refresh();
+        testPassed &= MockLCD::checkRow(0, "CPU 12%  MEM 80%");
+        testPassed &= MockLCD::checkRow(1, "event 8");
+        testPassed &= MockLCD::checkRow(3, "event 10");
+        testPassed &= 0 == (MockLCD::s_rowWritten & 0b0001);
+        testPassed &= MockLCD::s_nofCommands == 3;
+
+        // Partial-line update of the header
+        MockLCD::resetCounters();
+        header.setCursor(0, 4);
+        headerStream << "57"_pgm;
+        LCD::refresh();
+        testPassed &= MockLCD::checkRow(0, "CPU 57%  MEM 80%");
+        testPassed &= MockLCD::s_nofCommands == 1;
+        testPassed &= MockLCD::s_nofChars == 2;
+
+        // Rewriting the same content is not transferred
+        MockLCD::resetCounters();
+        header.setCursor(0, 0);
+        headerStream << "CPU 57%"_pgm;
+        LCD::refresh();
+        testPassed &= MockLCD::s_nofChars == 0;
+
+        // Clearing a region
+        log.clear();
+        LCD::refresh();
+        testPassed &= MockLCD::checkRow(0, "CPU 57%  MEM 80%");
+        testPassed &= MockLCD::checkRow(1, "");
+        testPassed &= MockLCD::checkRow(3, "");
+        logStream << "restart"_pgm;
+        LCD::refresh();
+        testPassed &= MockLCD::checkRow(1, "restart");
+    }
+    allPassed &= test_assert("regions", testPassed);
+
+    {
+        testPassed = true;
+
+        // Status line updated 100 times while the log scrolls every 10th update
+        LCD::clear();
+        LCD::Region header(0, 1);
+        LCD::Region log(1, 3);
+        StringStream<LCD::Region> headerStream(header);
+        StringStream<LCD::Region> logStream(log);
+        MockLCD::resetCounters();
+        for (uint8_t cnt = 0; cnt < 100; ++cnt)
+        {
+            header.setCursor(0, 0);
+            headerStream << "T="_pgm << cnt;
+            if (0 == cnt % 10)
+            {
+                logStream << "\nlog "_pgm << cnt;
+            }
+            LCD::refresh();
+        }
+        testPassed &= MockLCD::checkRow(0, "T=99");
+        testPassed &= MockLCD::checkRow(3, "log 90");
+
+        // Redrawing the whole LCD on every update: 100 * (4 commands + 80 characters)
+        testPassed &= MockLCD::s_nofChars + MockLCD::s_nofCommands < 8400 / 10;
+    }
+    allPassed &= test_assert("partial update", testPassed);
+
+    {
+        testPassed = true;
+
+        // A cursor beyond the region stays within the region
+        LCD::clear();
+        LCD::Region header(0, 1);
+        LCD::Region log(1, 3);
+        StringStream<LCD::Region> headerStream(header);
+        StringStream<LCD::Region> logStream(log);
+        headerStream << "header"_pgm;
+        logStream << "one\ntwo\nthree"_pgm;
+        header.setCursor(1, 0);
+        headerStream << "\nstatus"_pgm;
+        log.setCursor(3, 0);
+        logStream << "\nfour\nfive"_pgm;
+        LCD::refresh();
+        testPassed &= MockLCD::checkRow(0, "status");
+        testPassed &= MockLCD::checkRow(1, "three");
+        testPassed &= MockLCD::checkRow(2, "four");
+        testPassed &= MockLCD::checkRow(3, "five");
+    }
+    allPassed &= test_assert("cursor beyond region", testPassed);
+
+    test_assert("OVERALL:", allPassed);
+
+    while (true)
+    {
+    }
+}
+
+template <>
+struct debugPrinter<const char*>
+{
+    static void print(const char* arg)
+    {
+        // Put a tracepoint here and display {arg, s} in output window
+        (void)arg;
+    }
+};
@@ -0,0 +1,157 @@
+/*
+Copyright (C) 2023 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <command_table.h>
+
+#include "../../common/debug_print.h"
+
+static uint8_t s_lastCommand = 0;
+static size_t s_lastArgSize = 0;
+
+void onSet(const ConstSpan<char> args)
+{
+    s_lastCommand = 1;
+    s_lastArgSize = args.size();
+}
+
+void onSetup(const ConstSpan<char> args)
+{
+    s_lastCommand = 2;
+    s_lastArgSize = args.size();
+}
+
+void onGet(const ConstSpan<char> args)
+{
+    s_lastCommand = 3;
+    s_lastArgSize = args.size();
+}
+
+void onStatus(const ConstSpan<char> args)
+{
+    s_lastCommand = 4;
+    s_lastArgSize = args.size();
+}
+
+// Command table in program memory, sorted at compile time
+constexpr auto commands PROGMEM = makeCommandTable(
+Command{"set"_pgm, &onSet},
+Command{"setup"_pgm, &onSetup},
+Command{"get"_pgm, &onGet},
+Command{"status"_pgm, &onStatus});
+
+bool test_assert(const char * str, const bool flag)
+{
+    cout << str;
+    if (flag)
+    {
+        cout << static_cast<const char *>("PASSED");
+    }
+    else
+    {
+        cout << static_cast<const char *>("FAILED");
+    }
+    return flag;
+}
+
+template <size_t t_size>
+constexpr ConstSpan<char> token(const char (&str)[t_size])
+{
+    // Strip null terminator
+    return ConstSpan<char>(str, t_size - 1);
+}
+
+int main(void)
+{
+    bool allPassed = true;
+    bool testPassed = true;
+
+    {
+        testPassed = true;
+        testPassed &= commands.matchP(token("set")) == 0;
+        testPassed &= commands.matchP(token("setup")) == 1;
+        testPassed &= commands.matchP(token("get")) == 2;
+        testPassed &= commands.matchP(token("status")) == 3;
+    }
+    allPassed &= test_assert("matchP", testPassed);
+
+    {
+        testPassed = true;
+        using Table = decltype(commands);
+        testPassed &= commands.matchP(token("")) == Table::s_noMatch;
+        testPassed &= commands.matchP(token("se")) == Table::s_noMatch;
+        testPassed &= commands.matchP(token("setu")) == Table::s_noMatch;
+        testPassed &= commands.matchP(token("setups")) == Table::s_noMatch;
+        testPassed &= commands.matchP(token("stat")) == Table::s_noMatch;
+        testPassed &= commands.matchP(token("reset")) == Table::s_noMatch;
+    }
+    allPassed &= test_assert("no match", testPassed);
+
+    {
+        testPassed = true;
+        testPassed &= commands.dispatchP(token("setup  42 13"));
+        testPassed &= s_lastCommand == 2;
+        testPassed &= s_lastArgSize == 5;
+        testPassed &= commands.dispatchP(token("get"));
+        testPassed &= s_lastCommand == 3;
+        testPassed &= s_lastArgSize == 0;
+        testPassed &= !commands.dispatchP(token("gets 1"));
+        testPassed &= s_lastCommand == 3;
+    }
+    allPassed &= test_assert("dispatchP", testPassed);
+
+    {
+        testPassed = true;
+
+        // Feed characters one at a time, e.g. as they are received by a USART
+        decltype(commands)::Matcher matcher(commands);
+        for (const char c : token("status"))
+        {
+            matcher.feed(c);
+        }
+        testPassed &= matcher.matched();
+        testPassed &= matcher.index() == 3;
+        matcher.handler()(ConstSpan<char>());
+        testPassed &= s_lastCommand == 4;
+
+        matcher.reset();
+        testPassed &= matcher.feed('s');
+        testPassed &= !matcher.feed('x');
+        testPassed &= !matcher.matched();
+    }
+    allPassed &= test_assert("Matcher", testPassed);
+
+    test_assert("OVERALL:", allPassed);
+
+    while (true)
+    {
+    }
+}
+
+template <>
+struct debugPrinter<const char*>
+{
+    static void print(const char* arg)
+    {
+        // Put a tracepoint here and display {arg, s} in output window
+        (void)arg;
+    }
+};
+
+void throw_length_error()
+{
+    while(true);
+}
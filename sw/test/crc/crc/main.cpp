@@ -0,0 +1,182 @@
+/*
+Copyright (C) 2023 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <crc.h>
+
+#include "../../common/debug_print.h"
+
+bool test_assert(const char * str, const bool flag)
+{
+    cout << str;
+    if (flag)
+    {
+        cout << static_cast<const char *>("PASSED");
+    }
+    else
+    {
+        cout << static_cast<const char *>("FAILED");
+    }
+    return flag;
+}
+
+// Check message used by the CRC catalogue
+static const uint8_t s_check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+// Pseudo random bytes (16-bit xorshift)
+uint8_t nextByte(uint16_t& state)
+{
+    state ^= state << 7;
+    state ^= state >> 9;
+    state ^= state << 8;
+    return static_cast<uint8_t>(state);
+}
+
+// Check value, incremental update and residue of a CRC
+template <typename CRCType>
+bool testCRC(const typename CRCType::value_type check)
+{
+    bool passed = CRCType::compute(s_check) == check;
+    
+    // Incremental update in pieces of 4, 1 and 4 bytes
+    const ConstSpan<uint8_t> message(s_check);
+    typename CRCType::value_type crc = CRCType::init();
+    crc = CRCType::update(crc, message.first(4));
+    crc = CRCType::update(crc, message[4]);
+    crc = CRCType::update(crc, message.last(4));
+    passed &= CRCType::finalize(crc) == check;
+    
+    // Message followed by its CRC
+    for (uint8_t idx = 0; idx < CRCType::s_size; ++idx)
+    {
+        crc = CRCType::update(crc, CRCType::getByte(check, idx));
+    }
+    passed &= crc == CRCType::getResidue();
+    return passed;
+}
+
+// All implementations of a CRC yield the same result
+template <typename CRCTable, typename CRCNibble, typename CRCBitwise>
+bool testImplementations()
+{
+    uint8_t data[200];
+    uint16_t state = 1;
+    for (uint8_t idx = 0; idx < 200; ++idx)
+    {
+        data[idx] = nextByte(state);
+    }
+    
+    bool passed = true;
+    for (uint8_t size = 0; size < 200; size += 7)
+    {
+        const ConstSpan<uint8_t> message(data, size);
+        const auto crc = CRCTable::compute(message);
+        passed &= CRCNibble::compute(message) == crc;
+        passed &= CRCBitwise::compute(message) == crc;
+    }
+    return passed;
+}
+
+// Benchmark: CRC of 256 bytes.
+// Put a breakpoint before and after each benchmark call and read the cycle counter of the simulator.
+template <typename CRCType>
+typename CRCType::value_type benchmarkCRC(const ConstSpan<uint8_t> data)
+{
+    return CRCType::compute(data);
+}
+
+int main(void)
+{
+    bool allPassed = true;
+    bool testPassed = true;
+    
+    {
+        testPassed = true;
+        testPassed &= testCRC<CRC8>(0xF4);
+        testPassed &= testCRC<CRC8Nibble>(0xF4);
+        testPassed &= testCRC<CRC8Bitwise>(0xF4);
+        testPassed &= CRC8::getResidue() == 0x00;
+    }
+    allPassed &= test_assert("CRC-8", testPassed);
+    
+    {
+        testPassed = true;
+        testPassed &= testCRC<CRC16>(0x29B1);
+        testPassed &= testCRC<CRC16Nibble>(0x29B1);
+        testPassed &= testCRC<CRC16Bitwise>(0x29B1);
+        testPassed &= CRC16::getResidue() == 0x0000;
+    }
+    allPassed &= test_assert("CRC-16", testPassed);
+    
+    {
+        testPassed = true;
+        testPassed &= testCRC<CRC32>(0xCBF43926);
+        testPassed &= testCRC<CRC32Nibble>(0xCBF43926);
+        testPassed &= testCRC<CRC32Bitwise>(0xCBF43926);
+        testPassed &= CRC32::getResidue() == 0xDEBB20E3;
+    }
+    allPassed &= test_assert("CRC-32", testPassed);
+    
+    {
+        testPassed = true;
+        testPassed &= testImplementations<CRC8, CRC8Nibble, CRC8Bitwise>();
+        testPassed &= testImplementations<CRC16, CRC16Nibble, CRC16Bitwise>();
+        testPassed &= testImplementations<CRC32, CRC32Nibble, CRC32Bitwise>();
+    }
+    allPassed &= test_assert("implementations", testPassed);
+    
+    {
+        testPassed = true;
+        constexpr PgmString message = "123456789"_pgm;
+        const PgmSpan<uint8_t> data(reinterpret_cast<const uint8_t*>(message.data()), message.size());
+        testPassed &= CRC16::compute(data) == 0x29B1;
+        testPassed &= CRC32Nibble::compute(data) == 0xCBF43926;
+    }
+    allPassed &= test_assert("PROGMEM data", testPassed);
+    
+    {
+        testPassed = true;
+        uint8_t data[256];
+        uint16_t state = 1;
+        for (uint16_t idx = 0; idx < 256; ++idx)
+        {
+            data[idx] = nextByte(state);
+        }
+        testPassed &= benchmarkCRC<CRC8>(data) == benchmarkCRC<CRC8Nibble>(data);
+        testPassed &= benchmarkCRC<CRC8>(data) == benchmarkCRC<CRC8Bitwise>(data);
+        testPassed &= benchmarkCRC<CRC16>(data) == benchmarkCRC<CRC16Nibble>(data);
+        testPassed &= benchmarkCRC<CRC16>(data) == benchmarkCRC<CRC16Bitwise>(data);
+        testPassed &= benchmarkCRC<CRC32>(data) == benchmarkCRC<CRC32Nibble>(data);
+        testPassed &= benchmarkCRC<CRC32>(data) == benchmarkCRC<CRC32Bitwise>(data);
+    }
+    allPassed &= test_assert("benchmark", testPassed);
+    
+    test_assert("OVERALL:", allPassed);
+    
+    while (true)
+    {
+    }
+}
+
+template <>
+struct debugPrinter<const char*>
+{
+    static void print(const char* arg)
+    {
+        // Put a tracepoint here and display {arg, s} in output window
+        (void)arg;
+    }
+};
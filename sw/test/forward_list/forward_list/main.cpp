@@ -17,6 +17,7 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <forward_list.h>
 #include <allocator.h>
+#include <vector.h>
 
 #include "../../common/debug_print.h"
 
@@ -55,6 +56,11 @@ class Test
         return *this;
     }
     
+    bool operator<(const Test& other) const
+    {
+        return m_value < other.m_value;
+    }
+    
     uint8_t getValue() const
     {
         return m_value;
@@ -125,6 +131,89 @@ bool test_assert(const char * str, const bool flag)
 }
 
 
+// Heap for up to 256 list nodes (the node size depends on the pointer size)
+using BenchmarkHeap = HeapAllocator<sizeof(void*) * 1536>;
+
+// Pseudo random values 0..63 (full period linear congruential generator modulo 256)
+uint8_t nextValue(uint8_t& state)
+{
+    state = 5 * state + 1;
+    return state & 0x3F;
+}
+
+template <typename Container>
+bool isSorted(Container& x)
+{
+    bool sorted = true;
+    auto it = x.begin();
+    if (it != x.end())
+    {
+        uint8_t prev = *it;
+        for (++it; it != x.end(); ++it)
+        {
+            sorted &= !(*it < prev);
+            prev = *it;
+        }
+    }
+    return sorted;
+}
+
+// Benchmark: Sort a list of t_size pseudo random elements in place vs. copying the elements into a vector, sorting the vector and rebuilding the list.
+// Put a breakpoint before and after each benchmark call and read the cycle counter of the simulator.
+template <uint16_t t_size>
+bool benchmarkSort()
+{
+    ForwardList<uint8_t, BenchmarkHeap> x;
+    uint8_t state = 1;
+    for (uint16_t cnt = 0; cnt < t_size; ++cnt)
+    {
+        x.pushFront(nextValue(state));
+    }
+    x.sort();
+    return isSorted(x);
+}
+
+template <uint16_t t_size>
+bool benchmarkCopySortRebuild()
+{
+    ForwardList<uint8_t, BenchmarkHeap> x;
+    uint8_t state = 1;
+    for (uint16_t cnt = 0; cnt < t_size; ++cnt)
+    {
+        x.pushFront(nextValue(state));
+    }
+
+    // Copy
+    Vector<uint8_t, BenchmarkHeap> v;
+    v.reserve(t_size);
+    for (const uint8_t elem : x)
+    {
+        v.pushBack(elem);
+    }
+
+    // Insertion sort
+    for (uint16_t idx = 1; idx < v.size(); ++idx)
+    {
+        const uint8_t value = v[idx];
+        uint16_t pos = idx;
+        while (pos > 0 && value < v[pos - 1])
+        {
+            v[pos] = v[pos - 1];
+            --pos;
+        }
+        v[pos] = value;
+    }
+
+    // Rebuild
+    x.clear();
+    for (uint16_t idx = v.size(); idx > 0; --idx)
+    {
+        x.pushFront(v[idx - 1]);
+    }
+
+    return isSorted(x);
+}
+
 int main(void)
 {
     bool allPassed = true;
@@ -617,7 +706,86 @@ int main(void)
     allPassed &= test_assert("spliceAfter()", testPassed && Test::check(0,0,6,0,6));
 
 
+    {
+        testPassed = true;
+        Test::resetCounter();
+        ForwardList<Test> x(testList);
+        x.pushFront(testList.front());
+        x.sort();
+        const uint8_t expected[] = {42, 42, 43, 44};
+        const uint8_t* it = expected;
+        for (const Test& t : x)
+        {
+            testPassed &= t.getValue() == *it++;
+        }
+    }
+    allPassed &= test_assert("sort()", testPassed && Test::check(0,0,4,0,4));
 
+    {
+        testPassed = true;
+        ForwardList<uint8_t, BenchmarkHeap> x;
+        x.sort();
+        testPassed &= x.empty();
+        
+        uint8_t state = 1;
+        for (uint16_t cnt = 0; cnt < 200; ++cnt)
+        {
+            x.pushFront(nextValue(state));
+        }
+        x.sort();
+        testPassed &= isSorted(x);
+        uint16_t nofElems = 0;
+        for (auto it = x.begin(); it != x.end(); ++it)
+        {
+            ++nofElems;
+        }
+        testPassed &= nofElems == 200;
+        
+        // Sort descending
+        x.sort([](const uint8_t lhs, const uint8_t rhs) { return lhs > rhs; });
+        testPassed &= x.front() == 63;
+    }
+    allPassed &= test_assert("sort()", testPassed);
+    
+    {
+        testPassed = true;
+        ForwardList<uint8_t> x({1, 3, 5, 7});
+        ForwardList<uint8_t> y({0, 3, 4, 8, 9});
+        x.merge(y);
+        testPassed &= y.empty();
+        const uint8_t expected[] = {0, 1, 3, 3, 4, 5, 7, 8, 9};
+        const uint8_t* it = expected;
+        for (const uint8_t elem : x)
+        {
+            testPassed &= elem == *it++;
+        }
+        testPassed &= it == expected + sizeof(expected);
+    }
+    allPassed &= test_assert("merge()", testPassed);
+    
+    {
+        testPassed = true;
+        ForwardList<uint8_t> x({1, 1, 2, 3, 3, 3, 1});
+        testPassed &= x.unique() == 3;
+        const uint8_t expected[] = {1, 2, 3, 1};
+        const uint8_t* it = expected;
+        for (const uint8_t elem : x)
+        {
+            testPassed &= elem == *it++;
+        }
+        testPassed &= it == expected + sizeof(expected);
+        testPassed &= x.unique([](const uint8_t lhs, const uint8_t rhs) { return lhs + 1 == rhs; }) == 1;
+    }
+    allPassed &= test_assert("unique()", testPassed);
+    
+    {
+        testPassed = true;
+        testPassed &= benchmarkSort<64>();
+        testPassed &= benchmarkCopySortRebuild<64>();
+        testPassed &= benchmarkSort<256>();
+        testPassed &= benchmarkCopySortRebuild<256>();
+    }
+    allPassed &= test_assert("benchmark", testPassed);
 
     //// forward_list operations
     //void splice_after(const_iterator position, forward_list& x);
@@ -632,17 +800,9 @@ int main(void)
     //size_type remove(const T& value);
     //template<class Predicate> size_type remove_if(Predicate pred);
     //
-    //size_type unique();
-    //template<class BinaryPredicate> size_type unique(BinaryPredicate binary_pred);
-    //
-    //void merge(forward_list& x);
     //void merge(forward_list&& x);
-    //template<class Compare> void merge(forward_list& x, Compare comp);
     //template<class Compare> void merge(forward_list&& x, Compare comp);
     //
-    //void sort();
-    //template<class Compare> void sort(Compare comp);
-    //
     //void reverse() noexcept;
 
     allPassed &= test_assert("OVERALL:", allPassed);
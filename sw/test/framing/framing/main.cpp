@@ -0,0 +1,533 @@
+/*
+Copyright (C) 2023 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <framing.h>
+
+#include "../../common/debug_print.h"
+
+bool test_assert(const char * str, const bool flag)
+{
+    cout << str;
+    if (flag)
+    {
+        cout << static_cast<const char *>("PASSED");
+    }
+    else
+    {
+        cout << static_cast<const char *>("FAILED");
+    }
+    return flag;
+}
+
+// Pseudo random bytes (16-bit xorshift)
+uint8_t nextByte(uint16_t& state)
+{
+    state ^= state << 7;
+    state ^= state >> 9;
+    state ^= state << 8;
+    return static_cast<uint8_t>(state);
+}
+
+// Transmit channel recording all bytes. The number of free bytes is limited to test encoding in chunks.
+struct MockTX
+{
+    static bool put(const uint8_t data)
+    {
+        s_data[s_size++] = data;
+        --s_nofFreeBytes;
+        return true;
+    }
+    
+    static size_t getNofFreeBytes()
+    {
+        return s_nofFreeBytes;
+    }
+    
+    static bool read(uint8_t& data)
+    {
+        if (s_pos == s_size)
+        {
+            return false;
+        }
+        data = s_data[s_pos++];
+        return true;
+    }
+    
+    static void clear()
+    {
+        s_size = 0;
+        s_pos = 0;
+    }
+    
+    static uint8_t s_data[2048];
+    static size_t s_size;
+    static size_t s_pos;
+    static size_t s_nofFreeBytes;
+};
+
+// Static initialization
+uint8_t MockTX::s_data[2048];
+size_t MockTX::s_size = 0;
+size_t MockTX::s_pos = 0;
+size_t MockTX::s_nofFreeBytes = 0;
+
+// Handlers recording the received frames
+struct RecordingHandlers : FrameHandlers
+{
+    static void frame(const ConstSpan<uint8_t> payload)
+    {
+        ++s_nofFrames;
+        s_lastSize = payload.size();
+        s_lastCRC = CRC16::compute(payload);
+        
+        // First payload byte is the sequence number, if any
+        if (!payload.empty())
+        {
+            s_received[payload[0]] = true;
+        }
+    }
+    
+    static void error(const FrameError error)
+    {
+        ++s_nofErrors[static_cast<uint8_t>(error)];
+    }
+    
+    static void clear()
+    {
+        s_nofFrames = 0;
+        s_lastSize = 0;
+        s_lastCRC = 0;
+        for (uint16_t idx = 0; idx < 256; ++idx)
+        {
+            s_received[idx] = false;
+        }
+        for (uint8_t idx = 0; idx < 3; ++idx)
+        {
+            s_nofErrors[idx] = 0;
+        }
+    }
+    
+    static uint16_t s_nofFrames;
+    static size_t s_lastSize;
+    static uint16_t s_lastCRC;
+    static bool s_received[256];
+    static uint16_t s_nofErrors[3];
+};
+
+// Static initialization
+uint16_t RecordingHandlers::s_nofFrames = 0;
+size_t RecordingHandlers::s_lastSize = 0;
+uint16_t RecordingHandlers::s_lastCRC = 0;
+bool RecordingHandlers::s_received[256] = {};
+uint16_t RecordingHandlers::s_nofErrors[3] = {};
+
+template <size_t t_size>
+constexpr ConstSpan<uint8_t> bytes(const char (&str)[t_size])
+{
+    // Strip null terminator
+    return ConstSpan<uint8_t>(reinterpret_cast<const uint8_t*>(str), t_size - 1);
+}
+
+// Straightforward reference COBS encoder (including delimiter) as published in the COBS paper. The trailing empty block after a final block
+// of maximum length is omitted, like COBSEncoder does.
+size_t encodeCOBSReference(const ConstSpan<uint8_t> data, uint8_t * dst)
+{
+    size_t codePos = 0;
+    size_t size = 1;
+    uint8_t code = 1;
+    bool lastBlockFull = false;
+    for (const uint8_t byte : data)
+    {
+        lastBlockFull = false;
+        if (0 == byte)
+        {
+            dst[codePos] = code;
+            codePos = size++;
+            code = 1;
+        }
+        else
+        {
+            dst[size++] = byte;
+            if (0xFF == ++code)
+            {
+                dst[codePos] = code;
+                codePos = size++;
+                code = 1;
+                lastBlockFull = true;
+            }
+        }
+    }
+    
+    if (lastBlockFull)
+    {
+        size = codePos;
+    }
+    else
+    {
+        dst[codePos] = code;
+    }
+    dst[size++] = 0;
+    return size;
+}
+
+// Encode a complete frame using read()
+template <typename Encoder>
+size_t encodeAll(Encoder& encoder, const ConstSpan<uint8_t> payload, uint8_t * dst)
+{
+    encoder.begin(payload);
+    size_t size = 0;
+    while (encoder.read(dst[size]))
+    {
+        ++size;
+    }
+    return size;
+}
+
+// Compare the streaming encoder with the reference encoding of payload and CRC
+bool testCOBSEncoder(const ConstSpan<uint8_t> payload)
+{
+    uint8_t source[600];
+    size_t sourceSize = 0;
+    for (const uint8_t byte : payload)
+    {
+        source[sourceSize++] = byte;
+    }
+    const uint16_t crc = CRC16::compute(payload);
+    source[sourceSize++] = CRC16::getByte(crc, 0);
+    source[sourceSize++] = CRC16::getByte(crc, 1);
+    
+    uint8_t expected[700];
+    const size_t expectedSize = encodeCOBSReference(ConstSpan<uint8_t>(source, sourceSize), expected);
+    
+    uint8_t encoded[700];
+    COBSEncoder<> encoder;
+    const size_t size = encodeAll(encoder, payload, encoded);
+    
+    bool passed = size == expectedSize && encoder.done();
+    for (size_t idx = 0; idx < size && idx < expectedSize; ++idx)
+    {
+        passed &= encoded[idx] == expected[idx];
+        
+        // Only the delimiter is zero
+        passed &= (0 == encoded[idx]) == (idx == size - 1);
+    }
+    return passed;
+}
+
+// Send random frames with random corruptions through encoder and decoder
+template <template <typename> class Encoder, template <typename, typename> class Decoder>
+bool testLoopback()
+{
+    RecordingHandlers::clear();
+    uint8_t buffer[300 + CRC16::s_size];
+    Decoder<RecordingHandlers, CRC16> decoder(buffer);
+    Encoder<CRC16> encoder;
+    uint16_t state = 0xACE1;
+    MockTX channel;
+    
+    // Bytes with special meaning for COBS or SLIP
+    const uint8_t special[] = {0x00, 0xC0, 0xDB};
+    
+    bool passed = true;
+    uint16_t nofCorrupted = 0;
+    bool corrupted[256] = {};
+    for (uint16_t seq = 0; seq < 256; ++seq)
+    {
+        // Random payload including bytes which need special treatment
+        uint8_t payload[300];
+        const size_t size = 1 + (static_cast<size_t>(nextByte(state)) * 300 >> 8);
+        payload[0] = static_cast<uint8_t>(seq);
+        for (size_t idx = 1; idx < size; ++idx)
+        {
+            const uint8_t value = nextByte(state);
+            payload[idx] = (value & 0x0F) < 3 ? special[value & 0x0F] : value;
+        }
+        
+        MockTX::clear();
+        MockTX::s_nofFreeBytes = 0;
+        encoder.begin(ConstSpan<uint8_t>(payload, size));
+        while (true)
+        {
+            MockTX::s_nofFreeBytes = 1 + (nextByte(state) & 0x1F);
+            if (encoder.template encodeTo<MockTX>())
+            {
+                break;
+            }
+        }
+        
+        // Corrupt every 4th frame (but never its delimiters) by flipping, inserting or dropping a byte
+        if (0 == (seq & 3) && MockTX::s_size > 4)
+        {
+            const size_t pos = 2 + nextByte(state) % (MockTX::s_size - 4);
+            switch (seq & 0xC)
+            {
+                case 0:
+                MockTX::s_data[pos] ^= 1 << (nextByte(state) & 7);
+                break;
+                
+                case 4:
+                for (size_t idx = MockTX::s_size; idx > pos; --idx)
+                {
+                    MockTX::s_data[idx] = MockTX::s_data[idx - 1];
+                }
+                ++MockTX::s_size;
+                break;
+                
+                default:
+                for (size_t idx = pos; idx < MockTX::s_size - 1; ++idx)
+                {
+                    MockTX::s_data[idx] = MockTX::s_data[idx + 1];
+                }
+                --MockTX::s_size;
+                break;
+            }
+            
+            corrupted[seq] = true;
+            ++nofCorrupted;
+        }
+        
+        // Decode in chunks of random length
+        while (decoder.parseFrom(channel, 1 + (nextByte(state) & 0x3F)) > 0)
+        {
+        }
+        
+        passed &= RecordingHandlers::s_received[seq] != corrupted[seq];
+    }
+    
+    uint16_t nofErrors = 0;
+    for (uint8_t idx = 0; idx < 3; ++idx)
+    {
+        nofErrors += RecordingHandlers::s_nofErrors[idx];
+    }
+    passed &= RecordingHandlers::s_nofFrames == 256 - nofCorrupted;
+    passed &= nofErrors >= nofCorrupted;
+    return passed;
+}
+
+// Benchmark: Encode and decode a frame of given length.
+// Put a breakpoint before and after each benchmark call and read the cycle counter of the simulator.
+template <typename Encoder>
+size_t benchmarkEncode(const ConstSpan<uint8_t> payload)
+{
+    Encoder encoder;
+    encoder.begin(payload);
+    uint8_t data;
+    size_t size = 0;
+    while (encoder.read(data))
+    {
+        MockTX::s_data[size++] = data;
+    }
+    return size;
+}
+
+template <typename Decoder>
+uint16_t benchmarkDecode(const size_t size)
+{
+    RecordingHandlers::clear();
+    uint8_t buffer[300];
+    Decoder decoder(buffer);
+    decoder.parse(ConstSpan<uint8_t>(MockTX::s_data, size));
+    return RecordingHandlers::s_nofFrames;
+}
+
+int main(void)
+{
+    bool allPassed = true;
+    bool testPassed = true;
+    
+    {
+        testPassed = true;
+        testPassed &= CRC8::compute(bytes("123456789")) == 0xF4;
+        testPassed &= CRC16::compute(bytes("123456789")) == 0x29B1;
+        
+        // Incremental update
+        uint16_t crc = CRC16::init();
+        crc = CRC16::update(crc, bytes("1234"));
+        crc = CRC16::update(crc, '5');
+        crc = CRC16::update(crc, bytes("6789"));
+        testPassed &= CRC16::finalize(crc) == 0x29B1;
+        
+        // Message followed by its CRC yields the residue
+        crc = CRC16::update(CRC16::init(), bytes("123456789"));
+        crc = CRC16::update(crc, 0x29);
+        crc = CRC16::update(crc, 0xB1);
+        testPassed &= crc == CRC16::getResidue();
+        uint8_t crc8 = CRC8::update(CRC8::init(), bytes("123456789"));
+        testPassed &= CRC8::update(crc8, 0xF4) == CRC8::getResidue();
+    }
+    allPassed &= test_assert("CRC", testPassed);
+    
+    {
+        testPassed = true;
+        
+        // Reference encoder against examples from the COBS paper
+        uint8_t encoded[8];
+        const uint8_t example1[] = {0x00};
+        testPassed &= encodeCOBSReference(example1, encoded) == 3;
+        testPassed &= encoded[0] == 0x01 && encoded[1] == 0x01 && encoded[2] == 0x00;
+        const uint8_t example2[] = {0x11, 0x22, 0x00, 0x33};
+        testPassed &= encodeCOBSReference(example2, encoded) == 6;
+        testPassed &= encoded[0] == 0x03 && encoded[1] == 0x11 && encoded[2] == 0x22 && encoded[3] == 0x02 && encoded[4] == 0x33 && encoded[5] == 0x00;
+        
+        // Streaming encoder against reference encoder, including blocks of maximum length
+        uint8_t payload[600];
+        uint16_t state = 1;
+        for (size_t size = 0; size < 600; size += 1 + (nextByte(state) & 0x0F))
+        {
+            for (size_t idx = 0; idx < size; ++idx)
+            {
+                payload[idx] = nextByte(state) | 1;
+            }
+            testPassed &= testCOBSEncoder(ConstSpan<uint8_t>(payload, size));
+            if (size > 0)
+            {
+                payload[nextByte(state) % size] = 0;
+                testPassed &= testCOBSEncoder(ConstSpan<uint8_t>(payload, size));
+            }
+        }
+        for (size_t size = 250; size < 260; ++size)
+        {
+            for (size_t idx = 0; idx < size; ++idx)
+            {
+                payload[idx] = 0x55;
+            }
+            testPassed &= testCOBSEncoder(ConstSpan<uint8_t>(payload, size));
+            payload[size - 1] = 0;
+            testPassed &= testCOBSEncoder(ConstSpan<uint8_t>(payload, size));
+        }
+    }
+    allPassed &= test_assert("COBS encoder", testPassed);
+    
+    {
+        testPassed = true;
+        uint8_t encoded[32];
+        SLIPEncoder<CRC8> encoder;
+        const uint8_t payload[] = {0x01, 0xC0, 0xDB, 0x02};
+        const size_t size = encodeAll(encoder, payload, encoded);
+        testPassed &= size == 9;
+        testPassed &= encoded[0] == 0xC0 && encoded[1] == 0x01;
+        testPassed &= encoded[2] == 0xDB && encoded[3] == 0xDC && encoded[4] == 0xDB && encoded[5] == 0xDD;
+        testPassed &= encoded[6] == 0x02 && encoded[7] == CRC8::compute(payload) && encoded[8] == 0xC0;
+        testPassed &= encoder.done();
+    }
+    allPassed &= test_assert("SLIP encoder", testPassed);
+    
+    {
+        testPassed = true;
+        RecordingHandlers::clear();
+        uint8_t buffer[8];
+        COBSDecoder<RecordingHandlers> decoder(buffer);
+        COBSEncoder<> encoder;
+        uint8_t encoded[32];
+        
+        // Idle delimiters are ignored
+        const uint8_t idle[] = {0x00, 0x00, 0x00};
+        decoder.parse(idle);
+        testPassed &= RecordingHandlers::s_nofFrames == 0;
+        testPassed &= RecordingHandlers::s_nofErrors[0] + RecordingHandlers::s_nofErrors[1] + RecordingHandlers::s_nofErrors[2] == 0;
+        
+        // Frame of maximum size
+        const uint8_t payload[] = {1, 0, 2, 0, 0, 3};
+        decoder.parse(ConstSpan<uint8_t>(encoded, encodeAll(encoder, payload, encoded)));
+        testPassed &= RecordingHandlers::s_nofFrames == 1;
+        testPassed &= RecordingHandlers::s_lastSize == 6;
+        testPassed &= RecordingHandlers::s_lastCRC == CRC16::compute(payload);
+        
+        // Frame too large for the buffer
+        const uint8_t large[] = {1, 2, 3, 4, 5, 6, 7};
+        decoder.parse(ConstSpan<uint8_t>(encoded, encodeAll(encoder, large, encoded)));
+        testPassed &= RecordingHandlers::s_nofErrors[static_cast<uint8_t>(FrameError::overflow)] == 1;
+        
+        // Truncated block
+        const uint8_t truncated[] = {0x05, 0x01, 0x00};
+        decoder.parse(truncated);
+        testPassed &= RecordingHandlers::s_nofErrors[static_cast<uint8_t>(FrameError::encoding)] == 1;
+        
+        // Too short for CRC
+        const uint8_t tooShort[] = {0x02, 0x01, 0x00};
+        decoder.parse(tooShort);
+        testPassed &= RecordingHandlers::s_nofErrors[static_cast<uint8_t>(FrameError::crc)] == 1;
+        
+        // Decoder has recovered
+        decoder.parse(ConstSpan<uint8_t>(encoded, encodeAll(encoder, payload, encoded)));
+        testPassed &= RecordingHandlers::s_nofFrames == 2;
+    }
+    allPassed &= test_assert("COBS decoder", testPassed);
+    
+    {
+        testPassed = true;
+        RecordingHandlers::clear();
+        uint8_t buffer[8];
+        SLIPDecoder<RecordingHandlers> decoder(buffer);
+        SLIPEncoder<> encoder;
+        uint8_t encoded[32];
+        
+        const uint8_t payload[] = {0xC0, 0xDB, 0xDC, 0xDD, 0x00, 0xC0};
+        decoder.parse(ConstSpan<uint8_t>(encoded, encodeAll(encoder, payload, encoded)));
+        testPassed &= RecordingHandlers::s_nofFrames == 1;
+        testPassed &= RecordingHandlers::s_lastSize == 6;
+        testPassed &= RecordingHandlers::s_lastCRC == CRC16::compute(payload);
+        
+        // Invalid escape sequence
+        const uint8_t invalid[] = {0xC0, 0x01, 0xDB, 0x01, 0x02, 0xC0};
+        decoder.parse(invalid);
+        testPassed &= RecordingHandlers::s_nofErrors[static_cast<uint8_t>(FrameError::encoding)] == 1;
+        
+        // Decoder has recovered
+        decoder.parse(ConstSpan<uint8_t>(encoded, encodeAll(encoder, payload, encoded)));
+        testPassed &= RecordingHandlers::s_nofFrames == 2;
+    }
+    allPassed &= test_assert("SLIP decoder", testPassed);
+    
+    {
+        testPassed = true;
+        testPassed &= testLoopback<COBSEncoder, COBSDecoder>();
+        testPassed &= testLoopback<SLIPEncoder, SLIPDecoder>();
+    }
+    allPassed &= test_assert("loopback", testPassed);
+    
+    {
+        testPassed = true;
+        uint8_t payload[256];
+        uint16_t state = 1;
+        for (uint16_t idx = 0; idx < 256; ++idx)
+        {
+            payload[idx] = nextByte(state);
+        }
+        size_t size = benchmarkEncode<COBSEncoder<CRC16>>(payload);
+        testPassed &= benchmarkDecode<COBSDecoder<RecordingHandlers, CRC16>>(size) == 1;
+        size = benchmarkEncode<SLIPEncoder<CRC16>>(payload);
+        testPassed &= benchmarkDecode<SLIPDecoder<RecordingHandlers, CRC16>>(size) == 1;
+    }
+    allPassed &= test_assert("benchmark", testPassed);
+    
+    test_assert("OVERALL:", allPassed);
+    
+    while (true)
+    {
+    }
+}
+
+template <>
+struct debugPrinter<const char*>
+{
+    static void print(const char* arg)
+    {
+        // Put a tracepoint here and display {arg, s} in output window
+        (void)arg;
+    }
+};
@@ -0,0 +1,82 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef HOST_BENCHMARK_H
+#define HOST_BENCHMARK_H
+
+// Interface between the translation units of the host benchmark.
+// The library headers replace parts of the standard library (e.g. string.h, limits.h, initializer_list), so library containers
+// and their std:: counterparts are compiled in separate translation units, which only share the plain types declared here.
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+@brief Operation sequence run on a container
+The sequence is run with n elements and returns a checksum over all observed results, e.g. popped values or iteration order.
+A library operation and the std:: operation of the same name must perform identical sequences and return identical checksums.
+Only run() is timed. prepare() and release() are optional and allow to exclude setting up or destroying a container from the run time,
+e.g. to measure sorting a list and destroying the sorted list as separate operations.
+*/
+struct Operation
+{
+    const char* name;
+    uint32_t (*run)(uint32_t n);
+
+    // Called with n before run(), not timed. May be nullptr.
+    void (*prepare)(uint32_t n) = nullptr;
+
+    // Called after run(), not timed. May be nullptr.
+    void (*release)() = nullptr;
+};
+
+// Operations on library containers (library_ops.cpp)
+extern const Operation g_libraryOperations[];
+extern const size_t g_nofLibraryOperations;
+
+// Operations on std:: containers (std_ops.cpp)
+extern const Operation g_stdOperations[];
+extern const size_t g_nofStdOperations;
+
+/**
+@brief Pseudo random numbers (linear congruential generator) so both implementations see the same input sequence
+@param state Generator state
+@result Next pseudo random number
+*/
+inline uint32_t nextRandom(uint32_t& state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+/**
+@brief Mix a value into a checksum (FNV-1a over the four bytes of the value)
+@param checksum Checksum to update
+@param value Value to mix in
+*/
+inline void mix(uint32_t& checksum, const uint32_t value)
+{
+    for (uint8_t shift = 0; shift < 32; shift += 8)
+    {
+        checksum = (checksum ^ ((value >> shift) & 0xFF)) * 16777619u;
+    }
+}
+
+/// @brief Initial value of a checksum
+static constexpr uint32_t s_checksumSeed = 2166136261u;
+
+#endif
@@ -0,0 +1,180 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// Host benchmark comparing library containers to their std:: counterparts.
+// Every operation sequence is run on both implementations:
+// - The checksums of both implementations must be equal (differential test), otherwise the benchmark fails.
+// - The run time of both implementations is measured for a small and a large number of elements. The growth exponent of the run time
+//   (1 for linear, 2 for quadratic run time of the whole sequence) reveals operations of the library that scale worse than the std::
+//   counterpart, e.g. a linear insertion instead of a logarithmic one. These operations are flagged.
+// Build and run with run.sh. With option --strict, flagged operations make the benchmark fail, too.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "benchmark.h"
+
+namespace
+{
+    // Numbers of elements for the differential test, including corner cases
+    constexpr uint32_t s_testSizes[] = {0, 1, 2, 3, 17, 100, 1000};
+
+    // Numbers of elements for the run time measurement
+    constexpr uint32_t s_smallSize = 1000;
+    constexpr uint32_t s_largeSize = 8000;
+
+    // Minimum duration of one measurement
+    constexpr double s_minDuration = 0.05;
+
+    // Tolerance of the growth exponent before an operation is flagged
+    constexpr double s_exponentTolerance = 0.5;
+
+    // The checksum is accumulated so the compiler cannot discard the operation
+    volatile uint32_t s_sink = 0;
+
+    // Measure the run time of one operation sequence in seconds, best of three. Preparation and release are not included.
+    double measure(const Operation& operation, const uint32_t n)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        double best = 0.0;
+        for (uint8_t trial = 0; trial < 3; ++trial)
+        {
+            uint32_t nofRuns = 0;
+            double duration = 0.0;
+            do
+            {
+                if (nullptr != operation.prepare)
+                {
+                    operation.prepare(n);
+                }
+                const Clock::time_point start = Clock::now();
+                s_sink = s_sink + operation.run(n);
+                duration += std::chrono::duration<double>(Clock::now() - start).count();
+                if (nullptr != operation.release)
+                {
+                    operation.release();
+                }
+                ++nofRuns;
+            }
+            while (duration < s_minDuration);
+
+            const double perRun = duration / nofRuns;
+            if (0 == trial || perRun < best)
+            {
+                best = perRun;
+            }
+        }
+        return best;
+    }
+
+    // Run one operation sequence including its preparation and release
+    uint32_t runOnce(const Operation& operation, const uint32_t n)
+    {
+        if (nullptr != operation.prepare)
+        {
+            operation.prepare(n);
+        }
+        const uint32_t checksum = operation.run(n);
+        if (nullptr != operation.release)
+        {
+            operation.release();
+        }
+        return checksum;
+    }
+
+    const Operation* findStdOperation(const char* name)
+    {
+        for (size_t idx = 0; idx < g_nofStdOperations; ++idx)
+        {
+            if (0 == std::strcmp(name, g_stdOperations[idx].name))
+            {
+                return &g_stdOperations[idx];
+            }
+        }
+        return nullptr;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const bool strict = argc > 1 && 0 == std::strcmp(argv[1], "--strict");
+
+    uint32_t nofMismatches = 0;
+    uint32_t nofFlagged = 0;
+
+    std::printf("%-28s %10s %10s %10s %10s  %s\n", "operation", "lib [us]", "std [us]", "lib/std", "growth", "");
+    for (size_t idx = 0; idx < g_nofLibraryOperations; ++idx)
+    {
+        const Operation& library = g_libraryOperations[idx];
+        const Operation* const reference = findStdOperation(library.name);
+        if (nullptr == reference)
+        {
+            std::printf("%-28s no std:: counterpart\n", library.name);
+            ++nofMismatches;
+            continue;
+        }
+
+        // Differential test
+        bool equal = true;
+        for (const uint32_t n : s_testSizes)
+        {
+            if (runOnce(library, n) != runOnce(*reference, n))
+            {
+                std::printf("%-28s MISMATCH for n = %u\n", library.name, static_cast<unsigned>(n));
+                equal = false;
+            }
+        }
+        if (!equal)
+        {
+            ++nofMismatches;
+            continue;
+        }
+
+        // Run time and growth exponents
+        const double librarySmall = measure(library, s_smallSize);
+        const double libraryLarge = measure(library, s_largeSize);
+        const double referenceSmall = measure(*reference, s_smallSize);
+        const double referenceLarge = measure(*reference, s_largeSize);
+        const double sizeRatio = std::log(static_cast<double>(s_largeSize) / s_smallSize);
+        const double libraryExponent = std::log(libraryLarge / librarySmall) / sizeRatio;
+        const double referenceExponent = std::log(referenceLarge / referenceSmall) / sizeRatio;
+        const bool flagged = libraryExponent > referenceExponent + s_exponentTolerance;
+        nofFlagged += flagged;
+
+        char growth[24];
+        std::snprintf(growth, sizeof(growth), "%.1f/%.1f", libraryExponent, referenceExponent);
+        std::printf("%-28s %10.1f %10.1f %10.2f %10s  %s\n",
+        library.name,
+        libraryLarge * 1e6,
+        referenceLarge * 1e6,
+        libraryLarge / referenceLarge,
+        growth,
+        flagged ? "ASYMPTOTICALLY WORSE" : "");
+
+        // Show progress when the output is piped
+        std::fflush(stdout);
+    }
+
+    std::printf("\nn = %u, growth = run time exponent of library/std between n = %u and n = %u\n",
+    static_cast<unsigned>(s_largeSize), static_cast<unsigned>(s_smallSize), static_cast<unsigned>(s_largeSize));
+    std::printf("%u mismatches, %u operations flagged\n", static_cast<unsigned>(nofMismatches), static_cast<unsigned>(nofFlagged));
+
+    return (nofMismatches > 0 || (strict && nofFlagged > 0)) ? 1 : 0;
+}
@@ -0,0 +1,21 @@
+#!/bin/sh
+# Build and run the host benchmark comparing library containers to libstdc++.
+# Usage: run.sh [--strict]
+# The compiler and the build directory can be changed via the environment variables CXX and BUILD_DIR.
+set -e
+
+dir=$(cd "$(dirname "$0")" && pwd)
+include="$dir/../../../include"
+build=${BUILD_DIR:-"${TMPDIR:-/tmp}/avr_common_host_benchmark"}
+cxx=${CXX:-g++}
+flags="-std=gnu++20 -O2 -funsigned-char"
+
+mkdir -p "$build"
+
+# The library headers shadow parts of the standard library, so only library_ops.cpp sees the library include paths
+$cxx $flags -I"$dir/../include" -I"$include" -c "$dir/library_ops.cpp" -o "$build/library_ops.o"
+$cxx $flags -c "$dir/std_ops.cpp" -o "$build/std_ops.o"
+$cxx $flags -c "$dir/main.cpp" -o "$build/main.o"
+$cxx "$build/library_ops.o" "$build/std_ops.o" "$build/main.o" -o "$build/benchmark"
+
+"$build/benchmark" "$@"
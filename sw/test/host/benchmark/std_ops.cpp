@@ -0,0 +1,311 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// Operation sequences on std:: containers. Must mirror library_ops.cpp operation by operation.
+
+#include <vector>
+#include <deque>
+#include <list>
+#include <forward_list>
+#include <queue>
+#include <variant>
+#include <string>
+#include <functional>
+
+#include "benchmark.h"
+
+namespace
+{
+    struct VisitValue
+    {
+        template <typename T>
+        constexpr uint32_t operator()(const T& value) const
+        {
+            return value;
+        }
+    };
+
+    uint32_t vectorPushBack(const uint32_t n)
+    {
+        uint32_t state = 1;
+        uint32_t checksum = s_checksumSeed;
+        std::vector<uint32_t> x;
+        for (uint32_t idx = 0; idx < n; ++idx)
+        {
+            x.push_back(nextRandom(state));
+        }
+        for (uint32_t idx = 0; idx < n; ++idx)
+        {
+            mix(checksum, x[idx]);
+        }
+        while (!x.empty())
+        {
+            mix(checksum, x.back());
+            x.pop_back();
+        }
+        return checksum;
+    }
+
+    uint32_t dequeFifo(const uint32_t n)
+    {
+        uint32_t state = 1;
+        uint32_t checksum = s_checksumSeed;
+        std::deque<uint32_t> x;
+        for (uint32_t idx = 0; idx < n; ++idx)
+        {
+            x.push_back(nextRandom(state));
+            if (0 == idx % 3)
+            {
+                mix(checksum, x.front());
+                x.pop_front();
+            }
+        }
+        while (!x.empty())
+        {
+            mix(checksum, x.front());
+            x.pop_front();
+        }
+        return checksum;
+    }
+
+    uint32_t dequePushFront(const uint32_t n)
+    {
+        uint32_t state = 1;
+        uint32_t checksum = s_checksumSeed;
+        std::deque<uint32_t> x;
+        for (uint32_t idx = 0; idx < n; ++idx)
+        {
+            x.push_front(nextRandom(state));
+        }
+        for (uint32_t idx = 0; idx < n; ++idx)
+        {
+            mix(checksum, x[idx]);
+        }
+        return checksum;
+    }
+
+    uint32_t listFifo(const uint32_t n)
+    {
+        uint32_t state = 1;
+        uint32_t checksum = s_checksumSeed;
+        std::list<uint32_t> x;
+        for (uint32_t idx = 0; idx < n; ++idx)
+        {
+            x.push_back(nextRandom(state));
+            if (0 == idx % 3)
+            {
+                mix(checksum, x.front());
+                x.pop_front();
+            }
+        }
+        while (!x.empty())
+        {
+            mix(checksum, x.front());
+            x.pop_front();
+        }
+        return checksum;
+    }
+
+    // Lists shared by the timed run and the untimed preparation or release of an operation
+    std::list<uint32_t> s_list;
+    std::forward_list<uint32_t> s_forwardList;
+
+    void clearList()
+    {
+        s_list.clear();
+    }
+
+    void clearForwardList()
+    {
+        s_forwardList.clear();
+    }
+
+    // The sorted list is destroyed by clearList(), i.e. not timed, since freeing its nodes in shuffled order is measured separately
+    uint32_t listSort(const uint32_t n)
+    {
+        uint32_t state = 1;
+        uint32_t checksum = s_checksumSeed;
+        std::list<uint32_t>& x = s_list;
+        for (uint32_t idx = 0; idx < n; ++idx)
+        {
+            x.push_back(nextRandom(state) & 0xFFFF);
+        }
+        x.sort();
+        x.reverse();
+        for (const uint32_t value : x)
+        {
+            mix(checksum, value);
+        }
+        return checksum;
+    }
+
+    // The sorted list is destroyed by clearForwardList(), i.e. not timed
+    uint32_t forwardListSort(const uint32_t n)
+    {
+        uint32_t state = 1;
+        uint32_t checksum = s_checksumSeed;
+        std::forward_list<uint32_t>& x = s_forwardList;
+        for (uint32_t idx = 0; idx < n; ++idx)
+        {
+            x.push_front(nextRandom(state) & 0xFFFF);
+        }
+        x.sort();
+        for (const uint32_t value : x)
+        {
+            mix(checksum, value);
+        }
+        return checksum;
+    }
+
+    // Sorting by value leaves the nodes in shuffled order of their addresses
+    void prepareShuffledList(const uint32_t n)
+    {
+        uint32_t state = 1;
+        for (uint32_t idx = 0; idx < n; ++idx)
+        {
+            s_list.push_back(nextRandom(state) & 0xFFFF);
+        }
+        s_list.sort();
+    }
+
+    void prepareShuffledForwardList(const uint32_t n)
+    {
+        uint32_t state = 1;
+        for (uint32_t idx = 0; idx < n; ++idx)
+        {
+            s_forwardList.push_front(nextRandom(state) & 0xFFFF);
+        }
+        s_forwardList.sort();
+    }
+
+    uint32_t listDestroyShuffled(const uint32_t)
+    {
+        uint32_t checksum = s_checksumSeed;
+        while (!s_list.empty())
+        {
+            mix(checksum, s_list.front());
+            s_list.pop_front();
+        }
+        return checksum;
+    }
+
+    uint32_t forwardListDestroyShuffled(const uint32_t)
+    {
+        uint32_t checksum = s_checksumSeed;
+        while (!s_forwardList.empty())
+        {
+            mix(checksum, s_forwardList.front());
+            s_forwardList.pop_front();
+        }
+        return checksum;
+    }
+
+    uint32_t priorityQueuePushPop(const uint32_t n)
+    {
+        uint32_t state = 1;
+        uint32_t checksum = s_checksumSeed;
+        std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> x;
+        for (uint32_t idx = 0; idx < n; ++idx)
+        {
+            x.push(nextRandom(state));
+        }
+        while (!x.empty())
+        {
+            mix(checksum, x.top());
+            x.pop();
+        }
+        return checksum;
+    }
+
+    uint32_t variantAssignVisit(const uint32_t n)
+    {
+        uint32_t state = 1;
+        uint32_t checksum = s_checksumSeed;
+        std::variant<uint8_t, uint16_t, uint32_t> x;
+        for (uint32_t idx = 0; idx < n; ++idx)
+        {
+            const uint32_t value = nextRandom(state);
+            switch (value % 3)
+            {
+                case 0:
+                x = static_cast<uint8_t>(value);
+                break;
+
+                case 1:
+                x = static_cast<uint16_t>(value);
+                break;
+
+                default:
+                x = value;
+                break;
+            }
+            mix(checksum, x.index());
+            mix(checksum, std::visit(VisitValue(), x));
+        }
+        return checksum;
+    }
+
+    uint32_t stringPushBack(const uint32_t n)
+    {
+        uint32_t state = 1;
+        uint32_t checksum = s_checksumSeed;
+        std::string x;
+        for (uint32_t idx = 0; idx < n; ++idx)
+        {
+            x.push_back(static_cast<char>('a' + nextRandom(state) % 26));
+        }
+        for (const char c : x)
+        {
+            mix(checksum, static_cast<uint8_t>(c));
+        }
+        return checksum;
+    }
+
+    uint32_t stringAppend(const uint32_t n)
+    {
+        uint32_t checksum = s_checksumSeed;
+        std::string x;
+        for (uint32_t idx = 0; idx < n; ++idx)
+        {
+            x.append("abc", 3);
+        }
+        mix(checksum, x.size());
+        for (const char c : x)
+        {
+            mix(checksum, static_cast<uint8_t>(c));
+        }
+        return checksum;
+    }
+}
+
+const Operation g_stdOperations[] =
+{
+    {"Vector pushBack/popBack", &vectorPushBack},
+    {"Deque pushBack/popFront", &dequeFifo},
+    {"Deque pushFront/operator[]", &dequePushFront},
+    {"List pushBack/popFront", &listFifo},
+    {"List sort/reverse", &listSort, nullptr, &clearList},
+    {"List destroy shuffled", &listDestroyShuffled, &prepareShuffledList},
+    {"ForwardList sort", &forwardListSort, nullptr, &clearForwardList},
+    {"ForwardList destroy shuffled", &forwardListDestroyShuffled, &prepareShuffledForwardList},
+    {"PriorityQueue push/pop", &priorityQueuePushPop},
+    {"Variant assign/visit", &variantAssignVisit},
+    {"String pushBack", &stringPushBack},
+    {"String append", &stringAppend}
+};
+
+const size_t g_nofStdOperations = sizeof(g_stdOperations) / sizeof(g_stdOperations[0]);
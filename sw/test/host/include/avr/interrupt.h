@@ -0,0 +1,100 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// Portable stand-in for avr/interrupt.h to build the headers for a host machine.
+// cli() and sei() control the emulated global interrupt flag (see avr/io.h) and an ISR is an ordinary function.
+// Interrupts are raised by HostInterruptSource, e.g. to stress test code shared between application code and ISRs.
+
+#ifndef HOST_AVR_INTERRUPT_H
+#define HOST_AVR_INTERRUPT_H
+
+#include <avr/io.h>
+#include <signal.h>
+#include <sys/time.h>
+
+#define cli() hostInterrupts::disable()
+#define sei() hostInterrupts::enable()
+
+#define ISR(vector) void vector()
+#define EMPTY_INTERRUPT(vector) void vector() {}
+
+/**
+@brief Emulated periodic interrupt
+Calls an ISR periodically from construction until destruction of the interrupt source. The ISR interrupts application code like
+a hardware interrupt, i.e. at any instruction while interrupts are enabled. Only one interrupt source can be active at a time.
+@code
+ISR(TIMER0_OVF_vect)
+{
+    ...
+}
+
+{
+    HostInterruptSource timer(&TIMER0_OVF_vect, 20);
+    ...
+}
+@endcode
+*/
+class HostInterruptSource
+{
+    public:
+
+    /**
+    @brief Start calling the ISR periodically
+    @param vector ISR to call
+    @param period Period in microseconds
+    */
+    HostInterruptSource(void (*vector)(), const uint32_t period)
+    {
+        s_vector = vector;
+
+        struct sigaction action = {};
+        action.sa_handler = &handleSignal;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        sigaction(hostInterrupts::s_signal, &action, nullptr);
+
+        const itimerval timer = {{0, static_cast<suseconds_t>(period)}, {0, static_cast<suseconds_t>(period)}};
+        setitimer(ITIMER_REAL, &timer, nullptr);
+    }
+
+    /**
+    @brief Stop calling the ISR
+    */
+    ~HostInterruptSource()
+    {
+        const itimerval timer = {};
+        setitimer(ITIMER_REAL, &timer, nullptr);
+        signal(hostInterrupts::s_signal, SIG_IGN);
+    }
+
+    HostInterruptSource(const HostInterruptSource&) = delete;
+    HostInterruptSource& operator=(const HostInterruptSource&) = delete;
+
+    private:
+
+    static void handleSignal(int)
+    {
+        // Interrupts are disabled during the execution of the ISR
+        hostInterrupts::s_disabled = true;
+        s_vector();
+        hostInterrupts::s_disabled = false;
+    }
+
+    static inline void (*s_vector)() = nullptr;
+};
+
+#endif
@@ -0,0 +1,117 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// Portable stand-in for avr/io.h to build the headers for a host machine.
+// There are no peripherals on the host. The status register emulates the global interrupt flag (see avr/interrupt.h).
+// Bit positions (ATmega328P) are provided for drivers which take their registers as template parameters, so they can be tested
+// with simulated registers, e.g. ADCModule.
+
+#ifndef HOST_AVR_IO_H
+#define HOST_AVR_IO_H
+
+#include <stdint.h>
+#include <signal.h>
+
+#define _BV(bit) (1u << (bit))
+
+// Global interrupt flag in SREG
+#define SREG_I 7
+
+// ADMUX
+#define REFS1 7
+#define REFS0 6
+#define ADLAR 5
+#define MUX3 3
+#define MUX2 2
+#define MUX1 1
+#define MUX0 0
+
+// ADCSRA
+#define ADEN 7
+#define ADSC 6
+#define ADATE 5
+#define ADIF 4
+#define ADIE 3
+#define ADPS2 2
+#define ADPS1 1
+#define ADPS0 0
+
+// ADCSRB
+#define ACME 6
+#define ADTS2 2
+#define ADTS1 1
+#define ADTS0 0
+
+/*
+Emulation of the global interrupt flag
+Emulated interrupts (see HostInterruptSource in avr/interrupt.h) are signals whose handler calls the ISR. Disabling interrupts blocks
+the signal, so an ISR can interrupt application code at any instruction except within a cli() ... sei() section or an ATOMIC_BLOCK.
+As on AVR, a pending interrupt is executed as soon as interrupts are enabled again. Unlike on AVR, interrupts are enabled at startup.
+*/
+namespace hostInterrupts
+{
+    // Signal used for emulated interrupts
+    constexpr int s_signal = SIGALRM;
+
+    // true if interrupts are disabled, e.g. during the execution of an ISR
+    inline volatile sig_atomic_t s_disabled = false;
+
+    inline void mask(const int how)
+    {
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, s_signal);
+        sigprocmask(how, &signals, nullptr);
+    }
+
+    inline void disable()
+    {
+        mask(SIG_BLOCK);
+        s_disabled = true;
+    }
+
+    inline void enable()
+    {
+        s_disabled = false;
+        mask(SIG_UNBLOCK);
+    }
+}
+
+// Status register. Only the global interrupt flag is emulated, which is needed by ATOMIC_BLOCK.
+struct SREG
+{
+    using Type = uint8_t;
+
+    static uint8_t read()
+    {
+        return hostInterrupts::s_disabled ? 0 : _BV(SREG_I);
+    }
+
+    static void write(const uint8_t value)
+    {
+        if (value & _BV(SREG_I))
+        {
+            hostInterrupts::enable();
+        }
+        else
+        {
+            hostInterrupts::disable();
+        }
+    }
+};
+
+#endif
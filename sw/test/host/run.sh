@@ -0,0 +1,26 @@
+#!/bin/sh
+# Build and run a host test, i.e. a program in a subdirectory of this directory built from main.cpp for the host machine.
+# Usage: run.sh <test> [arguments], e.g. run.sh atomic_pool_allocator
+# The benchmark has its own script, see benchmark/run.sh.
+# The compiler and the build directory can be changed via the environment variables CXX and BUILD_DIR.
+set -e
+
+dir=$(cd "$(dirname "$0")" && pwd)
+include="$dir/../../include"
+build=${BUILD_DIR:-"${TMPDIR:-/tmp}/avr_common_host_tests"}
+cxx=${CXX:-g++}
+flags="-std=gnu++20 -O2 -funsigned-char -pthread"
+
+if [ $# -lt 1 ]; then
+    echo "usage: $0 <test> [arguments]" >&2
+    exit 2
+fi
+test=$1
+shift
+
+mkdir -p "$build"
+
+# The stand-ins for the avr-libc headers in include/ take precedence over the library headers
+$cxx $flags -I"$dir/include" -I"$include" "$dir/$test/main.cpp" -o "$build/$test"
+
+"$build/$test" "$@"
@@ -0,0 +1,199 @@
+/*
+Copyright (C) 2023  Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// Host check of the band-limited wavetables of OscillatorBank.
+// - Measures the aliasing of every waveform at several frequencies: One second of output is analyzed with a DFT at the frequencies of
+//   the harmonics below the Nyquist frequency. Everything else is aliasing (plus quantization noise of the 8-bit tables) and is
+//   reported relative to the harmonics. The band-limited tables are compared with band 0 only, i.e. a single table with all harmonics.
+//   The check fails if the band-limited tables exceed s_maxAliasing.
+// - Writes a 16-bit mono WAV file with a sawtooth sweep over 8 octaves, first band-limited, then band 0 only, to listen to the difference.
+// Build and run with ../run.sh wavetable_oscillator [file.wav], default file name is wavetable_oscillator.wav
+
+#include <stdio.h>
+#include <wavetable_oscillator.h>
+
+// The math.h of libstdc++ includes <cmath>, which conflicts with the library headers (bits/c++config.h), so libm is declared directly
+extern "C"
+{
+    double sin(double);
+    double cos(double);
+    double pow(double, double);
+    double log10(double);
+}
+
+static constexpr double s_pi = 3.14159265358979323846;
+
+// Sample rate in Hz. The DFT over one second has a resolution of 1 Hz, so harmonics of integer frequencies fall on DFT bins.
+static constexpr uint32_t s_sampleRate = 32768;
+
+// Maximum aliasing of the band-limited tables relative to the harmonics in dB
+static constexpr double s_maxAliasing = -30.0;
+
+using Bank = OscillatorBank<1, uint32_t, true>;
+
+static double s_cos[s_sampleRate];
+static double s_sin[s_sampleRate];
+static int16_t s_samples[s_sampleRate];
+
+// Render one second of a single voice with the given integer frequency
+static void render(const ConstSpan<PgmArray<int8_t>> bands, const uint32_t frequency)
+{
+    Bank bank;
+    bank.setWaveform(0, bands);
+
+    // Exact increment f * 2^32 / s_sampleRate, so the second contains an integer number of periods
+    bank.setIncrement(0, frequency << 17);
+    bank.render(Span<int16_t>(s_samples, s_sampleRate));
+}
+
+// Power of aliasing and noise relative to the power of the harmonics in dB
+static double measureAliasing(const uint32_t frequency)
+{
+    double mean = 0.0;
+    for (const int16_t sample : s_samples)
+    {
+        mean += sample;
+    }
+    mean /= s_sampleRate;
+
+    double total = 0.0;
+    for (const int16_t sample : s_samples)
+    {
+        total += (sample - mean) * (sample - mean);
+    }
+
+    double harmonics = 0.0;
+    for (uint32_t bin = frequency; bin < s_sampleRate / 2; bin += frequency)
+    {
+        double re = 0.0;
+        double im = 0.0;
+        for (uint32_t idx = 0; idx < s_sampleRate; ++idx)
+        {
+            const uint32_t angle = (bin * idx) % s_sampleRate;
+            re += s_samples[idx] * s_cos[angle];
+            im -= s_samples[idx] * s_sin[angle];
+        }
+
+        // Parseval: Positive and negative frequency contribute |X|^2 / N each
+        harmonics += 2.0 * (re * re + im * im) / s_sampleRate;
+    }
+
+    const double aliasing = total > harmonics ? total - harmonics : 0.0;
+    return 10.0 * log10((aliasing + 1e-9) / harmonics);
+}
+
+template <typename Shape>
+static bool checkShape(const char* name)
+{
+    static constexpr uint32_t s_frequencies[] = {110, 440, 1760, 3520, 7040, 12000};
+
+    bool passed = true;
+    for (const uint32_t frequency : s_frequencies)
+    {
+        render(Wavetable<Shape>::getBands(), frequency);
+        const double bandLimited = measureAliasing(frequency);
+        render(Wavetable<Shape, 1>::getBands(), frequency);
+        const double band0 = measureAliasing(frequency);
+
+        const bool ok = bandLimited <= s_maxAliasing;
+        passed &= ok;
+        printf("%-10s %6lu Hz %12.1f dB %12.1f dB  %s\n", name, static_cast<unsigned long>(frequency), bandLimited, band0, ok ? "" : "FAILED");
+    }
+    return passed;
+}
+
+static void writeLE(FILE* file, const uint32_t value, const uint8_t nofBytes)
+{
+    for (uint8_t idx = 0; idx < nofBytes; ++idx)
+    {
+        fputc(static_cast<int>((value >> (8 * idx)) & 0xFF), file);
+    }
+}
+
+// Exponential sweep from 55 Hz to 14080 Hz in 4 seconds, the increment is updated every 64 samples
+static void writeSweep(FILE* file, const ConstSpan<PgmArray<int8_t>> bands)
+{
+    constexpr uint32_t nofSamples = 4 * s_sampleRate;
+    Bank bank;
+    bank.setWaveform(0, bands);
+    for (uint32_t idx = 0; idx < nofSamples; idx += 64)
+    {
+        const double frequency = 55.0 * pow(2.0, 8.0 * idx / nofSamples);
+        bank.setIncrement(0, static_cast<uint32_t>(frequency / s_sampleRate * 4294967296.0));
+
+        int16_t block[64];
+        bank.render(Span<int16_t>(block, 64));
+        for (const int16_t sample : block)
+        {
+            writeLE(file, static_cast<uint16_t>(sample * 256), 2);
+        }
+    }
+}
+
+static bool writeWav(const char* fileName)
+{
+    FILE* file = fopen(fileName, "wb");
+    if (nullptr == file)
+    {
+        return false;
+    }
+
+    constexpr uint32_t dataSize = 2 * 4 * s_sampleRate * 2;
+    fputs("RIFF", file);
+    writeLE(file, 36 + dataSize, 4);
+    fputs("WAVEfmt ", file);
+    writeLE(file, 16, 4);
+    writeLE(file, 1, 2);                // PCM
+    writeLE(file, 1, 2);                // Mono
+    writeLE(file, s_sampleRate, 4);
+    writeLE(file, 2 * s_sampleRate, 4); // Bytes per second
+    writeLE(file, 2, 2);                // Bytes per frame
+    writeLE(file, 16, 2);               // Bits per sample
+    fputs("data", file);
+    writeLE(file, dataSize, 4);
+
+    writeSweep(file, Wavetable<SawShape>::getBands());
+    writeSweep(file, Wavetable<SawShape, 1>::getBands());
+    return 0 == fclose(file);
+}
+
+int main(int argc, char** argv)
+{
+    for (uint32_t idx = 0; idx < s_sampleRate; ++idx)
+    {
+        s_cos[idx] = cos(2.0 * s_pi * idx / s_sampleRate);
+        s_sin[idx] = sin(2.0 * s_pi * idx / s_sampleRate);
+    }
+
+    printf("%-10s %9s %15s %15s\n", "waveform", "frequency", "band-limited", "band 0 only");
+    bool passed = true;
+    passed &= checkShape<SineShape>("sine");
+    passed &= checkShape<SawShape>("saw");
+    passed &= checkShape<SquareShape>("square");
+    passed &= checkShape<TriangleShape>("triangle");
+
+    const char* const fileName = argc > 1 ? argv[1] : "wavetable_oscillator.wav";
+    if (!writeWav(fileName))
+    {
+        printf("Cannot write %s\n", fileName);
+        return 1;
+    }
+    printf("Sweep written to %s\n", fileName);
+
+    printf("OVERALL: %s\n", passed ? "PASSED" : "FAILED");
+    return passed ? 0 : 1;
+}
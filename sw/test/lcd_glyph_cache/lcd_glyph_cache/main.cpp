@@ -0,0 +1,352 @@
+/*
+Copyright (C) 2023 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <lcd_glyph_cache.h>
+#include <buffered_lcd.h>
+#include <static_string.h>
+
+#include "../../common/debug_print.h"
+
+// Emulation of a 2x16 HD44780 LCD counting the transferred commands
+class MockLCD
+{
+    public:
+
+    static void init()
+    {}
+
+    static constexpr uint8_t getNofColumns()
+    {
+        return 16;
+    }
+
+    static constexpr uint8_t getNofRows()
+    {
+        return 2;
+    }
+
+    static void setCursor(const uint8_t rowIdx, const uint8_t columnIdx)
+    {
+        s_row = rowIdx;
+        s_column = columnIdx;
+        ++s_nofCommands;
+    }
+
+    static void putc(const char c)
+    {
+        s_display[s_row][s_column++] = c;
+        ++s_nofChars;
+    }
+
+    static void setCustomCharacter(const uint8_t slot, const LCDGlyph& glyph)
+    {
+        s_cgram[slot] = glyph;
+        ++s_nofUploads;
+
+        // Set CGRAM address plus one data write per pixel row
+        ++s_nofCommands;
+        s_nofChars += glyph.size();
+    }
+
+    // Check if all custom characters on the display show the expected glyph
+    template <typename Expected>
+    static bool checkDisplay(Expected expected)
+    {
+        bool passed = true;
+        for (const auto& row : s_display)
+        {
+            for (const char c : row)
+            {
+                if (static_cast<uint8_t>(c) < 8)
+                {
+                    passed &= s_cgram[static_cast<uint8_t>(c)] == expected(c);
+                }
+            }
+        }
+        return passed;
+    }
+
+    static void resetCounters()
+    {
+        s_nofUploads = 0;
+        s_nofCommands = 0;
+        s_nofChars = 0;
+    }
+
+    static LCDGlyph s_cgram[8];
+    static char s_display[2][16];
+    static uint8_t s_row;
+    static uint8_t s_column;
+    static uint16_t s_nofUploads;
+    static uint16_t s_nofCommands;
+    static uint16_t s_nofChars;
+};
+
+LCDGlyph MockLCD::s_cgram[8] = {};
+char MockLCD::s_display[2][16] = {};
+uint8_t MockLCD::s_row = 0;
+uint8_t MockLCD::s_column = 0;
+uint16_t MockLCD::s_nofUploads = 0;
+uint16_t MockLCD::s_nofCommands = 0;
+uint16_t MockLCD::s_nofChars = 0;
+
+using LCD = LCDAlphanumericBuffered<MockLCD>;
+using GlyphCache = LCD::GlyphCache;
+using BarGraph = LCD::BarGraph;
+
+bool test_assert(const char * str, const bool flag)
+{
+    cout << str;
+    if (flag)
+    {
+        cout << static_cast<const char *>("PASSED");
+    }
+    else
+    {
+        cout << static_cast<const char *>("FAILED");
+    }
+    return flag;
+}
+
+LCDGlyph makeGlyph(const uint8_t id)
+{
+    LCDGlyph glyph;
+    glyph.fill(id & 0x1F);
+    return glyph;
+}
+
+// Expected glyph of a bar graph cell on the display, identified by the first pixel row and the number of lit rows
+LCDGlyph expectedBarGlyph(const LCDGlyph& glyph)
+{
+    LCDGlyph expected;
+    if (glyph[0] == glyph[7])
+    {
+        // Horizontal bar
+        expected.fill(glyph[0]);
+    }
+    else
+    {
+        // Vertical bar
+        for (uint8_t idx = 0; idx < 8; ++idx)
+        {
+            expected[idx] = glyph[idx] != 0 ? 0x1F : 0;
+        }
+    }
+    return expected;
+}
+
+// Animated meters: Two horizontal level meters on a 2x16 LCD with a new frame for each value
+// Returns the number of glyph uploads, naiveUploads is set to the number of uploads if all partial cells were uploaded every frame
+uint16_t animateMeters(const uint16_t nofFrames, uint16_t& naiveUploads, bool& displayOK)
+{
+    MockLCD::resetCounters();
+    naiveUploads = 0;
+    displayOK = true;
+
+    uint16_t left = 0;
+    uint16_t right = 40;
+    for (uint16_t frame = 0; frame < nofFrames; ++frame)
+    {
+        // Slow ramp on the left channel, faster triangle on the right channel
+        left = (left + 1) % 81;
+        right = (right + 7) % 161;
+        const uint16_t rightLevel = right > 80 ? 160 - right : right;
+
+        LCD::clear();
+        GlyphCache::beginFrame();
+        auto& buffer = LCD::getBuffer();
+        BarGraph::putHorizontal(buffer, 16, left, 80);
+        buffer.pushBack('\n');
+        BarGraph::putHorizontal(buffer, 16, rightLevel, 80);
+        LCD::refresh();
+
+        // Each meter has at most one partially filled cell
+        naiveUploads += (0 != left % 5) + (0 != rightLevel % 5);
+        displayOK &= MockLCD::checkDisplay([](const char c) { return expectedBarGlyph(MockLCD::s_cgram[static_cast<uint8_t>(c)]); });
+    }
+    return MockLCD::s_nofUploads;
+}
+
+int main(void)
+{
+    bool allPassed = true;
+    bool testPassed = true;
+
+    {
+        testPassed = true;
+        GlyphCache::init();
+        MockLCD::resetCounters();
+
+        // Fill all slots
+        for (uint8_t id = 0; id < 8; ++id)
+        {
+            testPassed &= GlyphCache::get(id, makeGlyph(id)) == static_cast<char>(id);
+        }
+        testPassed &= MockLCD::s_nofUploads == 8;
+
+        // Resident glyphs are not uploaded again
+        for (uint8_t id = 0; id < 8; ++id)
+        {
+            testPassed &= GlyphCache::get(id, makeGlyph(id)) == static_cast<char>(id);
+        }
+        testPassed &= MockLCD::s_nofUploads == 8;
+
+        for (uint8_t slot = 0; slot < 8; ++slot)
+        {
+            testPassed &= MockLCD::s_cgram[slot] == makeGlyph(slot);
+        }
+    }
+    allPassed &= test_assert("upload on miss", testPassed);
+
+    {
+        testPassed = true;
+        GlyphCache::init();
+        MockLCD::resetCounters();
+
+        for (uint8_t id = 0; id < 8; ++id)
+        {
+            GlyphCache::get(id, makeGlyph(id));
+        }
+        GlyphCache::beginFrame();
+
+        // Touch glyphs 1..7, so glyph 0 is least recently used
+        for (uint8_t id = 1; id < 8; ++id)
+        {
+            GlyphCache::get(id, makeGlyph(id));
+        }
+        GlyphCache::beginFrame();
+        testPassed &= GlyphCache::get(20, makeGlyph(20)) == 0;
+        testPassed &= MockLCD::s_cgram[0] == makeGlyph(20);
+
+        // Glyph 1 is next
+        testPassed &= GlyphCache::get(21, makeGlyph(21)) == 1;
+        testPassed &= MockLCD::s_nofUploads == 10;
+
+        // The generator is only called on a miss
+        uint8_t nofCalls = 0;
+        auto generate = [&nofCalls](LCDGlyph& glyph) { glyph.fill(0x15); ++nofCalls; };
+        GlyphCache::get(22, generate);
+        GlyphCache::get(22, generate);
+        testPassed &= nofCalls == 1;
+        testPassed &= MockLCD::s_nofUploads == 11;
+    }
+    allPassed &= test_assert("LRU replacement", testPassed);
+
+    {
+        testPassed = true;
+        GlyphCache::init();
+        MockLCD::resetCounters();
+
+        // Glyphs used within the same frame are not replaced
+        for (uint8_t id = 0; id < 8; ++id)
+        {
+            GlyphCache::get(id, makeGlyph(id));
+        }
+        testPassed &= GlyphCache::get(8, makeGlyph(8), '#') == '#';
+        testPassed &= MockLCD::s_nofUploads == 8;
+
+        GlyphCache::beginFrame();
+        testPassed &= GlyphCache::get(8, makeGlyph(8), '#') == 0;
+        testPassed &= MockLCD::s_nofUploads == 9;
+    }
+    allPassed &= test_assert("pinning", testPassed);
+
+    {
+        testPassed = true;
+        GlyphCache::init();
+        GlyphCache::beginFrame();
+
+        // 4 cells with 20 steps: 7 steps = one full cell, one cell with 2 columns
+        StaticString<16> str;
+        BarGraph::putHorizontal(str, 4, 7, 20);
+        testPassed &= str.size() == 4;
+        testPassed &= str[0] == static_cast<char>(0xFF);
+        testPassed &= static_cast<uint8_t>(str[1]) < 8;
+        testPassed &= MockLCD::s_cgram[static_cast<uint8_t>(str[1])][3] == 0b11000;
+        testPassed &= str[2] == ' ';
+        testPassed &= str[3] == ' ';
+
+        // Clipping to the maximum value
+        str.clear();
+        BarGraph::putHorizontal(str, 3, 1000, 20);
+        for (const char c : str)
+        {
+            testPassed &= c == static_cast<char>(0xFF);
+        }
+    }
+    allPassed &= test_assert("horizontal bar", testPassed);
+
+    {
+        testPassed = true;
+        GlyphCache::init();
+        GlyphCache::beginFrame();
+
+        // Bars with a height of 2 cells, i.e. 16 steps
+        const uint8_t values[] = {0, 3, 8, 11, 16};
+        StaticString<16> top;
+        StaticString<16> bottom;
+        BarGraph::putVertical(top, 0, 2, values, values + 5, 16);
+        BarGraph::putVertical(bottom, 1, 2, values, values + 5, 16);
+
+        testPassed &= top[0] == ' ' && bottom[0] == ' ';
+        testPassed &= top[1] == ' ' && static_cast<uint8_t>(bottom[1]) < 8;
+        testPassed &= top[2] == ' ' && bottom[2] == static_cast<char>(0xFF);
+        testPassed &= static_cast<uint8_t>(top[3]) < 8 && bottom[3] == static_cast<char>(0xFF);
+        testPassed &= top[4] == static_cast<char>(0xFF) && bottom[4] == static_cast<char>(0xFF);
+
+        // 3 rows lit from the bottom
+        const LCDGlyph& glyph = MockLCD::s_cgram[static_cast<uint8_t>(top[3])];
+        testPassed &= glyph[4] == 0 && glyph[5] == 0x1F && glyph[7] == 0x1F;
+        testPassed &= bottom[1] == top[3];
+    }
+    allPassed &= test_assert("vertical bar", testPassed);
+
+    {
+        testPassed = true;
+        GlyphCache::init();
+        uint16_t naiveUploads = 0;
+        bool displayOK = true;
+        const uint16_t nofUploads = animateMeters(200, naiveUploads, displayOK);
+
+        // Only 4 different partial glyphs exist, so each is uploaded once
+        testPassed &= nofUploads == 4;
+        testPassed &= naiveUploads > 200;
+        testPassed &= displayOK;
+    }
+    allPassed &= test_assert("animated meters", testPassed);
+
+    test_assert("OVERALL:", allPassed);
+
+    while (true)
+    {
+    }
+}
+
+template <>
+struct debugPrinter<const char*>
+{
+    static void print(const char* arg)
+    {
+        // Put a tracepoint here and display {arg, s} in output window
+        (void)arg;
+    }
+};
+
+void throw_bad_alloc()
+{
+    while(true);
+}
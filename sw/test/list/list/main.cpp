@@ -16,6 +16,8 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include <list.h>
+#include <vector.h>
+#include <bits/pair.h>
 #include "../../common/debug_print.h"
 
 class Test
@@ -58,6 +60,11 @@ class Test
         return m_value == other.m_value;
     }
     
+    bool operator<(const Test& other) const
+    {
+        return m_value < other.m_value;
+    }
+    
     uint8_t getValue() const
     {
         return m_value;
@@ -128,6 +135,89 @@ bool test_assert(const char * str, const bool flag)
 }
 
 
+// Heap for up to 256 list nodes (the node size depends on the pointer size)
+using BenchmarkHeap = HeapAllocator<sizeof(void*) * 1536>;
+
+// Pseudo random values 0..63 (full period linear congruential generator modulo 256)
+uint8_t nextValue(uint8_t& state)
+{
+    state = 5 * state + 1;
+    return state & 0x3F;
+}
+
+template <typename Container>
+bool isSorted(Container& x)
+{
+    bool sorted = true;
+    auto it = x.begin();
+    if (it != x.end())
+    {
+        uint8_t prev = *it;
+        for (++it; it != x.end(); ++it)
+        {
+            sorted &= !(*it < prev);
+            prev = *it;
+        }
+    }
+    return sorted;
+}
+
+// Benchmark: Sort a list of t_size pseudo random elements in place vs. copying the elements into a vector, sorting the vector and rebuilding the list.
+// Put a breakpoint before and after each benchmark call and read the cycle counter of the simulator.
+template <uint16_t t_size>
+bool benchmarkSort()
+{
+    List<uint8_t, BenchmarkHeap> x;
+    uint8_t state = 1;
+    for (uint16_t cnt = 0; cnt < t_size; ++cnt)
+    {
+        x.pushFront(nextValue(state));
+    }
+    x.sort();
+    return isSorted(x);
+}
+
+template <uint16_t t_size>
+bool benchmarkCopySortRebuild()
+{
+    List<uint8_t, BenchmarkHeap> x;
+    uint8_t state = 1;
+    for (uint16_t cnt = 0; cnt < t_size; ++cnt)
+    {
+        x.pushFront(nextValue(state));
+    }
+
+    // Copy
+    Vector<uint8_t, BenchmarkHeap> v;
+    v.reserve(t_size);
+    for (const uint8_t elem : x)
+    {
+        v.pushBack(elem);
+    }
+
+    // Insertion sort
+    for (uint16_t idx = 1; idx < v.size(); ++idx)
+    {
+        const uint8_t value = v[idx];
+        uint16_t pos = idx;
+        while (pos > 0 && value < v[pos - 1])
+        {
+            v[pos] = v[pos - 1];
+            --pos;
+        }
+        v[pos] = value;
+    }
+
+    // Rebuild
+    x.clear();
+    for (const uint8_t elem : v)
+    {
+        x.pushBack(elem);
+    }
+
+    return isSorted(x);
+}
+
 int main(void)
 {
     bool allPassed = true;
@@ -219,6 +309,20 @@ int main(void)
         }
     }
     allPassed &= test_assert("Move constructor", testPassed && Test::check(0,0,3,0,3));
+
+    {
+        // Moving from an empty list must not link the new list to the nodes of the source
+        testPassed = true;
+        Test::resetCounter();
+        List<Test> y;
+        List<Test> x(move(y));
+        testPassed &= x.empty() && y.empty();
+        x.pushBack(testInit.begin()[0]);
+        y.pushBack(testInit.begin()[1]);
+        testPassed &= x.size() == 1 && x.front().getValue() == testInit.begin()[0].getValue();
+        testPassed &= y.size() == 1 && y.front().getValue() == testInit.begin()[1].getValue();
+    }
+    allPassed &= test_assert("Move constructor", testPassed && Test::check(0,0,2,0,2));
     
     
     {
@@ -250,6 +354,39 @@ int main(void)
         }
     }
     allPassed &= test_assert("Move assignment operator", testPassed && Test::check(0,0,3,0,3));
+
+    {
+        // The previous elements of the target are destroyed
+        testPassed = true;
+        Test::resetCounter();
+        List<Test> x(2);
+        List<Test> y(testInit);
+        x = move(y);
+        testPassed &= y.empty();
+        testPassed &= x.size() == testInit.size();
+        auto it = testInit.begin();
+        for (const Test& t : x)
+        {
+            testPassed &= t.getValue() == (*it).getValue();
+            ++it;
+        }
+    }
+    allPassed &= test_assert("Move assignment operator", testPassed && Test::check(2,0,3,0,5));
+
+    {
+        // Move assignment from an empty list
+        testPassed = true;
+        Test::resetCounter();
+        List<Test> x(2);
+        List<Test> y;
+        x = move(y);
+        testPassed &= x.empty() && y.empty();
+        x.pushBack(testInit.begin()[0]);
+        y.pushBack(testInit.begin()[1]);
+        testPassed &= x.size() == 1 && x.front().getValue() == testInit.begin()[0].getValue();
+        testPassed &= y.size() == 1 && y.front().getValue() == testInit.begin()[1].getValue();
+    }
+    allPassed &= test_assert("Move assignment operator", testPassed && Test::check(2,0,2,0,4));
     
     {
         testPassed = true;
@@ -729,6 +866,162 @@ int main(void)
     }
     allPassed &= test_assert("reverse()", testPassed);
 
+    {
+        // Reversing an empty list must leave a valid empty list
+        testPassed = true;
+        List<uint8_t> x;
+        x.reverse();
+        testPassed &= x.empty();
+        testPassed &= !(x.begin() != x.end());
+        x.pushBack(1);
+        x.pushBack(2);
+        x.reverse();
+        testPassed &= x.size() == 2;
+        testPassed &= x.front() == 2 && x.back() == 1;
+        x.popBack();
+        x.reverse();
+        testPassed &= x.size() == 1 && x.front() == 2 && x.back() == 2;
+    }
+    allPassed &= test_assert("reverse()", testPassed);
+
+    {
+        testPassed = true;
+        Test::resetCounter();
+        List<Test> x(testList);
+        x.reverse();
+        x.sort();
+        auto it = testInit.begin();
+        for (const Test& t : x)
+        {
+            testPassed &= t.getValue() == (*it).getValue();
+            ++it;
+        }
+    }
+    allPassed &= test_assert("sort()", testPassed && Test::check(0,0,3,0,3));
+
+    {
+        testPassed = true;
+        List<uint8_t, BenchmarkHeap> x;
+        testPassed &= isSorted(x);
+        x.sort();
+        testPassed &= x.empty();
+        
+        uint8_t state = 1;
+        for (uint16_t cnt = 0; cnt < 200; ++cnt)
+        {
+            x.pushBack(nextValue(state));
+        }
+        x.sort();
+        testPassed &= isSorted(x);
+        testPassed &= x.size() == 200;
+        
+        // Check backward links
+        uint8_t prev = 0xFF;
+        for (auto it = x.rbegin(); it != x.rend(); ++it)
+        {
+            testPassed &= *it <= prev;
+            prev = *it;
+        }
+        
+        // Sort descending
+        x.sort([](const uint8_t lhs, const uint8_t rhs) { return lhs > rhs; });
+        testPassed &= x.front() == 63 && x.back() == 0;
+    }
+    allPassed &= test_assert("sort()", testPassed);
+    
+    {
+        testPassed = true;
+        // Sort is stable: sort by first, second is the original position
+        List<Pair<uint8_t, uint8_t>, BenchmarkHeap> x;
+        uint8_t state = 1;
+        for (uint8_t cnt = 0; cnt < 100; ++cnt)
+        {
+            x.pushBack(Pair<uint8_t, uint8_t>(nextValue(state) & 0x7, cnt));
+        }
+        x.sort([](const Pair<uint8_t, uint8_t>& lhs, const Pair<uint8_t, uint8_t>& rhs) { return lhs.first < rhs.first; });
+        Pair<uint8_t, uint8_t> prev(0, 0);
+        for (const auto& elem : x)
+        {
+            testPassed &= prev.first < elem.first || (prev.first == elem.first && prev.second <= elem.second);
+            prev = elem;
+        }
+    }
+    allPassed &= test_assert("sort() stable", testPassed);
+    
+    {
+        testPassed = true;
+        List<uint8_t> x({1, 3, 5, 7});
+        List<uint8_t> y({0, 3, 4, 8, 9});
+        x.merge(y);
+        testPassed &= y.empty();
+        testPassed &= x.size() == 9;
+        testPassed &= isSorted(x);
+        testPassed &= x.front() == 0 && x.back() == 9;
+        
+        List<uint8_t> z;
+        z.merge(x);
+        testPassed &= x.empty() && z.size() == 9;
+        z.merge(z);
+        testPassed &= z.size() == 9;
+    }
+    allPassed &= test_assert("merge()", testPassed);
+    
+    {
+        testPassed = true;
+        List<uint8_t> x({1, 1, 2, 3, 3, 3, 1});
+        testPassed &= x.unique() == 3;
+        const uint8_t expected[] = {1, 2, 3, 1};
+        const uint8_t* it = expected;
+        for (const uint8_t elem : x)
+        {
+            testPassed &= elem == *it++;
+        }
+        testPassed &= x.size() == 4;
+        testPassed &= x.back() == 1;
+    }
+    allPassed &= test_assert("unique()", testPassed);
+    
+    {
+        testPassed = true;
+        Test::resetCounter();
+        List<Test> x(testList);
+        List<Test> y(testList);
+        auto pos = x.begin();
+        ++pos;
+        x.splice(pos, y);
+        testPassed &= y.empty();
+        const uint8_t expected[] = {42, 42, 43, 44, 43, 44};
+        const uint8_t* it = expected;
+        for (const Test& t : x)
+        {
+            testPassed &= t.getValue() == *it++;
+        }
+        testPassed &= x.size() == 6;
+        testPassed &= x.back().getValue() == 44;
+        
+        // Move single element and range within the same list
+        auto last = x.begin();
+        ++(++(++last));
+        x.splice(x.begin(), x, last);
+        testPassed &= x.front().getValue() == 44;
+        testPassed &= x.back().getValue() == 44;
+        auto first = x.begin();
+        ++first;
+        y.splice(y.end(), x, first, x.end());
+        testPassed &= x.size() == 1 && y.size() == 5;
+        testPassed &= y.front().getValue() == 42 && y.back().getValue() == 44;
+    }
+    allPassed &= test_assert("splice()", testPassed && Test::check(0,0,6,0,6));
+    
+    {
+        testPassed = true;
+        testPassed &= benchmarkSort<64>();
+        testPassed &= benchmarkCopySortRebuild<64>();
+        testPassed &= benchmarkSort<256>();
+        testPassed &= benchmarkCopySortRebuild<256>();
+    }
+    allPassed &= test_assert("benchmark", testPassed);
+
     allPassed &= test_assert("OVERALL:", allPassed);
 
     while (true)
@@ -753,3 +1046,9 @@ void throw_nullptr_error()
     while(true);
 }
 
+
+void throw_bad_alloc()
+{
+    cout << (const char*)"BAD ALLOC !!!";
+    while(true);
+}
@@ -0,0 +1,474 @@
+/*
+Copyright (C) 2023 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <midi.h>
+#include <ring_buffer.h>
+#include <buffered_usart.h>
+
+#include "../../common/debug_print.h"
+
+// Log of parsed events
+struct Event
+{
+    char type;
+    uint8_t channel;
+    uint8_t data1;
+    int16_t data2;
+
+    bool operator==(const Event& other) const
+    {
+        return type == other.type && channel == other.channel && data1 == other.data1 && data2 == other.data2;
+    }
+};
+
+static Event s_events[64];
+static uint8_t s_nofEvents = 0;
+static uint8_t s_sysExData[32];
+static uint8_t s_sysExSize = 0;
+static uint8_t s_nofSysExChunks = 0;
+static bool s_sysExComplete = false;
+
+void log(const char type, const uint8_t channel, const uint8_t data1, const int16_t data2)
+{
+    if (s_nofEvents < 64)
+    {
+        s_events[s_nofEvents++] = {type, channel, data1, data2};
+    }
+}
+
+void clearLog()
+{
+    s_nofEvents = 0;
+    s_sysExSize = 0;
+    s_nofSysExChunks = 0;
+    s_sysExComplete = false;
+}
+
+template <size_t t_size>
+bool checkLog(const Event (&expected)[t_size])
+{
+    bool passed = s_nofEvents == t_size;
+    for (uint8_t idx = 0; idx < t_size && idx < s_nofEvents; ++idx)
+    {
+        passed &= s_events[idx] == expected[idx];
+    }
+    return passed;
+}
+
+// Handlers logging all messages
+struct Handlers : MidiHandlers
+{
+    static void noteOn(const uint8_t channel, const uint8_t note, const uint8_t velocity)
+    {
+        log('N', channel, note, velocity);
+    }
+
+    static void noteOff(const uint8_t channel, const uint8_t note, const uint8_t velocity)
+    {
+        log('F', channel, note, velocity);
+    }
+
+    static void controlChange(const uint8_t channel, const uint8_t controller, const uint8_t value)
+    {
+        log('C', channel, controller, value);
+    }
+
+    static void programChange(const uint8_t channel, const uint8_t program)
+    {
+        log('P', channel, program, 0);
+    }
+
+    static void pitchBend(const uint8_t channel, const int16_t value)
+    {
+        log('B', channel, 0, value);
+    }
+
+    static void systemCommon(const MidiMessage& message)
+    {
+        log('S', 0, message.status, message.data1);
+    }
+
+    static void realtime(const MidiStatus status)
+    {
+        log('R', 0, static_cast<uint8_t>(status), 0);
+    }
+
+    static void sysEx(const ConstSpan<uint8_t> data, const bool complete)
+    {
+        for (const uint8_t byte : data)
+        {
+            if (s_sysExSize < sizeof(s_sysExData))
+            {
+                s_sysExData[s_sysExSize++] = byte;
+            }
+        }
+        ++s_nofSysExChunks;
+        s_sysExComplete = complete;
+    }
+};
+
+// Handlers counting note on messages only, i.e. all other handlers are compiled away
+static uint16_t s_nofNotes = 0;
+
+struct CountingHandlers : MidiHandlers
+{
+    static void noteOn(const uint8_t, const uint8_t, const uint8_t)
+    {
+        ++s_nofNotes;
+    }
+};
+
+// Transmitter capturing the encoded bytes
+class MockTX
+{
+    public:
+
+    static bool put(const uint8_t data)
+    {
+        if (s_size >= sizeof(s_data))
+        {
+            return false;
+        }
+        s_data[s_size++] = data;
+        return true;
+    }
+
+    static size_t put(const ConstSpan<uint8_t> data)
+    {
+        size_t nofBytes = 0;
+        for (const uint8_t byte : data)
+        {
+            nofBytes += put(byte);
+        }
+        return nofBytes;
+    }
+
+    static size_t getNofFreeBytes()
+    {
+        return sizeof(s_data) - s_size;
+    }
+
+    static uint8_t s_data[255];
+    static uint8_t s_size;
+};
+
+uint8_t MockTX::s_data[255] = {};
+uint8_t MockTX::s_size = 0;
+
+// USART without transmission, i.e. the Tx buffer of BufferedUSART fills up
+class DummyUSART
+{
+    protected:
+
+    static void put(const uint8_t)
+    {}
+
+    static uint8_t get()
+    {
+        return 0;
+    }
+
+    static void startTransmission()
+    {}
+
+    static void stopTransmission()
+    {}
+};
+
+bool test_assert(const char * str, const bool flag)
+{
+    cout << str;
+    if (flag)
+    {
+        cout << static_cast<const char *>("PASSED");
+    }
+    else
+    {
+        cout << static_cast<const char *>("FAILED");
+    }
+    return flag;
+}
+
+// Pseudo random numbers 0..127 (full period linear congruential generator)
+uint8_t nextValue(uint8_t& state)
+{
+    state = (5 * state + 1) & 0x7F;
+    return state;
+}
+
+// Recorded stream: Notes with running status, controllers and clock
+const uint8_t recording[] = {
+    0xF8, 0x90, 0x3C, 0x64, 0x40, 0x64, 0x43, 0x64, 0xF8, 0x3C, 0x00, 0x40, 0x00, 0x43, 0x00,
+    0xB0, 0x07, 0x64, 0x0A, 0x40, 0xF8, 0x90, 0x3E, 0x50, 0xF8, 0x3E, 0x00, 0xE0, 0x00, 0x40};
+
+// Benchmark: Parse the recorded stream t_nofRepetitions times.
+// Put a breakpoint before and after each benchmark call and read the cycle counter of the simulator.
+template <uint8_t t_nofRepetitions>
+uint16_t benchmarkParse()
+{
+    MidiParser<CountingHandlers> parser;
+    s_nofNotes = 0;
+    for (uint8_t cnt = 0; cnt < t_nofRepetitions; ++cnt)
+    {
+        parser.parse(ConstSpan<uint8_t>(recording));
+    }
+    return s_nofNotes;
+}
+
+int main(void)
+{
+    bool allPassed = true;
+    bool testPassed = true;
+
+    uint8_t sysExBuffer[4];
+    MidiParser<Handlers> parser(sysExBuffer);
+
+    {
+        testPassed = true;
+        clearLog();
+        const uint8_t stream[] = {0x90, 0x3C, 0x64, 0x3E, 0x64, 0x40, 0x00, 0x91, 0x3C, 0x64, 0x80, 0x3C, 0x40};
+        parser.parse(ConstSpan<uint8_t>(stream));
+        const Event expected[] = {{'N', 0, 0x3C, 0x64}, {'N', 0, 0x3E, 0x64}, {'F', 0, 0x40, 0}, {'N', 1, 0x3C, 0x64}, {'F', 0, 0x3C, 0x40}};
+        testPassed &= checkLog(expected);
+    }
+    allPassed &= test_assert("running status", testPassed);
+
+    {
+        testPassed = true;
+        clearLog();
+        const uint8_t stream[] = {0x90, 0xF8, 0x3C, 0xF8, 0x64, 0xFA, 0xC2, 0x05, 0xFC, 0x06};
+        parser.parse(ConstSpan<uint8_t>(stream));
+        const Event expected[] = {{'R', 0, 0xF8, 0}, {'R', 0, 0xF8, 0}, {'N', 0, 0x3C, 0x64}, {'R', 0, 0xFA, 0}, {'P', 2, 5, 0}, {'R', 0, 0xFC, 0}, {'P', 2, 6, 0}};
+        testPassed &= checkLog(expected);
+    }
+    allPassed &= test_assert("realtime", testPassed);
+
+    {
+        testPassed = true;
+        clearLog();
+
+        // SysEx with 7 data bytes and a clock inside, streamed through a buffer of 4 bytes
+        const uint8_t stream[] = {0xF0, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0xF8, 0x07, 0xF7};
+        parser.parse(ConstSpan<uint8_t>(stream));
+        testPassed &= s_sysExSize == 7;
+        testPassed &= s_nofSysExChunks == 2;
+        testPassed &= s_sysExComplete;
+        for (uint8_t idx = 0; idx < 7; ++idx)
+        {
+            testPassed &= s_sysExData[idx] == idx + 1;
+        }
+        const Event expected[] = {{'R', 0, 0xF8, 0}};
+        testPassed &= checkLog(expected);
+
+        // SysEx terminated by another status byte
+        clearLog();
+        const uint8_t stream2[] = {0xF0, 0x7D, 0x01, 0x90, 0x3C, 0x64};
+        parser.parse(ConstSpan<uint8_t>(stream2));
+        testPassed &= s_sysExSize == 2;
+        testPassed &= s_sysExComplete;
+        const Event expected2[] = {{'N', 0, 0x3C, 0x64}};
+        testPassed &= checkLog(expected2);
+    }
+    allPassed &= test_assert("SysEx", testPassed);
+
+    {
+        testPassed = true;
+        clearLog();
+
+        // System common messages cancel running status, data bytes without status are ignored
+        const uint8_t stream[] = {0x90, 0x3C, 0x64, 0xF3, 0x05, 0x3E, 0x64, 0xF6, 0xB0, 0x07, 0x7F, 0x0A, 0x40, 0xF4, 0x01};
+        parser.parse(ConstSpan<uint8_t>(stream));
+        const Event expected[] = {{'N', 0, 0x3C, 0x64}, {'S', 0, 0xF3, 5}, {'S', 0, 0xF6, 0}, {'C', 0, 7, 0x7F}, {'C', 0, 10, 0x40}};
+        testPassed &= checkLog(expected);
+    }
+    allPassed &= test_assert("system common", testPassed);
+
+    {
+        testPassed = true;
+        clearLog();
+        const uint8_t stream[] = {0xE1, 0x00, 0x40, 0x7F, 0x7F, 0x00, 0x00};
+        parser.parse(ConstSpan<uint8_t>(stream));
+        const Event expected[] = {{'B', 1, 0, 0}, {'B', 1, 0, 8191}, {'B', 1, 0, -8192}};
+        testPassed &= checkLog(expected);
+    }
+    allPassed &= test_assert("pitch bend", testPassed);
+
+    {
+        testPassed = true;
+        clearLog();
+        parser.reset();
+
+        // Receive interrupt writes to the ring buffer, main loop parses in batches
+        RingBuffer<uint8_t, 5, true> rx;
+        for (const uint8_t data : recording)
+        {
+            rx.write(data);
+        }
+        testPassed &= parser.parseFrom(rx, 16) == 16;
+        testPassed &= parser.parseFrom(rx) == sizeof(recording) - 16;
+        testPassed &= parser.parseFrom(rx) == 0;
+        testPassed &= s_nofEvents == 15;
+        testPassed &= s_events[14] == Event{'B', 0, 0, 0};
+    }
+    allPassed &= test_assert("ring buffer", testPassed);
+
+    {
+        testPassed = true;
+        using Encoder = MidiEncoder<MockTX, true>;
+        MockTX::s_size = 0;
+        Encoder::noteOn(0, 0x3C, 0x64);
+        Encoder::noteOn(0, 0x3E, 0x64);
+        Encoder::realtime(MidiStatus::clock);
+        Encoder::noteOff(0, 0x3C);
+        Encoder::controlChange(0, 7, 0x64);
+        Encoder::controlChange(0, 10, 0xC0);
+        const uint8_t sysEx[] = {0x7D, 0x01};
+        testPassed &= Encoder::sysEx(ConstSpan<uint8_t>(sysEx));
+
+        // SysEx data with bit 7 set is rejected without sending anything
+        const uint8_t invalidSysEx[] = {0x7D, 0x90, 0x01};
+        testPassed &= !Encoder::sysEx(ConstSpan<uint8_t>(invalidSysEx));
+        Encoder::controlChange(0, 10, 0x40);
+        Encoder::pitchBend(1, -8192);
+        const uint8_t expected[] = {0x90, 0x3C, 0x64, 0x3E, 0x64, 0xF8, 0x3C, 0x00, 0xB0, 0x07, 0x64, 0x0A, 0x40, 0xF0, 0x7D, 0x01, 0xF7, 0xB0, 0x0A, 0x40, 0xE1, 0x00, 0x00};
+        testPassed &= MockTX::s_size == sizeof(expected);
+        for (uint8_t idx = 0; idx < sizeof(expected) && idx < MockTX::s_size; ++idx)
+        {
+            testPassed &= MockTX::s_data[idx] == expected[idx];
+        }
+    }
+    allPassed &= test_assert("encoder", testPassed);
+
+    {
+        testPassed = true;
+
+        // Messages are enqueued as a whole or not at all
+        using TX = BufferedUSART<DummyUSART, 8>;
+        using Encoder = MidiEncoder<TX>;
+        testPassed &= Encoder::noteOn(0, 0x3C, 0x64);
+        testPassed &= Encoder::noteOn(0, 0x3E, 0x64);
+        testPassed &= Encoder::noteOn(0, 0x40, 0x64);
+        testPassed &= TX::getNofFreeBytes() == 1;
+        testPassed &= !Encoder::noteOn(0, 0x43, 0x64);
+        testPassed &= !Encoder::controlChange(1, 0x07, 0x64);
+        testPassed &= Encoder::realtime(MidiStatus::clock);
+        testPassed &= TX::getNofFreeBytes() == 0;
+    }
+    allPassed &= test_assert("encoder Tx buffer full", testPassed);
+
+    {
+        testPassed = true;
+
+        // Loopback of pseudo random channel messages
+        using Encoder = MidiEncoder<MockTX>;
+        Encoder::resetRunningStatus();
+        uint8_t state = 1;
+        uint8_t nofMessages = 0;
+        uint16_t nofBytesEncoded = 0;
+        clearLog();
+        for (uint8_t block = 0; block < 8; ++block)
+        {
+            MockTX::s_size = 0;
+            for (uint8_t cnt = 0; cnt < 8; ++cnt)
+            {
+                const uint8_t value = nextValue(state);
+                switch (value >> 5)
+                {
+                    case 0:
+                    Encoder::noteOn(0, value, 0x40);
+                    break;
+
+                    case 1:
+                    Encoder::noteOff(0, value, 0x40);
+                    break;
+
+                    case 2:
+                    Encoder::controlChange(0, 1, value);
+                    break;
+
+                    default:
+                    Encoder::pitchBend(0, static_cast<int16_t>(value) * 64 - 4096);
+                    break;
+                }
+                ++nofMessages;
+            }
+            nofBytesEncoded += MockTX::s_size;
+            parser.parse(ConstSpan<uint8_t>(MockTX::s_data, MockTX::s_size));
+        }
+        testPassed &= s_nofEvents == nofMessages;
+
+        // Replay and compare
+        state = 1;
+        for (uint8_t idx = 0; idx < nofMessages; ++idx)
+        {
+            const uint8_t value = nextValue(state);
+            Event expected;
+            switch (value >> 5)
+            {
+                case 0:
+                expected = {'N', 0, value, 0x40};
+                break;
+
+                case 1:
+                expected = {'F', 0, value, 0x40};
+                break;
+
+                case 2:
+                expected = {'C', 0, 1, value};
+                break;
+
+                default:
+                expected = {'B', 0, 0, static_cast<int16_t>(static_cast<int16_t>(value) * 64 - 4096)};
+                break;
+            }
+            testPassed &= s_events[idx] == expected;
+        }
+
+        // Running status saves bytes
+        testPassed &= nofBytesEncoded < 3 * nofMessages;
+    }
+    allPassed &= test_assert("loopback", testPassed);
+
+    {
+        testPassed = true;
+        testPassed &= benchmarkParse<1>() == 4;
+        testPassed &= benchmarkParse<10>() == 40;
+        testPassed &= benchmarkParse<100>() == 400;
+    }
+    allPassed &= test_assert("benchmark", testPassed);
+
+    test_assert("OVERALL:", allPassed);
+
+    while (true)
+    {
+    }
+}
+
+template <>
+struct debugPrinter<const char*>
+{
+    static void print(const char* arg)
+    {
+        // Put a tracepoint here and display {arg, s} in output window
+        (void)arg;
+    }
+};
+
+void throw_bad_alloc()
+{
+    while(true);
+}
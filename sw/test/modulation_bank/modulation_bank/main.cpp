@@ -0,0 +1,329 @@
+/*
+Copyright (C) 2023 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <modulation_bank.h>
+#include <functional.h>
+
+#include "../../common/debug_print.h"
+
+bool test_assert(const char * str, const bool flag)
+{
+    cout << str;
+    if (flag)
+    {
+        cout << static_cast<const char *>("PASSED");
+    }
+    else
+    {
+        cout << static_cast<const char *>("FAILED");
+    }
+    return flag;
+}
+
+// Reference: Triangle LFO as an object, publishing through a callback on every change
+class TriangleLFO
+{
+    public:
+
+    void init(const uint16_t rate, const function<void(uint16_t)>& callback)
+    {
+        m_level = 0;
+        m_rate = rate;
+        m_rising = true;
+        m_callback = callback;
+    }
+
+    uint16_t getLevel() const
+    {
+        return m_level;
+    }
+
+    void tick()
+    {
+        if (m_rising)
+        {
+            if (0xFFFF - m_level > m_rate)
+            {
+                m_level += m_rate;
+            }
+            else
+            {
+                m_level = 0xFFFF;
+                m_rising = false;
+            }
+        }
+        else
+        {
+            if (m_level > m_rate)
+            {
+                m_level -= m_rate;
+            }
+            else
+            {
+                m_level = 0;
+                m_rising = true;
+            }
+        }
+        m_callback(m_level);
+    }
+
+    private:
+
+    uint16_t m_level = 0;
+    uint16_t m_rate = 0;
+    bool m_rising = true;
+    function<void(uint16_t)> m_callback;
+};
+
+static Param<uint8_t> s_params[16];
+
+template <uint8_t t_idx>
+void publishParam(const uint16_t level)
+{
+    s_params[t_idx] = level >> 8;
+}
+
+template <size_t ... t_idx>
+void initLFOs(TriangleLFO (&lfos)[16], index_sequence<t_idx...>)
+{
+    (lfos[t_idx].init(0x0123 * (t_idx + 1), function<void(uint16_t)>(&publishParam<t_idx>)), ...);
+}
+
+// Benchmark: 256 control ticks of 16 triangle LFOs, stored as array of objects or as structure of arrays.
+// Put a breakpoint before and after each benchmark call and read the cycle counter of the simulator.
+// The cycle count divided by 256 * 16 is the cost per modulator and tick.
+uint8_t benchmarkArrayOfObjects()
+{
+    static TriangleLFO lfos[16];
+    initLFOs(lfos, make_index_sequence<16>());
+    for (uint16_t cnt = 0; cnt < 256; ++cnt)
+    {
+        for (TriangleLFO& lfo : lfos)
+        {
+            lfo.tick();
+        }
+    }
+    return s_params[15];
+}
+
+uint8_t benchmarkStructureOfArrays()
+{
+    static ModulationBank<16> bank;
+    for (uint8_t idx = 0; idx < 16; ++idx)
+    {
+        bank.setLFO(idx, ModulatorMode::triangle, 0x0123 * (idx + 1));
+        bank.setTarget(idx, &s_params[idx]);
+    }
+    for (uint16_t cnt = 0; cnt < 256; ++cnt)
+    {
+        bank.tick();
+        bank.publish();
+    }
+    return s_params[15];
+}
+
+int main(void)
+{
+    bool allPassed = true;
+    bool testPassed = true;
+
+    {
+        testPassed = true;
+        ModulationBank<2> bank;
+        bank.setEnvelope(1, 0x1000, 0x0800, 0x8000, 0x2000);
+        bank.publish();
+        bank.tick();
+        testPassed &= bank.getLevel(1) == 0;
+        testPassed &= !bank.isDirty(1);
+
+        // Attack
+        bank.gate(1, true);
+        for (uint8_t cnt = 0; cnt < 15; ++cnt)
+        {
+            bank.tick();
+        }
+        testPassed &= bank.getLevel(1) == 0xF000;
+        bank.tick();
+        testPassed &= bank.getLevel(1) == 0xFFFF;
+
+        // Decay
+        bank.tick();
+        testPassed &= bank.getLevel(1) == 0xF7FF;
+        for (uint8_t cnt = 0; cnt < 15; ++cnt)
+        {
+            bank.tick();
+        }
+        testPassed &= bank.getLevel(1) == 0x8000;
+
+        // Sustain
+        bank.publish();
+        for (uint8_t cnt = 0; cnt < 100; ++cnt)
+        {
+            bank.tick();
+        }
+        testPassed &= bank.getLevel(1) == 0x8000;
+        testPassed &= !bank.isDirty(1);
+
+        // Release
+        bank.gate(1, false);
+        for (uint8_t cnt = 0; cnt < 3; ++cnt)
+        {
+            bank.tick();
+        }
+        testPassed &= bank.getLevel(1) == 0x2000;
+        bank.tick();
+        testPassed &= bank.getLevel(1) == 0;
+        bank.tick();
+        testPassed &= bank.getLevel(1) == 0;
+
+        // Note off during attack releases from the current level
+        bank.gate(1, true);
+        bank.tick();
+        bank.tick();
+        bank.gate(1, false);
+        bank.tick();
+        testPassed &= bank.getLevel(1) == 0;
+
+        // Rate 0 jumps on the next tick
+        bank.setEnvelope(0, 0, 0, 0x4000, 0);
+        bank.gate(0, true);
+        bank.tick();
+        testPassed &= bank.getLevel(0) == 0xFFFF;
+        bank.tick();
+        testPassed &= bank.getLevel(0) == 0x4000;
+        bank.gate(0, false);
+        bank.tick();
+        testPassed &= bank.getLevel(0) == 0;
+    }
+    allPassed &= test_assert("envelope", testPassed);
+
+    {
+        testPassed = true;
+        ModulationBank<3> bank;
+        bank.setLFO(0, ModulatorMode::triangle, 0x1000);
+        bank.setLFO(1, ModulatorMode::square, 0x1000);
+        bank.setLFO(2, ModulatorMode::saw, 0x2000);
+        for (uint8_t period = 0; period < 3; ++period)
+        {
+            for (uint8_t cnt = 0; cnt < 32; ++cnt)
+            {
+                bank.tick();
+                const uint8_t phase = cnt + 1;
+                testPassed &= bank.getLevel(0) == (phase < 16 ? phase * 0x1000 : (phase == 16 ? 0xFFFF : 0xFFFF - (phase - 16) * 0x1000 + (phase == 32)));
+                testPassed &= bank.getLevel(1) == ((phase >= 16 && phase < 32) ? 0xFFFF : 0);
+                testPassed &= bank.getLevel(2) == (phase & 0x0F) * 0x1000;
+            }
+        }
+
+        // Stop and restart
+        for (uint8_t cnt = 0; cnt < 10; ++cnt)
+        {
+            bank.tick();
+        }
+        testPassed &= bank.getLevel(0) == 0xA000;
+        bank.setRate(0, 0);
+        for (uint8_t cnt = 0; cnt < 10; ++cnt)
+        {
+            bank.tick();
+        }
+        testPassed &= bank.getLevel(0) == 0xA000;
+        bank.setRate(0, 0x1000);
+        bank.tick();
+        testPassed &= bank.getLevel(0) == 0xB000;
+    }
+    allPassed &= test_assert("LFO", testPassed);
+
+    {
+        testPassed = true;
+        Param<uint8_t> cutoff(77);
+        Param<uint8_t> resonance(77);
+        ModulationBank<10> bank;
+        bank.setTarget(3, &cutoff);
+        bank.setTarget(9, &resonance);
+        bank.setEnvelope(3, 0x1000, 0x1000, 0x8000, 0x1000);
+        bank.setEnvelope(9, 0x1000, 0x1000, 0x8000, 0x1000);
+        bank.publish();
+        testPassed &= cutoff == 0 && resonance == 0;
+
+        bank.gate(3, true);
+        bank.tick();
+        testPassed &= bank.isDirty(3) && !bank.isDirty(9);
+        resonance = 77;
+        bank.publish();
+        testPassed &= cutoff == 0x10 && resonance == 77;
+        testPassed &= !bank.isDirty(3);
+
+        // Clean modulators are not published
+        cutoff = 55;
+        bank.publish();
+        testPassed &= cutoff == 55;
+
+        ModulationBank<1, uint16_t> fine;
+        Param<uint16_t> pitch;
+        fine.setTarget(0, &pitch);
+        fine.setLFO(0, ModulatorMode::triangle, 0x0123);
+        fine.tick();
+        fine.publish();
+        testPassed &= pitch == 0x0123;
+    }
+    allPassed &= test_assert("publish", testPassed);
+
+    {
+        testPassed = true;
+        TriangleLFO lfos[16];
+        initLFOs(lfos, make_index_sequence<16>());
+        ModulationBank<16> bank;
+        for (uint8_t idx = 0; idx < 16; ++idx)
+        {
+            bank.setLFO(idx, ModulatorMode::triangle, 0x0123 * (idx + 1));
+        }
+        for (uint16_t cnt = 0; cnt < 1000; ++cnt)
+        {
+            bank.tick();
+            for (uint8_t idx = 0; idx < 16; ++idx)
+            {
+                lfos[idx].tick();
+                testPassed &= bank.getLevel(idx) == lfos[idx].getLevel();
+            }
+        }
+    }
+    allPassed &= test_assert("array of objects", testPassed);
+
+    {
+        testPassed = true;
+        const uint8_t aos = benchmarkArrayOfObjects();
+        const uint8_t soa = benchmarkStructureOfArrays();
+        testPassed &= aos == soa;
+    }
+    allPassed &= test_assert("benchmark", testPassed);
+
+    test_assert("OVERALL:", allPassed);
+
+    while (true)
+    {
+    }
+}
+
+template <>
+struct debugPrinter<const char*>
+{
+    static void print(const char* arg)
+    {
+        // Put a tracepoint here and display {arg, s} in output window
+        (void)arg;
+    }
+};
@@ -0,0 +1,203 @@
+/*
+Copyright (C) 2023 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <optional.h>
+#include <variant.h>
+#include <array.h>
+
+#include "../../common/debug_print.h"
+
+enum class Note : uint8_t
+{
+    c,
+    d,
+    e,
+    none = 0xFF
+};
+
+// Opt in to niche optimization for Note
+template <>
+struct OptionalNiche<Note>
+{
+    using Type = Sentinel<Note, Note::none>;
+};
+
+// Non-trivial type counting live instances
+class Counted
+{
+    public:
+
+    Counted(const uint8_t value) : m_value(value)
+    {
+        ++s_nofInstances;
+    }
+
+    Counted(const Counted& other) : m_value(other.m_value)
+    {
+        ++s_nofInstances;
+    }
+
+    ~Counted()
+    {
+        --s_nofInstances;
+    }
+
+    bool operator==(const Counted& other) const
+    {
+        return m_value == other.m_value;
+    }
+
+    uint8_t m_value;
+    static int8_t s_nofInstances;
+};
+
+// Static initialization
+int8_t Counted::s_nofInstances = 0;
+
+bool test_assert(const char * str, const bool flag)
+{
+    cout << str;
+    if (flag)
+    {
+        cout << static_cast<const char *>("PASSED");
+    }
+    else
+    {
+        cout << static_cast<const char *>("FAILED");
+    }
+    return flag;
+}
+
+int main(void)
+{
+    bool allPassed = true;
+    bool testPassed = true;
+
+    {
+        testPassed = true;
+        using Index = Optional<uint8_t, Sentinel<uint8_t, 0xFF>>;
+        testPassed &= sizeof(Index) == 1;
+        testPassed &= sizeof(Optional<uint8_t>) == 2;
+
+        Index x;
+        testPassed &= !x;
+        testPassed &= x.valueOr(3) == 3;
+        x = 42;
+        testPassed &= x.hasValue() && *x == 42;
+        x = nullopt;
+        testPassed &= !x.hasValue();
+
+        // The sentinel value cannot be stored
+        x = 0xFF;
+        testPassed &= !x.hasValue();
+    }
+    allPassed &= test_assert("Sentinel", testPassed);
+
+    {
+        testPassed = true;
+        uint8_t value = 7;
+        testPassed &= sizeof(Optional<uint8_t*>) == sizeof(uint8_t*);
+
+        Optional<uint8_t*> x;
+        testPassed &= !x;
+        x = &value;
+        testPassed &= x && **x == 7;
+        x.reset();
+        testPassed &= !x;
+    }
+    allPassed &= test_assert("Pointer", testPassed);
+
+    {
+        testPassed = true;
+        testPassed &= sizeof(Optional<Note>) == 1;
+        Optional<Note> x;
+        testPassed &= !x;
+        x = Note::e;
+        testPassed &= x && *x == Note::e;
+        testPassed &= x == makeOptional(Note::e);
+        testPassed &= !(x == Optional<Note>());
+    }
+    allPassed &= test_assert("OptionalNiche", testPassed);
+
+    {
+        testPassed = true;
+        // Container of optionals, e.g. a step sequencer pattern: 16 bytes instead of 32
+        Array<Optional<Note>, 16> pattern;
+        testPassed &= sizeof(pattern) == 16;
+        pattern[3] = Note::d;
+        uint8_t nofNotes = 0;
+        for (const auto& step : pattern)
+        {
+            nofNotes += step.hasValue();
+        }
+        testPassed &= nofNotes == 1;
+    }
+    allPassed &= test_assert("Array of optionals", testPassed);
+
+    {
+        testPassed = true;
+        {
+            Optional<Counted> x;
+            Optional<Counted> y(Counted(5));
+            testPassed &= Counted::s_nofInstances == 1;
+
+            // Copying an empty optional must not create a value
+            Optional<Counted> z(x);
+            testPassed &= !z;
+            testPassed &= Counted::s_nofInstances == 1;
+
+            z = y;
+            testPassed &= z && z->m_value == 5;
+            testPassed &= z == y;
+            testPassed &= Counted::s_nofInstances == 2;
+
+            z = x;
+            testPassed &= !z;
+            testPassed &= Counted::s_nofInstances == 1;
+        }
+        testPassed &= Counted::s_nofInstances == 0;
+    }
+    allPassed &= test_assert("Flag", testPassed);
+
+    {
+        testPassed = true;
+        // The variant index uses a single byte with a niche for the valueless state
+        testPassed &= sizeof(Variant<uint8_t, int8_t>) == 2;
+        Variant<uint8_t, int8_t> x;
+        testPassed &= x.index() == 0;
+        x = static_cast<int8_t>(-3);
+        testPassed &= x.index() == 1;
+        testPassed &= get<int8_t>(x) == -3;
+    }
+    allPassed &= test_assert("Variant", testPassed);
+
+    test_assert("OVERALL:", allPassed);
+
+    while (true)
+    {
+    }
+}
+
+template <>
+struct debugPrinter<const char*>
+{
+    static void print(const char* arg)
+    {
+        // Put a tracepoint here and display {arg, s} in output window
+        (void)arg;
+    }
+};
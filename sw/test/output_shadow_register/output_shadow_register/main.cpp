@@ -0,0 +1,400 @@
+/*
+Copyright (C) 2023 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <output_shadow_register.h>
+#include <functional.h>
+#include <scheduler.h>
+
+#include "../../common/debug_print.h"
+
+bool test_assert(const char * str, const bool flag)
+{
+    cout << str;
+    if (flag)
+    {
+        cout << static_cast<const char *>("PASSED");
+    }
+    else
+    {
+        cout << static_cast<const char *>("FAILED");
+    }
+    return flag;
+}
+
+// Simulated chain of 4 74HC595 shift registers
+struct MockChain
+{
+    static void shift(const uint8_t data)
+    {
+        for (uint8_t idx = 3; idx > 0; --idx)
+        {
+            s_shift[idx] = s_shift[idx - 1];
+        }
+        s_shift[0] = data;
+    }
+    
+    static void high()
+    {
+        // Rising edge of RCLK
+        for (uint8_t idx = 0; idx < 4; ++idx)
+        {
+            s_outputs[idx] = s_shift[idx];
+        }
+        ++s_nofTransfers;
+    }
+    
+    static void low()
+    {}
+    
+    static uint8_t s_shift[4];
+    static uint8_t s_outputs[4];
+    static uint16_t s_nofTransfers;
+};
+
+// Static initialization
+uint8_t MockChain::s_shift[4] = {};
+uint8_t MockChain::s_outputs[4] = {};
+uint16_t MockChain::s_nofTransfers = 0;
+
+// Simulated MCP23S17 devices with hardware addresses 0 and 1
+struct MockExpanders
+{
+    static void shift(const uint8_t data)
+    {
+        if (0 == s_pos)
+        {
+            s_opcode = data;
+        }
+        else if (1 == s_pos)
+        {
+            s_register = data;
+        }
+        else
+        {
+            for (uint8_t device = 0; device < 2; ++device)
+            {
+                // Without hardware addressing, all devices respond
+                const bool haen = s_registers[device][0x0A] & 0x08;
+                if (((s_opcode >> 1) & 0x07) == device || !haen)
+                {
+                    s_registers[device][s_register] = data;
+                }
+            }
+            ++s_register;
+        }
+        ++s_pos;
+    }
+    
+    static void low()
+    {
+        s_pos = 0;
+    }
+    
+    static void high()
+    {
+        ++s_nofTransfers;
+    }
+    
+    static uint8_t s_registers[2][0x16];
+    static uint8_t s_opcode;
+    static uint8_t s_register;
+    static uint8_t s_pos;
+    static uint16_t s_nofTransfers;
+};
+
+// Static initialization
+uint8_t MockExpanders::s_registers[2][0x16] = {};
+uint8_t MockExpanders::s_opcode = 0;
+uint8_t MockExpanders::s_register = 0;
+uint8_t MockExpanders::s_pos = 0;
+uint16_t MockExpanders::s_nofTransfers = 0;
+
+// Simulated SPI master forwarding all bytes to a model and counting them
+template <typename Model>
+struct MockSPIMaster
+{
+    static void put(const uint8_t data)
+    {
+        Model::shift(data);
+        ++s_nofBytes;
+    }
+    
+    template <typename Length>
+    static void put(const uint8_t * data, Length nofBytes)
+    {
+        while (nofBytes--)
+        {
+            put(*data++);
+        }
+    }
+    
+    static uint16_t s_nofBytes;
+};
+
+// Static initialization
+template <typename Model>
+uint16_t MockSPIMaster<Model>::s_nofBytes = 0;
+
+using ChainSPI = MockSPIMaster<MockChain>;
+using ExpanderSPI = MockSPIMaster<MockExpanders>;
+using ChainOutputs = OutputShadowRegister<ShiftRegister74HC595<ChainSPI, MockChain>, 32>;
+using ExpanderOutputs = OutputShadowRegister<MCP23S17Outputs<ExpanderSPI, MockExpanders, 2>, 32>;
+
+// Check that the outputs of the simulated devices match the given image
+bool checkChain(const uint32_t image)
+{
+    bool passed = true;
+    for (uint8_t idx = 0; idx < 4; ++idx)
+    {
+        // Byte 0 is shifted out first and ends up in the last register
+        passed &= MockChain::s_outputs[3 - idx] == static_cast<uint8_t>(image >> (8 * idx));
+    }
+    return passed;
+}
+
+bool checkExpanders(const uint32_t image)
+{
+    bool passed = true;
+    for (uint8_t device = 0; device < 2; ++device)
+    {
+        passed &= MockExpanders::s_registers[device][0x14] == static_cast<uint8_t>(image >> (16 * device));
+        passed &= MockExpanders::s_registers[device][0x15] == static_cast<uint8_t>(image >> (16 * device + 8));
+    }
+    return passed;
+}
+
+// LED update patterns on 32 outputs, returning the number of pin writes.
+// Without shadow register, every pin write would be a separate bus transfer.
+
+// Running light: one LED moves along the row, flushed after each step
+template <typename Outputs>
+uint16_t patternChaser()
+{
+    uint16_t nofWrites = 0;
+    for (uint8_t step = 0; step < 32; ++step)
+    {
+        Outputs::write((step + 31) & 31, false);
+        Outputs::write(step, true);
+        nofWrites += 2;
+        Outputs::flush();
+    }
+    return nofWrites;
+}
+
+// Bar graph (VU meter) with 32 segments, rewritten completely for each of 16 levels
+template <typename Outputs>
+uint16_t patternBarGraph()
+{
+    static const uint8_t levels[] = {3, 5, 9, 14, 20, 24, 26, 25, 22, 18, 17, 19, 23, 28, 31, 30};
+    uint16_t nofWrites = 0;
+    for (const uint8_t level : levels)
+    {
+        for (uint8_t idx = 0; idx < 32; ++idx)
+        {
+            Outputs::write(idx, idx < level);
+            ++nofWrites;
+        }
+        Outputs::flush();
+    }
+    return nofWrites;
+}
+
+// Status LEDs: a single LED toggled per update
+template <typename Outputs>
+uint16_t patternBlink()
+{
+    for (uint8_t step = 0; step < 16; ++step)
+    {
+        Outputs::toggle(5);
+        Outputs::flush();
+    }
+    return 16;
+}
+
+int main(void)
+{
+    bool allPassed = true;
+    bool testPassed = true;
+    
+    {
+        testPassed = true;
+        ChainOutputs::init();
+        testPassed &= MockChain::s_nofTransfers == 1;
+        testPassed &= ChainSPI::s_nofBytes == 4;
+        testPassed &= checkChain(0);
+        testPassed &= !ChainOutputs::isDirty();
+        
+        ExpanderOutputs::init();
+        testPassed &= (MockExpanders::s_registers[0][0x0A] & 0x08) && (MockExpanders::s_registers[1][0x0A] & 0x08);
+        testPassed &= MockExpanders::s_registers[1][0x00] == 0 && MockExpanders::s_registers[1][0x01] == 0;
+        testPassed &= checkExpanders(0);
+        testPassed &= !ExpanderOutputs::isDirty();
+    }
+    allPassed &= test_assert("init", testPassed);
+    
+    {
+        testPassed = true;
+        ChainSPI::s_nofBytes = 0;
+        ChainOutputs::Pin<0>::high();
+        ChainOutputs::Pin<9>::high();
+        ChainOutputs::Pin<31>::high();
+        testPassed &= ChainOutputs::Pin<9>::read();
+        testPassed &= checkChain(0);
+        ChainOutputs::flush();
+        testPassed &= checkChain(0x80000201);
+        testPassed &= ChainSPI::s_nofBytes == 4;
+        
+        // No change, no transfer
+        ChainOutputs::Pin<9>::high();
+        ChainOutputs::flush();
+        testPassed &= ChainSPI::s_nofBytes == 4;
+        
+        ChainOutputs::Pin<0>::low();
+        ChainOutputs::writeByte(2, 0xA5);
+        ChainOutputs::flush();
+        testPassed &= checkChain(0x80A50200);
+    }
+    allPassed &= test_assert("74HC595", testPassed);
+    
+    {
+        testPassed = true;
+        ExpanderSPI::s_nofBytes = 0;
+        MockExpanders::s_nofTransfers = 0;
+        
+        // Single port changed: opcode, register and value
+        ExpanderOutputs::Pin<20>::high();
+        ExpanderOutputs::flush();
+        testPassed &= checkExpanders(0x00100000);
+        testPassed &= ExpanderSPI::s_nofBytes == 3;
+        
+        // Both ports of one device changed: sequential write
+        ExpanderOutputs::Pin<0>::high();
+        ExpanderOutputs::Pin<15>::high();
+        ExpanderOutputs::flush();
+        testPassed &= checkExpanders(0x00108001);
+        testPassed &= ExpanderSPI::s_nofBytes == 3 + 4;
+        testPassed &= MockExpanders::s_nofTransfers == 2;
+        
+        // All outputs after invalidate
+        ExpanderOutputs::invalidate();
+        ExpanderOutputs::flush();
+        testPassed &= ExpanderSPI::s_nofBytes == 3 + 4 + 8;
+        testPassed &= checkExpanders(0x00108001);
+    }
+    allPassed &= test_assert("MCP23S17", testPassed);
+    
+    {
+        testPassed = true;
+        ChainOutputs::writeByte(0, 0);
+        ChainOutputs::writeByte(1, 0);
+        ChainOutputs::writeByte(2, 0);
+        ChainOutputs::writeByte(3, 0);
+        ChainOutputs::flush();
+        ChainSPI::s_nofBytes = 0;
+        MockChain::s_nofTransfers = 0;
+        
+        Scheduler<function<void()>, uint8_t, 4> scheduler;
+        ChainOutputs::Pin<3>::high();
+        ChainOutputs::scheduleFlush(scheduler, 2);
+        ChainOutputs::Pin<4>::high();
+        ChainOutputs::scheduleFlush(scheduler, 2);
+        scheduler.clock();
+        testPassed &= !scheduler.execute();
+        scheduler.clock();
+        testPassed &= scheduler.execute();
+        testPassed &= !scheduler.execute();
+        testPassed &= MockChain::s_nofTransfers == 1;
+        testPassed &= checkChain(0x18);
+        
+        // Flush can be scheduled again
+        ChainOutputs::Pin<3>::low();
+        ChainOutputs::scheduleFlush(scheduler, 0);
+        testPassed &= scheduler.execute();
+        testPassed &= checkChain(0x10);
+    }
+    allPassed &= test_assert("scheduleFlush", testPassed);
+    
+    {
+        testPassed = true;
+        
+        // Bus bytes with shadow register vs. one transfer per pin write (4 bytes for the chain, 3 bytes for an expander)
+        for (uint8_t idx = 0; idx < 4; ++idx)
+        {
+            ChainOutputs::writeByte(idx, 0);
+            ExpanderOutputs::writeByte(idx, 0);
+        }
+        ChainOutputs::flush();
+        ExpanderOutputs::flush();
+        ChainSPI::s_nofBytes = 0;
+        ExpanderSPI::s_nofBytes = 0;
+        const uint16_t nofWritesChaser = patternChaser<ChainOutputs>();
+        patternChaser<ExpanderOutputs>();
+        const uint16_t chainChaser = ChainSPI::s_nofBytes;
+        const uint16_t expanderChaser = ExpanderSPI::s_nofBytes;
+        testPassed &= checkChain(0x80000000) && checkExpanders(0x80000000);
+        
+        ChainSPI::s_nofBytes = 0;
+        ExpanderSPI::s_nofBytes = 0;
+        const uint16_t nofWritesBarGraph = patternBarGraph<ChainOutputs>();
+        patternBarGraph<ExpanderOutputs>();
+        const uint16_t chainBarGraph = ChainSPI::s_nofBytes;
+        const uint16_t expanderBarGraph = ExpanderSPI::s_nofBytes;
+        testPassed &= checkChain(0x3FFFFFFF) && checkExpanders(0x3FFFFFFF);
+        
+        ChainSPI::s_nofBytes = 0;
+        ExpanderSPI::s_nofBytes = 0;
+        const uint16_t nofWritesBlink = patternBlink<ChainOutputs>();
+        patternBlink<ExpanderOutputs>();
+        const uint16_t chainBlink = ChainSPI::s_nofBytes;
+        const uint16_t expanderBlink = ExpanderSPI::s_nofBytes;
+        
+        testPassed &= chainChaser == 32 * 4 && 4 * nofWritesChaser == 256;
+        
+        // Steps 8 and 24 change both ports of one device, step 16 changes one port of each device
+        testPassed &= expanderChaser == 29 * 3 + 4 + 6 + 4 && 3 * nofWritesChaser == 192;
+        testPassed &= chainBarGraph == 16 * 4 && 4 * nofWritesBarGraph == 2048;
+        testPassed &= expanderBarGraph < 16 * 8 && 3 * nofWritesBarGraph == 1536;
+        testPassed &= chainBlink == 16 * 4 && expanderBlink == 16 * 3 && nofWritesBlink == 16;
+    }
+    allPassed &= test_assert("bus bytes", testPassed);
+    
+    test_assert("OVERALL:", allPassed);
+    
+    while (true)
+    {
+    }
+}
+
+template <>
+struct debugPrinter<const char*>
+{
+    static void print(const char* arg)
+    {
+        // Put a tracepoint here and display {arg, s} in output window
+        (void)arg;
+    }
+};
+
+void throw_bad_alloc()
+{
+    while(true);
+}
+
+void throw_nullptr_error()
+{
+    while(true);
+}
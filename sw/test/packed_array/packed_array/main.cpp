@@ -0,0 +1,192 @@
+/*
+Copyright (C) 2023 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <packed_array.h>
+
+#include "../../common/debug_print.h"
+
+enum class Step : uint8_t
+{
+    off,
+    on,
+    accent,
+    tie
+};
+
+bool test_assert(const char * str, const bool flag)
+{
+    cout << str;
+    if (flag)
+    {
+        cout << static_cast<const char *>("PASSED");
+    }
+    else
+    {
+        cout << static_cast<const char *>("FAILED");
+    }
+    return flag;
+}
+
+// Write a pattern, read it back and check that neighbouring elements are not affected
+template <uint8_t t_bits>
+bool testReadWrite()
+{
+    constexpr uint8_t length = 50;
+    constexpr uint8_t mask = (1 << t_bits) - 1;
+    PackedArray<t_bits, length> x;
+    bool passed = x.sizeBytes() == (t_bits * length + 7) / 8;
+
+    for (uint8_t idx = 0; idx < length; ++idx)
+    {
+        x[idx] = (idx * 7 + 3) & mask;
+    }
+    for (uint8_t idx = 0; idx < length; ++idx)
+    {
+        passed &= x[idx] == ((idx * 7 + 3) & mask);
+    }
+
+    x.fill(mask);
+    uint8_t nofElems = 0;
+    for (const uint8_t elem : x)
+    {
+        passed &= elem == mask;
+        ++nofElems;
+    }
+    passed &= nofElems == length;
+
+    x.set(10, 0);
+    passed &= x[9] == mask && x[10] == 0 && x[11] == mask;
+    return passed;
+}
+
+// Copy ranges (aligned and unaligned) and compare element-wise
+template <uint8_t t_bits>
+bool testCopy()
+{
+    constexpr uint8_t mask = (1 << t_bits) - 1;
+    PackedArray<t_bits, 64> src;
+    for (uint8_t idx = 0; idx < src.size(); ++idx)
+    {
+        src[idx] = (idx * 5 + 1) & mask;
+    }
+
+    bool passed = true;
+    for (uint8_t dstIdx = 0; dstIdx < 10; ++dstIdx)
+    {
+        for (uint8_t srcIdx = 0; srcIdx < 10; ++srcIdx)
+        {
+            PackedArray<t_bits, 64> dst(mask);
+            dst.copy(dstIdx, src, srcIdx, 40);
+            for (uint8_t idx = 0; idx < 64; ++idx)
+            {
+                const bool inRange = idx >= dstIdx && idx < dstIdx + 40;
+                passed &= dst[idx] == (inRange ? src[idx - dstIdx + srcIdx] : mask);
+            }
+        }
+    }
+
+    // Overlapping copy within the same array
+    PackedArray<t_bits, 64> x = src;
+    x.copy(8, x, 0, 40);
+    for (uint8_t idx = 0; idx < 40; ++idx)
+    {
+        passed &= x[idx + 8] == src[idx];
+    }
+    x = src;
+    x.copy(0, x, 8, 40);
+    for (uint8_t idx = 0; idx < 40; ++idx)
+    {
+        passed &= x[idx] == src[idx + 8];
+    }
+
+    return passed;
+}
+
+int main(void)
+{
+    bool allPassed = true;
+    bool testPassed = true;
+
+    {
+        testPassed = true;
+        PackedArray<2, 16> x;
+        testPassed &= sizeof(x) == 4;
+        for (const uint8_t elem : x)
+        {
+            testPassed &= elem == 0;
+        }
+        PackedArray<3, 16> y(5);
+        testPassed &= sizeof(y) == 6;
+        for (const uint8_t elem : y)
+        {
+            testPassed &= elem == 5;
+        }
+    }
+    allPassed &= test_assert("Constructor", testPassed);
+
+    {
+        testPassed = true;
+        testPassed &= testReadWrite<1>();
+        testPassed &= testReadWrite<2>();
+        testPassed &= testReadWrite<3>();
+        testPassed &= testReadWrite<4>();
+        testPassed &= testReadWrite<5>();
+        testPassed &= testReadWrite<6>();
+        testPassed &= testReadWrite<7>();
+        testPassed &= testReadWrite<8>();
+    }
+    allPassed &= test_assert("get/set/fill", testPassed);
+
+    {
+        testPassed = true;
+        testPassed &= testCopy<1>();
+        testPassed &= testCopy<2>();
+        testPassed &= testCopy<3>();
+        testPassed &= testCopy<4>();
+        testPassed &= testCopy<6>();
+        testPassed &= testCopy<8>();
+    }
+    allPassed &= test_assert("copy", testPassed);
+
+    {
+        testPassed = true;
+        PackedArray<2, 32, Step> pattern(Step::off);
+        pattern[3] = Step::accent;
+        pattern[4] = pattern[3];
+        testPassed &= pattern[3] == Step::accent;
+        testPassed &= pattern[4] == Step::accent;
+        testPassed &= pattern[5] == Step::off;
+        testPassed &= sizeof(pattern) == 8;
+    }
+    allPassed &= test_assert("enum", testPassed);
+
+    test_assert("OVERALL:", allPassed);
+
+    while (true)
+    {
+    }
+}
+
+template <>
+struct debugPrinter<const char*>
+{
+    static void print(const char* arg)
+    {
+        // Put a tracepoint here and display {arg, s} in output window
+        (void)arg;
+    }
+};
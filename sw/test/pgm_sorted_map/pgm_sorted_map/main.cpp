@@ -0,0 +1,203 @@
+/*
+Copyright (C) 2023 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <pgm_sorted_map.h>
+#include <pgm_array.h>
+#include <lookup_table.h>
+#include <array.h>
+
+#include "../../common/debug_print.h"
+
+enum class Note : uint8_t
+{
+    C = 60,
+    D = 62,
+    E = 64,
+    G = 67,
+    A = 69
+};
+
+// Sorted map in program memory, entries given in arbitrary order
+constexpr auto noteNames = makePgmSortedMap([]
+{
+    return Array<Pair<uint8_t, char>, 5>{{{69, 'A'}, {60, 'C'}, {67, 'G'}, {62, 'D'}, {64, 'E'}}};
+});
+
+// Array in program memory, computed at compile time
+constexpr auto squares = makePgmArray([]
+{
+    Array<uint16_t, 16> table = {};
+    for (uint8_t idx = 0; idx < table.size(); ++idx)
+    {
+        table[idx] = idx * idx;
+    }
+    return table;
+});
+
+// Variable-length sequence computed at compile time: All primes below 50
+struct Primes
+{
+    constexpr Primes()
+    {
+        for (uint8_t candidate = 2; candidate < 50; ++candidate)
+        {
+            bool isPrime = true;
+            for (uint8_t idx = 0; idx < m_size; ++idx)
+            {
+                isPrime &= 0 != candidate % m_data[idx];
+            }
+            if (isPrime)
+            {
+                m_data[m_size++] = candidate;
+            }
+        }
+    }
+    
+    constexpr size_t size() const
+    {
+        return m_size;
+    }
+    
+    constexpr uint8_t operator[](const size_t idx) const
+    {
+        return m_data[idx];
+    }
+    
+    uint8_t m_data[50] = {};
+    uint8_t m_size = 0;
+};
+
+constexpr auto primes = makePgmArray([]{ return Primes(); });
+
+// Sparse lookup table in program memory
+constexpr auto lut = makePgmLUT([]{ return SparseLUT<uint8_t, uint8_t, 128>(0xFF, Pair<uint8_t, uint8_t>(1, 10), Pair<uint8_t, uint8_t>(64, 20)); });
+
+bool test_assert(const char * str, const bool flag)
+{
+    cout << str;
+    if (flag)
+    {
+        cout << static_cast<const char *>("PASSED");
+    }
+    else
+    {
+        cout << static_cast<const char *>("FAILED");
+    }
+    return flag;
+}
+
+int main(void)
+{
+    bool allPassed = true;
+    bool testPassed = true;
+
+    {
+        testPassed = true;
+        testPassed &= noteNames.size() == 5;
+        testPassed &= !noteNames.empty();
+        
+        // Entries are sorted by key
+        testPassed &= noteNames[0].first == 60 && noteNames[0].second == 'C';
+        testPassed &= noteNames[1].first == 62;
+        testPassed &= noteNames[2].first == 64;
+        testPassed &= noteNames[3].first == 67;
+        testPassed &= noteNames[4].first == 69 && noteNames[4].second == 'A';
+    }
+    allPassed &= test_assert("makePgmSortedMap", testPassed);
+
+    {
+        testPassed = true;
+        testPassed &= noteNames.at(67) == 'G';
+        testPassed &= noteNames.at(60) == 'C';
+        testPassed &= noteNames.get(64, '?') == 'E';
+        testPassed &= noteNames.get(65, '?') == '?';
+        testPassed &= noteNames.contains(69);
+        testPassed &= !noteNames.contains(70);
+        testPassed &= !noteNames.contains(0);
+        testPassed &= noteNames.find(62) == 1;
+        testPassed &= noteNames.find(63) == noteNames.size();
+        testPassed &= noteNames.lowerBound(63) == 2;
+        testPassed &= noteNames.lowerBound(0) == 0;
+        testPassed &= noteNames.lowerBound(100) == 5;
+    }
+    allPassed &= test_assert("find/at/get", testPassed);
+
+    {
+        testPassed = true;
+        
+        // Enumeration keys
+        constexpr auto intervals = makePgmSortedMap([]
+        {
+            return Array<Pair<Note, uint8_t>, 3>{{{Note::G, 7}, {Note::C, 0}, {Note::E, 4}}};
+        });
+        testPassed &= intervals.at(Note::E) == 4;
+        testPassed &= intervals.get(Note::A, 0xFF) == 0xFF;
+        testPassed &= intervals[0].first == Note::C;
+    }
+    allPassed &= test_assert("enum keys", testPassed);
+
+    {
+        testPassed = true;
+        static_assert(squares.size() == 16, "Size is known at compile time");
+        for (uint8_t idx = 0; idx < squares.size(); ++idx)
+        {
+            testPassed &= squares[idx] == idx * idx;
+        }
+        
+        static_assert(primes.size() == 15, "Size is known at compile time");
+        testPassed &= primes.front() == 2;
+        testPassed &= primes[4] == 11;
+        testPassed &= primes.back() == 47;
+    }
+    allPassed &= test_assert("makePgmArray", testPassed);
+
+    {
+        testPassed = true;
+        static_assert(lut.size() == 128, "Size is known at compile time");
+        testPassed &= lut(1) == 10;
+        testPassed &= lut(64) == 20;
+        testPassed &= lut(0) == 0xFF;
+        testPassed &= lut(127) == 0xFF;
+    }
+    allPassed &= test_assert("makePgmLUT", testPassed);
+
+    test_assert("OVERALL:", allPassed);
+
+    while (true)
+    {
+    }
+}
+
+template <>
+struct debugPrinter<const char*>
+{
+    static void print(const char* arg)
+    {
+        // Put a tracepoint here and display {arg, s} in output window
+        (void)arg;
+    }
+};
+
+void throw_length_error()
+{
+    while(true);
+}
+
+void throw_out_of_range()
+{
+    while(true);
+}
@@ -0,0 +1,207 @@
+/*
+Copyright (C) 2023 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <span.h>
+#include <array.h>
+#include <static_vector.h>
+#include <string.h>
+#include <string_stream.h>
+#include <spi_master.h>
+
+#include "../../common/debug_print.h"
+
+// Dummy SPI module counting the transferred bytes
+struct DummySPIModule
+{
+    struct SS_Pin {};
+    enum class ClockRate : uint8_t {};
+    enum class DataOrder : uint8_t {};
+    enum class ClockPolarity : uint8_t {};
+    enum class ClockPhase : uint8_t {};
+
+    static void transmit(const uint8_t data)
+    {
+        s_lastTransmitted = data;
+        s_sum += data;
+        ++s_nofTransmitted;
+    }
+
+    static void wait()
+    {}
+
+    static uint8_t receive()
+    {
+        return s_nofTransmitted;
+    }
+
+    static uint8_t s_lastTransmitted;
+    static uint16_t s_sum;
+    static uint16_t s_nofTransmitted;
+};
+
+uint8_t DummySPIModule::s_lastTransmitted = 0;
+uint16_t DummySPIModule::s_sum = 0;
+uint16_t DummySPIModule::s_nofTransmitted = 0;
+
+using SPIMaster = SPIMasterSync<DummySPIModule>;
+
+bool test_assert(const char * str, const bool flag)
+{
+    cout << str;
+    if (flag)
+    {
+        cout << static_cast<const char *>("PASSED");
+    }
+    else
+    {
+        cout << static_cast<const char *>("FAILED");
+    }
+    return flag;
+}
+
+int main(void)
+{
+    bool allPassed = true;
+    bool testPassed = true;
+
+    {
+        testPassed = true;
+        Span<uint8_t> x;
+        testPassed &= x.empty();
+        testPassed &= x.size() == 0;
+    }
+    allPassed &= test_assert("Default constructor", testPassed);
+
+    {
+        testPassed = true;
+        Array<uint8_t, 4> a = {1, 2, 3, 4};
+        Span<uint8_t> x(a);
+        testPassed &= x.size() == 4;
+        testPassed &= x.data() == a.data();
+        x[1] = 42;
+        testPassed &= a[1] == 42;
+        ConstSpan<uint8_t> y(x);
+        testPassed &= y.front() == 1;
+        testPassed &= y.back() == 4;
+    }
+    allPassed &= test_assert("Array", testPassed);
+
+    {
+        testPassed = true;
+        StaticVector<uint8_t, 8> v;
+        v.pushBack(5);
+        v.pushBack(6);
+        ConstSpan<uint8_t> x(v);
+        testPassed &= x.size() == 2;
+        uint8_t sum = 0;
+        for (uint8_t elem : x)
+        {
+            sum += elem;
+        }
+        testPassed &= sum == 11;
+    }
+    allPassed &= test_assert("StaticVector", testPassed);
+
+    {
+        testPassed = true;
+        uint8_t a[6] = {0, 1, 2, 3, 4, 5};
+        Span<uint8_t> x(a);
+        testPassed &= x.first(2).size() == 2;
+        testPassed &= x.last(2).front() == 4;
+        testPassed &= x.subspan(1, 3).back() == 3;
+        testPassed &= x.subspan(4).size() == 2;
+        testPassed &= x.subspan(4, 10).size() == 2;
+    }
+    allPassed &= test_assert("subspan", testPassed);
+
+    {
+        testPassed = true;
+        const PgmArray<uint8_t> p = makePgmArray<uint8_t, 10, 20, 30>();
+        PgmSpan<uint8_t> x(p);
+        testPassed &= x.size() == 3;
+        testPassed &= x[1] == 20;
+        testPassed &= x.back() == 30;
+        uint8_t a[2] = {};
+        testPassed &= x.subspan(1).copy(a) == 2;
+        testPassed &= a[0] == 20 && a[1] == 30;
+    }
+    allPassed &= test_assert("PgmSpan", testPassed);
+
+    {
+        testPassed = true;
+        String<> str;
+        StringStream<String<>> stream(str);
+        const char text[] = {'a', 'b', 'c'};
+        stream << ConstSpan<char>(text) << PgmSpan<char>("def"_pgm);
+        testPassed &= str.size() == 6;
+        testPassed &= str.data()[3] == 'd';
+    }
+    allPassed &= test_assert("toString", testPassed);
+
+    {
+        testPassed = true;
+
+        // Transfers of more than 255 bytes
+        static uint8_t buffer[300];
+        for (uint16_t idx = 0; idx < 300; ++idx)
+        {
+            buffer[idx] = 1;
+        }
+        SPIMaster::put(ConstSpan<uint8_t>(buffer));
+        testPassed &= DummySPIModule::s_nofTransmitted == 300;
+        testPassed &= DummySPIModule::s_sum == 300;
+
+        SPIMaster::put(PgmSpan<uint8_t>(makePgmArray<uint8_t, 7, 8, 9>()));
+        testPassed &= DummySPIModule::s_nofTransmitted == 303;
+        testPassed &= DummySPIModule::s_lastTransmitted == 9;
+
+        SPIMaster::get(Span<uint8_t>(buffer).first(3));
+        testPassed &= buffer[2] == 50; // (303 + 3) modulo 256
+    }
+    allPassed &= test_assert("SPIMasterSync", testPassed);
+
+    test_assert("OVERALL:", allPassed);
+
+    while (true)
+    {
+    }
+}
+
+template <>
+struct debugPrinter<const char*>
+{
+    static void print(const char* arg)
+    {
+        // Put a tracepoint here and display {arg, s} in output window
+        (void)arg;
+    }
+};
+
+void throw_bad_alloc()
+{
+    while(true);
+}
+
+void throw_out_of_range()
+{
+    while(true);
+}
+
+void throw_length_error()
+{
+    while(true);
+}
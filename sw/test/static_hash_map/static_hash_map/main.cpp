@@ -0,0 +1,245 @@
+/*
+Copyright (C) 2023 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <static_hash_map.h>
+#include <static_vector.h>
+#include <lookup_table.h>
+
+#include "../../common/debug_print.h"
+
+bool test_assert(const char * str, const bool flag)
+{
+    cout << str;
+    if (flag)
+    {
+        cout << static_cast<const char *>("PASSED");
+    }
+    else
+    {
+        cout << static_cast<const char *>("FAILED");
+    }
+    return flag;
+}
+
+// Pseudo random keys 0..127 (full period linear congruential generator)
+uint8_t nextKey(uint8_t& state)
+{
+    state = (5 * state + 1) & 0x7F;
+    return state;
+}
+
+// Benchmark: Lookup of all keys 0..127 in a map filled with t_nofKeys pseudo random keys.
+// Put a breakpoint before and after each benchmark call and read the cycle counter of the simulator.
+template <uint8_t t_nofKeys>
+uint8_t benchmarkHashMap()
+{
+    StaticHashMap<uint8_t, uint8_t, 128> map;
+    uint8_t state = 1;
+    while (map.size() < t_nofKeys)
+    {
+        const uint8_t key = nextKey(state);
+        map[key] = key;
+    }
+
+    uint8_t nofHits = 0;
+    for (uint8_t key = 0; key < 128; ++key)
+    {
+        nofHits += map.contains(key);
+    }
+    return nofHits;
+}
+
+template <uint8_t t_nofKeys>
+uint8_t benchmarkLinearSearch()
+{
+    StaticVector<Pair<uint8_t, uint8_t>, 128> vector;
+    uint8_t state = 1;
+    while (vector.size() < t_nofKeys)
+    {
+        const uint8_t key = nextKey(state);
+        bool found = false;
+        for (const auto& entry : vector)
+        {
+            found |= entry.first == key;
+        }
+        if (!found)
+        {
+            vector.emplaceBack(key, key);
+        }
+    }
+
+    uint8_t nofHits = 0;
+    for (uint8_t key = 0; key < 128; ++key)
+    {
+        for (const auto& entry : vector)
+        {
+            if (entry.first == key)
+            {
+                ++nofHits;
+                break;
+            }
+        }
+    }
+    return nofHits;
+}
+
+// SparseLUT covers the whole key space, i.e. lookup cost does not depend on the load factor
+uint8_t benchmarkSparseLUT()
+{
+    constexpr SparseLUT<uint8_t, uint8_t, 128> lut(0xFF, Pair<uint8_t, uint8_t>(1, 1), Pair<uint8_t, uint8_t>(64, 64));
+
+    uint8_t nofHits = 0;
+    for (uint8_t key = 0; key < 128; ++key)
+    {
+        nofHits += 0xFF != lut(key);
+    }
+    return nofHits;
+}
+
+int main(void)
+{
+    bool allPassed = true;
+    bool testPassed = true;
+
+    {
+        testPassed = true;
+        StaticHashMap<uint8_t, uint16_t, 16> x;
+        testPassed &= x.empty();
+        testPassed &= x.begin() == x.end();
+        testPassed &= !x.contains(3);
+        testPassed &= x.find(3) == x.end();
+    }
+    allPassed &= test_assert("Default constructor", testPassed);
+
+    {
+        testPassed = true;
+        StaticHashMap<uint8_t, uint16_t, 16> x;
+        testPassed &= x.insert(Pair<uint8_t, uint16_t>(3, 300)).second;
+        testPassed &= !x.insert(Pair<uint8_t, uint16_t>(3, 301)).second;
+        testPassed &= x.emplace(19, 1900).second; // same home slot as key 3
+        testPassed &= x.emplace(4, 400).second;
+        x[5] = 500;
+        testPassed &= x.size() == 4;
+        testPassed &= x.at(3) == 300;
+        testPassed &= x.at(19) == 1900;
+        testPassed &= x.find(4)->second == 400;
+        testPassed &= x[5] == 500;
+        testPassed &= !x.contains(35);
+    }
+    allPassed &= test_assert("insert/find", testPassed);
+
+    {
+        testPassed = true;
+        StaticHashMap<uint8_t, uint16_t, 16> x;
+        x[3] = 300;
+        x[19] = 1900;
+        x[35] = 3500;
+        x[4] = 400;
+        testPassed &= x.erase(3) == 1;
+        testPassed &= x.erase(3) == 0;
+        testPassed &= x.at(19) == 1900;
+        testPassed &= x.at(35) == 3500;
+        testPassed &= x.at(4) == 400;
+        x.erase(x.find(19));
+        testPassed &= x.size() == 2;
+        testPassed &= x.at(35) == 3500;
+        testPassed &= x.at(4) == 400;
+    }
+    allPassed &= test_assert("erase", testPassed);
+
+    {
+        testPassed = true;
+        StaticHashMap<uint8_t, uint8_t, 128> x;
+        uint8_t state = 1;
+        while (x.size() < 115)
+        {
+            const uint8_t key = nextKey(state);
+            x[key] = key;
+        }
+
+        // Remove every other key and check the remaining ones
+        for (uint8_t key = 0; key < 128; key += 2)
+        {
+            x.erase(key);
+        }
+        uint8_t nofElems = 0;
+        for (const auto& elem : x)
+        {
+            testPassed &= elem.first == elem.second;
+            testPassed &= 1 == (elem.first & 1);
+            testPassed &= x.contains(elem.first);
+            ++nofElems;
+        }
+        testPassed &= nofElems == x.size();
+    }
+    allPassed &= test_assert("high load", testPassed);
+
+    {
+        testPassed = true;
+        StaticHashMap<PgmString, uint8_t, 8> x;
+        x["start"_pgm] = 1;
+        x["stop"_pgm] = 2;
+        x["status"_pgm] = 3;
+
+        // Lookup by token received in RAM
+        const char token[] = {'s', 't', 'o', 'p'};
+        testPassed &= x.at(ConstSpan<char>(token)) == 2;
+        testPassed &= x.at("status"_pgm) == 3;
+        testPassed &= !x.contains(ConstSpan<char>(token).first(3));
+    }
+    allPassed &= test_assert("PgmString keys", testPassed);
+
+    {
+        testPassed = true;
+        testPassed &= benchmarkHashMap<32>() == 32;
+        testPassed &= benchmarkHashMap<64>() == 64;
+        testPassed &= benchmarkHashMap<96>() == 96;
+        testPassed &= benchmarkHashMap<115>() == 115;
+        testPassed &= benchmarkLinearSearch<32>() == 32;
+        testPassed &= benchmarkLinearSearch<64>() == 64;
+        testPassed &= benchmarkLinearSearch<96>() == 96;
+        testPassed &= benchmarkLinearSearch<115>() == 115;
+        testPassed &= benchmarkSparseLUT() == 2;
+    }
+    allPassed &= test_assert("benchmark", testPassed);
+
+    test_assert("OVERALL:", allPassed);
+
+    while (true)
+    {
+    }
+}
+
+template <>
+struct debugPrinter<const char*>
+{
+    static void print(const char* arg)
+    {
+        // Put a tracepoint here and display {arg, s} in output window
+        (void)arg;
+    }
+};
+
+void throw_bad_alloc()
+{
+    while(true);
+}
+
+void throw_out_of_range()
+{
+    while(true);
+}
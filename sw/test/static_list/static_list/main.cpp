@@ -16,6 +16,7 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include <static_list.h>
+#include <vector.h>
 
 #include "../../common/debug_print.h"
 
@@ -59,6 +60,11 @@ class Test
         return m_value == other.m_value;
     }
     
+    bool operator<(const Test& other) const
+    {
+        return m_value < other.m_value;
+    }
+    
     uint8_t getValue() const
     {
         return m_value;
@@ -129,6 +135,86 @@ bool test_assert(const char * str, const bool flag)
 }
 
 
+// Pseudo random values 0..63 (full period linear congruential generator modulo 256)
+uint8_t nextValue(uint8_t& state)
+{
+    state = 5 * state + 1;
+    return state & 0x3F;
+}
+
+template <typename Container>
+bool isSorted(Container& x)
+{
+    bool sorted = true;
+    auto it = x.begin();
+    if (it != x.end())
+    {
+        uint8_t prev = *it;
+        for (++it; it != x.end(); ++it)
+        {
+            sorted &= !(*it < prev);
+            prev = *it;
+        }
+    }
+    return sorted;
+}
+
+// Benchmark: Sort a list of t_size pseudo random elements in place vs. copying the elements into a vector, sorting the vector and rebuilding the list.
+// Put a breakpoint before and after each benchmark call and read the cycle counter of the simulator.
+template <uint16_t t_size>
+bool benchmarkSort()
+{
+    StaticList<uint8_t, 256> x;
+    uint8_t state = 1;
+    for (uint16_t cnt = 0; cnt < t_size; ++cnt)
+    {
+        x.pushFront(nextValue(state));
+    }
+    x.sort();
+    return isSorted(x);
+}
+
+template <uint16_t t_size>
+bool benchmarkCopySortRebuild()
+{
+    StaticList<uint8_t, 256> x;
+    uint8_t state = 1;
+    for (uint16_t cnt = 0; cnt < t_size; ++cnt)
+    {
+        x.pushFront(nextValue(state));
+    }
+
+    // Copy
+    Vector<uint8_t> v;
+    v.reserve(t_size);
+    for (const uint8_t elem : x)
+    {
+        v.pushBack(elem);
+    }
+
+    // Insertion sort
+    for (uint16_t idx = 1; idx < v.size(); ++idx)
+    {
+        const uint8_t value = v[idx];
+        uint16_t pos = idx;
+        while (pos > 0 && value < v[pos - 1])
+        {
+            v[pos] = v[pos - 1];
+            --pos;
+        }
+        v[pos] = value;
+    }
+
+    // Rebuild
+    x.clear();
+    for (const uint8_t elem : v)
+    {
+        x.pushBack(elem);
+    }
+
+    return isSorted(x);
+}
+
 int main(void)
 {
     bool allPassed = true;
@@ -721,6 +807,95 @@ int main(void)
     }
     allPassed &= test_assert("reverse()", testPassed);
 
+    {
+        testPassed = true;
+        Test::resetCounter();
+        StaticList<Test,10> x(testList);
+        x.reverse();
+        x.sort();
+        auto it = testInit.begin();
+        for (const Test& t : x)
+        {
+            testPassed &= t.getValue() == (*it).getValue();
+            ++it;
+        }
+    }
+    allPassed &= test_assert("sort()", testPassed && Test::check(0,0,3,0,3));
+
+    {
+        testPassed = true;
+        StaticList<uint8_t, 200> x;
+        x.sort();
+        testPassed &= x.empty();
+        
+        uint8_t state = 1;
+        for (uint16_t cnt = 0; cnt < 200; ++cnt)
+        {
+            x.pushBack(nextValue(state));
+        }
+        x.sort();
+        testPassed &= isSorted(x);
+        testPassed &= x.size() == 200;
+        
+        // Check backward links
+        uint8_t prev = 0xFF;
+        for (auto it = x.rbegin(); it != x.rend(); ++it)
+        {
+            testPassed &= *it <= prev;
+            prev = *it;
+        }
+        
+        // Sort descending
+        x.sort([](const uint8_t lhs, const uint8_t rhs) { return lhs > rhs; });
+        testPassed &= x.front() == 63 && x.back() == 0;
+    }
+    allPassed &= test_assert("sort()", testPassed);
+    
+    {
+        testPassed = true;
+        Test::resetCounter();
+        StaticList<Test,10> x(testList);
+        StaticList<Test,10> y(testList);
+        x.merge(y);
+        testPassed &= y.empty();
+        testPassed &= x.size() == 6;
+        const uint8_t expected[] = {42, 42, 43, 43, 44, 44};
+        const uint8_t* it = expected;
+        for (const Test& t : x)
+        {
+            testPassed &= t.getValue() == *it++;
+        }
+    }
+    allPassed &= test_assert("merge()", testPassed && Test::check(0,0,6,3,9));
+    
+    {
+        testPassed = true;
+        StaticList<uint8_t, 10> x({1, 1, 2, 3, 3, 3, 1});
+        testPassed &= x.unique() == 3;
+        const uint8_t expected[] = {1, 2, 3, 1};
+        const uint8_t* it = expected;
+        for (const uint8_t elem : x)
+        {
+            testPassed &= elem == *it++;
+        }
+        testPassed &= x.size() == 4;
+        testPassed &= x.back() == 1;
+        
+        // Released nodes can be reused
+        x.insert(x.cend(), static_cast<size_t>(6), 0);
+        testPassed &= x.size() == 10;
+    }
+    allPassed &= test_assert("unique()", testPassed);
+    
+    {
+        testPassed = true;
+        testPassed &= benchmarkSort<64>();
+        testPassed &= benchmarkCopySortRebuild<64>();
+        testPassed &= benchmarkSort<256>();
+        testPassed &= benchmarkCopySortRebuild<256>();
+    }
+    allPassed &= test_assert("benchmark", testPassed);
+
     allPassed &= test_assert("OVERALL:", allPassed);
 
     while (true)
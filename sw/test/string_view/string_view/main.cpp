@@ -0,0 +1,236 @@
+/*
+Copyright (C) 2023 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string_view.h>
+#include <string.h>
+#include <static_string.h>
+#include <string_stream.h>
+
+#include "../../common/debug_print.h"
+
+bool test_assert(const char * str, const bool flag)
+{
+    cout << str;
+    if (flag)
+    {
+        cout << static_cast<const char *>("PASSED");
+    }
+    else
+    {
+        cout << static_cast<const char *>("FAILED");
+    }
+    return flag;
+}
+
+// Compare the content of a character container with a null-terminated string
+template <typename Container>
+bool equals(const Container& container, const char* str)
+{
+    size_t idx = 0;
+    for (const char c : container)
+    {
+        if (c != str[idx++])
+        {
+            return false;
+        }
+    }
+    return '\0' == str[idx];
+}
+
+int main(void)
+{
+    bool allPassed = true;
+    bool testPassed = true;
+
+    {
+        testPassed = true;
+        StringView x;
+        testPassed &= x.empty();
+        testPassed &= x.begin() == x.end();
+
+        String<> string("Hello");
+        StringView y(string);
+        testPassed &= y.data() == string.data();
+        testPassed &= y.size() == 5;
+
+        StaticString<8> staticString;
+        staticString.pushBack('a');
+        staticString.pushBack('b');
+        StringView z(staticString);
+        testPassed &= z.size() == 2 && z[1] == 'b';
+
+        const char token[] = {'s', 't', 'o', 'p'};
+        testPassed &= StringView(ConstSpan<char>(token)).size() == 4;
+        testPassed &= StringView("stop").size() == 4;
+
+        PgmStringView p("stop"_pgm);
+        testPassed &= p.size() == 4 && p.front() == 's' && p.back() == 'p';
+        testPassed &= equals(p, "stop");
+        testPassed &= PgmStringView(PgmSpan<char>("stop"_pgm)).size() == 4;
+
+        // Characters in program memory cannot be viewed as a StringView in RAM
+        static_assert(!is_convertible<PgmString, StringView>::value, "PgmString must not be viewed as StringView");
+        static_assert(!is_convertible<PgmSpan<char>, StringView>::value, "PgmSpan must not be viewed as StringView");
+        static_assert(!is_convertible<PgmArray<char>, StringView>::value, "PgmArray must not be viewed as StringView");
+        static_assert(!is_convertible<PgmStringView, StringView>::value, "PgmStringView must not be viewed as StringView");
+        static_assert(is_convertible<ConstSpan<char>, StringView>::value, "ConstSpan can be viewed as StringView");
+    }
+    allPassed &= test_assert("Constructor", testPassed);
+
+    {
+        testPassed = true;
+        const StringView x("set volume 42");
+        testPassed &= x.find(' ') == 3;
+        testPassed &= x.find(' ', 4) == 10;
+        testPassed &= x.find('x') == StringView::s_npos;
+        testPassed &= x.find("volume") == 4;
+        testPassed &= x.find("volume"_pgm) == 4;
+        testPassed &= x.find("42") == 11;
+        testPassed &= x.find("421") == StringView::s_npos;
+        testPassed &= x.find("") == 0;
+        testPassed &= PgmStringView("set volume 42"_pgm).find("42") == 11;
+        testPassed &= StringView("ab").find("abc") == StringView::s_npos;
+    }
+    allPassed &= test_assert("find", testPassed);
+
+    {
+        testPassed = true;
+        const StringView x("set volume 42");
+        testPassed &= x.startsWith('s');
+        testPassed &= x.startsWith("set");
+        testPassed &= x.startsWith("set"_pgm);
+        testPassed &= !x.startsWith("setup"_pgm);
+        testPassed &= x.endsWith('2');
+        testPassed &= x.endsWith("42");
+        testPassed &= x.endsWith(" 42"_pgm);
+        testPassed &= !x.endsWith("x42 set volume 42");
+        testPassed &= !StringView().startsWith('s');
+        testPassed &= PgmStringView("status"_pgm).startsWith("stat");
+    }
+    allPassed &= test_assert("startsWith/endsWith", testPassed);
+
+    {
+        testPassed = true;
+        const StringView x("stop");
+        testPassed &= x == "stop"_pgm;
+        testPassed &= x == StringView("stop");
+        testPassed &= !(x == "sto"_pgm);
+        testPassed &= PgmStringView("stop"_pgm) == x;
+        testPassed &= x.compare("stop"_pgm) == 0;
+        testPassed &= x.compare("start"_pgm) > 0;
+        testPassed &= x.compare("stops") < 0;
+        testPassed &= x.compare("sto") > 0;
+        testPassed &= PgmStringView("start"_pgm).compare(x) < 0;
+        testPassed &= StringView("\xFF").compare("a") > 0;
+    }
+    allPassed &= test_assert("compare", testPassed);
+
+    {
+        testPassed = true;
+        StringView x("  \tset volume\r\n");
+        x = x.trim();
+        testPassed &= x == "set volume";
+        testPassed &= x.substr(4) == "volume";
+        testPassed &= x.substr(4, 3) == "vol";
+        testPassed &= x.substr(4, 100) == "volume";
+        testPassed &= x.substr(x.size()).empty();
+        testPassed &= StringView("   ").trim().empty();
+        testPassed &= PgmStringView(" on "_pgm).trim() == "on";
+
+        x.removePrefix(4);
+        x.removeSuffix(3);
+        testPassed &= x == "vol";
+    }
+    allPassed &= test_assert("substr/trim", testPassed);
+
+    {
+        testPassed = true;
+        const char* const expected[] = {"a", "bc", "", "d"};
+        uint8_t nofTokens = 0;
+        for (const StringView token : StringView("a,bc,,d").split(','))
+        {
+            testPassed &= nofTokens < 4 && token == expected[nofTokens];
+            ++nofTokens;
+        }
+        testPassed &= nofTokens == 4;
+
+        nofTokens = 0;
+        for (const PgmStringView token : PgmStringView("a,bc,,d"_pgm).split(','))
+        {
+            testPassed &= nofTokens < 4 && token == expected[nofTokens];
+            ++nofTokens;
+        }
+        testPassed &= nofTokens == 4;
+
+        nofTokens = 0;
+        for (const StringView token : StringView().split(','))
+        {
+            testPassed &= token.empty();
+            ++nofTokens;
+        }
+        testPassed &= nofTokens == 1;
+
+        nofTokens = 0;
+        for (const StringView token : StringView("x,").split(','))
+        {
+            testPassed &= token == (0 == nofTokens ? "x" : "");
+            ++nofTokens;
+        }
+        testPassed &= nofTokens == 2;
+    }
+    allPassed &= test_assert("split", testPassed);
+
+    {
+        testPassed = true;
+        StaticString<32> string;
+        StringStream<StaticString<32>> stream(string);
+        const StringView line("set volume 42");
+        stream << line.substr(4, 6) << '=' << PgmStringView("on"_pgm);
+        testPassed &= equals(string, "volume=on");
+
+        stream.clear();
+        stream << setWidth(5) << rightAlign << StringView("ab");
+        testPassed &= equals(string, "   ab");
+    }
+    allPassed &= test_assert("toString/StringStream", testPassed);
+
+    test_assert("OVERALL:", allPassed);
+
+    while (true)
+    {
+    }
+}
+
+template <>
+struct debugPrinter<const char*>
+{
+    static void print(const char* arg)
+    {
+        // Put a tracepoint here and display {arg, s} in output window
+        (void)arg;
+    }
+};
+
+void throw_bad_alloc()
+{
+    while(true);
+}
+
+void throw_length_error()
+{
+    while(true);
+}
@@ -0,0 +1,313 @@
+/*
+Copyright (C) 2023 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <timebase.h>
+#include <functional.h>
+#include <scheduler.h>
+
+#include "../../common/debug_print.h"
+
+bool test_assert(const char * str, const bool flag)
+{
+    cout << str;
+    if (flag)
+    {
+        cout << static_cast<const char *>("PASSED");
+    }
+    else
+    {
+        cout << static_cast<const char *>("FAILED");
+    }
+    return flag;
+}
+
+void handleOverflowInterrupt();
+void handleSlowOverflowInterrupt();
+
+// Simulated free-running timer. The overflow interrupt is executed on wrap-around unless interrupts are disabled.
+template <typename Count, void (*t_interrupt)()>
+struct MockTimer
+{
+    using Type = Count;
+
+    static Count s_count;
+    static bool s_overflowFlag;
+    static bool s_interruptsEnabled;
+
+    // Number of ticks the timer advances between two reads, i.e. the execution time of the read sequence
+    static Count s_ticksPerRead;
+
+    static void advance(const uint32_t nofTicks)
+    {
+        for (uint32_t cnt = 0; cnt < nofTicks; ++cnt)
+        {
+            if (0 == ++s_count)
+            {
+                s_overflowFlag = true;
+                serveInterrupt();
+            }
+        }
+    }
+
+    static void serveInterrupt()
+    {
+        if (s_interruptsEnabled && s_overflowFlag)
+        {
+            s_overflowFlag = false;
+            t_interrupt();
+        }
+    }
+
+    static Count read()
+    {
+        const Count count = s_count;
+        advance(s_ticksPerRead);
+        return count;
+    }
+};
+
+template <typename Count, void (*t_interrupt)()>
+Count MockTimer<Count, t_interrupt>::s_count = 0;
+
+template <typename Count, void (*t_interrupt)()>
+bool MockTimer<Count, t_interrupt>::s_overflowFlag = false;
+
+template <typename Count, void (*t_interrupt)()>
+bool MockTimer<Count, t_interrupt>::s_interruptsEnabled = true;
+
+template <typename Count, void (*t_interrupt)()>
+Count MockTimer<Count, t_interrupt>::s_ticksPerRead = 0;
+
+template <typename Timer>
+struct MockOverflowFlag
+{
+    static bool read()
+    {
+        return Timer::s_overflowFlag;
+    }
+};
+
+// 16-bit timer at 2 MHz, e.g. 16 MHz with prescaler 8
+using Timer16 = MockTimer<uint16_t, &handleOverflowInterrupt>;
+using Clock = Timebase<Timer16, MockOverflowFlag<Timer16>, 2000000>;
+
+// 8-bit timer at 250 kHz, e.g. 16 MHz with prescaler 64
+using Timer8 = MockTimer<uint8_t, &handleSlowOverflowInterrupt>;
+using SlowClock = Timebase<Timer8, MockOverflowFlag<Timer8>, 250000>;
+
+// Scheduler clocked by the overflow interrupt of the 8-bit timer
+static Scheduler<function<void()>, uint8_t, 4> s_scheduler;
+
+void handleOverflowInterrupt()
+{
+    Clock::onOverflow();
+}
+
+void handleSlowOverflowInterrupt()
+{
+    SlowClock::onOverflow();
+    s_scheduler.clock();
+}
+
+static uint32_t s_executedAt = 0;
+
+void onTask()
+{
+    s_executedAt = SlowClock::getMicros();
+}
+
+// Benchmark: 256 reads of the timebase.
+// Put a breakpoint before and after each benchmark call and read the cycle counter of the simulator.
+uint32_t benchmarkGetTicks()
+{
+    uint32_t sum = 0;
+    for (uint16_t cnt = 0; cnt < 256; ++cnt)
+    {
+        sum += Clock::getTicks();
+    }
+    return sum;
+}
+
+uint32_t benchmarkGetMicros()
+{
+    uint32_t sum = 0;
+    for (uint16_t cnt = 0; cnt < 256; ++cnt)
+    {
+        sum += Clock::getMicros();
+    }
+    return sum;
+}
+
+int main(void)
+{
+    bool allPassed = true;
+    bool testPassed = true;
+
+    {
+        testPassed = true;
+        testPassed &= Clock::s_overflowMicros == 32768;
+        testPassed &= SlowClock::s_overflowMicros == 1024;
+        testPassed &= Clock::getTicks() == 0;
+        Timer16::advance(1000);
+        testPassed &= Clock::getTicks() == 1000;
+        testPassed &= Clock::getMicros() == 500;
+        Timer16::advance(200000);
+        testPassed &= Clock::getTicks() == 201000;
+        testPassed &= Clock::getMicros() == 100500;
+        testPassed &= Clock::toTicks(100500) == 201000;
+        testPassed &= SlowClock::toTicks(1000) == 250;
+    }
+    allPassed &= test_assert("ticks/micros", testPassed);
+
+    {
+        testPassed = true;
+
+        // The overflow interrupt hits while the timebase is read: The read is repeated
+        Timer16::s_count = 0xFFFF;
+        const uint32_t expected = Clock::getTicks() + 1;
+        Timer16::s_ticksPerRead = 1;
+        testPassed &= Clock::getTicks() == expected;
+        Timer16::s_ticksPerRead = 0;
+
+        // Monotonic across many wrap-arounds, with an interrupt in every read sequence
+        Timer16::s_ticksPerRead = 7;
+        uint32_t previous = Clock::getTicks();
+        for (uint16_t cnt = 0; cnt < 30000; ++cnt)
+        {
+            const uint32_t now = Clock::getTicks();
+            testPassed &= now - previous > 0 && now - previous < 16;
+            previous = now;
+        }
+        Timer16::s_ticksPerRead = 0;
+
+        // Interrupts disabled: The pending overflow is detected by the overflow flag
+        Timer16::s_interruptsEnabled = false;
+        Timer16::s_count = 0xFFF0;
+        const uint32_t before = Clock::getTicks();
+        Timer16::advance(0x20);
+        testPassed &= Timer16::s_overflowFlag;
+        testPassed &= Clock::getTicks() - before == 0x20;
+        testPassed &= Clock::getMicros() - (before >> 1) == 0x10;
+        Timer16::s_interruptsEnabled = true;
+        Timer16::serveInterrupt();
+        testPassed &= Clock::getTicks() - before == 0x20;
+    }
+    allPassed &= test_assert("consistency", testPassed);
+
+    {
+        testPassed = true;
+
+        // 32-bit microseconds wrap around correctly for slow ticks
+        uint32_t start = SlowClock::getMicros();
+        Timer8::advance(1000);
+        testPassed &= SlowClock::getElapsedMicros(start) == 4000;
+
+        // Fast ticks: Microseconds keep all 32 bits although the tick counter wraps first
+        start = Clock::getMicros();
+        for (uint8_t cnt = 0; cnt < 100; ++cnt)
+        {
+            Timer16::advance(2000000);
+        }
+        testPassed &= Clock::getElapsedMicros(start) == 100000000;
+    }
+    allPassed &= test_assert("elapsed", testPassed);
+
+    {
+        testPassed = true;
+        testPassed &= SlowClock::toDelay<uint8_t>(0) == 0;
+        testPassed &= SlowClock::toDelay<uint8_t>(1) == 2;
+        testPassed &= SlowClock::toDelay<uint8_t>(1024) == 2;
+        testPassed &= SlowClock::toDelay<uint8_t>(1025) == 3;
+        testPassed &= SlowClock::toDelay<uint8_t>(1000000) == 255;
+        testPassed &= SlowClock::toDelay<uint16_t>(1000000) == 978;
+        testPassed &= SlowClock::toDelay<uint8_t>(5000, 1000) == 6;
+
+        // 8-bit timer at 192 of 256 ticks: The next overflow follows in 256 us
+        Timer8::s_count = 192;
+        testPassed &= SlowClock::getDelay<uint8_t>(0) == 0;
+        testPassed &= SlowClock::getDelay<uint8_t>(256) == 1;
+        testPassed &= SlowClock::getDelay<uint8_t>(257) == 2;
+        testPassed &= SlowClock::getDelay<uint8_t>(1280) == 2;
+        testPassed &= SlowClock::getDelay<uint8_t>(1281) == 3;
+        testPassed &= SlowClock::getDelay<uint8_t>(1000000) == 255;
+        Timer16::s_count = 0;
+        testPassed &= Clock::getDelay<uint16_t>(32768) == 1;
+        testPassed &= Clock::getDelay<uint16_t>(32769) == 2;
+        testPassed &= Clock::getDelay<uint16_t>(0xFFFFFFFF) == 0xFFFF;
+
+        // Durations close to 2^32 ticks must saturate instead of wrapping around to a short delay
+        Timer16::s_count = 0xFFFF;
+        testPassed &= Clock::getDelay<uint32_t>(0x7FFFFFFF) == 0x10001;
+        testPassed &= Clock::getDelay<uint32_t>(0x80000000) == 0xFFFFFFFF;
+        testPassed &= SlowClock::getDelay<uint32_t>(0xFFFFFFFF) == 0x400001;
+        testPassed &= SlowClock::getDelay<uint32_t>(0xFFFFFFFD) == 0x400001;
+        Timer16::s_count = 0;
+        testPassed &= SlowClock::fromDelay<uint8_t>(5) == 5120;
+        testPassed &= Clock::fromDelay<uint16_t>(1000, 500) == 500000;
+    }
+    allPassed &= test_assert("toDelay/fromDelay", testPassed);
+
+    {
+        testPassed = true;
+
+        // Task scheduled for 10 ms in the future executes no earlier than that and within one scheduler period after
+        Timer8::s_count = 123;
+        const uint32_t start = SlowClock::getMicros();
+        s_scheduler.schedule(&onTask, SlowClock::getDelay<uint8_t>(10000));
+        for (uint16_t cnt = 0; cnt < 4000 && 0 == s_executedAt; ++cnt)
+        {
+            Timer8::advance(1);
+            s_scheduler.execute();
+        }
+        const uint32_t delay = s_executedAt - start;
+        testPassed &= delay >= 10000 && delay < 10000 + SlowClock::s_overflowMicros;
+    }
+    allPassed &= test_assert("Scheduler", testPassed);
+
+    {
+        testPassed = true;
+        benchmarkGetTicks();
+        benchmarkGetMicros();
+    }
+    allPassed &= test_assert("benchmark", testPassed);
+
+    test_assert("OVERALL:", allPassed);
+
+    while (true)
+    {
+    }
+}
+
+template <>
+struct debugPrinter<const char*>
+{
+    static void print(const char* arg)
+    {
+        // Put a tracepoint here and display {arg, s} in output window
+        (void)arg;
+    }
+};
+
+void throw_bad_alloc()
+{
+    while(true);
+}
+
+void throw_nullptr_error()
+{
+    while(true);
+}
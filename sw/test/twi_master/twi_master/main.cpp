@@ -0,0 +1,506 @@
+/*
+Copyright (C) 2023 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <twi_master.h>
+
+#include "../../common/debug_print.h"
+
+bool test_assert(const char * str, const bool flag)
+{
+    cout << str;
+    if (flag)
+    {
+        cout << static_cast<const char *>("PASSED");
+    }
+    else
+    {
+        cout << static_cast<const char *>("FAILED");
+    }
+    return flag;
+}
+
+// Simulated I2C EEPROM with 8-bit addresses. After a write, the EEPROM does not acknowledge its address until the write cycle has completed.
+struct MockEEPROM
+{
+    static constexpr uint8_t s_address = 0x50;
+    static constexpr uint16_t s_writeCycleTicks = 100;
+    
+    static bool addressed(const bool read)
+    {
+        if (s_busyTicks > 0)
+        {
+            return false;
+        }
+        s_nofWritten = read ? 1 : 0;
+        return true;
+    }
+    
+    static bool write(const uint8_t data)
+    {
+        if (0 == s_nofWritten++)
+        {
+            s_pointer = data;
+        }
+        else
+        {
+            s_memory[s_pointer++] = data;
+        }
+        return true;
+    }
+    
+    static uint8_t read()
+    {
+        return s_memory[s_pointer++];
+    }
+    
+    static void stop()
+    {
+        // Data has been written, start write cycle
+        if (s_nofWritten > 1)
+        {
+            s_busyTicks = s_writeCycleTicks;
+        }
+        s_nofWritten = 0;
+    }
+    
+    static uint8_t s_memory[256];
+    static uint8_t s_pointer;
+    static uint8_t s_nofWritten;
+    static uint16_t s_busyTicks;
+};
+
+// Static initialization
+uint8_t MockEEPROM::s_memory[256] = {};
+uint8_t MockEEPROM::s_pointer = 0;
+uint8_t MockEEPROM::s_nofWritten = 0;
+uint16_t MockEEPROM::s_busyTicks = 0;
+
+// Simulated DAC accepting up to 3 data bytes per transaction
+struct MockDAC
+{
+    static constexpr uint8_t s_address = 0x60;
+    
+    static bool write(const uint8_t data)
+    {
+        s_value = (s_value << 8) | data;
+        return ++s_nofWritten <= 3;
+    }
+    
+    static uint32_t s_value;
+    static uint8_t s_nofWritten;
+};
+
+// Static initialization
+uint32_t MockDAC::s_value = 0;
+uint8_t MockDAC::s_nofWritten = 0;
+
+// Simulated TWI peripheral and bus. Each bus operation takes a number of ticks (SCL periods) before the interrupt flag is set.
+struct MockTWI
+{
+    enum class Phase : uint8_t
+    {
+        idle,
+        started,
+        transmitting,
+        receiving
+    };
+    
+    // Register bit rate and status register contents
+    static uint8_t s_twbr;
+    static uint8_t s_twsr;
+    static uint8_t s_twdr;
+    static uint8_t s_twcr;
+    
+    static Phase s_phase;
+    static uint8_t s_slave;
+    static uint8_t s_pendingTicks;
+    static uint8_t s_pendingStatus;
+    
+    // Fault injection
+    static bool s_loseArbitration;
+    static bool s_busError;
+    
+    // Statistics
+    static uint16_t s_nofBytes;
+    
+    static void control(const uint8_t value)
+    {
+        s_twcr = value & ~_BV(TWINT);
+        if (!(value & _BV(TWINT)))
+        {
+            return;
+        }
+        
+        if (value & _BV(TWSTO))
+        {
+            stopCondition();
+            s_twcr &= ~_BV(TWSTO);
+        }
+        
+        if (value & _BV(TWSTA))
+        {
+            schedule(Phase::idle == s_phase ? 0x08 : 0x10, 1);
+            s_phase = Phase::started;
+            s_twcr &= ~_BV(TWSTA);
+        }
+        else if (Phase::started == s_phase)
+        {
+            addressSlave();
+        }
+        else if (Phase::transmitting == s_phase)
+        {
+            bool ack = false;
+            if (MockEEPROM::s_address == s_slave)
+            {
+                ack = MockEEPROM::write(s_twdr);
+            }
+            else if (MockDAC::s_address == s_slave)
+            {
+                ack = MockDAC::write(s_twdr);
+            }
+            schedule(ack ? 0x28 : 0x30, 9);
+        }
+        else if (Phase::receiving == s_phase)
+        {
+            s_twdr = MockEEPROM::read();
+            schedule((value & _BV(TWEA)) ? 0x50 : 0x58, 9);
+        }
+    }
+    
+    static void addressSlave()
+    {
+        const bool read = s_twdr & 1;
+        s_slave = s_twdr >> 1;
+        if (s_loseArbitration)
+        {
+            // Another master wins the bus and releases it after its transaction
+            s_loseArbitration = false;
+            s_phase = Phase::idle;
+            schedule(0x38, 9);
+            return;
+        }
+        if (s_busError)
+        {
+            s_busError = false;
+            s_phase = Phase::idle;
+            schedule(0x00, 1);
+            return;
+        }
+        
+        bool ack = false;
+        if (MockEEPROM::s_address == s_slave)
+        {
+            ack = MockEEPROM::addressed(read);
+        }
+        else if (MockDAC::s_address == s_slave)
+        {
+            ack = !read;
+            MockDAC::s_nofWritten = 0;
+        }
+        s_phase = read ? Phase::receiving : Phase::transmitting;
+        schedule(read ? (ack ? 0x40 : 0x48) : (ack ? 0x18 : 0x20), 9);
+    }
+    
+    static void stopCondition()
+    {
+        if (MockEEPROM::s_address == s_slave)
+        {
+            MockEEPROM::stop();
+        }
+        s_slave = 0;
+        s_phase = Phase::idle;
+    }
+    
+    static void schedule(const uint8_t status, const uint8_t nofTicks)
+    {
+        s_pendingStatus = status;
+        s_pendingTicks = nofTicks;
+        if (nofTicks > 1)
+        {
+            ++s_nofBytes;
+        }
+    }
+    
+    // Advance time by one SCL period
+    // @result true if the TWI interrupt is triggered
+    static bool tick()
+    {
+        if (MockEEPROM::s_busyTicks > 0)
+        {
+            --MockEEPROM::s_busyTicks;
+        }
+        if (0 == s_pendingTicks || 0 != --s_pendingTicks)
+        {
+            return false;
+        }
+        s_twsr = (s_twsr & 0x07) | s_pendingStatus;
+        s_twcr |= _BV(TWINT);
+        return s_twcr & _BV(TWIE);
+    }
+};
+
+// Static initialization
+uint8_t MockTWI::s_twbr = 0;
+uint8_t MockTWI::s_twsr = 0xF8;
+uint8_t MockTWI::s_twdr = 0;
+uint8_t MockTWI::s_twcr = 0;
+MockTWI::Phase MockTWI::s_phase = MockTWI::Phase::idle;
+uint8_t MockTWI::s_slave = 0;
+uint8_t MockTWI::s_pendingTicks = 0;
+uint8_t MockTWI::s_pendingStatus = 0;
+bool MockTWI::s_loseArbitration = false;
+bool MockTWI::s_busError = false;
+uint16_t MockTWI::s_nofBytes = 0;
+
+// Simulated registers
+struct MockTWBR
+{
+    using Type = uint8_t;
+    static uint8_t read() {return MockTWI::s_twbr;}
+    static void write(const uint8_t value) {MockTWI::s_twbr = value;}
+};
+
+struct MockTWSR
+{
+    using Type = uint8_t;
+    static uint8_t read() {return MockTWI::s_twsr;}
+    static void write(const uint8_t value) {MockTWI::s_twsr = (MockTWI::s_twsr & 0xF8) | (value & 0x07);}
+};
+
+struct MockTWDR
+{
+    using Type = uint8_t;
+    static uint8_t read() {return MockTWI::s_twdr;}
+    static void write(const uint8_t value) {MockTWI::s_twdr = value;}
+};
+
+struct MockTWCR
+{
+    using Type = uint8_t;
+    static uint8_t read() {return MockTWI::s_twcr;}
+    static void write(const uint8_t value) {MockTWI::control(value);}
+};
+
+using TWI = TWIMasterAsync<TWIModule<MockTWBR, MockTWSR, MockTWDR, MockTWCR>, 4>;
+
+// Completion callbacks recording results in order
+static TWIResult s_results[8];
+static uint8_t s_nofResults = 0;
+
+void onComplete(const TWIResult result)
+{
+    s_results[s_nofResults++] = result;
+}
+
+// Run the bus until all transactions have completed, calling the interrupt handler like the TWI interrupt would
+// @result Number of ticks
+uint16_t run()
+{
+    uint16_t nofTicks = 0;
+    while (TWI::isBusy() && nofTicks < 10000)
+    {
+        if (MockTWI::tick())
+        {
+            TWI::onInterrupt();
+        }
+        ++nofTicks;
+    }
+    return nofTicks;
+}
+
+// Wait until the EEPROM write cycle has completed by polling its address (acknowledge polling)
+// @result Number of polls
+uint8_t pollEEPROM()
+{
+    uint8_t nofPolls = 0;
+    do
+    {
+        s_nofResults = 0;
+        TWI::write(MockEEPROM::s_address, ConstSpan<uint8_t>(), onComplete);
+        run();
+        ++nofPolls;
+    }
+    while (TWIResult::success != s_results[0] && nofPolls < 100);
+    return nofPolls;
+}
+
+// Chained transaction enqueued by a completion callback
+static uint8_t s_chained[2];
+
+void onCompleteChain(const TWIResult result)
+{
+    onComplete(result);
+    TWI::read(MockEEPROM::s_address, s_chained, onComplete);
+}
+
+int main(void)
+{
+    bool allPassed = true;
+    bool testPassed = true;
+    
+    {
+        testPassed = true;
+        using Module = TWIModule<MockTWBR, MockTWSR, MockTWDR, MockTWCR>;
+        testPassed &= Module::getBitRate(16000000, 400000) == 12;
+        testPassed &= Module::getBitRate(16000000, 100000) == 72;
+        MockTWI::s_twsr = 0xFB;
+        TWI::init(Module::getBitRate(16000000, 400000));
+        testPassed &= MockTWI::s_twbr == 12;
+        testPassed &= (MockTWI::s_twsr & 0x07) == 0;
+        testPassed &= MockTWI::s_twcr == _BV(TWEN);
+        testPassed &= !TWI::isBusy();
+    }
+    allPassed &= test_assert("init", testPassed);
+    
+    {
+        testPassed = true;
+        s_nofResults = 0;
+        MockTWI::s_nofBytes = 0;
+        const uint8_t data[] = {0x10, 'T', 'W', 'I'};
+        testPassed &= TWI::write(MockEEPROM::s_address, data, onComplete);
+        testPassed &= TWI::isBusy();
+        const uint16_t nofTicks = run();
+        testPassed &= s_nofResults == 1 && TWIResult::success == s_results[0];
+        testPassed &= MockEEPROM::s_memory[0x10] == 'T' && MockEEPROM::s_memory[0x12] == 'I';
+        
+        // Start, address and 4 data bytes
+        testPassed &= MockTWI::s_nofBytes == 5;
+        testPassed &= nofTicks == 1 + 5 * 9;
+        testPassed &= MockTWI::Phase::idle == MockTWI::s_phase;
+    }
+    allPassed &= test_assert("write", testPassed);
+    
+    {
+        testPassed = true;
+        
+        // The EEPROM is busy with its write cycle
+        s_nofResults = 0;
+        uint8_t buffer[3] = {};
+        const uint8_t address[] = {0x10};
+        TWI::writeRead(MockEEPROM::s_address, address, buffer, onComplete);
+        run();
+        testPassed &= s_nofResults == 1 && TWIResult::addressNack == s_results[0];
+        
+        testPassed &= pollEEPROM() > 1;
+        
+        s_nofResults = 0;
+        TWI::writeRead(MockEEPROM::s_address, address, buffer, onComplete);
+        run();
+        testPassed &= s_nofResults == 1 && TWIResult::success == s_results[0];
+        testPassed &= buffer[0] == 'T' && buffer[1] == 'W' && buffer[2] == 'I';
+        
+        // Read continues at the current address
+        uint8_t single[1] = {};
+        MockEEPROM::s_pointer = 0x11;
+        s_nofResults = 0;
+        TWI::read(MockEEPROM::s_address, single, onComplete);
+        run();
+        testPassed &= s_nofResults == 1 && TWIResult::success == s_results[0] && single[0] == 'W';
+    }
+    allPassed &= test_assert("writeRead", testPassed);
+    
+    {
+        testPassed = true;
+        s_nofResults = 0;
+        uint8_t buffer[2];
+        TWI::read(0x23, buffer, onComplete);
+        run();
+        testPassed &= s_nofResults == 1 && TWIResult::addressNack == s_results[0];
+        
+        const uint8_t dacData[] = {0x01, 0x02, 0x03, 0x04};
+        s_nofResults = 0;
+        TWI::write(MockDAC::s_address, ConstSpan<uint8_t>(dacData).first(3), onComplete);
+        TWI::write(MockDAC::s_address, dacData, onComplete);
+        run();
+        testPassed &= s_nofResults == 2;
+        testPassed &= TWIResult::success == s_results[0];
+        testPassed &= TWIResult::dataNack == s_results[1];
+    }
+    allPassed &= test_assert("NACK", testPassed);
+    
+    {
+        testPassed = true;
+        s_nofResults = 0;
+        const uint8_t dacData[] = {0x0A, 0x0B};
+        for (uint8_t idx = 0; idx < 4; ++idx)
+        {
+            testPassed &= TWI::write(MockDAC::s_address, dacData, onComplete);
+        }
+        testPassed &= !TWI::write(MockDAC::s_address, dacData, onComplete);
+        testPassed &= TWI::getNofPendingTransactions() == 4;
+        run();
+        testPassed &= s_nofResults == 4;
+        testPassed &= !TWI::isBusy();
+    }
+    allPassed &= test_assert("queue", testPassed);
+    
+    {
+        testPassed = true;
+        pollEEPROM();
+        s_nofResults = 0;
+        MockEEPROM::s_pointer = 0x10;
+        const uint8_t dacData[] = {0x0C};
+        TWI::write(MockDAC::s_address, dacData, onCompleteChain);
+        run();
+        testPassed &= s_nofResults == 2;
+        testPassed &= TWIResult::success == s_results[0] && TWIResult::success == s_results[1];
+        testPassed &= s_chained[0] == 'T' && s_chained[1] == 'W';
+    }
+    allPassed &= test_assert("chaining", testPassed);
+    
+    {
+        testPassed = true;
+        s_nofResults = 0;
+        MockDAC::s_value = 0;
+        MockTWI::s_loseArbitration = true;
+        const uint8_t dacData[] = {0x12, 0x34};
+        TWI::write(MockDAC::s_address, dacData, onComplete);
+        run();
+        testPassed &= s_nofResults == 1 && TWIResult::success == s_results[0];
+        testPassed &= (MockDAC::s_value & 0xFFFF) == 0x1234;
+        
+        s_nofResults = 0;
+        MockTWI::s_busError = true;
+        TWI::write(MockDAC::s_address, dacData, onComplete);
+        TWI::write(MockDAC::s_address, dacData, onComplete);
+        run();
+        testPassed &= s_nofResults == 2;
+        testPassed &= TWIResult::busError == s_results[0] && TWIResult::success == s_results[1];
+    }
+    allPassed &= test_assert("arbitration/bus error", testPassed);
+    
+    test_assert("OVERALL:", allPassed);
+    
+    while (true)
+    {
+    }
+}
+
+template <>
+struct debugPrinter<const char*>
+{
+    static void print(const char* arg)
+    {
+        // Put a tracepoint here and display {arg, s} in output window
+        (void)arg;
+    }
+};
+
+void throw_bad_alloc()
+{
+    while(true);
+}
@@ -333,6 +333,32 @@ int main(void)
     testPassed &= T4::check(0,0,0,0,0);
     allPassed &= test_assert("Copy assignment", testPassed);
 
+    {
+        // Assignment of a const value, first to another alternative, then to the same alternative
+        testPassed = true;
+        T0::resetCounter();
+        T1::resetCounter();
+        T2::resetCounter();
+        T3::resetCounter();
+        T4::resetCounter();
+        TestVariant x;
+        using Type = T1;
+        const Type t(42);
+        x = t;
+        testPassed &= x.index() == 1;
+        testPassed &= get<Type>(x).getValue() == 42;
+        const Type u(43);
+        x = u;
+        testPassed &= x.index() == 1;
+        testPassed &= get<Type>(x).getValue() == 43;
+    }
+    testPassed &= T0::check(1,0,0,0,1);
+    testPassed &= T1::check(0,2,1,0,3);
+    testPassed &= T2::check(0,0,0,0,0);
+    testPassed &= T3::check(0,0,0,0,0);
+    testPassed &= T4::check(0,0,0,0,0);
+    allPassed &= test_assert("Copy assignment", testPassed);
+
     {
         testPassed = true;
         T0::resetCounter();
@@ -679,6 +679,26 @@ int main(void)
     testPassed &= (len == checkAllocator());
     allPassed &= test_assert("pushBack()", testPassed && Test::check(0,0,7,1,8));
 
+    {
+        // Growth from capacity 0: Elements are copied when growing from capacity 1 to 2 and from 2 to 4
+        testPassed = true;
+        Test::resetCounter();
+        Vector<Test> x;
+        for (const Test& t : testDeque)
+        {
+            x.pushBack(t);
+        }
+        testPassed &= (x.size() == testDeque.size());
+        auto it = x.begin();
+        for (const Test& t : testDeque)
+        {
+            testPassed &= t.getValue() == (*it).getValue();
+            ++it;
+        }
+    }
+    testPassed &= (len == checkAllocator());
+    allPassed &= test_assert("pushBack()", testPassed && Test::check(0,0,6,0,6));
+
     {
         testPassed = true;
         Test::resetCounter();
@@ -0,0 +1,270 @@
+/*
+Copyright (C) 2023 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <wavetable_oscillator.h>
+
+#include "../../common/debug_print.h"
+
+bool test_assert(const char * str, const bool flag)
+{
+    cout << str;
+    if (flag)
+    {
+        cout << static_cast<const char *>("PASSED");
+    }
+    else
+    {
+        cout << static_cast<const char *>("FAILED");
+    }
+    return flag;
+}
+
+// Count rising zero crossings of a voice over the given number of samples
+template <typename Bank>
+uint16_t countPeriods(Bank& bank, const uint16_t nofSamples)
+{
+    uint16_t nofPeriods = 0;
+    int16_t previous = bank.tick();
+    for (uint16_t cnt = 1; cnt < nofSamples; ++cnt)
+    {
+        const int16_t sample = bank.tick();
+        nofPeriods += previous < 0 && sample >= 0;
+        previous = sample;
+    }
+    return nofPeriods;
+}
+
+// Largest difference between consecutive samples of a slow sine wave
+template <bool t_interpolate>
+uint8_t getMaxStep()
+{
+    OscillatorBank<1, uint32_t, t_interpolate> bank;
+    bank.setIncrement(0, 0x00100000); // 1/4096 of a period per sample
+    int16_t previous = bank.tick();
+    uint8_t maxStep = 0;
+    for (uint16_t cnt = 0; cnt < 4096; ++cnt)
+    {
+        const int16_t sample = bank.tick();
+        const uint8_t step = sample > previous ? sample - previous : previous - sample;
+        maxStep = step > maxStep ? step : maxStep;
+        previous = sample;
+    }
+    return maxStep;
+}
+
+// Benchmark: Render 256 samples of t_nofVoices saw waves.
+// Put a breakpoint before and after each benchmark call and read the cycle counter of the simulator.
+// The cycle count divided by 256 * t_nofVoices is the cost per sample per voice.
+template <uint8_t t_nofVoices, typename Phase, bool t_interpolate>
+int16_t benchmarkTick()
+{
+    static OscillatorBank<t_nofVoices, Phase, t_interpolate> bank;
+    for (uint8_t voice = 0; voice < t_nofVoices; ++voice)
+    {
+        bank.setWaveform(voice, Wavetable<SawShape>::getBands());
+        bank.setIncrement(voice, bank.getIncrement(110.0f * (voice + 1), 32000.0f));
+    }
+
+    int16_t sum = 0;
+    for (uint16_t cnt = 0; cnt < 256; ++cnt)
+    {
+        sum += bank.tick();
+    }
+    return sum;
+}
+
+int main(void)
+{
+    bool allPassed = true;
+    bool testPassed = true;
+
+    {
+        testPassed = true;
+        const PgmArray<int8_t> sine = Wavetable<SineShape, 1>::getBand(0);
+        testPassed &= sine.size() == 256;
+        testPassed &= sine[0] == 0;
+        testPassed &= sine[64] == 127;
+        testPassed &= sine[128] == 0;
+        testPassed &= sine[192] == -127;
+        testPassed &= sine[32] == 90 && sine[160] == -90;
+
+        // The highest band contains the fundamental only
+        const PgmArray<int8_t> saw = Wavetable<SawShape>::getBand(7);
+        const PgmArray<int8_t> square = Wavetable<SquareShape>::getBand(7);
+        for (uint16_t idx = 0; idx < 256; ++idx)
+        {
+            testPassed &= saw[idx] == -sine[idx];
+            testPassed &= square[idx] == sine[idx];
+        }
+    }
+    allPassed &= test_assert("sine", testPassed);
+
+    {
+        testPassed = true;
+        testPassed &= Wavetable<SawShape>::getBands().size() == 8;
+        testPassed &= Wavetable<SawShape>::getNofHarmonics(0) == 128;
+        testPassed &= Wavetable<SawShape>::getNofHarmonics(7) == 1;
+
+        // All bands are normalized, and the rising saw wave jumps from its maximum to its minimum at the start of the table
+        for (uint8_t band = 0; band < 8; ++band)
+        {
+            const PgmArray<int8_t> saw = Wavetable<SawShape>::getBand(band);
+            int8_t peak = 0;
+            for (const int8_t sample : saw)
+            {
+                peak = sample > peak ? sample : (-sample > peak ? -sample : peak);
+            }
+            testPassed &= peak == 127;
+            testPassed &= saw[0] == 0 && saw[1] < 0 && saw[255] > 0;
+            testPassed &= saw[128] == 0 && saw[64] < 0 && saw[64] == -saw[192];
+        }
+
+        // Band 0 ramps up almost linearly, the peak being the overshoot at the discontinuity (Gibbs phenomenon)
+        const PgmArray<int8_t> saw = Wavetable<SawShape>::getBand(0);
+        testPassed &= saw[1] == -127;
+        testPassed &= saw[64] > -58 && saw[64] < -50;
+        testPassed &= saw[96] > -31 && saw[96] < -23;
+
+        // The triangle wave peaks at a quarter period
+        const PgmArray<int8_t> triangle = Wavetable<TriangleShape, 4>::getBand(0);
+        testPassed &= triangle[64] == 127 && triangle[192] == -127;
+        testPassed &= triangle[32] > 60 && triangle[32] < 68;
+    }
+    allPassed &= test_assert("band-limited tables", testPassed);
+
+    {
+        testPassed = true;
+        OscillatorBank<1> bank;
+        bank.setWaveform(0, Wavetable<SawShape>::getBands());
+        testPassed &= bank.getBand(0) == 0;
+        bank.setIncrement(0, 0x01000000);
+        testPassed &= bank.getBand(0) == 0;
+        bank.setIncrement(0, 0x01000001);
+        testPassed &= bank.getBand(0) == 1;
+        bank.setIncrement(0, 0x04000000);
+        testPassed &= bank.getBand(0) == 2;
+        bank.setIncrement(0, 0x40000000);
+        testPassed &= bank.getBand(0) == 6;
+        bank.setIncrement(0, 0x7FFFFFFF);
+        testPassed &= bank.getBand(0) == 7;
+
+        // Tables with less bands are clamped to the last band
+        bank.setWaveform(0, Wavetable<SquareShape, 4>::getBands());
+        testPassed &= bank.getBand(0) == 3;
+    }
+    allPassed &= test_assert("band selection", testPassed);
+
+    {
+        testPassed = true;
+        OscillatorBank<2> bank;
+        bank.setWaveform(0, Wavetable<SawShape>::getBands());
+        bank.setWaveform(1, Wavetable<SquareShape>::getBands());
+        bank.setIncrement(0, bank.getIncrement(1000.0f, 32000.0f));
+        testPassed &= bank.getIncrement(0) == 0x08000000;
+        testPassed &= countPeriods(bank, 3200) == 100;
+
+        // Second voice only
+        bank.setIncrement(0, 0);
+        bank.setPhase(0, 0x80000000);
+        bank.setIncrement(1, bank.getIncrement(440.0f, 32000.0f));
+        testPassed &= countPeriods(bank, 32050) == 440;
+
+        // 16-bit phase accumulator
+        OscillatorBank<1, uint16_t> lfo;
+        lfo.setIncrement(0, lfo.getIncrement(5.0f, 1000.0f));
+        testPassed &= lfo.getIncrement(0) == 328;
+        testPassed &= countPeriods(lfo, 2000) == 10;
+    }
+    allPassed &= test_assert("frequency", testPassed);
+
+    {
+        testPassed = true;
+        OscillatorBank<3, uint32_t> bank;
+        bank.setWaveform(1, Wavetable<SawShape>::getBands());
+        bank.setWaveform(2, Wavetable<SquareShape>::getBands());
+        for (uint8_t voice = 0; voice < 3; ++voice)
+        {
+            bank.setIncrement(voice, 0x01230000 * (voice + 1));
+        }
+        OscillatorBank<3, uint32_t> mix = bank;
+        for (uint16_t cnt = 0; cnt < 1000; ++cnt)
+        {
+            Array<int8_t, 3> samples;
+            bank.tick(samples);
+            testPassed &= mix.tick() == samples[0] + samples[1] + samples[2];
+        }
+        testPassed &= bank.getPhase(2) == static_cast<uint32_t>(0x03690000) * 1000;
+
+        // render() produces the same sequence as tick()
+        int16_t buffer[16];
+        mix.render(Span<int16_t>(buffer));
+        for (const int16_t sample : buffer)
+        {
+            testPassed &= sample == bank.tick();
+        }
+    }
+    allPassed &= test_assert("mix", testPassed);
+
+    {
+        testPassed = true;
+
+        // Halfway between two samples, the interpolated value is their average
+        OscillatorBank<1, uint32_t, true> bank;
+        const PgmArray<int8_t> sine = Wavetable<SineShape, 1>::getBand(0);
+        bank.setPhase(0, 0x00800000);
+        testPassed &= bank.tick() == (sine[0x00] + sine[0x01]) / 2;
+
+        bank.setWaveform(0, Wavetable<SawShape>::getBands());
+        const PgmArray<int8_t> saw = Wavetable<SawShape>::getBand(0);
+        bank.setPhase(0, 0xFF000000);
+        testPassed &= bank.tick() == saw[0xFF];
+        bank.setPhase(0, 0xFFC00000);
+        testPassed &= bank.tick() == saw[0xFF] + (3 * (saw[0] - saw[0xFF]) >> 2);
+
+        // Interpolation smoothes the staircase of a slow sine wave
+        testPassed &= getMaxStep<false>() == 4;
+        testPassed &= getMaxStep<true>() == 1;
+    }
+    allPassed &= test_assert("interpolation", testPassed);
+
+    {
+        testPassed = true;
+        benchmarkTick<1, __uint24, false>();
+        benchmarkTick<4, __uint24, false>();
+        benchmarkTick<4, __uint24, true>();
+        benchmarkTick<4, uint32_t, false>();
+        benchmarkTick<4, uint32_t, true>();
+        benchmarkTick<8, __uint24, false>();
+    }
+    allPassed &= test_assert("benchmark", testPassed);
+
+    test_assert("OVERALL:", allPassed);
+
+    while (true)
+    {
+    }
+}
+
+template <>
+struct debugPrinter<const char*>
+{
+    static void print(const char* arg)
+    {
+        // Put a tracepoint here and display {arg, s} in output window
+        (void)arg;
+    }
+};